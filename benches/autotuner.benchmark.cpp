@@ -0,0 +1,90 @@
+// First-party headers
+#include "calculator/autotuner.h"
+#include "calculator/compiled_program.h"
+#include "calculator/expression.h"
+
+// Third-party headers
+#include <benchmark/benchmark.h>
+
+// Standard library headers
+#include <algorithm>
+#include <filesystem>
+#include <span>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// Three formulas over four inputs, evaluated in one shared program.
+struct Workload {
+  explicit Workload(std::size_t row_count)
+      : inputs(4, std::vector<double>(row_count)),
+        results(3, std::vector<double>(row_count)), program(make_program()) {
+    for (std::size_t row = 0; row < row_count; ++row) {
+      inputs[0][row] = static_cast<double>(row % 101);
+      inputs[1][row] = static_cast<double>(row % 7);
+      inputs[2][row] = 0.5;
+      inputs[3][row] = static_cast<double>(row % 3);
+    }
+    columns.assign(inputs.begin(), inputs.end());
+    outputs.assign(results.begin(), results.end());
+  }
+
+  static CompiledProgram make_program() {
+    std::vector<Expression> expressions(3);
+    for (int seed = 0; seed < 3; ++seed) {
+      Expression& expression = expressions[seed];
+      NodeId a = expression.input(seed % 4);
+      NodeId b = expression.input((seed + 1) % 4);
+      NodeId c = expression.input((seed + 2) % 4);
+      expression.subtract(expression.multiply(expression.add(a, b), c),
+                          expression.multiply(a, expression.constant(0.25)));
+    }
+    return CompiledProgram(expressions);
+  }
+
+  std::vector<std::vector<double>> inputs;
+  std::vector<std::vector<double>> results;
+  std::vector<std::span<const double>> columns;
+  std::vector<std::span<double>> outputs;
+  CompiledProgram program;
+};
+
+void run_workload(benchmark::State& state, const TuningConfig& config) {
+  Workload workload(static_cast<std::size_t>(state.range(0)));
+  for (auto _ : state) {
+    evaluate_parallel(workload.program, workload.columns, workload.outputs,
+                      config);
+    benchmark::DoNotOptimize(workload.results.front().data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  state.counters["tile_rows"] = static_cast<double>(config.tile_rows);
+  state.counters["threads"] = static_cast<double>(config.thread_count);
+}
+
+} // namespace
+
+// Fixed configuration using every hardware thread, as an untuned caller
+// would.
+static void benchmark_autotuner_evaluate_default(benchmark::State& state) {
+  TuningConfig config;
+  config.thread_count = std::max(1u, std::thread::hardware_concurrency());
+  run_workload(state, config);
+}
+BENCHMARK(benchmark_autotuner_evaluate_default)
+    ->Arg(4096)
+    ->Arg(65536)
+    ->Arg(1 << 20)
+    ->UseRealTime();
+
+static void benchmark_autotuner_evaluate_tuned(benchmark::State& state) {
+  std::filesystem::path path = std::filesystem::temp_directory_path() /
+                               "calculator-autotuner-benchmark.txt";
+  Autotuner autotuner(path);
+  run_workload(state, autotuner.config_for(state.range(0)));
+}
+BENCHMARK(benchmark_autotuner_evaluate_tuned)
+    ->Arg(4096)
+    ->Arg(65536)
+    ->Arg(1 << 20)
+    ->UseRealTime();
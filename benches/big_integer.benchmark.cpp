@@ -0,0 +1,89 @@
+// First-party headers
+#include "calculator/big_integer.h"
+
+// Third-party headers
+#include <benchmark/benchmark.h>
+
+// Standard library headers
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+std::string make_digits(std::size_t count) {
+  std::mt19937_64 random(17);
+  std::string digits(count, '0');
+  for (char& digit : digits) {
+    digit = static_cast<char>('0' + random() % 10);
+  }
+  digits[0] = '7';
+  return digits;
+}
+
+// Today's approach: repeated division of the binary limbs by ten, one
+// quadratic pass per digit.
+std::string naive_to_string(std::vector<std::uint32_t> limbs) {
+  std::string digits;
+  while (!limbs.empty()) {
+    std::uint64_t remainder = 0;
+    for (std::size_t index = limbs.size(); index-- > 0;) {
+      const std::uint64_t current = (remainder << 32) | limbs[index];
+      limbs[index] = static_cast<std::uint32_t>(current / 10);
+      remainder = current % 10;
+    }
+    digits.push_back(static_cast<char>('0' + remainder));
+    while (!limbs.empty() && limbs.back() == 0) {
+      limbs.pop_back();
+    }
+  }
+  return {digits.rbegin(), digits.rend()};
+}
+
+} // namespace
+
+// The argument is the number of decimal digits.
+static void benchmark_big_integer_from_string(benchmark::State& state) {
+  const std::string digits =
+      make_digits(static_cast<std::size_t>(state.range(0)));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(BigInteger::from_string(digits));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(benchmark_big_integer_from_string)
+    ->RangeMultiplier(10)
+    ->Range(1000, 10000000)
+    ->Unit(benchmark::kMillisecond);
+
+static void benchmark_big_integer_to_string(benchmark::State& state) {
+  const BigInteger value = BigInteger::from_string(
+      make_digits(static_cast<std::size_t>(state.range(0))));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(value.to_string());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(benchmark_big_integer_to_string)
+    ->RangeMultiplier(10)
+    ->Range(1000, 10000000)
+    ->Unit(benchmark::kMillisecond);
+
+// Stops at 100k digits, which already takes seconds per conversion.
+static void benchmark_big_integer_to_string_naive(benchmark::State& state) {
+  std::mt19937 random(17);
+  std::vector<std::uint32_t> limbs(
+      static_cast<std::size_t>(state.range(0)) * 10 / 96 + 1);
+  for (std::uint32_t& limb : limbs) {
+    limb = static_cast<std::uint32_t>(random());
+  }
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(naive_to_string(limbs));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(benchmark_big_integer_to_string_naive)
+    ->RangeMultiplier(10)
+    ->Range(1000, 100000)
+    ->Unit(benchmark::kMillisecond);
@@ -4,6 +4,41 @@
 // Third-party headers
 #include <benchmark/benchmark.h>
 
+// Standard library headers
+#include <numeric>
+#include <random>
+#include <vector>
+
+namespace {
+
+constexpr std::size_t PAIR_COUNT = 4096;
+
+// Pairs of 31-bit values sharing a random factor, as ratios to normalize
+// do.
+std::vector<int> make_operands(std::uint64_t seed) {
+  std::mt19937 random(17);
+  std::mt19937 other(static_cast<std::mt19937::result_type>(seed));
+  std::uniform_int_distribution<int> factor_of(1, 1000);
+  std::uniform_int_distribution<int> value_of(1, 2000000);
+  std::vector<int> values(PAIR_COUNT);
+  for (int& value : values) {
+    value = factor_of(random) * value_of(other);
+  }
+  return values;
+}
+
+// Today's approach: Euclid's algorithm, one hardware division per step.
+int modulo_gcd(int first_value, int second_value) {
+  while (second_value != 0) {
+    const int remainder = first_value % second_value;
+    first_value = second_value;
+    second_value = remainder;
+  }
+  return first_value < 0 ? -first_value : first_value;
+}
+
+} // namespace
+
 static void benchmark_calculator_add_basic(benchmark::State& state) {
   Calculator calculator;
   for (auto _ : state) {
@@ -44,4 +79,94 @@ static void benchmark_calculator_add_range(benchmark::State& state) {
 }
 BENCHMARK(benchmark_calculator_add_range)->Args({8, 32})->Args({64, 128})->Args({512, 1024});
 
+static void benchmark_calculator_gcd_modulo_loop(benchmark::State& state) {
+  const std::vector<int> first_values = make_operands(1);
+  const std::vector<int> second_values = make_operands(2);
+  std::vector<int> results(PAIR_COUNT);
+  for (auto _ : state) {
+    for (std::size_t index = 0; index < PAIR_COUNT; ++index) {
+      results[index] = modulo_gcd(first_values[index], second_values[index]);
+    }
+    benchmark::DoNotOptimize(results.data());
+  }
+  state.SetItemsProcessed(state.iterations() * PAIR_COUNT);
+}
+BENCHMARK(benchmark_calculator_gcd_modulo_loop);
+
+static void benchmark_calculator_gcd_std_loop(benchmark::State& state) {
+  const std::vector<int> first_values = make_operands(1);
+  const std::vector<int> second_values = make_operands(2);
+  std::vector<int> results(PAIR_COUNT);
+  for (auto _ : state) {
+    for (std::size_t index = 0; index < PAIR_COUNT; ++index) {
+      results[index] = std::gcd(first_values[index], second_values[index]);
+    }
+    benchmark::DoNotOptimize(results.data());
+  }
+  state.SetItemsProcessed(state.iterations() * PAIR_COUNT);
+}
+BENCHMARK(benchmark_calculator_gcd_std_loop);
+
+static void benchmark_calculator_gcd_scalar_loop(benchmark::State& state) {
+  Calculator calculator;
+  const std::vector<int> first_values = make_operands(1);
+  const std::vector<int> second_values = make_operands(2);
+  std::vector<int> results(PAIR_COUNT);
+  for (auto _ : state) {
+    for (std::size_t index = 0; index < PAIR_COUNT; ++index) {
+      results[index] =
+          calculator.gcd(first_values[index], second_values[index]);
+    }
+    benchmark::DoNotOptimize(results.data());
+  }
+  state.SetItemsProcessed(state.iterations() * PAIR_COUNT);
+}
+BENCHMARK(benchmark_calculator_gcd_scalar_loop);
+
+static void benchmark_calculator_gcd_batch(benchmark::State& state) {
+  Calculator calculator;
+  const std::vector<int> first_values = make_operands(1);
+  const std::vector<int> second_values = make_operands(2);
+  std::vector<int> results(PAIR_COUNT);
+  for (auto _ : state) {
+    calculator.gcd(first_values, second_values, results);
+    benchmark::DoNotOptimize(results.data());
+  }
+  state.SetItemsProcessed(state.iterations() * PAIR_COUNT);
+}
+BENCHMARK(benchmark_calculator_gcd_batch);
+
+// LCMs of the operands' shared factors, which all fit in int.
+static void benchmark_calculator_lcm_std_loop(benchmark::State& state) {
+  const std::vector<int> first_values = make_operands(1);
+  const std::vector<int> second_values = make_operands(2);
+  std::vector<int> results(PAIR_COUNT);
+  for (auto _ : state) {
+    for (std::size_t index = 0; index < PAIR_COUNT; ++index) {
+      results[index] = std::lcm(first_values[index] % 46340,
+                                second_values[index] % 46340);
+    }
+    benchmark::DoNotOptimize(results.data());
+  }
+  state.SetItemsProcessed(state.iterations() * PAIR_COUNT);
+}
+BENCHMARK(benchmark_calculator_lcm_std_loop);
+
+static void benchmark_calculator_lcm_batch(benchmark::State& state) {
+  Calculator calculator;
+  std::vector<int> first_values = make_operands(1);
+  std::vector<int> second_values = make_operands(2);
+  for (std::size_t index = 0; index < PAIR_COUNT; ++index) {
+    first_values[index] %= 46340;
+    second_values[index] %= 46340;
+  }
+  std::vector<int> results(PAIR_COUNT);
+  for (auto _ : state) {
+    calculator.lcm(first_values, second_values, results);
+    benchmark::DoNotOptimize(results.data());
+  }
+  state.SetItemsProcessed(state.iterations() * PAIR_COUNT);
+}
+BENCHMARK(benchmark_calculator_lcm_batch);
+
 BENCHMARK_MAIN();
\ No newline at end of file
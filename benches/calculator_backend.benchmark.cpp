@@ -0,0 +1,68 @@
+// First-party headers
+#include "calculator/calculator_backend.h"
+
+// Third-party headers
+#include <benchmark/benchmark.h>
+
+// Standard library headers
+#include <random>
+#include <vector>
+
+namespace {
+
+// Small enough to stay in L1, so that the timings are the dispatch.
+constexpr std::size_t PAIR_COUNT = 4096;
+
+std::vector<int> make_operands(std::uint64_t seed) {
+  std::mt19937_64 random(seed);
+  std::vector<int> values(PAIR_COUNT);
+  for (int& value : values) {
+    value = static_cast<int>(random() % 2001) - 1000;
+  }
+  return values;
+}
+
+template <typename Engine>
+void run_multiply(benchmark::State& state,
+                  BasicCalculator<Engine>& calculator) {
+  const std::vector<int> first_values = make_operands(1);
+  const std::vector<int> second_values = make_operands(2);
+  std::vector<int> results(PAIR_COUNT);
+  for (auto _ : state) {
+    calculator.multiply(first_values, second_values, results);
+    benchmark::DoNotOptimize(results.data());
+  }
+  state.SetItemsProcessed(state.iterations() * PAIR_COUNT);
+}
+
+} // namespace
+
+// Static dispatch into an engine defined in the header: inlined, so the
+// batch loop vectorizes.
+static void
+benchmark_calculator_backend_multiply_static_inline(benchmark::State& state) {
+  BasicCalculator<WrappingBackend> calculator;
+  run_multiply(state, calculator);
+}
+BENCHMARK(benchmark_calculator_backend_multiply_static_inline);
+
+// Static dispatch into Calculator: a direct call per element into its
+// translation unit.
+static void benchmark_calculator_backend_multiply_static_calculator(
+    benchmark::State& state) {
+  BasicCalculator<Calculator> calculator;
+  run_multiply(state, calculator);
+}
+BENCHMARK(benchmark_calculator_backend_multiply_static_calculator);
+
+// Virtual dispatch through AnyCalculator, with the engine picked at run
+// time as the type-erased path is meant for: the argument is 0 for
+// WrappingBackend and 1 for Calculator.
+static void
+benchmark_calculator_backend_multiply_virtual(benchmark::State& state) {
+  BasicCalculator<AnyCalculator> calculator{
+      state.range(0) == 0 ? AnyCalculator(WrappingBackend())
+                          : AnyCalculator(Calculator())};
+  run_multiply(state, calculator);
+}
+BENCHMARK(benchmark_calculator_backend_multiply_virtual)->Arg(0)->Arg(1);
@@ -0,0 +1,147 @@
+// First-party headers
+#include "calculator/comparison.h"
+
+// Third-party headers
+#include <benchmark/benchmark.h>
+
+// Standard library headers
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace {
+
+constexpr std::size_t VALUE_COUNT = 1 << 20;
+
+// The median of the values, so that half of them compare below it.
+constexpr int THRESHOLD = static_cast<int>(VALUE_COUNT / 2);
+
+// Values 0 to VALUE_COUNT - 1 in order, after swapping the given percentage
+// of positions with random ones. A branch on value < THRESHOLD is then
+// always predicted at 0 and a coin flip at 100.
+std::vector<int> make_values(int random_percent) {
+  std::mt19937_64 random(1);
+  std::vector<int> values(VALUE_COUNT);
+  std::iota(values.begin(), values.end(), 0);
+  const std::size_t swaps =
+      VALUE_COUNT * static_cast<std::size_t>(random_percent) / 100;
+  for (std::size_t swap = 0; swap < swaps; ++swap) {
+    std::swap(values[random() % VALUE_COUNT], values[random() % VALUE_COUNT]);
+  }
+  return values;
+}
+
+void randomness_arguments(benchmark::internal::Benchmark* benchmark) {
+  for (int random_percent : {0, 1, 10, 50, 100}) {
+    benchmark->Arg(random_percent);
+  }
+}
+
+} // namespace
+
+// Scalar baseline: a branch per value, setting the bit when it is taken.
+// The argument is the percentage of shuffled values.
+static void benchmark_comparison_compare_branching(benchmark::State& state) {
+  const std::vector<int> values =
+      make_values(static_cast<int>(state.range(0)));
+  Bitmask mask(VALUE_COUNT);
+  for (auto _ : state) {
+    std::span<std::uint64_t> words = mask.words();
+    std::fill(words.begin(), words.end(), 0);
+    for (std::size_t position = 0; position < VALUE_COUNT; ++position) {
+      if (values[position] < THRESHOLD) {
+        words[position / 64] |= std::uint64_t{1} << (position % 64);
+      }
+    }
+    benchmark::DoNotOptimize(words.data());
+  }
+  state.SetItemsProcessed(state.iterations() * VALUE_COUNT);
+}
+BENCHMARK(benchmark_comparison_compare_branching)
+    ->Apply(randomness_arguments);
+
+static void benchmark_comparison_compare(benchmark::State& state) {
+  const std::vector<int> values =
+      make_values(static_cast<int>(state.range(0)));
+  Bitmask mask;
+  for (auto _ : state) {
+    batch_compare(values, THRESHOLD, Comparison::Less, mask);
+    benchmark::DoNotOptimize(mask.words().data());
+  }
+  state.SetItemsProcessed(state.iterations() * VALUE_COUNT);
+}
+BENCHMARK(benchmark_comparison_compare)->Apply(randomness_arguments);
+
+static void benchmark_comparison_clamp_branching(benchmark::State& state) {
+  const std::vector<int> values =
+      make_values(static_cast<int>(state.range(0)));
+  std::vector<int> results(VALUE_COUNT);
+  for (auto _ : state) {
+    for (std::size_t position = 0; position < VALUE_COUNT; ++position) {
+      const int value = values[position];
+      if (value < THRESHOLD / 2) {
+        results[position] = THRESHOLD / 2;
+      } else if (value > THRESHOLD) {
+        results[position] = THRESHOLD;
+      } else {
+        results[position] = value;
+      }
+    }
+    benchmark::DoNotOptimize(results.data());
+  }
+  state.SetItemsProcessed(state.iterations() * VALUE_COUNT);
+}
+BENCHMARK(benchmark_comparison_clamp_branching)->Apply(randomness_arguments);
+
+static void benchmark_comparison_clamp(benchmark::State& state) {
+  const std::vector<int> values =
+      make_values(static_cast<int>(state.range(0)));
+  std::vector<int> results(VALUE_COUNT);
+  for (auto _ : state) {
+    batch_clamp(values, THRESHOLD / 2, THRESHOLD, results);
+    benchmark::DoNotOptimize(results.data());
+  }
+  state.SetItemsProcessed(state.iterations() * VALUE_COUNT);
+}
+BENCHMARK(benchmark_comparison_clamp)->Apply(randomness_arguments);
+
+// Picking between two precomputed results by a predicate on the values.
+static void benchmark_comparison_select_branching(benchmark::State& state) {
+  const std::vector<int> values =
+      make_values(static_cast<int>(state.range(0)));
+  const std::vector<int> if_set(VALUE_COUNT, 1);
+  const std::vector<int> if_clear(VALUE_COUNT, -1);
+  std::vector<int> results(VALUE_COUNT);
+  for (auto _ : state) {
+    for (std::size_t position = 0; position < VALUE_COUNT; ++position) {
+      if (values[position] < THRESHOLD) {
+        results[position] = if_set[position];
+      } else {
+        results[position] = if_clear[position];
+      }
+    }
+    benchmark::DoNotOptimize(results.data());
+  }
+  state.SetItemsProcessed(state.iterations() * VALUE_COUNT);
+}
+BENCHMARK(benchmark_comparison_select_branching)
+    ->Apply(randomness_arguments);
+
+static void benchmark_comparison_select(benchmark::State& state) {
+  const std::vector<int> values =
+      make_values(static_cast<int>(state.range(0)));
+  const std::vector<int> if_set(VALUE_COUNT, 1);
+  const std::vector<int> if_clear(VALUE_COUNT, -1);
+  std::vector<int> results(VALUE_COUNT);
+  Bitmask mask;
+  for (auto _ : state) {
+    batch_compare(values, THRESHOLD, Comparison::Less, mask);
+    batch_select(mask, if_set, if_clear, results);
+    benchmark::DoNotOptimize(results.data());
+  }
+  state.SetItemsProcessed(state.iterations() * VALUE_COUNT);
+}
+BENCHMARK(benchmark_comparison_select)->Apply(randomness_arguments);
@@ -0,0 +1,110 @@
+// First-party headers
+#include "calculator/calculator.h"
+#include "calculator/convolution.h"
+
+// Third-party headers
+#include <benchmark/benchmark.h>
+
+// Standard library headers
+#include <algorithm>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr std::size_t SIGNAL_SIZE = 1 << 16;
+
+template <typename T> std::vector<T> make_values(std::size_t count) {
+  std::vector<T> values(count);
+  for (std::size_t index = 0; index < count; ++index) {
+    values[index] = static_cast<T>(static_cast<int>(index * 7919 % 201) - 100);
+  }
+  return values;
+}
+
+// Arguments are the kernel size and the method (Automatic, Direct, Fft);
+// the direct and FFT series cross where Automatic should switch.
+template <typename T, typename Result>
+void run_convolution(benchmark::State& state) {
+  const auto kernel_size = static_cast<std::size_t>(state.range(0));
+  const auto method = static_cast<ConvolutionMethod>(state.range(1));
+  const std::vector<T> signal = make_values<T>(SIGNAL_SIZE);
+  const std::vector<T> kernel = make_values<T>(kernel_size);
+  std::vector<Result> results(SIGNAL_SIZE + kernel_size - 1);
+  for (auto _ : state) {
+    convolve(signal, kernel, results, method);
+    benchmark::DoNotOptimize(results.data());
+  }
+  state.SetItemsProcessed(state.iterations() * SIGNAL_SIZE);
+}
+
+void crossover_arguments(benchmark::internal::Benchmark* benchmark) {
+  for (int method : {1, 2}) {
+    for (int kernel_size : {8, 16, 32, 48, 64, 96, 128, 192, 256, 4096}) {
+      benchmark->Args({kernel_size, method});
+    }
+  }
+}
+
+} // namespace
+
+// Today's approach: nested Calculator::multiply and add loops.
+static void benchmark_convolution_calculator_loops(benchmark::State& state) {
+  const auto kernel_size = static_cast<std::size_t>(state.range(0));
+  const std::vector<int> signal = make_values<int>(SIGNAL_SIZE);
+  const std::vector<int> kernel = make_values<int>(kernel_size);
+  std::vector<int> results(SIGNAL_SIZE + kernel_size - 1);
+  Calculator calculator;
+  for (auto _ : state) {
+    std::fill(results.begin(), results.end(), 0);
+    for (std::size_t index = 0; index < signal.size(); ++index) {
+      for (std::size_t tap = 0; tap < kernel.size(); ++tap) {
+        results[index + tap] = calculator.add(
+            results[index + tap], calculator.multiply(signal[index],
+                                                      kernel[tap]));
+      }
+    }
+    benchmark::DoNotOptimize(results.data());
+  }
+  state.SetItemsProcessed(state.iterations() * SIGNAL_SIZE);
+}
+BENCHMARK(benchmark_convolution_calculator_loops)->Arg(16)->Arg(128);
+
+static void benchmark_convolution_float_crossover(benchmark::State& state) {
+  run_convolution<float, float>(state);
+}
+BENCHMARK(benchmark_convolution_float_crossover)->Apply(crossover_arguments);
+
+static void benchmark_convolution_double_crossover(benchmark::State& state) {
+  run_convolution<double, double>(state);
+}
+BENCHMARK(benchmark_convolution_double_crossover)->Apply(crossover_arguments);
+
+static void benchmark_convolution_int_crossover(benchmark::State& state) {
+  run_convolution<int, std::int64_t>(state);
+}
+BENCHMARK(benchmark_convolution_int_crossover)->Apply(crossover_arguments);
+
+// Arguments are the kernel size and the thread count (zero for all
+// hardware threads), over a 16M-value signal.
+static void benchmark_convolution_float_threads(benchmark::State& state) {
+  const auto kernel_size = static_cast<std::size_t>(state.range(0));
+  const unsigned threads =
+      state.range(1) == 0 ? std::max(1u, std::thread::hardware_concurrency())
+                          : static_cast<unsigned>(state.range(1));
+  const std::vector<float> signal = make_values<float>(SIGNAL_SIZE << 8);
+  const std::vector<float> kernel = make_values<float>(kernel_size);
+  std::vector<float> results(signal.size() + kernel_size - 1);
+  for (auto _ : state) {
+    convolve(signal, kernel, results, ConvolutionMethod::Automatic, threads);
+    benchmark::DoNotOptimize(results.data());
+  }
+  state.SetItemsProcessed(state.iterations() * signal.size());
+}
+BENCHMARK(benchmark_convolution_float_threads)
+    ->Args({16, 1})
+    ->Args({16, 0})
+    ->Args({1024, 1})
+    ->Args({1024, 0})
+    ->Unit(benchmark::kMillisecond);
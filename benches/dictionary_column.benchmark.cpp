@@ -0,0 +1,158 @@
+// First-party headers
+#include "calculator/calculator.h"
+#include "calculator/dictionary_column.h"
+
+// Third-party headers
+#include <benchmark/benchmark.h>
+
+// Standard library headers
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace {
+
+constexpr std::size_t ROW_COUNT = 1 << 22;
+
+// Rows drawn from distinct values spread spacing apart, e.g. price points
+// in cents.
+std::vector<int> make_column(std::size_t distinct, int spacing,
+                             std::uint64_t seed) {
+  std::mt19937_64 random(seed);
+  std::uniform_int_distribution<std::size_t> index_of(0, distinct - 1);
+  std::vector<int> values(ROW_COUNT);
+  for (int& value : values) {
+    value = static_cast<int>(index_of(random)) * spacing + 99;
+  }
+  return values;
+}
+
+} // namespace
+
+// Arguments are the distinct count and the spacing of the values; 1000
+// values 100 apart take the dense encoder, 100000 apart the hash table.
+static void benchmark_dictionary_column_encode(benchmark::State& state) {
+  const std::vector<int> values = make_column(
+      static_cast<std::size_t>(state.range(0)),
+      static_cast<int>(state.range(1)), 1);
+  for (auto _ : state) {
+    DictionaryColumn column = DictionaryColumn::encode(values);
+    benchmark::DoNotOptimize(column.codes().data());
+  }
+  state.SetItemsProcessed(state.iterations() * ROW_COUNT);
+}
+BENCHMARK(benchmark_dictionary_column_encode)
+    ->Args({1000, 100})
+    ->Args({1000, 100000})
+    ->Args({60000, 1})
+    ->Args({60000, 10000});
+
+// Today's approach on encoded data: decode the column, then call
+// Calculator once per row.
+static void
+benchmark_dictionary_column_multiply_decode_then_compute(
+    benchmark::State& state) {
+  const DictionaryColumn column =
+      DictionaryColumn::encode(make_column(1000, 100, 1));
+  std::vector<int> decoded(ROW_COUNT);
+  std::vector<int> results(ROW_COUNT);
+  Calculator calculator;
+  for (auto _ : state) {
+    column.decode(decoded);
+    for (std::size_t row = 0; row < ROW_COUNT; ++row) {
+      results[row] = calculator.multiply(decoded[row], 3);
+    }
+    benchmark::DoNotOptimize(results.data());
+  }
+  state.SetItemsProcessed(state.iterations() * ROW_COUNT);
+}
+BENCHMARK(benchmark_dictionary_column_multiply_decode_then_compute);
+
+static void benchmark_dictionary_column_multiply(benchmark::State& state) {
+  const DictionaryColumn column =
+      DictionaryColumn::encode(make_column(1000, 100, 1));
+  std::vector<int> results(ROW_COUNT);
+  DictionaryCalculator calculator;
+  for (auto _ : state) {
+    calculator.multiply(column, 3, results);
+    benchmark::DoNotOptimize(results.data());
+  }
+  state.SetItemsProcessed(state.iterations() * ROW_COUNT);
+}
+BENCHMARK(benchmark_dictionary_column_multiply);
+
+static void
+benchmark_dictionary_column_divide_decode_then_compute(
+    benchmark::State& state) {
+  const DictionaryColumn column =
+      DictionaryColumn::encode(make_column(1000, 100, 1));
+  std::vector<int> decoded(ROW_COUNT);
+  std::vector<double> results(ROW_COUNT);
+  Calculator calculator;
+  for (auto _ : state) {
+    column.decode(decoded);
+    for (std::size_t row = 0; row < ROW_COUNT; ++row) {
+      results[row] = calculator.divide(decoded[row], 7);
+    }
+    benchmark::DoNotOptimize(results.data());
+  }
+  state.SetItemsProcessed(state.iterations() * ROW_COUNT);
+}
+BENCHMARK(benchmark_dictionary_column_divide_decode_then_compute);
+
+static void benchmark_dictionary_column_divide(benchmark::State& state) {
+  const DictionaryColumn column =
+      DictionaryColumn::encode(make_column(1000, 100, 1));
+  std::vector<double> results(ROW_COUNT);
+  DictionaryCalculator calculator;
+  for (auto _ : state) {
+    calculator.divide(column, 7, results);
+    benchmark::DoNotOptimize(results.data());
+  }
+  state.SetItemsProcessed(state.iterations() * ROW_COUNT);
+}
+BENCHMARK(benchmark_dictionary_column_divide);
+
+// Argument is the distinct count of the divisor column; prices are divided
+// by quantities, 16 distinct ones giving 16000 pairs and 1000 giving too
+// many for the pair table.
+static void
+benchmark_dictionary_column_divide_columns_decode_then_compute(
+    benchmark::State& state) {
+  const DictionaryColumn first =
+      DictionaryColumn::encode(make_column(1000, 100, 1));
+  const DictionaryColumn second = DictionaryColumn::encode(
+      make_column(static_cast<std::size_t>(state.range(0)), 1, 2));
+  std::vector<int> first_decoded(ROW_COUNT);
+  std::vector<int> second_decoded(ROW_COUNT);
+  std::vector<double> results(ROW_COUNT);
+  Calculator calculator;
+  for (auto _ : state) {
+    first.decode(first_decoded);
+    second.decode(second_decoded);
+    for (std::size_t row = 0; row < ROW_COUNT; ++row) {
+      results[row] = calculator.divide(first_decoded[row], second_decoded[row]);
+    }
+    benchmark::DoNotOptimize(results.data());
+  }
+  state.SetItemsProcessed(state.iterations() * ROW_COUNT);
+}
+BENCHMARK(benchmark_dictionary_column_divide_columns_decode_then_compute)
+    ->Arg(16)
+    ->Arg(1000);
+
+static void
+benchmark_dictionary_column_divide_columns(benchmark::State& state) {
+  const DictionaryColumn first =
+      DictionaryColumn::encode(make_column(1000, 100, 1));
+  const DictionaryColumn second = DictionaryColumn::encode(
+      make_column(static_cast<std::size_t>(state.range(0)), 1, 2));
+  std::vector<double> results(ROW_COUNT);
+  DictionaryCalculator calculator;
+  for (auto _ : state) {
+    calculator.divide(first, second, results);
+    benchmark::DoNotOptimize(results.data());
+  }
+  state.SetItemsProcessed(state.iterations() * ROW_COUNT);
+}
+BENCHMARK(benchmark_dictionary_column_divide_columns)->Arg(16)->Arg(1000);
@@ -0,0 +1,145 @@
+// First-party headers
+#include "calculator/elementary_functions.h"
+
+// Third-party headers
+#include <benchmark/benchmark.h>
+
+// Standard library headers
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <span>
+#include <vector>
+
+namespace {
+
+constexpr std::size_t VALUE_COUNT = 4096;
+
+template <typename T>
+std::vector<T> make_values(double low, double high, std::uint64_t seed = 21) {
+  std::mt19937_64 random(seed);
+  std::uniform_real_distribution<double> value_of(low, high);
+  std::vector<T> values(VALUE_COUNT);
+  for (T& value : values) {
+    value = static_cast<T>(value_of(random));
+  }
+  return values;
+}
+
+// Element-wise libm, the baseline. Argument -1 selects it, 0..2 the tiers.
+template <typename T, typename Batch, typename Libm>
+void run_unary(benchmark::State& state, double low, double high, Batch batch,
+               Libm libm) {
+  const std::vector<T> values = make_values<T>(low, high);
+  std::vector<T> results(VALUE_COUNT);
+  const auto tier = state.range(0);
+  for (auto _ : state) {
+    if (tier < 0) {
+      for (std::size_t index = 0; index < VALUE_COUNT; ++index) {
+        results[index] = libm(values[index]);
+      }
+    } else {
+      batch(std::span<const T>(values), std::span<T>(results),
+            static_cast<MathAccuracy>(tier));
+    }
+    benchmark::DoNotOptimize(results.data());
+  }
+  state.SetItemsProcessed(state.iterations() * VALUE_COUNT);
+
+  std::uint64_t worst = 0;
+  for (std::size_t index = 0; index < VALUE_COUNT; ++index) {
+    worst = std::max(worst, ulp_distance(results[index], libm(values[index])));
+  }
+  state.counters["max_ulp"] = static_cast<double>(worst);
+}
+
+template <typename T> void run_pow(benchmark::State& state) {
+  const std::vector<T> bases = make_values<T>(0.0, 100.0);
+  const std::vector<T> exponents = make_values<T>(-3.0, 3.0, 22);
+  std::vector<T> results(VALUE_COUNT);
+  const auto tier = state.range(0);
+  for (auto _ : state) {
+    if (tier < 0) {
+      for (std::size_t index = 0; index < VALUE_COUNT; ++index) {
+        results[index] = std::pow(bases[index], exponents[index]);
+      }
+    } else {
+      batch_pow(std::span<const T>(bases), std::span<const T>(exponents),
+                std::span<T>(results), static_cast<MathAccuracy>(tier));
+    }
+    benchmark::DoNotOptimize(results.data());
+  }
+  state.SetItemsProcessed(state.iterations() * VALUE_COUNT);
+
+  std::uint64_t worst = 0;
+  for (std::size_t index = 0; index < VALUE_COUNT; ++index) {
+    worst = std::max(worst, ulp_distance(results[index],
+                                         std::pow(bases[index],
+                                                  exponents[index])));
+  }
+  state.counters["max_ulp"] = static_cast<double>(worst);
+}
+
+} // namespace
+
+static void benchmark_elementary_functions_sqrt_double(
+    benchmark::State& state) {
+  run_unary<double>(
+      state, 0.0, 1e6,
+      [](auto values, auto results, MathAccuracy accuracy) {
+        batch_sqrt(values, results, accuracy);
+      },
+      [](double x) { return std::sqrt(x); });
+}
+BENCHMARK(benchmark_elementary_functions_sqrt_double)->DenseRange(-1, 2);
+
+static void benchmark_elementary_functions_exp_double(benchmark::State& state) {
+  run_unary<double>(
+      state, -700.0, 700.0,
+      [](auto values, auto results, MathAccuracy accuracy) {
+        batch_exp(values, results, accuracy);
+      },
+      [](double x) { return std::exp(x); });
+}
+BENCHMARK(benchmark_elementary_functions_exp_double)->DenseRange(-1, 2);
+
+static void benchmark_elementary_functions_exp_float(benchmark::State& state) {
+  run_unary<float>(
+      state, -80.0, 80.0,
+      [](auto values, auto results, MathAccuracy accuracy) {
+        batch_exp(values, results, accuracy);
+      },
+      [](float x) { return std::exp(x); });
+}
+BENCHMARK(benchmark_elementary_functions_exp_float)->DenseRange(-1, 2);
+
+static void benchmark_elementary_functions_log_double(benchmark::State& state) {
+  run_unary<double>(
+      state, 1e-3, 1e6,
+      [](auto values, auto results, MathAccuracy accuracy) {
+        batch_log(values, results, accuracy);
+      },
+      [](double x) { return std::log(x); });
+}
+BENCHMARK(benchmark_elementary_functions_log_double)->DenseRange(-1, 2);
+
+static void benchmark_elementary_functions_log_float(benchmark::State& state) {
+  run_unary<float>(
+      state, 1e-3, 1e6,
+      [](auto values, auto results, MathAccuracy accuracy) {
+        batch_log(values, results, accuracy);
+      },
+      [](float x) { return std::log(x); });
+}
+BENCHMARK(benchmark_elementary_functions_log_float)->DenseRange(-1, 2);
+
+static void benchmark_elementary_functions_pow_double(benchmark::State& state) {
+  run_pow<double>(state);
+}
+BENCHMARK(benchmark_elementary_functions_pow_double)->DenseRange(-1, 2);
+
+static void benchmark_elementary_functions_pow_float(benchmark::State& state) {
+  run_pow<float>(state);
+}
+BENCHMARK(benchmark_elementary_functions_pow_float)->DenseRange(-1, 2);
@@ -0,0 +1,343 @@
+// First-party headers
+#include "calculator/compiled_expression.h"
+#include "calculator/compiled_program.h"
+#include "calculator/expression.h"
+#include "calculator/interval.h"
+#include "calculator/narrowed_expression.h"
+#include "calculator/tiered_expression.h"
+
+// Third-party headers
+#include <benchmark/benchmark.h>
+
+// Standard library headers
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <random>
+#include <span>
+#include <vector>
+
+namespace {
+
+// Builds (a + b) * (a - c) / (b + k) with a distinct constant per formula
+Expression make_formula(int seed) {
+  Expression expression;
+  NodeId a = expression.input(0);
+  NodeId b = expression.input(1);
+  NodeId c = expression.input(2);
+  NodeId k = expression.constant(1.0 + seed);
+  NodeId product = expression.multiply(expression.add(a, b),
+                                       expression.subtract(a, c));
+  expression.divide(product, expression.add(b, k));
+  return expression;
+}
+
+struct Columns {
+  explicit Columns(std::size_t rows)
+      : a(rows, 3.0), b(rows, 2.0), c(rows, 1.0), views{a, b, c} {}
+
+  std::vector<double> a;
+  std::vector<double> b;
+  std::vector<double> c;
+  std::vector<std::span<const double>> views;
+};
+
+// Each iteration creates 32 fresh formulas that run 4 times each, plus one
+// long-lived formula that runs over a 4096-row batch.
+void run_mixed_workload(benchmark::State& state, TierPolicy policy) {
+  constexpr int COLD_FORMULAS = 32;
+  constexpr int COLD_CALLS = 4;
+  Columns columns(4096);
+  std::vector<double> results(columns.a.size());
+  std::vector<double> row = {3.0, 2.0, 1.0};
+  TieredExpression hot(make_formula(0), policy);
+
+  for (auto _ : state) {
+    for (int formula = 0; formula < COLD_FORMULAS; ++formula) {
+      TieredExpression cold(make_formula(formula), policy);
+      for (int call = 0; call < COLD_CALLS; ++call) {
+        benchmark::DoNotOptimize(cold.evaluate(row));
+      }
+    }
+    hot.evaluate(columns.views, results);
+    benchmark::DoNotOptimize(results.data());
+  }
+}
+
+// Builds (x[i] + x[j]) * (x[k] * x[l]) - c over eight inputs, so that a
+// large corpus repeats the same sums and products many times.
+std::vector<Expression> make_formula_corpus(int formula_count) {
+  std::vector<Expression> corpus;
+  for (int formula = 0; formula < formula_count; ++formula) {
+    Expression expression;
+    NodeId sum = expression.add(expression.input(formula % 8),
+                                expression.input((formula / 8) % 8));
+    NodeId product = expression.multiply(expression.input((formula / 3) % 8),
+                                         expression.input((formula / 5) % 8));
+    expression.subtract(expression.multiply(sum, product),
+                        expression.constant(formula % 16));
+    corpus.push_back(expression);
+  }
+  return corpus;
+}
+
+// Extends the corpus with a division by (x[m] + 1), so that each formula
+// carries overflow checks and one division-by-zero check.
+std::vector<Expression> make_checked_corpus(int formula_count) {
+  std::vector<Expression> corpus = make_formula_corpus(formula_count);
+  for (std::size_t formula = 0; formula < corpus.size(); ++formula) {
+    Expression& expression = corpus[formula];
+    NodeId numerator = expression.result();
+    NodeId divisor = expression.add(expression.input(formula % 8),
+                                    expression.constant(1.0));
+    expression.divide(numerator, divisor);
+  }
+  return corpus;
+}
+
+void run_checked_corpus(benchmark::State& state,
+                        const CompileOptions& options) {
+  std::vector<Expression> corpus = make_checked_corpus(1000);
+  CompiledProgram program(corpus, options);
+  std::vector<std::vector<double>> inputs(8, std::vector<double>(1024, 1.5));
+  std::vector<std::span<const double>> columns(inputs.begin(), inputs.end());
+  std::vector<std::vector<double>> results(corpus.size(),
+                                           std::vector<double>(1024));
+  std::vector<std::span<double>> outputs(results.begin(), results.end());
+  for (auto _ : state) {
+    program.evaluate(columns, outputs);
+    benchmark::DoNotOptimize(outputs.data());
+  }
+  state.SetItemsProcessed(state.iterations() * corpus.size() * 1024);
+  state.counters["checks_kept"] = static_cast<double>(program.checks_kept());
+  state.counters["checks_removed"] =
+      static_cast<double>(program.checks_removed());
+}
+
+// Builds (a * b + c * d) - (a - c); with inputs in [-100, 100] every node
+// fits int16.
+Expression make_narrowable_formula() {
+  Expression expression;
+  NodeId a = expression.input(0);
+  NodeId b = expression.input(1);
+  NodeId c = expression.input(2);
+  NodeId d = expression.input(3);
+  NodeId products = expression.add(expression.multiply(a, b),
+                                   expression.multiply(c, d));
+  expression.subtract(products, expression.subtract(a, c));
+  return expression;
+}
+
+// Builds select(qty > 0, price / qty, 0)
+Expression make_guarded_formula() {
+  Expression expression;
+  NodeId price = expression.input(0);
+  NodeId qty = expression.input(1);
+  NodeId zero = expression.constant(0.0);
+  expression.select(expression.greater(qty, zero),
+                    expression.divide(price, qty), zero);
+  return expression;
+}
+
+// Quantities where roughly the given percentage of rows are positive, in
+// random order so that a branching loop cannot predict them.
+std::vector<double> make_guarded_quantities(std::size_t row_count,
+                                            int positive_percent) {
+  std::mt19937 generator(42);
+  std::uniform_int_distribution<int> percent(0, 99);
+  std::vector<double> quantities(row_count);
+  for (double& quantity : quantities) {
+    quantity = percent(generator) < positive_percent ? 3.0 : 0.0;
+  }
+  return quantities;
+}
+
+} // namespace
+
+static void benchmark_expression_evaluate_interpreter_4k(
+    benchmark::State& state) {
+  Expression expression = make_formula(0);
+  Columns columns(4096);
+  std::vector<double> results(columns.a.size());
+  for (auto _ : state) {
+    expression.evaluate(columns.views, results);
+    benchmark::DoNotOptimize(results.data());
+  }
+  state.SetItemsProcessed(state.iterations() * results.size());
+}
+BENCHMARK(benchmark_expression_evaluate_interpreter_4k);
+
+static void benchmark_expression_evaluate_compiled_4k(benchmark::State& state) {
+  CompiledExpression compiled(make_formula(0));
+  Columns columns(4096);
+  std::vector<double> results(columns.a.size());
+  for (auto _ : state) {
+    compiled.evaluate(columns.views, results);
+    benchmark::DoNotOptimize(results.data());
+  }
+  state.SetItemsProcessed(state.iterations() * results.size());
+}
+BENCHMARK(benchmark_expression_evaluate_compiled_4k);
+
+static void benchmark_expression_compile_formula(benchmark::State& state) {
+  Expression expression = make_formula(0);
+  for (auto _ : state) {
+    CompiledExpression compiled(expression);
+    benchmark::DoNotOptimize(compiled.step_count());
+  }
+}
+BENCHMARK(benchmark_expression_compile_formula);
+
+static void benchmark_tiered_expression_mixed_interpreter_only(
+    benchmark::State& state) {
+  TierPolicy policy;
+  policy.hot_threshold = std::numeric_limits<std::uint64_t>::max();
+  run_mixed_workload(state, policy);
+}
+BENCHMARK(benchmark_tiered_expression_mixed_interpreter_only);
+
+static void benchmark_tiered_expression_mixed_compile_eagerly(
+    benchmark::State& state) {
+  TierPolicy policy;
+  policy.hot_threshold = 0;
+  run_mixed_workload(state, policy);
+}
+BENCHMARK(benchmark_tiered_expression_mixed_compile_eagerly);
+
+static void benchmark_tiered_expression_mixed_tiered(benchmark::State& state) {
+  TierPolicy policy;
+  policy.hot_threshold = 1024;
+  run_mixed_workload(state, policy);
+}
+BENCHMARK(benchmark_tiered_expression_mixed_tiered);
+
+static void benchmark_compiled_program_corpus_independent(
+    benchmark::State& state) {
+  std::vector<Expression> corpus =
+      make_formula_corpus(static_cast<int>(state.range(0)));
+  std::vector<CompiledExpression> compiled(corpus.begin(), corpus.end());
+  std::vector<std::vector<double>> inputs(8, std::vector<double>(1024, 1.5));
+  std::vector<std::span<const double>> columns(inputs.begin(), inputs.end());
+  std::vector<double> results(1024);
+  for (auto _ : state) {
+    for (const CompiledExpression& formula : compiled) {
+      formula.evaluate(columns, results);
+      benchmark::DoNotOptimize(results.data());
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0) *
+                          results.size());
+}
+BENCHMARK(benchmark_compiled_program_corpus_independent)->Arg(100)->Arg(1000);
+
+static void benchmark_compiled_program_corpus_shared(benchmark::State& state) {
+  std::vector<Expression> corpus =
+      make_formula_corpus(static_cast<int>(state.range(0)));
+  CompiledProgram program(corpus);
+  std::vector<std::vector<double>> inputs(8, std::vector<double>(1024, 1.5));
+  std::vector<std::span<const double>> columns(inputs.begin(), inputs.end());
+  std::vector<std::vector<double>> results(corpus.size(),
+                                           std::vector<double>(1024));
+  std::vector<std::span<double>> outputs(results.begin(), results.end());
+  for (auto _ : state) {
+    program.evaluate(columns, outputs);
+    benchmark::DoNotOptimize(outputs.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0) * 1024);
+}
+BENCHMARK(benchmark_compiled_program_corpus_shared)->Arg(100)->Arg(1000);
+
+static void benchmark_compiled_program_checked_unbounded(
+    benchmark::State& state) {
+  CompileOptions options;
+  options.check_overflow = true;
+  run_checked_corpus(state, options);
+}
+BENCHMARK(benchmark_compiled_program_checked_unbounded);
+
+static void benchmark_compiled_program_checked_bounded(
+    benchmark::State& state) {
+  CompileOptions options;
+  options.check_overflow = true;
+  options.input_bounds.assign(8, Interval{0.0, 100.0});
+  run_checked_corpus(state, options);
+}
+BENCHMARK(benchmark_compiled_program_checked_bounded);
+
+static void benchmark_narrowed_expression_int16_64k(benchmark::State& state) {
+  std::vector<InputDeclaration> declarations(
+      4, InputDeclaration{ValueType::Int16, {-100.0, 100.0}});
+  NarrowedExpression narrowed(make_narrowable_formula(), declarations);
+  std::vector<std::vector<std::int16_t>> inputs(
+      4, std::vector<std::int16_t>(65536, 42));
+  std::vector<TypedColumn> columns;
+  for (const std::vector<std::int16_t>& input : inputs) {
+    columns.push_back(std::span<const std::int16_t>(input));
+  }
+  std::vector<double> results(65536);
+  for (auto _ : state) {
+    narrowed.evaluate(columns, results);
+    benchmark::DoNotOptimize(results.data());
+  }
+  state.SetItemsProcessed(state.iterations() * results.size());
+}
+BENCHMARK(benchmark_narrowed_expression_int16_64k);
+
+static void benchmark_narrowed_expression_float64_baseline_64k(
+    benchmark::State& state) {
+  CompiledExpression compiled(make_narrowable_formula());
+  std::vector<std::vector<double>> inputs(4, std::vector<double>(65536, 42.0));
+  std::vector<std::span<const double>> columns(inputs.begin(), inputs.end());
+  std::vector<double> results(65536);
+  for (auto _ : state) {
+    compiled.evaluate(columns, results);
+    benchmark::DoNotOptimize(results.data());
+  }
+  state.SetItemsProcessed(state.iterations() * results.size());
+}
+BENCHMARK(benchmark_narrowed_expression_float64_baseline_64k);
+
+static void benchmark_compiled_expression_select_branch_free(
+    benchmark::State& state) {
+  CompiledExpression compiled(make_guarded_formula());
+  std::vector<double> prices(65536, 12.0);
+  std::vector<double> quantities =
+      make_guarded_quantities(prices.size(), static_cast<int>(state.range(0)));
+  std::vector<std::span<const double>> columns = {prices, quantities};
+  std::vector<double> results(prices.size());
+  for (auto _ : state) {
+    compiled.evaluate(columns, results);
+    benchmark::DoNotOptimize(results.data());
+  }
+  state.SetItemsProcessed(state.iterations() * results.size());
+}
+BENCHMARK(benchmark_compiled_expression_select_branch_free)
+    ->Arg(0)
+    ->Arg(10)
+    ->Arg(50)
+    ->Arg(90)
+    ->Arg(100);
+
+// The same guarded divide as a plain loop with a conditional per row, the
+// branching baseline that the branch-free select is measured against.
+static void benchmark_compiled_expression_select_scalar_branch(
+    benchmark::State& state) {
+  std::vector<double> prices(65536, 12.0);
+  std::vector<double> quantities =
+      make_guarded_quantities(prices.size(), static_cast<int>(state.range(0)));
+  std::vector<double> results(prices.size());
+  for (auto _ : state) {
+    for (std::size_t row = 0; row < prices.size(); ++row) {
+      results[row] =
+          quantities[row] > 0.0 ? prices[row] / quantities[row] : 0.0;
+    }
+    benchmark::DoNotOptimize(results.data());
+  }
+  state.SetItemsProcessed(state.iterations() * results.size());
+}
+BENCHMARK(benchmark_compiled_expression_select_scalar_branch)
+    ->Arg(0)
+    ->Arg(10)
+    ->Arg(50)
+    ->Arg(90)
+    ->Arg(100);
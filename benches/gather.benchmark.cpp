@@ -0,0 +1,123 @@
+// First-party headers
+#include "calculator/calculator.h"
+#include "calculator/gather.h"
+
+// Third-party headers
+#include <benchmark/benchmark.h>
+
+// Standard library headers
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace {
+
+constexpr std::size_t INDEX_COUNT = 1 << 22;
+
+// Consecutive indices in the clustered distribution.
+constexpr std::size_t CLUSTER_SIZE = 16;
+
+enum Distribution { Sequential, Sorted, Random, Clustered };
+
+std::vector<std::uint32_t> make_indices(Distribution distribution,
+                                        std::size_t value_count) {
+  std::mt19937_64 random(1);
+  std::vector<std::uint32_t> indices(INDEX_COUNT);
+  for (std::size_t position = 0; position < INDEX_COUNT; ++position) {
+    switch (distribution) {
+    case Sequential:
+      indices[position] = static_cast<std::uint32_t>(position % value_count);
+      break;
+    case Sorted:
+    case Random:
+      indices[position] = static_cast<std::uint32_t>(random() % value_count);
+      break;
+    case Clustered:
+      indices[position] =
+          position % CLUSTER_SIZE == 0
+              ? static_cast<std::uint32_t>(random() %
+                                           (value_count - CLUSTER_SIZE))
+              : indices[position - 1] + 1;
+      break;
+    }
+  }
+  if (distribution == Sorted) {
+    std::sort(indices.begin(), indices.end());
+  }
+  return indices;
+}
+
+// Arguments are the distribution and log2 of the value count: 2^16 values
+// stay in L2, 2^25 (128 MiB) come from memory.
+void distribution_arguments(benchmark::internal::Benchmark* benchmark) {
+  for (int value_bits : {16, 25}) {
+    for (int distribution : {Sequential, Sorted, Random, Clustered}) {
+      benchmark->Args({distribution, value_bits});
+    }
+  }
+}
+
+struct Operands {
+  explicit Operands(const benchmark::State& state)
+      : values(std::size_t{1} << state.range(1), 3),
+        indices(make_indices(static_cast<Distribution>(state.range(0)),
+                             values.size())),
+        weights(INDEX_COUNT, 2), results(INDEX_COUNT) {}
+
+  std::vector<int> values;
+  std::vector<std::uint32_t> indices;
+  std::vector<int> weights;
+  std::vector<int> results;
+};
+
+} // namespace
+
+// Today's approach: index, then Calculator::multiply, one row at a time.
+static void benchmark_gather_multiply_calculator_loop(benchmark::State& state) {
+  Operands operands(state);
+  Calculator calculator;
+  for (auto _ : state) {
+    for (std::size_t position = 0; position < INDEX_COUNT; ++position) {
+      operands.results[position] =
+          calculator.multiply(operands.values[operands.indices[position]],
+                              operands.weights[position]);
+    }
+    benchmark::DoNotOptimize(operands.results.data());
+  }
+  state.SetItemsProcessed(state.iterations() * INDEX_COUNT);
+}
+BENCHMARK(benchmark_gather_multiply_calculator_loop)
+    ->Apply(distribution_arguments);
+
+static void benchmark_gather_multiply(benchmark::State& state) {
+  Operands operands(state);
+  GatherCalculator calculator;
+  for (auto _ : state) {
+    calculator.multiply(operands.values, operands.indices, operands.weights,
+                        operands.results);
+    benchmark::DoNotOptimize(operands.results.data());
+  }
+  state.SetItemsProcessed(state.iterations() * INDEX_COUNT);
+}
+BENCHMARK(benchmark_gather_multiply)->Apply(distribution_arguments);
+
+static void benchmark_gather_take(benchmark::State& state) {
+  Operands operands(state);
+  for (auto _ : state) {
+    take(operands.values, operands.indices, operands.results);
+    benchmark::DoNotOptimize(operands.results.data());
+  }
+  state.SetItemsProcessed(state.iterations() * INDEX_COUNT);
+}
+BENCHMARK(benchmark_gather_take)->Apply(distribution_arguments);
+
+static void benchmark_gather_put(benchmark::State& state) {
+  Operands operands(state);
+  for (auto _ : state) {
+    put(operands.values, operands.indices, operands.weights);
+    benchmark::DoNotOptimize(operands.values.data());
+  }
+  state.SetItemsProcessed(state.iterations() * INDEX_COUNT);
+}
+BENCHMARK(benchmark_gather_put)->Apply(distribution_arguments);
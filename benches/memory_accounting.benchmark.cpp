@@ -0,0 +1,67 @@
+// First-party headers
+#include "calculator/memory_accounting.h"
+
+// Third-party headers
+#include <benchmark/benchmark.h>
+
+// Standard library headers
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace {
+
+// Mirrors per-call evaluation scratch: three slot buffers allocated,
+// written, reduced and released on every call. The allocator is the only
+// difference between the tracked and untracked variants.
+template <template <typename> typename Allocator>
+void run_scratch_allocations(benchmark::State& state) {
+  const auto count = static_cast<std::size_t>(state.range(0));
+  for (auto _ : state) {
+    std::vector<short, Allocator<short>> narrow(count);
+    std::vector<int, Allocator<int>> wide(count);
+    std::vector<double, Allocator<double>> values(count);
+    for (std::size_t index = 0; index < count; ++index) {
+      narrow[index] = static_cast<short>(index);
+      wide[index] = narrow[index] * 3;
+      values[index] = wide[index] * 0.5;
+    }
+    double sum = 0.0;
+    for (double value : values) {
+      sum += value;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename T>
+using BuffersAllocator = TrackedAllocator<T, MemorySubsystem::Buffers>;
+
+} // namespace
+
+static void
+benchmark_memory_accounting_scratch_untracked(benchmark::State& state) {
+  run_scratch_allocations<std::allocator>(state);
+}
+BENCHMARK(benchmark_memory_accounting_scratch_untracked)
+    ->Arg(16)
+    ->Arg(256)
+    ->Arg(4096);
+
+static void
+benchmark_memory_accounting_scratch_tracked(benchmark::State& state) {
+  run_scratch_allocations<BuffersAllocator>(state);
+}
+BENCHMARK(benchmark_memory_accounting_scratch_tracked)
+    ->Arg(16)
+    ->Arg(256)
+    ->Arg(4096);
+
+// Cost of reading the counters, which walks every registered thread.
+static void benchmark_memory_accounting_snapshot(benchmark::State& state) {
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(memory_snapshot());
+  }
+}
+BENCHMARK(benchmark_memory_accounting_snapshot);
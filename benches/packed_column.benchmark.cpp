@@ -0,0 +1,176 @@
+// First-party headers
+#include "calculator/calculator.h"
+#include "calculator/packed_column.h"
+
+// Third-party headers
+#include <benchmark/benchmark.h>
+
+// Standard library headers
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <vector>
+
+namespace {
+
+constexpr std::size_t ROW_COUNT = 1 << 22;
+
+// Values spread over width bits, so frame of reference packs them at
+// exactly that width.
+std::vector<int> make_values(unsigned width) {
+  std::mt19937_64 random(width);
+  std::vector<int> values(ROW_COUNT);
+  for (int& value : values) {
+    value = static_cast<int>(static_cast<std::uint32_t>(random()) >>
+                             (32 - width)) -
+            1000;
+  }
+  return values;
+}
+
+// Sorted timestamps one to eight ticks apart.
+std::vector<int> make_timestamps() {
+  std::mt19937_64 random(1);
+  std::vector<int> values(ROW_COUNT);
+  int timestamp = 1700000000;
+  for (int& value : values) {
+    timestamp += static_cast<int>(random() % 8) + 1;
+    value = timestamp;
+  }
+  return values;
+}
+
+void width_arguments(benchmark::internal::Benchmark* benchmark) {
+  for (int width : {1, 4, 8, 12, 16, 24, 32}) {
+    benchmark->Arg(width);
+  }
+}
+
+} // namespace
+
+// Baseline without packing: Calculator over a plain int array. The
+// argument is the bit width of the values.
+static void benchmark_packed_column_multiply_unpacked(benchmark::State& state) {
+  const std::vector<int> values =
+      make_values(static_cast<unsigned>(state.range(0)));
+  std::vector<int> results(ROW_COUNT);
+  Calculator calculator;
+  for (auto _ : state) {
+    for (std::size_t row = 0; row < ROW_COUNT; ++row) {
+      results[row] = calculator.multiply(values[row], 3);
+    }
+    benchmark::DoNotOptimize(results.data());
+  }
+  state.SetItemsProcessed(state.iterations() * ROW_COUNT);
+}
+BENCHMARK(benchmark_packed_column_multiply_unpacked)->Apply(width_arguments);
+
+static void
+benchmark_packed_column_multiply_decode_then_compute(benchmark::State& state) {
+  const PackedColumn column =
+      PackedColumn::encode(make_values(static_cast<unsigned>(state.range(0))));
+  std::vector<int> decoded(ROW_COUNT);
+  std::vector<int> results(ROW_COUNT);
+  Calculator calculator;
+  for (auto _ : state) {
+    column.decode(decoded);
+    for (std::size_t row = 0; row < ROW_COUNT; ++row) {
+      results[row] = calculator.multiply(decoded[row], 3);
+    }
+    benchmark::DoNotOptimize(results.data());
+  }
+  state.SetItemsProcessed(state.iterations() * ROW_COUNT);
+}
+BENCHMARK(benchmark_packed_column_multiply_decode_then_compute)
+    ->Apply(width_arguments);
+
+static void benchmark_packed_column_multiply_fused(benchmark::State& state) {
+  const PackedColumn column =
+      PackedColumn::encode(make_values(static_cast<unsigned>(state.range(0))));
+  std::vector<int> results(ROW_COUNT);
+  PackedCalculator calculator;
+  for (auto _ : state) {
+    calculator.multiply(column, 3, results);
+    benchmark::DoNotOptimize(results.data());
+  }
+  state.SetItemsProcessed(state.iterations() * ROW_COUNT);
+}
+BENCHMARK(benchmark_packed_column_multiply_fused)->Apply(width_arguments);
+
+static void benchmark_packed_column_sum_unpacked(benchmark::State& state) {
+  const std::vector<int> values =
+      make_values(static_cast<unsigned>(state.range(0)));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        std::accumulate(values.begin(), values.end(), std::int64_t{0}));
+  }
+  state.SetItemsProcessed(state.iterations() * ROW_COUNT);
+}
+BENCHMARK(benchmark_packed_column_sum_unpacked)->Apply(width_arguments);
+
+static void
+benchmark_packed_column_sum_decode_then_compute(benchmark::State& state) {
+  const PackedColumn column =
+      PackedColumn::encode(make_values(static_cast<unsigned>(state.range(0))));
+  std::vector<int> decoded(ROW_COUNT);
+  for (auto _ : state) {
+    column.decode(decoded);
+    benchmark::DoNotOptimize(
+        std::accumulate(decoded.begin(), decoded.end(), std::int64_t{0}));
+  }
+  state.SetItemsProcessed(state.iterations() * ROW_COUNT);
+}
+BENCHMARK(benchmark_packed_column_sum_decode_then_compute)
+    ->Apply(width_arguments);
+
+static void benchmark_packed_column_sum_fused(benchmark::State& state) {
+  const PackedColumn column =
+      PackedColumn::encode(make_values(static_cast<unsigned>(state.range(0))));
+  PackedCalculator calculator;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(calculator.sum(column));
+  }
+  state.SetItemsProcessed(state.iterations() * ROW_COUNT);
+}
+BENCHMARK(benchmark_packed_column_sum_fused)->Apply(width_arguments);
+
+static void
+benchmark_packed_column_delta_sum_decode_then_compute(benchmark::State& state) {
+  const PackedColumn column =
+      PackedColumn::encode(make_timestamps(), PackedEncoding::Delta);
+  std::vector<int> decoded(ROW_COUNT);
+  for (auto _ : state) {
+    column.decode(decoded);
+    benchmark::DoNotOptimize(
+        std::accumulate(decoded.begin(), decoded.end(), std::int64_t{0}));
+  }
+  state.SetItemsProcessed(state.iterations() * ROW_COUNT);
+}
+BENCHMARK(benchmark_packed_column_delta_sum_decode_then_compute);
+
+static void benchmark_packed_column_delta_sum_fused(benchmark::State& state) {
+  const PackedColumn column =
+      PackedColumn::encode(make_timestamps(), PackedEncoding::Delta);
+  PackedCalculator calculator;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(calculator.sum(column));
+  }
+  state.SetItemsProcessed(state.iterations() * ROW_COUNT);
+}
+BENCHMARK(benchmark_packed_column_delta_sum_fused);
+
+// Arguments are the bit width and the encoding (frame of reference, delta).
+static void benchmark_packed_column_encode(benchmark::State& state) {
+  const std::vector<int> values =
+      make_values(static_cast<unsigned>(state.range(0)));
+  const auto encoding = static_cast<PackedEncoding>(state.range(1));
+  for (auto _ : state) {
+    PackedColumn column = PackedColumn::encode(values, encoding);
+    benchmark::DoNotOptimize(column.byte_size());
+  }
+  state.SetItemsProcessed(state.iterations() * ROW_COUNT);
+}
+BENCHMARK(benchmark_packed_column_encode)
+    ->Args({8, 0})
+    ->Args({24, 0})
+    ->Args({8, 1});
@@ -0,0 +1,109 @@
+// First-party headers
+#include "calculator/calculator.h"
+#include "calculator/polynomial.h"
+
+// Third-party headers
+#include <benchmark/benchmark.h>
+
+// Standard library headers
+#include <vector>
+
+namespace {
+
+constexpr std::size_t VALUE_COUNT = 4096;
+
+std::vector<double> make_xs() {
+  std::vector<double> xs(VALUE_COUNT);
+  for (std::size_t index = 0; index < xs.size(); ++index) {
+    xs[index] = -1.0 + 2.0 * static_cast<double>(index) / VALUE_COUNT;
+  }
+  return xs;
+}
+
+Polynomial make_polynomial(std::size_t degree) {
+  std::vector<double> coefficients(degree + 1);
+  for (std::size_t index = 0; index <= degree; ++index) {
+    coefficients[index] = 1.0 / static_cast<double>(index + 1);
+  }
+  return Polynomial(coefficients);
+}
+
+} // namespace
+
+// Today's approach: Horner's scheme chained through Calculator::multiply
+// and add for every value. x in {-1, 0, 1} keeps the ints from overflowing.
+static void benchmark_polynomial_calculator_chain(benchmark::State& state) {
+  const auto degree = static_cast<std::size_t>(state.range(0));
+  std::vector<int> coefficients(degree + 1, 3);
+  std::vector<int> xs(VALUE_COUNT);
+  for (std::size_t index = 0; index < xs.size(); ++index) {
+    xs[index] = static_cast<int>(index % 3) - 1;
+  }
+  std::vector<int> results(VALUE_COUNT);
+  Calculator calculator;
+  for (auto _ : state) {
+    for (std::size_t index = 0; index < xs.size(); ++index) {
+      int result = coefficients[degree];
+      for (std::size_t power = degree; power-- > 0;) {
+        result = calculator.add(calculator.multiply(result, xs[index]),
+                                coefficients[power]);
+      }
+      results[index] = result;
+    }
+    benchmark::DoNotOptimize(results.data());
+  }
+  state.SetItemsProcessed(state.iterations() * VALUE_COUNT);
+}
+BENCHMARK(benchmark_polynomial_calculator_chain)->DenseRange(2, 16, 2);
+
+static void benchmark_polynomial_batch_horner(benchmark::State& state) {
+  const Polynomial polynomial =
+      make_polynomial(static_cast<std::size_t>(state.range(0)));
+  const std::vector<double> xs = make_xs();
+  std::vector<double> results(VALUE_COUNT);
+  for (auto _ : state) {
+    polynomial.evaluate(xs, results, PolynomialScheme::Horner);
+    benchmark::DoNotOptimize(results.data());
+  }
+  state.SetItemsProcessed(state.iterations() * VALUE_COUNT);
+}
+BENCHMARK(benchmark_polynomial_batch_horner)->DenseRange(2, 16, 2);
+
+static void benchmark_polynomial_batch_estrin(benchmark::State& state) {
+  const Polynomial polynomial =
+      make_polynomial(static_cast<std::size_t>(state.range(0)));
+  const std::vector<double> xs = make_xs();
+  std::vector<double> results(VALUE_COUNT);
+  for (auto _ : state) {
+    polynomial.evaluate(xs, results, PolynomialScheme::Estrin);
+    benchmark::DoNotOptimize(results.data());
+  }
+  state.SetItemsProcessed(state.iterations() * VALUE_COUNT);
+}
+BENCHMARK(benchmark_polynomial_batch_estrin)->DenseRange(2, 16, 2);
+
+// Latency of one evaluation whose x depends on the previous result, where
+// Estrin's shorter dependency chain matters most.
+static void benchmark_polynomial_latency_horner(benchmark::State& state) {
+  constexpr std::array<double, 13> COEFFICIENTS = {
+      1, 0.5, 0.25, 0.125, 0.0625, 0.03, 0.01, 0.005, 0.002, 0.001, 5e-4,
+      2e-4, 1e-4};
+  double x = 0.5;
+  for (auto _ : state) {
+    x = horner<12>(COEFFICIENTS, x) * 0.25;
+  }
+  benchmark::DoNotOptimize(x);
+}
+BENCHMARK(benchmark_polynomial_latency_horner);
+
+static void benchmark_polynomial_latency_estrin(benchmark::State& state) {
+  constexpr std::array<double, 13> COEFFICIENTS = {
+      1, 0.5, 0.25, 0.125, 0.0625, 0.03, 0.01, 0.005, 0.002, 0.001, 5e-4,
+      2e-4, 1e-4};
+  double x = 0.5;
+  for (auto _ : state) {
+    x = estrin<12>(COEFFICIENTS, x) * 0.25;
+  }
+  benchmark::DoNotOptimize(x);
+}
+BENCHMARK(benchmark_polynomial_latency_estrin);
@@ -0,0 +1,63 @@
+// First-party headers
+#include "calculator/autotuner.h"
+#include "calculator/compiled_program.h"
+#include "calculator/expression.h"
+
+// Third-party headers
+#include <benchmark/benchmark.h>
+
+// Standard library headers
+#include <span>
+#include <vector>
+
+// Small batches make the fixed per-call cost of the probe sites as visible
+// as possible. With no tracer attached the results should match a build
+// configured with -DCALCULATOR_ENABLE_PROBES=OFF.
+
+namespace {
+
+CompiledProgram make_probed_program() {
+  Expression expression;
+  expression.add(expression.multiply(expression.input(0), expression.input(1)),
+                 expression.constant(1.0));
+  std::vector<Expression> expressions = {expression};
+  return CompiledProgram(expressions);
+}
+
+} // namespace
+
+static void benchmark_probes_compiled_program_evaluate_detached(
+    benchmark::State& state) {
+  CompiledProgram program = make_probed_program();
+  std::vector<double> a(static_cast<std::size_t>(state.range(0)), 2.0);
+  std::vector<double> b(a.size(), 3.0);
+  std::vector<std::span<const double>> columns = {a, b};
+  std::vector<double> results(a.size());
+  std::vector<std::span<double>> outputs = {results};
+  for (auto _ : state) {
+    program.evaluate(columns, outputs);
+    benchmark::DoNotOptimize(results.data());
+  }
+  state.SetItemsProcessed(state.iterations() * results.size());
+}
+BENCHMARK(benchmark_probes_compiled_program_evaluate_detached)
+    ->Arg(16)
+    ->Arg(4096);
+
+static void benchmark_probes_evaluate_parallel_detached(
+    benchmark::State& state) {
+  CompiledProgram program = make_probed_program();
+  std::vector<double> a(static_cast<std::size_t>(state.range(0)), 2.0);
+  std::vector<double> b(a.size(), 3.0);
+  std::vector<std::span<const double>> columns = {a, b};
+  std::vector<double> results(a.size());
+  std::vector<std::span<double>> outputs = {results};
+  TuningConfig config;
+  config.tile_rows = 256;
+  for (auto _ : state) {
+    evaluate_parallel(program, columns, outputs, config);
+    benchmark::DoNotOptimize(results.data());
+  }
+  state.SetItemsProcessed(state.iterations() * results.size());
+}
+BENCHMARK(benchmark_probes_evaluate_parallel_detached)->Arg(16)->Arg(4096);
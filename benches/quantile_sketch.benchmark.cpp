@@ -0,0 +1,128 @@
+// First-party headers
+#include "calculator/quantile_sketch.h"
+
+// Third-party headers
+#include <benchmark/benchmark.h>
+
+// Standard library headers
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <type_traits>
+#include <vector>
+
+namespace {
+
+// Log-normal, like request latencies.
+std::vector<double> make_values(std::size_t count) {
+  std::mt19937_64 random(5);
+  std::lognormal_distribution<double> latency(3.0, 1.0);
+  std::vector<double> values(count);
+  for (double& value : values) {
+    value = latency(random);
+  }
+  return values;
+}
+
+double exact_quantile(const std::vector<double>& sorted, double q) {
+  return sorted[static_cast<std::size_t>(q * (sorted.size() - 1))];
+}
+
+// Relative value error for DDSketch and rank error for KLL, the quantities
+// each sketch bounds.
+template <typename Sketch>
+void report_errors(benchmark::State& state, const Sketch& sketch,
+                   const std::vector<double>& sorted) {
+  for (double q : {0.5, 0.99}) {
+    const double estimate = sketch.quantile(q);
+    double error = 0.0;
+    if constexpr (std::is_same_v<Sketch, DdSketch>) {
+      const double exact = exact_quantile(sorted, q);
+      error = std::abs(estimate - exact) / exact;
+    } else {
+      const auto rank = std::lower_bound(sorted.begin(), sorted.end(),
+                                         estimate) -
+                        sorted.begin();
+      error = std::abs(static_cast<double>(rank) / sorted.size() - q);
+    }
+    state.counters[q == 0.5 ? "p50_error" : "p99_error"] = error;
+  }
+}
+
+} // namespace
+
+static void benchmark_quantile_sketch_exact_sort(benchmark::State& state) {
+  const std::vector<double> values =
+      make_values(static_cast<std::size_t>(state.range(0)));
+  std::vector<double> sorted;
+  for (auto _ : state) {
+    sorted = values;
+    std::sort(sorted.begin(), sorted.end());
+    benchmark::DoNotOptimize(exact_quantile(sorted, 0.5));
+    benchmark::DoNotOptimize(exact_quantile(sorted, 0.99));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(benchmark_quantile_sketch_exact_sort)
+    ->RangeMultiplier(16)
+    ->Range(1 << 12, 1 << 24);
+
+static void benchmark_quantile_sketch_ddsketch_batch(benchmark::State& state) {
+  const std::vector<double> values =
+      make_values(static_cast<std::size_t>(state.range(0)));
+  DdSketch sketch;
+  for (auto _ : state) {
+    sketch = DdSketch();
+    sketch.add(values);
+    benchmark::DoNotOptimize(sketch.quantile(0.5));
+    benchmark::DoNotOptimize(sketch.quantile(0.99));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  std::vector<double> sorted = values;
+  std::sort(sorted.begin(), sorted.end());
+  report_errors(state, sketch, sorted);
+}
+BENCHMARK(benchmark_quantile_sketch_ddsketch_batch)
+    ->RangeMultiplier(16)
+    ->Range(1 << 12, 1 << 24);
+
+static void benchmark_quantile_sketch_kll_batch(benchmark::State& state) {
+  const std::vector<double> values =
+      make_values(static_cast<std::size_t>(state.range(0)));
+  KllSketch sketch;
+  for (auto _ : state) {
+    sketch = KllSketch();
+    sketch.add(values);
+    benchmark::DoNotOptimize(sketch.quantile(0.5));
+    benchmark::DoNotOptimize(sketch.quantile(0.99));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  std::vector<double> sorted = values;
+  std::sort(sorted.begin(), sorted.end());
+  report_errors(state, sketch, sorted);
+}
+BENCHMARK(benchmark_quantile_sketch_kll_batch)
+    ->RangeMultiplier(16)
+    ->Range(1 << 12, 1 << 24);
+
+// Sketches from separate threads or processes combined into one.
+static void benchmark_quantile_sketch_merge(benchmark::State& state) {
+  const std::vector<double> values = make_values(1 << 16);
+  DdSketch dd_part;
+  KllSketch kll_part;
+  dd_part.add(values);
+  kll_part.add(values);
+  const auto parts = static_cast<std::size_t>(state.range(0));
+  for (auto _ : state) {
+    DdSketch dd_total;
+    KllSketch kll_total;
+    for (std::size_t part = 0; part < parts; ++part) {
+      dd_total.merge(dd_part);
+      kll_total.merge(kll_part);
+    }
+    benchmark::DoNotOptimize(dd_total.quantile(0.99));
+    benchmark::DoNotOptimize(kll_total.quantile(0.99));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(benchmark_quantile_sketch_merge)->Arg(4)->Arg(64);
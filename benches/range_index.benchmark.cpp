@@ -0,0 +1,126 @@
+// First-party headers
+#include "calculator/calculator.h"
+#include "calculator/range_index.h"
+
+// Third-party headers
+#include <benchmark/benchmark.h>
+
+// Standard library headers
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace {
+
+// Values in [-1, 1], so Calculator::add sums cannot overflow an int.
+std::vector<int> make_values(std::size_t count) {
+  std::vector<int> values(count);
+  for (std::size_t index = 0; index < count; ++index) {
+    values[index] = static_cast<int>(index % 3) - 1;
+  }
+  return values;
+}
+
+std::vector<IndexRange> make_ranges(std::size_t count, std::size_t size) {
+  std::mt19937_64 random(3);
+  std::vector<IndexRange> ranges(count);
+  for (IndexRange& range : ranges) {
+    std::size_t first = random() % (size + 1);
+    std::size_t last = random() % (size + 1);
+    range = first < last ? IndexRange{first, last} : IndexRange{last, first};
+  }
+  return ranges;
+}
+
+constexpr std::size_t RANGE_COUNT = 1024;
+
+} // namespace
+
+// Arguments run from 1M to 1B elements; the largest needs about 9 GB.
+static void benchmark_range_index_sum_naive(benchmark::State& state) {
+  const auto size = static_cast<std::size_t>(state.range(0));
+  std::vector<int> values = make_values(size);
+  std::vector<IndexRange> ranges = make_ranges(RANGE_COUNT, size);
+  Calculator calculator;
+  std::size_t query = 0;
+  for (auto _ : state) {
+    const IndexRange& range = ranges[query++ % RANGE_COUNT];
+    int sum = 0;
+    for (std::size_t index = range.first; index < range.last; ++index) {
+      sum = calculator.add(sum, values[index]);
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(benchmark_range_index_sum_naive)
+    ->RangeMultiplier(32)
+    ->Range(1 << 20, 1 << 30);
+
+static void benchmark_range_index_sum_indexed(benchmark::State& state) {
+  const auto size = static_cast<std::size_t>(state.range(0));
+  RangeIndex index(make_values(size));
+  std::vector<IndexRange> ranges = make_ranges(RANGE_COUNT, size);
+  std::size_t query = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(index.sum(ranges[query++ % RANGE_COUNT]));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(benchmark_range_index_sum_indexed)
+    ->RangeMultiplier(32)
+    ->Range(1 << 20, 1 << 30);
+
+static void benchmark_range_index_sum_batched(benchmark::State& state) {
+  const auto size = static_cast<std::size_t>(state.range(0));
+  RangeIndex index(make_values(size));
+  std::vector<IndexRange> ranges = make_ranges(RANGE_COUNT, size);
+  std::vector<std::int64_t> sums(RANGE_COUNT);
+  for (auto _ : state) {
+    index.sum(ranges, sums);
+    benchmark::DoNotOptimize(sums.data());
+  }
+  state.SetItemsProcessed(state.iterations() * RANGE_COUNT);
+}
+BENCHMARK(benchmark_range_index_sum_batched)
+    ->RangeMultiplier(32)
+    ->Range(1 << 20, 1 << 30);
+
+static void benchmark_range_index_min_batched(benchmark::State& state) {
+  const auto size = static_cast<std::size_t>(state.range(0));
+  RangeIndex index(make_values(size));
+  std::vector<IndexRange> ranges = make_ranges(RANGE_COUNT, size);
+  for (IndexRange& range : ranges) {
+    // Minimums are undefined over empty ranges.
+    if (range.first == range.last) {
+      range.first > 0 ? --range.first : ++range.last;
+    }
+  }
+  std::vector<int> minimums(RANGE_COUNT);
+  for (auto _ : state) {
+    index.min(ranges, minimums);
+    benchmark::DoNotOptimize(minimums.data());
+  }
+  state.SetItemsProcessed(state.iterations() * RANGE_COUNT);
+}
+BENCHMARK(benchmark_range_index_min_batched)
+    ->RangeMultiplier(32)
+    ->Range(1 << 20, 1 << 30);
+
+static void benchmark_range_index_update_batched(benchmark::State& state) {
+  const auto size = static_cast<std::size_t>(state.range(0));
+  RangeIndex index(make_values(size));
+  std::mt19937_64 random(5);
+  std::vector<PointUpdate> updates(RANGE_COUNT);
+  for (PointUpdate& update : updates) {
+    update.position = random() % size;
+    update.value = static_cast<int>(random() % 3) - 1;
+  }
+  for (auto _ : state) {
+    index.update(updates);
+  }
+  state.SetItemsProcessed(state.iterations() * RANGE_COUNT);
+}
+BENCHMARK(benchmark_range_index_update_batched)
+    ->RangeMultiplier(32)
+    ->Range(1 << 20, 1 << 30);
@@ -0,0 +1,151 @@
+// First-party headers
+#include "calculator/calculator.h"
+#include "calculator/run_length_column.h"
+
+// Third-party headers
+#include <benchmark/benchmark.h>
+
+// Standard library headers
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <vector>
+
+namespace {
+
+constexpr std::size_t ROW_COUNT = 1 << 22;
+
+// Rows in runs of 1 to 2 * average_run - 1 values.
+std::vector<int> make_runs(std::size_t average_run, std::uint64_t seed) {
+  std::mt19937_64 random(seed);
+  std::uniform_int_distribution<std::size_t> length_of(1,
+                                                       2 * average_run - 1);
+  std::uniform_int_distribution<int> value_of(1, 1000);
+  std::vector<int> values;
+  values.reserve(ROW_COUNT);
+  while (values.size() < ROW_COUNT) {
+    const std::size_t length =
+        std::min(length_of(random), ROW_COUNT - values.size());
+    values.insert(values.end(), length, value_of(random));
+  }
+  return values;
+}
+
+void run_length_arguments(benchmark::internal::Benchmark* benchmark) {
+  for (int average_run : {1, 2, 4, 16, 64, 1024}) {
+    benchmark->Arg(average_run);
+  }
+}
+
+} // namespace
+
+// Dense execution: Calculator once per row over plain arrays. The argument
+// is the average run length of the inputs.
+static void benchmark_run_length_column_add_dense(benchmark::State& state) {
+  const auto average_run = static_cast<std::size_t>(state.range(0));
+  const std::vector<int> first = make_runs(average_run, 1);
+  const std::vector<int> second = make_runs(average_run, 2);
+  std::vector<int> results(ROW_COUNT);
+  Calculator calculator;
+  for (auto _ : state) {
+    for (std::size_t row = 0; row < ROW_COUNT; ++row) {
+      results[row] = calculator.add(first[row], second[row]);
+    }
+    benchmark::DoNotOptimize(results.data());
+  }
+  state.SetItemsProcessed(state.iterations() * ROW_COUNT);
+}
+BENCHMARK(benchmark_run_length_column_add_dense)->Apply(run_length_arguments);
+
+static void benchmark_run_length_column_add_runs(benchmark::State& state) {
+  const auto average_run = static_cast<std::size_t>(state.range(0));
+  const auto first = RunLengthColumn<int>::encode(make_runs(average_run, 1));
+  const auto second = RunLengthColumn<int>::encode(make_runs(average_run, 2));
+  RunLengthCalculator calculator;
+  for (auto _ : state) {
+    RunLengthColumn<int> results = calculator.add(first, second);
+    benchmark::DoNotOptimize(results.values().data());
+  }
+  state.SetItemsProcessed(state.iterations() * ROW_COUNT);
+}
+BENCHMARK(benchmark_run_length_column_add_runs)->Apply(run_length_arguments);
+
+// Run-length inputs with a dense consumer: the merged runs are expanded.
+static void
+benchmark_run_length_column_add_runs_then_decode(benchmark::State& state) {
+  const auto average_run = static_cast<std::size_t>(state.range(0));
+  const auto first = RunLengthColumn<int>::encode(make_runs(average_run, 1));
+  const auto second = RunLengthColumn<int>::encode(make_runs(average_run, 2));
+  std::vector<int> results(ROW_COUNT);
+  RunLengthCalculator calculator;
+  for (auto _ : state) {
+    calculator.add(first, second).decode(results);
+    benchmark::DoNotOptimize(results.data());
+  }
+  state.SetItemsProcessed(state.iterations() * ROW_COUNT);
+}
+BENCHMARK(benchmark_run_length_column_add_runs_then_decode)
+    ->Apply(run_length_arguments);
+
+static void benchmark_run_length_column_divide_dense(benchmark::State& state) {
+  const std::vector<int> values =
+      make_runs(static_cast<std::size_t>(state.range(0)), 1);
+  std::vector<double> results(ROW_COUNT);
+  Calculator calculator;
+  for (auto _ : state) {
+    for (std::size_t row = 0; row < ROW_COUNT; ++row) {
+      results[row] = calculator.divide(values[row], 7);
+    }
+    benchmark::DoNotOptimize(results.data());
+  }
+  state.SetItemsProcessed(state.iterations() * ROW_COUNT);
+}
+BENCHMARK(benchmark_run_length_column_divide_dense)
+    ->Apply(run_length_arguments);
+
+static void benchmark_run_length_column_divide_runs(benchmark::State& state) {
+  const auto column = RunLengthColumn<int>::encode(
+      make_runs(static_cast<std::size_t>(state.range(0)), 1));
+  RunLengthCalculator calculator;
+  for (auto _ : state) {
+    RunLengthColumn<double> results = calculator.divide(column, 7);
+    benchmark::DoNotOptimize(results.values().data());
+  }
+  state.SetItemsProcessed(state.iterations() * ROW_COUNT);
+}
+BENCHMARK(benchmark_run_length_column_divide_runs)
+    ->Apply(run_length_arguments);
+
+static void benchmark_run_length_column_sum_dense(benchmark::State& state) {
+  const std::vector<int> values =
+      make_runs(static_cast<std::size_t>(state.range(0)), 1);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        std::accumulate(values.begin(), values.end(), std::int64_t{0}));
+  }
+  state.SetItemsProcessed(state.iterations() * ROW_COUNT);
+}
+BENCHMARK(benchmark_run_length_column_sum_dense)->Apply(run_length_arguments);
+
+static void benchmark_run_length_column_sum_runs(benchmark::State& state) {
+  const auto column = RunLengthColumn<int>::encode(
+      make_runs(static_cast<std::size_t>(state.range(0)), 1));
+  RunLengthCalculator calculator;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(calculator.sum(column));
+  }
+  state.SetItemsProcessed(state.iterations() * ROW_COUNT);
+}
+BENCHMARK(benchmark_run_length_column_sum_runs)->Apply(run_length_arguments);
+
+static void benchmark_run_length_column_encode(benchmark::State& state) {
+  const std::vector<int> values =
+      make_runs(static_cast<std::size_t>(state.range(0)), 1);
+  for (auto _ : state) {
+    RunLengthColumn<int> column = RunLengthColumn<int>::encode(values);
+    benchmark::DoNotOptimize(column.values().data());
+  }
+  state.SetItemsProcessed(state.iterations() * ROW_COUNT);
+}
+BENCHMARK(benchmark_run_length_column_encode)->Apply(run_length_arguments);
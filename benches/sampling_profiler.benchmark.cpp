@@ -0,0 +1,58 @@
+// First-party headers
+#include "calculator/compiled_program.h"
+#include "calculator/expression.h"
+#include "calculator/sampling_profiler.h"
+
+// Third-party headers
+#include <benchmark/benchmark.h>
+
+// Standard library headers
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+// The argument is the sampling frequency in Hz; zero runs without the
+// profiler, as the baseline for the 100 Hz and 1 kHz overhead.
+static void benchmark_sampling_profiler_compiled_program_64k(
+    benchmark::State& state) {
+  Expression expression;
+  NodeId a = expression.input(0);
+  NodeId b = expression.input(1);
+  expression.divide(expression.multiply(a, b),
+                    expression.add(a, expression.constant(1.0)));
+  std::vector<Expression> expressions = {expression};
+  CompiledProgram program(expressions);
+  std::vector<double> first(65536, 2.0);
+  std::vector<double> second(first.size(), 3.0);
+  std::vector<std::span<const double>> columns = {first, second};
+  std::vector<double> results(first.size());
+  std::vector<std::span<double>> outputs = {results};
+
+  std::unique_ptr<SamplingProfiler> profiler;
+  if (state.range(0) > 0) {
+    ProfilerOptions options;
+    options.frequency_hz = static_cast<unsigned>(state.range(0));
+    profiler = std::make_unique<SamplingProfiler>(options);
+    try {
+      profiler->start();
+    } catch (const std::runtime_error& error) {
+      state.SkipWithError(error.what());
+      return;
+    }
+  }
+
+  for (auto _ : state) {
+    program.evaluate(columns, outputs);
+    benchmark::DoNotOptimize(results.data());
+  }
+  state.SetItemsProcessed(state.iterations() * results.size());
+  if (profiler) {
+    profiler->stop();
+    state.counters["samples"] = static_cast<double>(profiler->sample_count());
+  }
+}
+BENCHMARK(benchmark_sampling_profiler_compiled_program_64k)
+    ->Arg(0)
+    ->Arg(100)
+    ->Arg(1000);
@@ -0,0 +1,48 @@
+// First-party headers
+#include "calculator/spilling_aggregator.h"
+
+// Third-party headers
+#include <benchmark/benchmark.h>
+
+// Standard library headers
+#include <cstdint>
+#include <random>
+#include <vector>
+
+// The argument is the number of groups as a percentage of the slots that
+// fit in the memory budget: 50 stays in memory, while 100 and 400 overflow
+// it and spill. Every key appears four times.
+static void
+benchmark_spilling_aggregator_group_sum_budget_ratio(benchmark::State& state) {
+  constexpr std::size_t MEMORY_BUDGET = std::size_t{8} << 20;
+  const std::size_t group_count = MEMORY_BUDGET /
+                                  SpillingAggregator::SLOT_BYTES *
+                                  static_cast<std::size_t>(state.range(0)) /
+                                  100;
+  std::vector<std::int64_t> keys(4 * group_count);
+  std::vector<int> values(keys.size(), 1);
+  std::mt19937_64 random(7);
+  for (std::size_t row = 0; row < keys.size(); ++row) {
+    keys[row] = static_cast<std::int64_t>(random() % group_count);
+  }
+  AggregationOptions options;
+  options.memory_budget = MEMORY_BUDGET;
+
+  std::uint64_t spilled_bytes = 0;
+  for (auto _ : state) {
+    SpillingAggregator aggregator(options);
+    aggregator.add(keys, values);
+    std::int64_t total = 0;
+    aggregator.finish([&](std::int64_t, int sum) { total += sum; });
+    benchmark::DoNotOptimize(total);
+    spilled_bytes = aggregator.spilled_bytes();
+  }
+  state.SetItemsProcessed(state.iterations() * keys.size());
+  state.counters["spilled_MiB"] =
+      static_cast<double>(spilled_bytes) / (1 << 20);
+}
+BENCHMARK(benchmark_spilling_aggregator_group_sum_budget_ratio)
+    ->Arg(50)
+    ->Arg(100)
+    ->Arg(400)
+    ->Unit(benchmark::kMillisecond);
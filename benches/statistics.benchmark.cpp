@@ -0,0 +1,81 @@
+// First-party headers
+#include "calculator/calculator.h"
+#include "calculator/statistics.h"
+
+// Third-party headers
+#include <benchmark/benchmark.h>
+
+// Standard library headers
+#include <random>
+#include <vector>
+
+namespace {
+
+// Values in [0, 1000), so Calculator::add sums of up to 2M values fit an int.
+std::vector<int> make_values(std::size_t count) {
+  std::mt19937 random(13);
+  std::vector<int> values(count);
+  for (int& value : values) {
+    value = static_cast<int>(random() % 1000);
+  }
+  return values;
+}
+
+} // namespace
+
+// Mean and variance the way callers compute them by hand today: a first
+// pass summing with Calculator::add, then a second pass of squared
+// deviations.
+static void benchmark_statistics_variance_two_pass(benchmark::State& state) {
+  const std::vector<int> values =
+      make_values(static_cast<std::size_t>(state.range(0)));
+  Calculator calculator;
+  for (auto _ : state) {
+    int sum = 0;
+    for (int value : values) {
+      sum = calculator.add(sum, value);
+    }
+    const double mean = calculator.divide(sum, static_cast<int>(values.size()));
+    double squares = 0.0;
+    for (int value : values) {
+      squares += (value - mean) * (value - mean);
+    }
+    benchmark::DoNotOptimize(squares / static_cast<double>(values.size() - 1));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(benchmark_statistics_variance_two_pass)
+    ->RangeMultiplier(16)
+    ->Range(1 << 12, 1 << 20);
+
+static void benchmark_statistics_variance_running(benchmark::State& state) {
+  const std::vector<int> values =
+      make_values(static_cast<std::size_t>(state.range(0)));
+  for (auto _ : state) {
+    RunningStatistics statistics;
+    statistics.add(values);
+    benchmark::DoNotOptimize(statistics.mean());
+    benchmark::DoNotOptimize(statistics.variance());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(benchmark_statistics_variance_running)
+    ->RangeMultiplier(16)
+    ->Range(1 << 12, 1 << 20);
+
+// Pairs of doubles through the covariance kernel.
+static void benchmark_statistics_correlation(benchmark::State& state) {
+  const auto size = static_cast<std::size_t>(state.range(0));
+  const std::vector<int> ints = make_values(2 * size);
+  const std::vector<double> xs(ints.begin(), ints.begin() + size);
+  const std::vector<double> ys(ints.begin() + size, ints.end());
+  for (auto _ : state) {
+    RunningCovariance covariance;
+    covariance.add(xs, ys);
+    benchmark::DoNotOptimize(covariance.correlation());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(benchmark_statistics_correlation)
+    ->RangeMultiplier(16)
+    ->Range(1 << 12, 1 << 20);
@@ -0,0 +1,104 @@
+// First-party headers
+#include "calculator/calculator.h"
+#include "calculator/summed_area_table.h"
+
+// Third-party headers
+#include <benchmark/benchmark.h>
+
+// Standard library headers
+#include <cstdint>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace {
+
+std::vector<int> make_grid(std::size_t side) {
+  std::vector<int> values(side * side);
+  for (std::size_t cell = 0; cell < values.size(); ++cell) {
+    values[cell] = static_cast<int>(cell % 255);
+  }
+  return values;
+}
+
+std::vector<GridRectangle> make_rectangles(std::size_t count,
+                                           std::size_t side) {
+  std::mt19937_64 random(9);
+  std::vector<GridRectangle> rectangles(count);
+  for (GridRectangle& rectangle : rectangles) {
+    std::size_t rows[] = {random() % (side + 1), random() % (side + 1)};
+    std::size_t columns[] = {random() % (side + 1), random() % (side + 1)};
+    rectangle = {std::min(rows[0], rows[1]), std::min(columns[0], columns[1]),
+                 std::max(rows[0], rows[1]), std::max(columns[0], columns[1])};
+  }
+  return rectangles;
+}
+
+constexpr std::size_t RECTANGLE_COUNT = 4096;
+
+} // namespace
+
+// Arguments are the grid side and the thread count (zero for all hardware
+// threads). A 16k x 16k grid takes 1 GiB and its table 2 GiB.
+static void benchmark_summed_area_table_build_grid(benchmark::State& state) {
+  const auto side = static_cast<std::size_t>(state.range(0));
+  const unsigned threads =
+      state.range(1) == 0 ? std::max(1u, std::thread::hardware_concurrency())
+                          : static_cast<unsigned>(state.range(1));
+  std::vector<int> values = make_grid(side);
+  for (auto _ : state) {
+    SummedAreaTable table(values, side, side, threads);
+    benchmark::DoNotOptimize(table.sum({0, 0, side, side}));
+  }
+  state.SetItemsProcessed(state.iterations() * values.size());
+}
+BENCHMARK(benchmark_summed_area_table_build_grid)
+    ->Args({4096, 1})
+    ->Args({4096, 0})
+    ->Args({16384, 1})
+    ->Args({16384, 0})
+    ->Unit(benchmark::kMillisecond);
+
+static void benchmark_summed_area_table_query_batched(benchmark::State& state) {
+  const auto side = static_cast<std::size_t>(state.range(0));
+  SummedAreaTable table(make_grid(side), side, side);
+  std::vector<GridRectangle> rectangles =
+      make_rectangles(RECTANGLE_COUNT, side);
+  std::vector<std::int64_t> sums(RECTANGLE_COUNT);
+  for (auto _ : state) {
+    table.sum(rectangles, sums);
+    benchmark::DoNotOptimize(sums.data());
+  }
+  state.SetItemsProcessed(state.iterations() * RECTANGLE_COUNT);
+}
+BENCHMARK(benchmark_summed_area_table_query_batched)->Arg(4096)->Arg(16384);
+
+// Baseline: nested Calculator::add loops over each rectangle.
+static void benchmark_summed_area_table_query_naive(benchmark::State& state) {
+  const auto side = static_cast<std::size_t>(state.range(0));
+  std::vector<int> values = make_grid(side);
+  std::vector<GridRectangle> rectangles =
+      make_rectangles(RECTANGLE_COUNT, side);
+  Calculator calculator;
+  std::size_t query = 0;
+  for (auto _ : state) {
+    const GridRectangle& rectangle = rectangles[query++ % RECTANGLE_COUNT];
+    std::int64_t sum = 0;
+    for (std::size_t row = rectangle.first_row; row < rectangle.last_row;
+         ++row) {
+      // Per-row sums stay within int: at most 16k cells below 255.
+      int row_sum = 0;
+      for (std::size_t column = rectangle.first_column;
+           column < rectangle.last_column; ++column) {
+        row_sum = calculator.add(row_sum, values[row * side + column]);
+      }
+      sum += row_sum;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(benchmark_summed_area_table_query_naive)
+    ->Arg(4096)
+    ->Arg(16384)
+    ->Unit(benchmark::kMillisecond);
@@ -0,0 +1,69 @@
+#pragma once
+
+// First-party headers
+#include "calculator/compiled_program.h"
+#include "calculator/memory_accounting.h"
+
+// Standard library headers
+#include <cstddef>
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <span>
+#include <utility>
+
+struct TuningConfig {
+  // Rows a worker claims at a time.
+  std::size_t tile_rows = 16384;
+  // Threads evaluating tiles, including the calling thread.
+  unsigned thread_count = 1;
+};
+
+// Evaluates every row of a program, splitting the rows into tiles that
+// thread_count workers claim in order. The first exception thrown by any
+// tile is rethrown once all workers have stopped.
+void evaluate_parallel(const CompiledProgram& program,
+                       std::span<const std::span<const double>> columns,
+                       std::span<const std::span<double>> outputs,
+                       const TuningConfig& config);
+
+// Chooses a TuningConfig per batch size. The first time a size class (rows
+// rounded up to a power of two) is requested, candidate tile sizes and
+// thread counts are timed on a probe program and the fastest one is kept.
+// Winners are written to a per-host profile that later instances load, so
+// each host pays for tuning once.
+class Autotuner {
+public:
+  // Loads the profile if it exists and was written on a host with the same
+  // number of hardware threads; otherwise starts empty.
+  explicit Autotuner(std::filesystem::path profile_path);
+
+  // Returns the tuned configuration, tuning and saving it on first use.
+  // Tuning runs without holding the tuner's lock, so callers asking for
+  // size classes that are already tuned never wait on it.
+  TuningConfig config_for(std::size_t row_count);
+
+  // Size classes tuned so far, from the profile or by this instance.
+  std::size_t tuned_size_classes() const;
+  const std::filesystem::path& profile_path() const;
+
+private:
+  using Profile =
+      std::map<std::size_t, TuningConfig, std::less<std::size_t>,
+               TrackedAllocator<std::pair<const std::size_t, TuningConfig>,
+                                MemorySubsystem::Caches>>;
+
+  void load();
+  void save() const;
+
+  std::filesystem::path m_profile_path;
+  mutable std::mutex m_mutex;
+  Profile m_profile;
+};
+
+// Profile location for this host inside the user's cache directory.
+std::filesystem::path default_tuning_profile_path();
+
+// Process-wide tuner backed by default_tuning_profile_path().
+Autotuner& host_autotuner();
@@ -0,0 +1,53 @@
+#pragma once
+
+// Standard library headers
+#include <compare>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Arbitrary-precision signed integer for results that outgrow int: a sign
+// and a little-endian magnitude of 32-bit limbs without leading zeros, so
+// zero has no limbs and is never negative. Multiplication switches from
+// the schoolbook method to Karatsuba's above a few dozen limbs.
+//
+// Decimal conversion is divide and conquer in both directions: the digits
+// are split in halves, each half converted recursively and the two joined
+// with one multiplication by a precomputed power of the source base,
+// squared from the one below it. Parsing joins base-10^9 halves with powers
+// of 10^9 in binary; printing joins binary halves with powers of 2^32 in
+// base 10^9, which needs no division. With Karatsuba multiplication both
+// take O(n^1.59) rather than the O(n^2) of repeated division by ten.
+class BigInteger {
+public:
+  BigInteger() = default;
+  explicit BigInteger(std::int64_t value);
+
+  // An optional '-' followed by decimal digits; anything else throws
+  // std::invalid_argument.
+  static BigInteger from_string(std::string_view text);
+  std::string to_string() const;
+
+  bool is_zero() const;
+  bool is_negative() const;
+
+  BigInteger operator-() const;
+  friend BigInteger operator+(const BigInteger& first,
+                              const BigInteger& second);
+  friend BigInteger operator-(const BigInteger& first,
+                              const BigInteger& second);
+  friend BigInteger operator*(const BigInteger& first,
+                              const BigInteger& second);
+
+  friend bool operator==(const BigInteger& first,
+                         const BigInteger& second) = default;
+  friend std::strong_ordering operator<=>(const BigInteger& first,
+                                          const BigInteger& second);
+
+private:
+  BigInteger(bool negative, std::vector<std::uint32_t> magnitude);
+
+  bool m_negative = false;
+  std::vector<std::uint32_t> m_magnitude;
+};
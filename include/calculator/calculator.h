@@ -1,9 +1,27 @@
 #pragma once
 
+// Standard library headers
+#include <span>
+
 class Calculator {
 public:
   int add(int first_value, int second_value);
   int subtract(int first_value, int second_value);
   int multiply(int first_value, int second_value);
   double divide(int first_value, int second_value);
-};
\ No newline at end of file
+
+  // Greatest common divisor and least common multiple of the magnitudes,
+  // by binary GCD. gcd(0, 0) and lcm(x, 0) are 0. Results that int cannot
+  // hold (gcd of INT_MIN with itself or zero, an LCM above INT_MAX) throw
+  // std::overflow_error.
+  int gcd(int first_value, int second_value);
+  int lcm(int first_value, int second_value);
+
+  // Element-wise over spans; results may alias the inputs. Mismatched
+  // spans throw std::invalid_argument, and a result overflowing int throws
+  // std::overflow_error once the batch is done.
+  void gcd(std::span<const int> first_values,
+           std::span<const int> second_values, std::span<int> results);
+  void lcm(std::span<const int> first_values,
+           std::span<const int> second_values, std::span<int> results);
+};
@@ -0,0 +1,223 @@
+#pragma once
+
+// First-party headers
+#include "calculator/calculator.h"
+
+// Standard library headers
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+// The operations of an engine behind BasicCalculator, with Calculator's
+// signatures; Calculator itself is the reference engine.
+template <typename Backend>
+concept CalculatorBackend =
+    requires(Backend& backend, int first_value, int second_value) {
+      { backend.add(first_value, second_value) } -> std::same_as<int>;
+      { backend.subtract(first_value, second_value) } -> std::same_as<int>;
+      { backend.multiply(first_value, second_value) } -> std::same_as<int>;
+      { backend.divide(first_value, second_value) } -> std::same_as<double>;
+    };
+
+// Calculator over an engine chosen at compile time. Calls go straight to
+// Backend without a virtual call, and are inlined when the engine is
+// defined in a header, so the batch overloads vectorize over engines such
+// as WrappingBackend. Engines chosen at run time go through AnyCalculator.
+//
+// The batch overloads compute results[i] = first_values[i] op
+// second_values[i], and results may alias the inputs. Operand spans of
+// different lengths or a shorter result span throw std::invalid_argument,
+// as does divide at the first zero divisor, after the quotients before it.
+template <CalculatorBackend Backend> class BasicCalculator {
+public:
+  BasicCalculator() = default;
+  explicit BasicCalculator(Backend backend) : m_backend(std::move(backend)) {}
+
+  int add(int first_value, int second_value) {
+    return m_backend.add(first_value, second_value);
+  }
+  int subtract(int first_value, int second_value) {
+    return m_backend.subtract(first_value, second_value);
+  }
+  int multiply(int first_value, int second_value) {
+    return m_backend.multiply(first_value, second_value);
+  }
+  double divide(int first_value, int second_value) {
+    return m_backend.divide(first_value, second_value);
+  }
+
+  void add(std::span<const int> first_values,
+           std::span<const int> second_values, std::span<int> results) {
+    apply(first_values, second_values, results, [this](int first, int second) {
+      return m_backend.add(first, second);
+    });
+  }
+  void subtract(std::span<const int> first_values,
+                std::span<const int> second_values, std::span<int> results) {
+    apply(first_values, second_values, results, [this](int first, int second) {
+      return m_backend.subtract(first, second);
+    });
+  }
+  void multiply(std::span<const int> first_values,
+                std::span<const int> second_values, std::span<int> results) {
+    apply(first_values, second_values, results, [this](int first, int second) {
+      return m_backend.multiply(first, second);
+    });
+  }
+  void divide(std::span<const int> first_values,
+              std::span<const int> second_values, std::span<double> results) {
+    apply(first_values, second_values, results, [this](int first, int second) {
+      return m_backend.divide(first, second);
+    });
+  }
+
+  Backend& backend() { return m_backend; }
+  const Backend& backend() const { return m_backend; }
+
+private:
+  template <typename Result, typename Operation>
+  static void apply(std::span<const int> first_values,
+                    std::span<const int> second_values,
+                    std::span<Result> results, const Operation& operation) {
+    if (first_values.size() != second_values.size()) {
+      throw std::invalid_argument("Operand counts do not match");
+    }
+    if (results.size() < first_values.size()) {
+      throw std::invalid_argument("Missing result values");
+    }
+    const int* first = first_values.data();
+    const int* second = second_values.data();
+    Result* output = results.data();
+    for (std::size_t index = 0; index < first_values.size(); ++index) {
+      output[index] = operation(first[index], second[index]);
+    }
+  }
+
+  Backend m_backend;
+};
+
+// Arithmetic defined inline, so that it is inlined into BasicCalculator's
+// loops. add, subtract and multiply compute in unsigned 32-bit arithmetic,
+// so an overflowing result wraps modulo 2^32 and is always defined. divide
+// returns the double quotient, and a zero divisor throws
+// std::invalid_argument.
+class WrappingBackend {
+public:
+  int add(int first_value, int second_value) {
+    return static_cast<int>(static_cast<std::uint32_t>(first_value) +
+                            static_cast<std::uint32_t>(second_value));
+  }
+  int subtract(int first_value, int second_value) {
+    return static_cast<int>(static_cast<std::uint32_t>(first_value) -
+                            static_cast<std::uint32_t>(second_value));
+  }
+  int multiply(int first_value, int second_value) {
+    return static_cast<int>(static_cast<std::uint32_t>(first_value) *
+                            static_cast<std::uint32_t>(second_value));
+  }
+  double divide(int first_value, int second_value) {
+    if (second_value == 0) {
+      throw std::invalid_argument("Division by zero");
+    }
+    return static_cast<double>(first_value) / second_value;
+  }
+};
+
+// Instrumented engine: counts the operations it passes on to Inner.
+template <CalculatorBackend Inner = Calculator> class CountingBackend {
+public:
+  CountingBackend() = default;
+  explicit CountingBackend(Inner inner) : m_inner(std::move(inner)) {}
+
+  int add(int first_value, int second_value) {
+    ++m_operation_count;
+    return m_inner.add(first_value, second_value);
+  }
+  int subtract(int first_value, int second_value) {
+    ++m_operation_count;
+    return m_inner.subtract(first_value, second_value);
+  }
+  int multiply(int first_value, int second_value) {
+    ++m_operation_count;
+    return m_inner.multiply(first_value, second_value);
+  }
+  double divide(int first_value, int second_value) {
+    ++m_operation_count;
+    return m_inner.divide(first_value, second_value);
+  }
+
+  std::size_t operation_count() const { return m_operation_count; }
+
+private:
+  Inner m_inner;
+  std::size_t m_operation_count = 0;
+};
+
+// Engine interface for choosing at run time, and for mocks.
+class ICalculator {
+public:
+  virtual ~ICalculator() = default;
+  virtual int add(int first_value, int second_value) = 0;
+  virtual int subtract(int first_value, int second_value) = 0;
+  virtual int multiply(int first_value, int second_value) = 0;
+  virtual double divide(int first_value, int second_value) = 0;
+};
+
+// Type-erased engine: any backend, or any ICalculator implementation,
+// behind one type, at the cost of a virtual call per operation. Only code
+// that picks its engine at run time should use it, as
+// BasicCalculator<AnyCalculator>. A null interface throws
+// std::invalid_argument.
+class AnyCalculator {
+public:
+  // Runs Calculator.
+  AnyCalculator();
+  explicit AnyCalculator(std::unique_ptr<ICalculator> engine);
+  template <CalculatorBackend Backend>
+    requires(!std::is_same_v<Backend, AnyCalculator>)
+  explicit AnyCalculator(Backend backend)
+      : m_engine(std::make_unique<Adapter<Backend>>(std::move(backend))) {}
+
+  int add(int first_value, int second_value) {
+    return m_engine->add(first_value, second_value);
+  }
+  int subtract(int first_value, int second_value) {
+    return m_engine->subtract(first_value, second_value);
+  }
+  int multiply(int first_value, int second_value) {
+    return m_engine->multiply(first_value, second_value);
+  }
+  double divide(int first_value, int second_value) {
+    return m_engine->divide(first_value, second_value);
+  }
+
+private:
+  template <CalculatorBackend Backend>
+  class Adapter final : public ICalculator {
+  public:
+    explicit Adapter(Backend backend) : m_backend(std::move(backend)) {}
+
+    int add(int first_value, int second_value) override {
+      return m_backend.add(first_value, second_value);
+    }
+    int subtract(int first_value, int second_value) override {
+      return m_backend.subtract(first_value, second_value);
+    }
+    int multiply(int first_value, int second_value) override {
+      return m_backend.multiply(first_value, second_value);
+    }
+    double divide(int first_value, int second_value) override {
+      return m_backend.divide(first_value, second_value);
+    }
+
+  private:
+    Backend m_backend;
+  };
+
+  std::unique_ptr<ICalculator> m_engine;
+};
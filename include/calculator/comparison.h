@@ -0,0 +1,101 @@
+#pragma once
+
+// Standard library headers
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// One bit per element, packed 64 to a word: element i is bit i % 64 of word
+// i / 64. Bits past size() in the last word are always clear, so words can
+// be counted and compared whole.
+class Bitmask {
+public:
+  Bitmask() = default;
+  explicit Bitmask(std::size_t size, bool value = false);
+
+  std::size_t size() const;
+  // Positions past size() throw std::out_of_range.
+  bool test(std::size_t position) const;
+  void set(std::size_t position, bool value = true);
+  // Number of set bits.
+  std::size_t count() const;
+
+  // Keeps the leading bits; bits added by growing are clear.
+  void resize(std::size_t size);
+
+  // Element-wise logic; a mask of another size throws std::invalid_argument.
+  Bitmask& operator&=(const Bitmask& other);
+  Bitmask& operator|=(const Bitmask& other);
+  void flip();
+
+  std::span<const std::uint64_t> words() const;
+  // Writers must leave the bits past size() clear.
+  std::span<std::uint64_t> words();
+
+  bool operator==(const Bitmask& other) const = default;
+
+private:
+  std::size_t m_size = 0;
+  std::vector<std::uint64_t> m_words;
+};
+
+enum class Comparison {
+  Equal,
+  NotEqual,
+  Less,
+  LessEqual,
+  Greater,
+  GreaterEqual
+};
+
+// Comparisons, clamping and selection over int and double spans, as loops
+// of branch-free lane masks that the compiler vectorizes, so their speed
+// does not depend on how predictable the data is.
+//
+// batch_compare sets bit i of results to first_values[i] op second_values[i]
+// (or values[i] op operand), resizing results to the number of values; a
+// NaN compares false except by NotEqual. batch_select writes if_set[i]
+// where bit i of mask is set and if_clear[i] elsewhere.
+//
+// min, max and clamp pick like std::min, std::max and std::clamp, so a NaN
+// first value is kept; int abs and negate compute in unsigned arithmetic
+// and wrap modulo 2^32, so abs and negate of INT_MIN give INT_MIN. Results
+// may alias the inputs. Operand spans or masks of different lengths, a
+// result span shorter than the inputs, and clamp bounds with low > high (or
+// NaN) throw std::invalid_argument.
+void batch_compare(std::span<const int> first_values,
+                   std::span<const int> second_values, Comparison comparison,
+                   Bitmask& results);
+void batch_compare(std::span<const int> values, int operand,
+                   Comparison comparison, Bitmask& results);
+void batch_compare(std::span<const double> first_values,
+                   std::span<const double> second_values,
+                   Comparison comparison, Bitmask& results);
+void batch_compare(std::span<const double> values, double operand,
+                   Comparison comparison, Bitmask& results);
+
+void batch_min(std::span<const int> first_values,
+               std::span<const int> second_values, std::span<int> results);
+void batch_min(std::span<const double> first_values,
+               std::span<const double> second_values,
+               std::span<double> results);
+void batch_max(std::span<const int> first_values,
+               std::span<const int> second_values, std::span<int> results);
+void batch_max(std::span<const double> first_values,
+               std::span<const double> second_values,
+               std::span<double> results);
+void batch_clamp(std::span<const int> values, int low, int high,
+                 std::span<int> results);
+void batch_clamp(std::span<const double> values, double low, double high,
+                 std::span<double> results);
+void batch_abs(std::span<const int> values, std::span<int> results);
+void batch_abs(std::span<const double> values, std::span<double> results);
+void batch_negate(std::span<const int> values, std::span<int> results);
+void batch_negate(std::span<const double> values, std::span<double> results);
+
+void batch_select(const Bitmask& mask, std::span<const int> if_set,
+                  std::span<const int> if_clear, std::span<int> results);
+void batch_select(const Bitmask& mask, std::span<const double> if_set,
+                  std::span<const double> if_clear,
+                  std::span<double> results);
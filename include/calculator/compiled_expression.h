@@ -0,0 +1,32 @@
+#pragma once
+
+// First-party headers
+#include "calculator/compiled_program.h"
+#include "calculator/expression.h"
+
+// Standard library headers
+#include <cstddef>
+#include <span>
+
+// Optimized form of an Expression. Construction folds constants, merges
+// common subexpressions and drops dead nodes; batch evaluation then runs
+// each operation over blocks of rows in tight, auto-vectorizable loops.
+class CompiledExpression {
+public:
+  static constexpr std::size_t BLOCK_SIZE = CompiledProgram::BLOCK_SIZE;
+
+  explicit CompiledExpression(const Expression& expression,
+                              const CompileOptions& options = {});
+
+  double evaluate(std::span<const double> inputs) const;
+  void evaluate(std::span<const std::span<const double>> columns,
+                std::span<double> results) const;
+
+  // Number of arithmetic steps left after optimization.
+  std::size_t step_count() const;
+  std::size_t checks_kept() const;
+  std::size_t checks_removed() const;
+
+private:
+  CompiledProgram m_program;
+};
@@ -0,0 +1,134 @@
+#pragma once
+
+// First-party headers
+#include "calculator/expression.h"
+#include "calculator/interval.h"
+#include "calculator/memory_accounting.h"
+
+// Standard library headers
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+struct CompileOptions {
+  // Checks add, subtract and multiply results against INT_RANGE and throws
+  // std::overflow_error when one leaves it, as Calculator's int would.
+  bool check_overflow = false;
+  // Declared range of each input, by index. Missing entries are unbounded.
+  // Range analysis uses them to drop overflow and division-by-zero checks
+  // that can never fire. Each block is first checked against the ranges,
+  // and a block with any value outside them (or NaN) runs with every check,
+  // so results never depend on the declared ranges.
+  std::vector<Interval> input_bounds;
+};
+
+// Several expressions lowered into one shared program. The formulas are
+// merged into a single DAG where constants are folded and identical
+// subexpressions are computed once, then every output is produced in one
+// pass over the input rows. Temporaries are recycled once their last reader
+// has run, so blocks stay cache-resident even for large formula sets.
+//
+// Selects are evaluated branch-free: both branches are computed for every
+// row and blended through the condition mask. Division by zero poisons only
+// its own lanes, and the poison is dropped by a Select that does not pick
+// it, so it only throws when it reaches an output.
+class CompiledProgram {
+public:
+  static constexpr std::size_t BLOCK_SIZE = 256;
+
+  explicit CompiledProgram(std::span<const Expression> expressions,
+                           const CompileOptions& options = {});
+
+  // Evaluates one row; outputs[i] receives the result of expressions[i].
+  void evaluate(std::span<const double> inputs,
+                std::span<double> outputs) const;
+
+  // Evaluates every row; all output columns must have the same length.
+  void evaluate(std::span<const std::span<const double>> columns,
+                std::span<const std::span<double>> outputs) const;
+
+  // Number of input columns the program reads.
+  int input_count() const;
+  std::size_t output_count() const;
+  // Number of arithmetic steps left after merging and optimization.
+  std::size_t step_count() const;
+  // Number of temporary slots needed after slot recycling.
+  std::size_t slot_count() const;
+  // Overflow and division-by-zero checks kept, and those proven redundant
+  // by range analysis, for rows within the declared input ranges.
+  std::size_t checks_kept() const;
+  std::size_t checks_removed() const;
+
+private:
+  enum class OperandKind { None, Input, Constant, Temporary };
+
+  struct Operand {
+    OperandKind kind = OperandKind::None;
+    int index = 0;
+    // Set for temporaries whose lanes may carry division-by-zero poison.
+    bool poisoned = false;
+  };
+
+  struct Step {
+    Opcode opcode;
+    Operand first;
+    Operand second;
+    Operand third;
+    bool checked;
+    bool poisoned;
+    int destination;
+  };
+
+  // Output written as soon as the step producing it has run.
+  struct Emit {
+    std::size_t step;
+    int output;
+  };
+
+  // Steps and slots of one lowering of the expressions.
+  struct Plan {
+    TrackedVector<Step, MemorySubsystem::Programs> steps;
+    TrackedVector<Emit, MemorySubsystem::Programs> emits;
+    TrackedVector<Operand, MemorySubsystem::Programs> outputs;
+    std::size_t slot_count = 0;
+    std::size_t checks_kept = 0;
+    std::size_t checks_removed = 0;
+  };
+
+  // Evaluation scratch, reused per thread across calls.
+  using SlotBuffer = TrackedVector<double, MemorySubsystem::Buffers>;
+  using PoisonBuffer = TrackedVector<std::uint64_t, MemorySubsystem::Buffers>;
+
+  void lower(std::span<const Expression> expressions,
+             const CompileOptions& options, Plan& plan);
+  void allocate_slots(std::vector<Step> steps, const CompileOptions& options,
+                      Plan& plan);
+
+  // The plan for rows within the declared input ranges, or the fully
+  // checked one.
+  const Plan& plan_for(std::span<const double> inputs) const;
+  const Plan& plan_for(std::span<const std::span<const double>> columns,
+                       std::size_t offset, std::size_t count) const;
+
+  double load(const Operand& operand, std::span<const double> inputs,
+              const SlotBuffer& slots) const;
+  const std::uint64_t* poison_pointer(const Operand& operand,
+                                      const PoisonBuffer& poison) const;
+  const double* block_pointer(const Operand& operand,
+                              std::span<const std::span<const double>> columns,
+                              std::size_t offset,
+                              const SlotBuffer& slots) const;
+
+  // Lowered with the declared input ranges, and, only when some range is
+  // declared, again without them for the blocks that leave them.
+  Plan m_plan;
+  Plan m_checked_plan;
+  // Declared ranges of the inputs the program reads; empty when every input
+  // is unbounded.
+  TrackedVector<Interval, MemorySubsystem::Programs> m_input_bounds;
+  TrackedVector<double, MemorySubsystem::Programs> m_constants;
+  TrackedVector<double, MemorySubsystem::Programs> m_broadcast_constants;
+  TrackedVector<std::uint64_t, MemorySubsystem::Programs> m_clean_lanes;
+  int m_input_count = 0;
+};
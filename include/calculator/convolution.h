@@ -0,0 +1,61 @@
+#pragma once
+
+// Standard library headers
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+enum class ConvolutionMethod {
+  // Direct while the shorter operand has at most 128 taps for float, 64 for
+  // double and 40 for int, FFT beyond; the crossovers the convolution
+  // benchmarks measure.
+  Automatic,
+  // Multiply-adds over blocks of outputs: O(signal * kernel), exact for int.
+  Direct,
+  // Overlap-save over power-of-two FFTs in double: O(signal * log kernel).
+  Fft
+};
+
+// Full 1D convolution and cross-correlation: results hold signal.size() +
+// kernel.size() - 1 values, with the signal zero outside its range.
+//
+//   convolve:  results[i] = sum_j signal[i - j] * kernel[j]
+//   correlate: results[i] = sum_j signal[i + j + 1 - m] * kernel[j]
+//
+// for a kernel of m taps.
+//
+// The output is split into contiguous ranges across thread_count threads.
+// int inputs accumulate exactly into 64-bit results; they take the FFT path
+// only while every output is small enough (below 2^36 in magnitude) for the
+// double transform to round back exactly, and the direct path otherwise.
+// Inputs large enough for a sum to pass 2^62 are summed in 128 bits, and an
+// output that does not fit in 64 bits throws std::overflow_error.
+//
+// Results must not overlap the inputs. An empty signal or kernel, a result
+// span shorter than the output, or a zero thread count throw
+// std::invalid_argument.
+void convolve(std::span<const float> signal, std::span<const float> kernel,
+              std::span<float> results,
+              ConvolutionMethod method = ConvolutionMethod::Automatic,
+              unsigned thread_count = 1);
+void convolve(std::span<const double> signal, std::span<const double> kernel,
+              std::span<double> results,
+              ConvolutionMethod method = ConvolutionMethod::Automatic,
+              unsigned thread_count = 1);
+void convolve(std::span<const int> signal, std::span<const int> kernel,
+              std::span<std::int64_t> results,
+              ConvolutionMethod method = ConvolutionMethod::Automatic,
+              unsigned thread_count = 1);
+
+void correlate(std::span<const float> signal, std::span<const float> kernel,
+               std::span<float> results,
+               ConvolutionMethod method = ConvolutionMethod::Automatic,
+               unsigned thread_count = 1);
+void correlate(std::span<const double> signal, std::span<const double> kernel,
+               std::span<double> results,
+               ConvolutionMethod method = ConvolutionMethod::Automatic,
+               unsigned thread_count = 1);
+void correlate(std::span<const int> signal, std::span<const int> kernel,
+               std::span<std::int64_t> results,
+               ConvolutionMethod method = ConvolutionMethod::Automatic,
+               unsigned thread_count = 1);
@@ -0,0 +1,78 @@
+#pragma once
+
+// First-party headers
+#include "calculator/calculator.h"
+
+// Standard library headers
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// Column of int values stored as its distinct values (the dictionary, in
+// ascending order) and a 16-bit code per row indexing into it. Every
+// dictionary value occurs in at least one row.
+//
+// Encoding finds the distinct values and then looks up each row's code.
+// Columns whose values span a narrow range (up to 2^18 apart) use a table
+// indexed by value for both steps, a plain indexed load per row that
+// vectorizes into gathers where the target has them. Wider columns go
+// through an open-addressing hash table.
+class DictionaryColumn {
+public:
+  // Codes are 16 bits wide, so a column holds at most this many distinct
+  // values.
+  static constexpr std::size_t MAX_DISTINCT_VALUES = 65536;
+
+  DictionaryColumn() = default;
+
+  // Throws std::invalid_argument when values has more than
+  // MAX_DISTINCT_VALUES distinct values.
+  static DictionaryColumn encode(std::span<const int> values);
+
+  std::size_t size() const;
+  std::span<const int> dictionary() const;
+  std::span<const std::uint16_t> codes() const;
+
+  // Writes the value of every row; throws std::invalid_argument when
+  // results holds fewer than size() values.
+  void decode(std::span<int> results) const;
+
+private:
+  std::vector<int> m_dictionary;
+  std::vector<std::uint16_t> m_codes;
+};
+
+// Calculator operations over dictionary-encoded columns. An operation with
+// a constant runs once per distinct value, and one between two columns
+// once per pair of values that occurs together in some row, into a small
+// table that every row then reads through its codes. Pairs fall back to
+// computing per row when there are more of them than rows or the table
+// would outgrow the L2 cache.
+//
+// As every dictionary value and every tabulated pair occurs in some row,
+// operations see exactly the operands that per-row evaluation would, and
+// divide throws exactly when it would on a row. Columns of different sizes
+// or too few results throw std::invalid_argument.
+class DictionaryCalculator {
+public:
+  void add(const DictionaryColumn& column, int value, std::span<int> results);
+  void subtract(const DictionaryColumn& column, int value,
+                std::span<int> results);
+  void multiply(const DictionaryColumn& column, int value,
+                std::span<int> results);
+  void divide(const DictionaryColumn& column, int value,
+              std::span<double> results);
+
+  void add(const DictionaryColumn& first, const DictionaryColumn& second,
+           std::span<int> results);
+  void subtract(const DictionaryColumn& first, const DictionaryColumn& second,
+                std::span<int> results);
+  void multiply(const DictionaryColumn& first, const DictionaryColumn& second,
+                std::span<int> results);
+  void divide(const DictionaryColumn& first, const DictionaryColumn& second,
+              std::span<double> results);
+
+private:
+  Calculator m_calculator;
+};
@@ -0,0 +1,51 @@
+#pragma once
+
+// Standard library headers
+#include <cstdint>
+#include <span>
+
+// Accuracy tiers of the batch elementary functions, as the largest error
+// against the correctly rounded result.
+enum class MathAccuracy {
+  // Within 1 ULP. Double pow defers to std::pow and does not vectorize.
+  Precise,
+  // Within 4 ULP, with shorter polynomials. Double pow is computed as
+  // exp(y * log(x)) and is only within about 1 + |y * log(x)| ULP.
+  Relaxed,
+  // Relative error below 1e-5, for formulas that only need a few digits;
+  // for pow, below 1e-5 times max(1, |y * log(x)|).
+  Fast
+};
+
+// Elementary functions over float and double spans, in loops of branch-free
+// range reduction, polynomial and bit manipulation that the compiler
+// vectorizes, unlike per-element libm calls. Special values follow libm:
+// log of a negative value and sqrt of one are NaN, log(0) is -inf, exp
+// overflows to inf and underflows through the subnormals to zero.
+//
+// Results may alias the inputs. A result span shorter than the inputs, or
+// pow exponents not matching the bases, throw std::invalid_argument.
+void batch_sqrt(std::span<const double> values, std::span<double> results,
+                MathAccuracy accuracy = MathAccuracy::Precise);
+void batch_sqrt(std::span<const float> values, std::span<float> results,
+                MathAccuracy accuracy = MathAccuracy::Precise);
+void batch_exp(std::span<const double> values, std::span<double> results,
+               MathAccuracy accuracy = MathAccuracy::Precise);
+void batch_exp(std::span<const float> values, std::span<float> results,
+               MathAccuracy accuracy = MathAccuracy::Precise);
+void batch_log(std::span<const double> values, std::span<double> results,
+               MathAccuracy accuracy = MathAccuracy::Precise);
+void batch_log(std::span<const float> values, std::span<float> results,
+               MathAccuracy accuracy = MathAccuracy::Precise);
+void batch_pow(std::span<const double> bases, std::span<const double> exponents,
+               std::span<double> results,
+               MathAccuracy accuracy = MathAccuracy::Precise);
+void batch_pow(std::span<const float> bases, std::span<const float> exponents,
+               std::span<float> results,
+               MathAccuracy accuracy = MathAccuracy::Precise);
+
+// Number of representable values between two results, for measuring the
+// tiers; zero for equal values (including +0 and -0) and the maximum for a
+// NaN against anything else.
+std::uint64_t ulp_distance(double first_value, double second_value);
+std::uint64_t ulp_distance(float first_value, float second_value);
@@ -0,0 +1,101 @@
+#pragma once
+
+// Standard library headers
+#include <cstddef>
+#include <span>
+#include <vector>
+
+// Operations an expression node can perform. The arithmetic opcodes mirror
+// the Calculator operations and share its division-by-zero behaviour.
+// Comparisons yield 1.0 or 0.0, and Select picks its second or third operand
+// depending on whether the first is non-zero.
+enum class Opcode {
+  Input,
+  Constant,
+  Add,
+  Subtract,
+  Multiply,
+  Divide,
+  Less,
+  LessEqual,
+  Greater,
+  GreaterEqual,
+  Equal,
+  NotEqual,
+  Select
+};
+
+// Index of a node inside an Expression, returned by the builder methods.
+using NodeId = int;
+
+// A single node of an expression program. Operands always refer to nodes
+// appended earlier, so the instruction list is in evaluation order.
+struct Instruction {
+  Opcode opcode;
+  int first_operand;  // Input index for Input, node id otherwise
+  int second_operand; // Node id for binary opcodes and Select
+  int third_operand;  // Node id for Select, unused otherwise
+  double constant;    // Value for Constant, unused otherwise
+};
+
+// Applies an arithmetic or comparison opcode to two values with Calculator
+// semantics. Throws std::invalid_argument on division by zero.
+double apply_operation(Opcode opcode, double first_value, double second_value);
+
+bool is_comparison(Opcode opcode);
+
+// Checks that every input column holds at least row_count values.
+// Throws std::invalid_argument when a column is missing or too short.
+void validate_columns(std::span<const std::span<const double>> columns,
+                      int input_count, std::size_t row_count);
+
+// Formula built from Calculator operations over numbered inputs. Values are
+// carried as double so integer operands stay exact while divide keeps the
+// floating-point quotient returned by Calculator::divide. The last node
+// appended is the result of the expression.
+//
+// A division by zero only throws when its quotient reaches the result, so
+// select(qty > 0, price / qty, 0) is safe for rows where qty is zero.
+class Expression {
+public:
+  NodeId input(int index);
+  NodeId constant(double value);
+  NodeId add(NodeId first_node, NodeId second_node);
+  NodeId subtract(NodeId first_node, NodeId second_node);
+  NodeId multiply(NodeId first_node, NodeId second_node);
+  NodeId divide(NodeId first_node, NodeId second_node);
+  NodeId less(NodeId first_node, NodeId second_node);
+  NodeId less_equal(NodeId first_node, NodeId second_node);
+  NodeId greater(NodeId first_node, NodeId second_node);
+  NodeId greater_equal(NodeId first_node, NodeId second_node);
+  NodeId equal(NodeId first_node, NodeId second_node);
+  NodeId not_equal(NodeId first_node, NodeId second_node);
+  NodeId select(NodeId condition_node, NodeId true_node, NodeId false_node);
+
+  // Interprets the program for a single row of input values. With
+  // check_overflow, an add, subtract or multiply that the result depends on
+  // throws std::overflow_error when it leaves Calculator's int range, on the
+  // same nodes as CompiledProgram under CompileOptions::check_overflow.
+  double evaluate(std::span<const double> inputs,
+                  bool check_overflow = false) const;
+
+  // Interprets the program row by row over input columns.
+  void evaluate(std::span<const std::span<const double>> columns,
+                std::span<double> results, bool check_overflow = false) const;
+
+  const std::vector<Instruction>& instructions() const;
+  int input_count() const;
+  NodeId result() const;
+
+private:
+  NodeId append(Instruction instruction);
+  NodeId append_binary(Opcode opcode, NodeId first_node, NodeId second_node);
+  void validate_node(NodeId node) const;
+  // Nodes whose overflow is checked, by node id.
+  std::vector<bool> overflow_checked_nodes() const;
+  double evaluate_row(std::span<const double> inputs,
+                      const std::vector<bool>& checked) const;
+
+  std::vector<Instruction> m_instructions;
+  int m_input_count = 0;
+};
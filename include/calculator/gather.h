@@ -0,0 +1,46 @@
+#pragma once
+
+// Standard library headers
+#include <cstdint>
+#include <span>
+
+// Batch indexed access: take gathers results[i] = values[indices[i]] and
+// put scatters values[indices[i]] = sources[i], with later entries winning
+// for repeated indices.
+//
+// Indices are processed in chunks of 2048. Each chunk is checked first,
+// in a pass that also notices whether it strictly ascends. Such chunks are
+// left to the hardware prefetcher, and any stretch of 64 consecutive
+// indices in them is processed as a contiguous range. In the other chunks, once values
+// outgrows the L2 cache, each access is preceded by a software prefetch of
+// the access 64 indices ahead.
+//
+// An index past the end of values throws std::out_of_range after the
+// chunks before it are done, and spans of mismatched lengths throw
+// std::invalid_argument. Results and sources must not overlap values.
+void take(std::span<const int> values, std::span<const std::uint32_t> indices,
+          std::span<int> results);
+void put(std::span<int> values, std::span<const std::uint32_t> indices,
+         std::span<const int> sources);
+
+// Gather fused with a Calculator operation on a second, sequential operand:
+// results[i] = values[indices[i]] op operands[i], such as a weighted lookup
+// values[indices[i]] * weights[i]. add, subtract and multiply compute in
+// unsigned 32-bit arithmetic, so an overflowing result wraps modulo 2^32;
+// divide throws std::invalid_argument before writing any result when an
+// operand is zero.
+class GatherCalculator {
+public:
+  void add(std::span<const int> values,
+           std::span<const std::uint32_t> indices,
+           std::span<const int> operands, std::span<int> results);
+  void subtract(std::span<const int> values,
+                std::span<const std::uint32_t> indices,
+                std::span<const int> operands, std::span<int> results);
+  void multiply(std::span<const int> values,
+                std::span<const std::uint32_t> indices,
+                std::span<const int> operands, std::span<int> results);
+  void divide(std::span<const int> values,
+              std::span<const std::uint32_t> indices,
+              std::span<const int> operands, std::span<double> results);
+};
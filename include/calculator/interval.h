@@ -0,0 +1,35 @@
+#pragma once
+
+// First-party headers
+#include "calculator/expression.h"
+
+// Standard library headers
+#include <limits>
+
+// Closed range [lower, upper] of values a node can take. Infinite bounds
+// mean the side is unknown.
+struct Interval {
+  double lower = -std::numeric_limits<double>::infinity();
+  double upper = std::numeric_limits<double>::infinity();
+
+  static Interval point(double value);
+
+  bool contains(double value) const;
+  bool is_within(const Interval& other) const;
+};
+
+// Range of Calculator's int results; add, subtract and multiply overflow
+// when they leave it.
+inline constexpr Interval INT_RANGE{
+    static_cast<double>(std::numeric_limits<int>::min()),
+    static_cast<double>(std::numeric_limits<int>::max())};
+
+// Interval arithmetic mirroring apply_operation. A divisor range that
+// contains zero yields an unbounded result; comparisons yield [0, 1].
+Interval apply_interval(Opcode opcode, const Interval& first,
+                        const Interval& second);
+
+// Range of a Select: one branch when the condition range decides it, the
+// hull of both branches otherwise.
+Interval select_interval(const Interval& condition, const Interval& if_true,
+                         const Interval& if_false);
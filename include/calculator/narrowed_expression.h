@@ -0,0 +1,69 @@
+#pragma once
+
+// First-party headers
+#include "calculator/expression.h"
+#include "calculator/interval.h"
+#include "calculator/memory_accounting.h"
+
+// Standard library headers
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <variant>
+#include <vector>
+
+// Element types an input column or an intermediate can be stored as,
+// ordered from narrowest to widest.
+enum class ValueType { Int16, Int32, Float32, Float64 };
+
+// Input column in its declared storage type. The alternative index matches
+// the ValueType enumerator order.
+using TypedColumn =
+    std::variant<std::span<const std::int16_t>, std::span<const std::int32_t>,
+                 std::span<const float>, std::span<const double>>;
+
+struct InputDeclaration {
+  ValueType type = ValueType::Float64;
+  // Declared bounds, intersected with the range of the storage type.
+  Interval range;
+};
+
+// Expression evaluated with the narrowest exact element type per node.
+// Integer-valued nodes whose range fits int16 or int32 are computed in that
+// type, so more values fit in a SIMD register; operands are only widened
+// where an operation's operands or result need a wider type, and anything
+// non-integral is computed in double so results match the double tiers.
+// Integer nodes compute in wrapping unsigned arithmetic, so inputs outside
+// their declared ranges give unspecified results but never undefined
+// behaviour.
+class NarrowedExpression {
+public:
+  static constexpr std::size_t BLOCK_SIZE = 512;
+
+  NarrowedExpression(const Expression& expression,
+                     std::span<const InputDeclaration> declarations);
+
+  // Evaluates every row; columns must match the declared storage types.
+  void evaluate(std::span<const TypedColumn> columns,
+                std::span<double> results) const;
+
+  // Storage type chosen for each expression node.
+  const std::vector<ValueType>& node_types() const;
+
+private:
+  struct Node {
+    Opcode opcode;
+    int first_operand;
+    int second_operand;
+    int slot;
+    bool checked;
+    double constant;
+  };
+
+  TrackedVector<Node, MemorySubsystem::Programs> m_nodes;
+  std::vector<ValueType> m_types;
+  TrackedVector<ValueType, MemorySubsystem::Programs> m_input_types;
+  std::size_t m_int16_slots = 0;
+  std::size_t m_int32_slots = 0;
+  std::size_t m_float64_slots = 0;
+};
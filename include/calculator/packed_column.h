@@ -0,0 +1,112 @@
+#pragma once
+
+// Standard library headers
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+enum class PackedEncoding {
+  // Each block stores its values minus the block minimum.
+  FrameOfReference,
+  // Each block stores the differences from the value four rows earlier
+  // (from the first value for the first four rows), minus their minimum:
+  // small for sorted or slowly changing columns, such as timestamps, and
+  // decoded with one running sum per lane.
+  Delta
+};
+
+// Column of int values bit-packed in blocks of BLOCK_SIZE rows, each with
+// its own reference value and bit width (0 to 32 bits). Values are spread
+// over four interleaved lanes, row i in lane i % 4, so a block unpacks with
+// the same shifts in every lane: one vector operation per four values with
+// SSE2 and a kernel per bit width in which every shift is a constant.
+class PackedColumn {
+public:
+  static constexpr std::size_t BLOCK_SIZE = 128;
+
+  PackedColumn() = default;
+
+  static PackedColumn
+  encode(std::span<const int> values,
+         PackedEncoding encoding = PackedEncoding::FrameOfReference);
+
+  std::size_t size() const;
+  PackedEncoding encoding() const;
+  // Bytes of packed values and block headers.
+  std::size_t byte_size() const;
+
+  // Writes the value of every row; throws std::invalid_argument when
+  // results holds fewer than size() values.
+  void decode(std::span<int> results) const;
+
+private:
+  friend class PackedCalculator;
+
+  static constexpr std::size_t LANES = 4;
+  using Lanes = std::array<std::uint32_t, LANES>;
+
+  struct Block {
+    std::int32_t reference;
+    std::uint32_t width;
+    std::size_t offset; // First word of the block in m_words
+  };
+
+  // Calls consume(row, value) for every row in order, one decoded block at
+  // a time.
+  template <typename Consume> void scan(const Consume& consume) const;
+  // Unpacks BLOCK_SIZE values, even for a partial last block; previous
+  // carries the last value of each lane from block to block.
+  void decode_block(std::size_t block, Lanes& previous, int* values) const;
+  // Lane values before the first row, which delta encoding starts from.
+  Lanes initial_lanes() const;
+
+  PackedEncoding m_encoding = PackedEncoding::FrameOfReference;
+  std::size_t m_size = 0;
+  std::int32_t m_base = 0;
+  std::vector<Block> m_blocks;
+  std::vector<std::uint32_t> m_words;
+};
+
+// Calculator operations and sums over packed columns, fused with the
+// unpacking: each block is unpacked into a BLOCK_SIZE buffer that stays in
+// L1 and consumed from there, so no decoded copy of the column goes
+// through memory. add, subtract and multiply compute in unsigned 32-bit
+// arithmetic, so an overflowing result wraps modulo 2^32 instead of being
+// undefined, and divide matches Calculator::divide.
+//
+// Division by zero, columns of different sizes and too few results throw
+// std::invalid_argument.
+class PackedCalculator {
+public:
+  void add(const PackedColumn& column, int value, std::span<int> results);
+  void subtract(const PackedColumn& column, int value,
+                std::span<int> results);
+  void multiply(const PackedColumn& column, int value,
+                std::span<int> results);
+  void divide(const PackedColumn& column, int value,
+              std::span<double> results);
+
+  void add(const PackedColumn& first, const PackedColumn& second,
+           std::span<int> results);
+  void subtract(const PackedColumn& first, const PackedColumn& second,
+                std::span<int> results);
+  void multiply(const PackedColumn& first, const PackedColumn& second,
+                std::span<int> results);
+  void divide(const PackedColumn& first, const PackedColumn& second,
+              std::span<double> results);
+
+  std::int64_t sum(const PackedColumn& column);
+
+private:
+  // Writes value * scale + offset in wrapping arithmetic, which covers
+  // add, subtract and multiply by a constant.
+  static void affine(const PackedColumn& column, std::uint32_t scale,
+                     std::uint32_t offset, std::span<int> results);
+  template <typename Result, typename Operation>
+  static void apply_to_pairs(const PackedColumn& first,
+                             const PackedColumn& second,
+                             std::span<Result> results,
+                             const Operation& operation);
+};
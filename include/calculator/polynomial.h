@@ -0,0 +1,92 @@
+#pragma once
+
+// Standard library headers
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <span>
+#include <utility>
+#include <vector>
+
+// Fixed-degree evaluation for callers whose coefficients are known at
+// compile time, in float or double. coefficients[i] multiplies x^i.
+//
+// The multiply-adds are written as a * x + b rather than std::fma: the
+// compiler contracts them into FMA instructions where the target has them,
+// whereas std::fma without hardware support is a slow library call.
+
+// Horner's scheme: Degree dependent multiply-adds, the fewest operations
+// and the lowest latency when only one value is evaluated.
+// The steps are expanded at compile time, so the chain is straight-line
+// code that vectorizes across calls in a loop.
+template <std::size_t Degree, typename T>
+constexpr T horner(const std::array<T, Degree + 1>& coefficients, T x) {
+  T result = coefficients[Degree];
+  [&]<std::size_t... Step>(std::index_sequence<Step...>) {
+    ((result = result * x + coefficients[Degree - 1 - Step]), ...);
+  }(std::make_index_sequence<Degree>());
+  return result;
+}
+
+namespace polynomial_detail {
+
+// Evaluates coefficients [First, First + Count) as a polynomial in x;
+// powers[k] holds x^(2^k).
+template <std::size_t First, std::size_t Count, typename T, std::size_t Size>
+constexpr T estrin(const std::array<T, Size>& coefficients, const T* powers) {
+  if constexpr (Count == 1) {
+    return coefficients[First];
+  } else {
+    constexpr std::size_t HALF = std::bit_floor(Count - 1);
+    return estrin<First, HALF>(coefficients, powers) +
+           powers[std::countr_zero(HALF)] *
+               estrin<First + HALF, Count - HALF>(coefficients, powers);
+  }
+}
+
+} // namespace polynomial_detail
+
+// Estrin's scheme: the coefficients are paired into independent
+// multiply-adds combined by a tree over x^2, x^4, ..., so the dependency
+// chain is about 2 log2(Degree) long instead of Degree.
+template <std::size_t Degree, typename T>
+constexpr T estrin(const std::array<T, Degree + 1>& coefficients, T x) {
+  if constexpr (Degree == 0) {
+    return coefficients[0];
+  } else {
+    constexpr int LEVELS = std::countr_zero(std::bit_floor(Degree)) + 1;
+    std::array<T, LEVELS> powers{x};
+    for (int level = 1; level < LEVELS; ++level) {
+      powers[level] = powers[level - 1] * powers[level - 1];
+    }
+    return polynomial_detail::estrin<0, Degree + 1>(coefficients,
+                                                    powers.data());
+  }
+}
+
+enum class PolynomialScheme { Horner, Estrin };
+
+// Polynomial with coefficients chosen at run time, evaluated over batches
+// of x values. Degrees up to MAX_SPECIALIZED_DEGREE dispatch to the
+// fixed-degree kernels above, with the coefficients held in registers;
+// higher degrees run Horner's scheme over blocks of x values.
+//
+// An empty coefficient list or a result span shorter than the inputs
+// throws std::invalid_argument.
+class Polynomial {
+public:
+  static constexpr std::size_t MAX_SPECIALIZED_DEGREE = 16;
+
+  // coefficients[i] multiplies x^i.
+  explicit Polynomial(std::vector<double> coefficients);
+
+  std::size_t degree() const;
+  const std::vector<double>& coefficients() const;
+
+  double evaluate(double x) const;
+  void evaluate(std::span<const double> xs, std::span<double> results,
+                PolynomialScheme scheme = PolynomialScheme::Estrin) const;
+
+private:
+  std::vector<double> m_coefficients;
+};
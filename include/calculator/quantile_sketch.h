@@ -0,0 +1,109 @@
+#pragma once
+
+// Standard library headers
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <span>
+#include <vector>
+
+// Streaming quantile estimates in bounded memory, as an alternative to
+// sorting whole result arrays. Both sketches take values one at a time or
+// in batches, merge with sketches built elsewhere (other threads, or other
+// processes through serialize and deserialize), and answer any quantile.
+// Quantiles of an empty sketch and non-finite inputs throw
+// std::invalid_argument, as does deserializing input that serialize could
+// not have written. Serializing and deserializing leave the stream's
+// formatting flags as they were.
+
+// DDSketch: every estimate is within relative_accuracy of the exact
+// quantile's value. Values are counted in logarithmic buckets, so merging
+// is exact and the result does not depend on insertion order. When more
+// than max_buckets are in use, the buckets nearest zero are collapsed and
+// only the quantiles that fall into them lose their guarantee.
+class DdSketch {
+public:
+  explicit DdSketch(double relative_accuracy = 0.01,
+                    std::size_t max_buckets = 2048);
+
+  void add(double value);
+  void add(std::span<const double> values);
+  // Both sketches must use the same relative accuracy.
+  void merge(const DdSketch& other);
+
+  // q in [0, 1]; 0 and 1 give the exact minimum and maximum.
+  double quantile(double q) const;
+  std::uint64_t count() const;
+  double relative_accuracy() const;
+
+  void serialize(std::ostream& output) const;
+  static DdSketch deserialize(std::istream& input);
+
+private:
+  // Counts of consecutive bucket indices starting at offset.
+  struct Store {
+    std::vector<std::uint64_t> counts;
+    int offset = 0;
+
+    void add(int index, std::uint64_t count);
+    void collapse_lowest(std::size_t max_buckets);
+    std::uint64_t total() const;
+  };
+
+  int index_of(double magnitude) const;
+  double value_of(int index) const;
+
+  double m_relative_accuracy;
+  double m_gamma;
+  double m_log_gamma;
+  std::size_t m_max_buckets;
+  Store m_positive;
+  Store m_negative;
+  std::uint64_t m_zero_count = 0;
+  double m_min;
+  double m_max;
+};
+
+// KLL sketch: the rank of every estimate is within about 2.5 / k of the
+// requested one with high probability, whatever the value distribution.
+// Values are kept in compactors of doubling weight that randomly keep half
+// of their sorted items when full. Compaction is lazy: nothing is sorted
+// until the sketch as a whole is full, so batches of inserts are plain
+// appends. The seed makes compaction reproducible.
+class KllSketch {
+public:
+  explicit KllSketch(std::size_t k = 200, std::uint64_t seed = 1);
+
+  void add(double value);
+  void add(std::span<const double> values);
+  // Both sketches must use the same k.
+  void merge(const KllSketch& other);
+
+  // q in [0, 1]; 0 and 1 give the exact minimum and maximum.
+  double quantile(double q) const;
+  std::uint64_t count() const;
+  // Values currently retained, which stays O(k log(count / k)).
+  std::size_t retained() const;
+
+  void serialize(std::ostream& output) const;
+  static KllSketch deserialize(std::istream& input);
+
+private:
+  std::size_t capacity(std::size_t level) const;
+  void update_capacity();
+  // Compacts the lowest full levels until the sketch is under capacity.
+  void compress();
+  void compact(std::size_t level);
+  bool random_bit();
+
+  std::size_t m_k;
+  std::uint64_t m_state;
+  std::uint64_t m_count = 0;
+  // m_levels[h] holds items of weight 2^h.
+  std::vector<std::vector<double>> m_levels;
+  std::size_t m_retained = 0;
+  std::size_t m_total_capacity = 0;
+  double m_min;
+  double m_max;
+};
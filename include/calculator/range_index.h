@@ -0,0 +1,89 @@
+#pragma once
+
+// Standard library headers
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+// Half-open range of positions [first, last).
+struct IndexRange {
+  std::size_t first = 0;
+  std::size_t last = 0;
+};
+
+struct PointUpdate {
+  std::size_t position = 0;
+  int value = 0;
+};
+
+// Mutable array of ints answering range sum, min and max queries in
+// O(log n). The index is an implicit B-tree: level k holds the sum, min and
+// max of each run of FANOUT entries of level k - 1, and the values are
+// level zero. A query scans at most 2 * FANOUT contiguous entries per level
+// and an update rewrites one entry per level, so both touch a handful of
+// cache lines per level instead of one scattered line per bit as in a
+// Fenwick tree. The levels add about a quarter to the values' memory.
+//
+// Sums are 64-bit, so no range of ints can overflow them. Positions past
+// size() throw std::out_of_range, and min or max of an empty range throws
+// std::invalid_argument.
+class RangeIndex {
+public:
+  static constexpr std::size_t FANOUT = 16;
+
+  explicit RangeIndex(std::span<const int> values);
+
+  std::size_t size() const;
+  int value(std::size_t position) const;
+
+  void update(std::size_t position, int value);
+  // Applies the updates in order, then refreshes each touched summary once.
+  void update(std::span<const PointUpdate> updates);
+
+  std::int64_t sum(IndexRange range) const;
+  int min(IndexRange range) const;
+  int max(IndexRange range) const;
+
+  // Answer a batch of queries, walking the levels for several queries at
+  // once so that their cache misses overlap.
+  void sum(std::span<const IndexRange> ranges,
+           std::span<std::int64_t> results) const;
+  void min(std::span<const IndexRange> ranges, std::span<int> results) const;
+  void max(std::span<const IndexRange> ranges, std::span<int> results) const;
+
+private:
+  enum class Aggregate { Sum, Min, Max };
+
+  template <Aggregate Kind>
+  using Result = std::conditional_t<Kind == Aggregate::Sum, std::int64_t, int>;
+
+  // Summaries of one level, one entry per FANOUT entries of the level below.
+  struct Level {
+    std::vector<std::int64_t> sums;
+    std::vector<int> mins;
+    std::vector<int> maxs;
+  };
+
+  void validate(IndexRange range, bool allow_empty) const;
+  // Recomputes one summary of level (one-based) from the level below.
+  void refresh(std::size_t level, std::size_t entry);
+
+  template <Aggregate Kind>
+  void query(std::span<const IndexRange> ranges,
+             std::span<Result<Kind>> results) const;
+  // Folds the partial blocks of [first, last) at level (zero for the
+  // values) into result and narrows the range to the full blocks above.
+  // Returns true once the range is exhausted.
+  template <Aggregate Kind>
+  bool step(std::size_t level, std::size_t& first, std::size_t& last,
+            Result<Kind>& result) const;
+  template <Aggregate Kind>
+  void scan(std::size_t level, std::size_t first, std::size_t last,
+            Result<Kind>& result) const;
+
+  std::vector<int> m_values;
+  // m_levels[0] summarizes m_values; the last level has a single entry.
+  std::vector<Level> m_levels;
+};
@@ -0,0 +1,81 @@
+#pragma once
+
+// First-party headers
+#include "calculator/calculator.h"
+
+// Standard library headers
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// Column stored as runs of identical values: the value of each run and the
+// row it ends before, so run i covers rows [ends[i - 1], ends[i]). Adjacent
+// runs always differ; double values are compared bit for bit, keeping the
+// sign of zero and NaN payloads. Instantiated for int and double.
+template <typename T> class RunLengthColumn {
+public:
+  RunLengthColumn() = default;
+
+  static RunLengthColumn encode(std::span<const T> values);
+
+  // Appends count rows of value, extending the last run when it holds the
+  // same value.
+  void append(T value, std::size_t count);
+  void reserve(std::size_t run_count);
+
+  std::size_t size() const;
+  std::size_t run_count() const;
+  std::span<const T> values() const;
+  std::span<const std::size_t> ends() const;
+
+  // Writes the value of every row; throws std::invalid_argument when
+  // results holds fewer than size() values.
+  void decode(std::span<T> results) const;
+
+private:
+  std::vector<T> m_values;
+  std::vector<std::size_t> m_ends;
+};
+
+// Calculator operations and reductions over run-length columns, computed
+// once per run instead of once per row, with results that stay run-length
+// encoded. Between two columns the runs are merged: each output run covers
+// rows where neither input changes value, so the output has fewer runs
+// than the inputs together. Equal neighbouring results join into one run,
+// as when multiplying by zero.
+//
+// Columns of different sizes throw std::invalid_argument, as do divide by
+// zero in any run and the minimum or maximum of an empty column.
+class RunLengthCalculator {
+public:
+  RunLengthColumn<int> add(const RunLengthColumn<int>& column, int value);
+  RunLengthColumn<int> subtract(const RunLengthColumn<int>& column,
+                                int value);
+  RunLengthColumn<int> multiply(const RunLengthColumn<int>& column,
+                                int value);
+  RunLengthColumn<double> divide(const RunLengthColumn<int>& column,
+                                 int value);
+
+  RunLengthColumn<int> add(const RunLengthColumn<int>& first,
+                           const RunLengthColumn<int>& second);
+  RunLengthColumn<int> subtract(const RunLengthColumn<int>& first,
+                                const RunLengthColumn<int>& second);
+  RunLengthColumn<int> multiply(const RunLengthColumn<int>& first,
+                                const RunLengthColumn<int>& second);
+  RunLengthColumn<double> divide(const RunLengthColumn<int>& first,
+                                 const RunLengthColumn<int>& second);
+
+  // Sums weigh each run's value by its length. The int sum is exact: runs
+  // are added in 128 bits, and a total outside int64 throws
+  // std::overflow_error.
+  std::int64_t sum(const RunLengthColumn<int>& column);
+  double sum(const RunLengthColumn<double>& column);
+  int min(const RunLengthColumn<int>& column);
+  int max(const RunLengthColumn<int>& column);
+  double min(const RunLengthColumn<double>& column);
+  double max(const RunLengthColumn<double>& column);
+
+private:
+  Calculator m_calculator;
+};
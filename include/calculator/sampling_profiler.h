@@ -0,0 +1,99 @@
+#pragma once
+
+// Standard library headers
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <vector>
+
+class ProfiledThread;
+
+struct ProfilerOptions {
+  // Samples per second of CPU time consumed by each attached thread.
+  unsigned frequency_hz = 100;
+  // Frames kept per sample, innermost first.
+  std::size_t max_depth = 64;
+  // Samples buffered per thread; later samples are counted as dropped. The
+  // buffer of a thread that detached is reused by the next thread to attach,
+  // which appends to it, so memory is bounded by the number of threads
+  // attached at once rather than by the number ever started.
+  std::size_t samples_per_thread = 16384;
+};
+
+// In-process sampling profiler for environments where perf is unavailable.
+// Each attached thread gets a CPU-time timer (timer_create) that delivers
+// SIGPROF; the handler walks the frame-pointer chain and appends the stack
+// to that thread's own buffer without locks or allocation. Stacks are
+// symbolized only when written out, as folded lines ("outer;inner count")
+// that flamegraph.pl, inferno and speedscope read.
+//
+// Frames are only complete when the code is built with frame pointers, and
+// symbol names need the executable to export its symbols (-rdynamic).
+// Linux only; start() throws std::runtime_error elsewhere. One profiler can
+// run at a time.
+class SamplingProfiler {
+public:
+  explicit SamplingProfiler(ProfilerOptions options = {});
+  ~SamplingProfiler();
+
+  SamplingProfiler(const SamplingProfiler&) = delete;
+  SamplingProfiler& operator=(const SamplingProfiler&) = delete;
+
+  // Installs the signal handler and attaches the calling thread.
+  void start();
+  // Stops sampling on every attached thread; samples are kept.
+  void stop();
+  bool is_running() const;
+
+  // Samples the calling thread too until the returned guard is destroyed;
+  // throws std::logic_error unless this profiler is running. A thread that
+  // is already attached gets a guard that leaves it attached.
+  [[nodiscard]] ProfiledThread attach_current_thread();
+
+  std::size_t sample_count() const;
+  std::size_t dropped_samples() const;
+
+  // Writes one line per distinct stack, root frame first.
+  void write_folded(std::ostream& output) const;
+
+  // Per-thread sample storage and timer, written by the signal handler.
+  struct ThreadBuffer;
+
+private:
+  // Attaches the calling thread while this profiler is the active one,
+  // taking a detached buffer if there is one. A new buffer is allocated with
+  // lock released, so threads starting together are not serialized on its
+  // zero fill. Returns null if the thread was already attached or the
+  // profiler stopped meanwhile.
+  ThreadBuffer* attach(std::unique_lock<std::mutex>& lock);
+  // Both require the profiler registry lock to be held.
+  ThreadBuffer* attach_locked(ThreadBuffer* buffer);
+  void detach_locked(ThreadBuffer* buffer);
+
+  friend class ProfiledThread;
+
+  ProfilerOptions m_options;
+  std::vector<std::unique_ptr<ThreadBuffer>> m_buffers;
+  bool m_running = false;
+};
+
+// Attaches the constructing thread to the running profiler, if any, for
+// its lifetime. Worker threads create one so their samples are kept.
+class ProfiledThread {
+public:
+  ProfiledThread();
+  ~ProfiledThread();
+
+  ProfiledThread(const ProfiledThread&) = delete;
+  ProfiledThread& operator=(const ProfiledThread&) = delete;
+
+private:
+  friend class SamplingProfiler;
+
+  ProfiledThread(SamplingProfiler* profiler,
+                 SamplingProfiler::ThreadBuffer* buffer);
+
+  SamplingProfiler* m_profiler = nullptr;
+  SamplingProfiler::ThreadBuffer* m_buffer = nullptr;
+};
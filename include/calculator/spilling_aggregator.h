@@ -0,0 +1,93 @@
+#pragma once
+
+// First-party headers
+#include "calculator/calculator.h"
+#include "calculator/memory_accounting.h"
+
+// Standard library headers
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <span>
+#include <vector>
+
+struct AggregationOptions {
+  // Bytes the group tables may take. A full table that cannot grow within
+  // it is spilled instead.
+  std::size_t memory_budget = std::size_t{64} << 20;
+  // Hash partitions of the key space. Each spills and merges on its own,
+  // so a merge only reads the runs of one partition at a time.
+  std::size_t partition_count = 16;
+  // Sources one merge pass reads at once, counting a partition's resident
+  // groups. A partition with more runs first merges its oldest runs into
+  // larger ones, which bounds the open files and read buffers.
+  std::size_t merge_fan_in = 64;
+  // Parent of the run files; empty means the system temporary directory.
+  std::filesystem::path spill_directory;
+};
+
+// Group-by sum whose groups may outgrow memory. Values are combined with
+// Calculator::add. Each partition keeps its groups in an open-addressing
+// table; when a table is full and growing it would pass the memory budget,
+// its groups are written to a temporary file as a run sorted by key and the
+// table is reused. Groups are sorted within the table itself, so spilling
+// needs no memory beyond the budget. finish() then merges each partition's
+// runs and remaining groups in streaming passes of at most merge_fan_in
+// sources, so memory stays bounded by the budget plus that many read
+// buffers.
+class SpillingAggregator {
+public:
+  // Table bytes per slot. Tables grow at three-quarters load, so a group
+  // takes between 4/3 and 8/3 slots' worth.
+  static constexpr std::size_t SLOT_BYTES =
+      sizeof(std::int64_t) + sizeof(int) + sizeof(std::uint8_t);
+
+  explicit SpillingAggregator(AggregationOptions options = {});
+  // Removes any run files left behind.
+  ~SpillingAggregator();
+
+  SpillingAggregator(const SpillingAggregator&) = delete;
+  SpillingAggregator& operator=(const SpillingAggregator&) = delete;
+
+  void add(std::int64_t key, int value);
+  void add(std::span<const std::int64_t> keys, std::span<const int> values);
+
+  // Passes every group to consumer exactly once, in ascending key order
+  // within a partition, then leaves the aggregator empty for reuse.
+  void finish(const std::function<void(std::int64_t key, int sum)>& consumer);
+
+  // Runs written and bytes spilled since construction.
+  std::size_t spilled_runs() const;
+  std::uint64_t spilled_bytes() const;
+
+private:
+  // Linear-probing table of one partition's groups.
+  struct Partition {
+    TrackedVector<std::int64_t, MemorySubsystem::Buffers> keys;
+    TrackedVector<int, MemorySubsystem::Buffers> sums;
+    TrackedVector<std::uint8_t, MemorySubsystem::Buffers> occupied;
+    std::size_t size = 0;
+  };
+
+  void make_room(std::size_t partition);
+  void resize(Partition& partition, std::size_t capacity);
+  void spill(std::size_t partition);
+  void merge_partition(
+      std::size_t partition,
+      const std::function<void(std::int64_t key, int sum)>& consumer);
+  std::filesystem::path next_run_path();
+  void add_run(std::size_t partition, std::filesystem::path path,
+               std::uint64_t bytes);
+  void remove_spill_files();
+
+  AggregationOptions m_options;
+  Calculator m_calculator;
+  std::vector<Partition> m_partitions;
+  // Run files of each partition, oldest first.
+  std::vector<std::vector<std::filesystem::path>> m_runs;
+  std::filesystem::path m_spill_directory;
+  std::size_t m_table_bytes = 0;
+  std::size_t m_spilled_runs = 0;
+  std::uint64_t m_spilled_bytes = 0;
+};
@@ -0,0 +1,73 @@
+#pragma once
+
+// Standard library headers
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+// One-pass descriptive statistics. Spans are consumed in cache-sized blocks:
+// each block's central moments are computed in two passes over lane-wise
+// accumulators that the compiler vectorizes, and blocks are combined with
+// the pairwise merge formulas (Chan et al., Pebay). Accuracy matches a
+// two-pass computation even for data with a large mean, and partial states
+// built on different threads merge into the same result.
+//
+// Statistics that are undefined for the data seen so far (the mean of
+// nothing, the variance of one value, the skewness of constant data) throw
+// std::invalid_argument. NaN inputs propagate to every statistic.
+class RunningStatistics {
+public:
+  void add(double value);
+  void add(std::span<const double> values);
+  void add(std::span<const int> values);
+  void merge(const RunningStatistics& other);
+
+  std::uint64_t count() const;
+  double mean() const;
+  // Sample variance and standard deviation, with n - 1 in the denominator.
+  double variance() const;
+  double standard_deviation() const;
+  // Population skewness and excess kurtosis (zero for a normal
+  // distribution).
+  double skewness() const;
+  double kurtosis() const;
+
+private:
+  template <typename T>
+  static RunningStatistics summarize(const T* values, std::size_t count);
+  template <typename T> void add_blocks(std::span<const T> values);
+
+  std::uint64_t m_count = 0;
+  double m_mean = 0.0;
+  // Sums of the 2nd, 3rd and 4th powers of deviations from the mean.
+  double m_m2 = 0.0;
+  double m_m3 = 0.0;
+  double m_m4 = 0.0;
+};
+
+// Covariance and correlation of paired values, under the same scheme as
+// RunningStatistics. Spans of x and y values must have equal lengths.
+class RunningCovariance {
+public:
+  void add(double x, double y);
+  void add(std::span<const double> xs, std::span<const double> ys);
+  void merge(const RunningCovariance& other);
+
+  std::uint64_t count() const;
+  // Sample covariance, with n - 1 in the denominator.
+  double covariance() const;
+  // Pearson correlation; throws if either variable is constant.
+  double correlation() const;
+
+private:
+  static RunningCovariance summarize(const double* xs, const double* ys,
+                                     std::size_t count);
+
+  std::uint64_t m_count = 0;
+  double m_mean_x = 0.0;
+  double m_mean_y = 0.0;
+  double m_m2_x = 0.0;
+  double m_m2_y = 0.0;
+  // Sum of products of the x and y deviations.
+  double m_c_xy = 0.0;
+};
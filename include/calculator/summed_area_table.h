@@ -0,0 +1,50 @@
+#pragma once
+
+// Standard library headers
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+
+// Half-open block of cells [first_row, last_row) x [first_column,
+// last_column).
+struct GridRectangle {
+  std::size_t first_row = 0;
+  std::size_t first_column = 0;
+  std::size_t last_row = 0;
+  std::size_t last_column = 0;
+};
+
+// Summed-area table over a row-major grid of ints: entry (r, c) holds the
+// sum of every cell above and to the left of it, so any rectangle sum takes
+// four lookups. Entries are 64-bit, which holds the sum of any grid of up
+// to 2^32 cells, and a zero border row and column keep queries branch-free.
+//
+// Construction runs in two passes. Rows are prefix-summed in parallel,
+// then each row has the row above it added to it; that pass is a plain
+// vector add over column strips, split across threads as well.
+class SummedAreaTable {
+public:
+  SummedAreaTable(std::span<const int> values, std::size_t rows,
+                  std::size_t columns, unsigned thread_count = 1);
+
+  std::size_t rows() const;
+  std::size_t columns() const;
+
+  // Throws std::out_of_range for rectangles outside the grid or with a
+  // last row or column before the first.
+  std::int64_t sum(const GridRectangle& rectangle) const;
+  void sum(std::span<const GridRectangle> rectangles,
+           std::span<std::int64_t> results) const;
+
+private:
+  void validate(const GridRectangle& rectangle) const;
+  std::int64_t lookup(const GridRectangle& rectangle) const;
+
+  std::size_t m_rows;
+  std::size_t m_columns;
+  // (m_rows + 1) x (m_columns + 1), row-major, with a zero first row and
+  // column. Left uninitialized on allocation, since the build writes every
+  // entry and zero-filling would cost a pass of its own.
+  std::unique_ptr<std::int64_t[]> m_table;
+};
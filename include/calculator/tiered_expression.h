@@ -0,0 +1,62 @@
+#pragma once
+
+// First-party headers
+#include "calculator/compiled_expression.h"
+#include "calculator/compiled_program.h"
+#include "calculator/expression.h"
+
+// Standard library headers
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <thread>
+
+struct TierPolicy {
+  // Rows evaluated in the interpreter before the expression is promoted.
+  // Zero compiles on construction.
+  std::uint64_t hot_threshold = 10000;
+  // Compile on a background thread instead of the thread that crossed the
+  // threshold. Callers keep interpreting until the swap happens.
+  bool background_promotion = true;
+  // Checks and input bounds for the compiled tier. The interpreter applies
+  // the same overflow checks, so promotion never changes a result.
+  CompileOptions compile_options;
+};
+
+// Runs an Expression in the interpreter until it turns hot, then swaps in a
+// CompiledExpression. The swap is a single atomic pointer publish, so
+// concurrent callers see either tier but never a partially built one.
+class TieredExpression {
+public:
+  explicit TieredExpression(Expression expression, TierPolicy policy = {});
+
+  TieredExpression(const TieredExpression&) = delete;
+  TieredExpression& operator=(const TieredExpression&) = delete;
+
+  double evaluate(std::span<const double> inputs);
+  void evaluate(std::span<const std::span<const double>> columns,
+                std::span<double> results);
+
+  // Rows evaluated while the expression was still interpreted.
+  std::uint64_t invocation_count() const;
+  bool is_optimized() const;
+
+  // Blocks until a promotion that has already started has been published.
+  void wait_for_promotion();
+
+private:
+  void record_invocations(std::uint64_t count);
+  void promote();
+
+  Expression m_expression;
+  TierPolicy m_policy;
+  std::atomic<std::uint64_t> m_invocation_count{0};
+  std::unique_ptr<CompiledExpression> m_compiled;
+  std::atomic<const CompiledExpression*> m_optimized{nullptr};
+  std::mutex m_promotion_mutex;
+  // Declared last so that it is joined before the members it writes to are
+  // destroyed.
+  std::jthread m_promotion_thread;
+};
@@ -0,0 +1,469 @@
+// First-party headers
+#include "calculator/autotuner.h"
+#include "calculator/expression.h"
+#include "calculator/sampling_profiler.h"
+#include "probes.h"
+
+// Standard library headers
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#if defined(_WIN32)
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+
+CALCULATOR_PROBE_SEMAPHORE(batch__start);
+CALCULATOR_PROBE_SEMAPHORE(batch__done);
+CALCULATOR_PROBE_SEMAPHORE(tile__start);
+
+namespace {
+
+constexpr const char* PROFILE_HEADER = "calculator-tuning-v1";
+// Rows timed per candidate; larger size classes are tuned on this many rows
+// so that first use stays cheap.
+constexpr std::size_t MAX_PROBE_ROWS = std::size_t{1} << 20;
+constexpr int PROBE_REPETITIONS = 3;
+constexpr std::size_t TILE_CANDIDATES[] = {4096, 16384, 65536};
+
+unsigned hardware_threads() {
+  return std::max(1u, std::thread::hardware_concurrency());
+}
+
+std::string host_name() {
+#if defined(_WIN32)
+  const char* name = std::getenv("COMPUTERNAME");
+  return name != nullptr ? name : "localhost";
+#else
+  char name[256] = {};
+  if (gethostname(name, sizeof(name) - 1) != 0) {
+    return "localhost";
+  }
+  return name;
+#endif
+}
+
+long long process_id() {
+#if defined(_WIN32)
+  return _getpid();
+#else
+  return static_cast<long long>(getpid());
+#endif
+}
+
+std::int64_t nanoseconds_since(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now() - start)
+      .count();
+}
+
+// Batches are grouped by the power of two that bounds their row count.
+std::size_t size_class(std::size_t row_count) {
+  return std::bit_ceil(std::max<std::size_t>(row_count, 1));
+}
+
+// Thread counts doubling from one up to the hardware thread count.
+std::vector<unsigned> thread_candidates() {
+  std::vector<unsigned> candidates;
+  for (unsigned threads = 1; threads < hardware_threads(); threads *= 2) {
+    candidates.push_back(threads);
+  }
+  candidates.push_back(hardware_threads());
+  return candidates;
+}
+
+// Two representative formulas with shared work, a select and a divide.
+CompiledProgram make_probe_program() {
+  Expression unit_price;
+  NodeId price = unit_price.input(0);
+  NodeId qty = unit_price.input(1);
+  NodeId zero = unit_price.constant(0.0);
+  unit_price.select(unit_price.greater(qty, zero),
+                    unit_price.divide(price, qty), zero);
+
+  Expression total;
+  NodeId total_price = total.input(0);
+  NodeId total_qty = total.input(1);
+  total.add(total.multiply(total_price, total_qty),
+            total.multiply(total.input(2), total.constant(0.2)));
+
+  std::vector<Expression> expressions = {unit_price, total};
+  return CompiledProgram(expressions);
+}
+
+std::chrono::nanoseconds time_config(
+    const CompiledProgram& program,
+    std::span<const std::span<const double>> columns,
+    std::span<const std::span<double>> outputs, const TuningConfig& config) {
+  evaluate_parallel(program, columns, outputs, config);
+
+  auto best = std::chrono::nanoseconds::max();
+  for (int repetition = 0; repetition < PROBE_REPETITIONS; ++repetition) {
+    auto start = std::chrono::steady_clock::now();
+    evaluate_parallel(program, columns, outputs, config);
+    best = std::min(best, std::chrono::duration_cast<std::chrono::nanoseconds>(
+                              std::chrono::steady_clock::now() - start));
+  }
+  return best;
+}
+
+TuningConfig tune(std::size_t row_count) {
+  const std::size_t probe_rows = std::min(row_count, MAX_PROBE_ROWS);
+  CompiledProgram program = make_probe_program();
+  std::vector<std::vector<double>> inputs(3, std::vector<double>(probe_rows));
+  for (std::size_t row = 0; row < probe_rows; ++row) {
+    inputs[0][row] = static_cast<double>(row % 97);
+    inputs[1][row] = static_cast<double>(row % 5);
+    inputs[2][row] = static_cast<double>(row % 13);
+  }
+  std::vector<std::span<const double>> columns(inputs.begin(), inputs.end());
+  std::vector<std::vector<double>> results(
+      program.output_count(), std::vector<double>(probe_rows));
+  std::vector<std::span<double>> outputs(results.begin(), results.end());
+
+  TuningConfig best_config;
+  auto best_time = std::chrono::nanoseconds::max();
+  for (std::size_t tile_rows : TILE_CANDIDATES) {
+    for (unsigned thread_count : thread_candidates()) {
+      // Candidates that leave threads without a tile only add start-up
+      // cost.
+      std::size_t tile_count = (probe_rows + tile_rows - 1) / tile_rows;
+      if (thread_count > 1 && thread_count > tile_count) {
+        continue;
+      }
+
+      TuningConfig candidate{tile_rows, thread_count};
+      auto elapsed = time_config(program, columns, outputs, candidate);
+      if (elapsed < best_time) {
+        best_time = elapsed;
+        best_config = candidate;
+      }
+    }
+  }
+  return best_config;
+}
+
+} // namespace
+
+void evaluate_parallel(const CompiledProgram& program,
+                       std::span<const std::span<const double>> columns,
+                       std::span<const std::span<double>> outputs,
+                       const TuningConfig& config) {
+  if (config.tile_rows == 0 || config.thread_count == 0) {
+    throw std::invalid_argument("Tile rows and thread count must be positive");
+  }
+  if (outputs.size() < program.output_count()) {
+    throw std::invalid_argument("Missing output columns");
+  }
+
+  const std::size_t row_count = outputs.front().size();
+  for (std::size_t output = 0; output < program.output_count(); ++output) {
+    if (outputs[output].size() != row_count) {
+      throw std::invalid_argument("Output columns differ in length");
+    }
+  }
+  validate_columns(columns, program.input_count(), row_count);
+
+  const std::size_t tile_count =
+      (row_count + config.tile_rows - 1) / config.tile_rows;
+  CALCULATOR_PROBE3(batch__start, row_count, tile_count, config.thread_count);
+  // Clocks are only read while a tracer is attached to a timed probe.
+  const bool timed = CALCULATOR_PROBE_ENABLED(batch__done) ||
+                     CALCULATOR_PROBE_ENABLED(tile__start);
+  const auto batch_start = timed ? std::chrono::steady_clock::now()
+                                 : std::chrono::steady_clock::time_point{};
+
+  std::atomic<std::size_t> next_tile{0};
+  std::atomic<bool> failed{false};
+  std::exception_ptr first_error;
+  std::mutex error_mutex;
+
+  // Workers claim tiles until none are left; the first failure stops the
+  // others from claiming more.
+  auto work = [&] {
+    std::vector<std::span<const double>> tile_columns(program.input_count());
+    std::vector<std::span<double>> tile_outputs(program.output_count());
+    for (std::size_t tile = next_tile.fetch_add(1); tile < tile_count;
+         tile = next_tile.fetch_add(1)) {
+      if (failed.load(std::memory_order_relaxed)) {
+        return;
+      }
+
+      const std::size_t offset = tile * config.tile_rows;
+      const std::size_t count = std::min(config.tile_rows, row_count - offset);
+      for (std::size_t column = 0; column < tile_columns.size(); ++column) {
+        tile_columns[column] = columns[column].subspan(offset, count);
+      }
+      for (std::size_t output = 0; output < tile_outputs.size(); ++output) {
+        tile_outputs[output] = outputs[output].subspan(offset, count);
+      }
+
+      // Queue latency: how long the tile waited after the batch started.
+      if (timed && CALCULATOR_PROBE_ENABLED(tile__start)) {
+        CALCULATOR_PROBE2(tile__start, tile, nanoseconds_since(batch_start));
+      }
+
+      try {
+        program.evaluate(tile_columns, tile_outputs);
+      } catch (...) {
+        std::lock_guard lock(error_mutex);
+        if (!first_error) {
+          first_error = std::current_exception();
+        }
+        failed.store(true, std::memory_order_relaxed);
+        return;
+      }
+    }
+  };
+
+  {
+    const std::size_t worker_count =
+        std::min<std::size_t>(config.thread_count, tile_count);
+    std::vector<std::jthread> workers;
+    for (std::size_t worker = 1; worker < worker_count; ++worker) {
+      workers.emplace_back([&work] {
+        ProfiledThread profiled;
+        work();
+      });
+    }
+    work();
+  }
+
+  if (timed && CALCULATOR_PROBE_ENABLED(batch__done)) {
+    CALCULATOR_PROBE2(batch__done, row_count, nanoseconds_since(batch_start));
+  }
+  if (first_error) {
+    std::rethrow_exception(first_error);
+  }
+}
+
+Autotuner::Autotuner(std::filesystem::path profile_path)
+    : m_profile_path(std::move(profile_path)) {
+  load();
+}
+
+TuningConfig Autotuner::config_for(std::size_t row_count) {
+  const std::size_t size = size_class(row_count);
+  {
+    std::lock_guard lock(m_mutex);
+    if (auto tuned = m_profile.find(size); tuned != m_profile.end()) {
+      return tuned->second;
+    }
+  }
+
+  // Timed without the lock, so other size classes are served meanwhile and
+  // waiting threads do not skew the timings. When two threads tune the same
+  // class, the first result published is the one both return.
+  TuningConfig config = tune(size);
+  std::lock_guard lock(m_mutex);
+  auto [tuned, inserted] = m_profile.emplace(size, config);
+  if (inserted) {
+    save();
+  }
+  return tuned->second;
+}
+
+std::size_t Autotuner::tuned_size_classes() const {
+  std::lock_guard lock(m_mutex);
+  return m_profile.size();
+}
+
+const std::filesystem::path& Autotuner::profile_path() const {
+  return m_profile_path;
+}
+
+void Autotuner::load() {
+  // The profile is a cache: an unreadable or foreign file is ignored and
+  // replaced on the next save.
+  std::ifstream file(m_profile_path);
+  std::string header;
+  unsigned threads = 0;
+  if (!(file >> header >> threads) || header != PROFILE_HEADER ||
+      threads != hardware_threads()) {
+    return;
+  }
+
+  Profile profile;
+  std::size_t size = 0;
+  TuningConfig config;
+  while (file >> size >> config.tile_rows >> config.thread_count) {
+    if (config.tile_rows == 0 || config.thread_count == 0) {
+      return;
+    }
+    profile[size] = config;
+  }
+  if (!file.eof()) {
+    return;
+  }
+  m_profile = std::move(profile);
+}
+
+void Autotuner::save() const {
+  // Written to a side file named after the process and save, then renamed
+  // over the profile, so concurrent processes never read a partial profile
+  // or write into each other's side file. Failures leave tuning in memory
+  // only.
+  static std::atomic<unsigned> save_count{0};
+  std::error_code error;
+  std::filesystem::create_directories(m_profile_path.parent_path(), error);
+  std::filesystem::path staging = m_profile_path;
+  staging += "." + std::to_string(process_id()) + "." +
+             std::to_string(save_count.fetch_add(1)) + ".tmp";
+  {
+    std::ofstream file(staging, std::ios::trunc);
+    file << PROFILE_HEADER << ' ' << hardware_threads() << '\n';
+    for (const auto& [size, config] : m_profile) {
+      file << size << ' ' << config.tile_rows << ' ' << config.thread_count
+           << '\n';
+    }
+    if (!file) {
+      file.close();
+      std::filesystem::remove(staging, error);
+      return;
+    }
+  }
+  std::filesystem::rename(staging, m_profile_path, error);
+  if (error) {
+    std::filesystem::remove(staging, error);
+  }
+}
+
+std::filesystem::path default_tuning_profile_path() {
+  std::filesystem::path directory;
+  if (const char* cache = std::getenv("XDG_CACHE_HOME"); cache != nullptr) {
+    directory = cache;
+  } else if (const char* local = std::getenv("LOCALAPPDATA");
+             local != nullptr) {
+    directory = local;
+  } else if (const char* home = std::getenv("HOME"); home != nullptr) {
+    directory = std::filesystem::path(home) / ".cache";
+  } else {
+    directory = std::filesystem::temp_directory_path();
+  }
+  return directory / "calculator" / ("tuning-" + host_name() + ".txt");
+}
+
+Autotuner& host_autotuner() {
+  static Autotuner autotuner(default_tuning_profile_path());
+  return autotuner;
+}
+
+// Unit tests (embedded in source file)
+// Disabled in production builds via DOCTEST_CONFIG_DISABLE
+#include <doctest/doctest.h>
+
+// Standard library headers
+#include <random>
+
+TEST_CASE("Autotuner - parallel evaluation") {
+  // Arrange - x * 2 over more rows than one tile
+  Expression expression;
+  expression.multiply(expression.input(0), expression.constant(2.0));
+  std::vector<Expression> expressions = {expression};
+  CompiledProgram program(expressions);
+  std::vector<double> values(1000);
+  for (std::size_t row = 0; row < values.size(); ++row) {
+    values[row] = static_cast<double>(row);
+  }
+  std::vector<std::span<const double>> columns = {values};
+  std::vector<double> results(values.size());
+  std::vector<std::span<double>> outputs = {results};
+
+  SUBCASE("every tile is evaluated once") {
+    // Act
+    evaluate_parallel(program, columns, outputs, TuningConfig{96, 3});
+
+    // Assert
+    for (std::size_t row = 0; row < values.size(); ++row) {
+      CHECK(results[row] == 2.0 * values[row]);
+    }
+  }
+
+  SUBCASE("errors from any tile are rethrown") {
+    // Arrange
+    Expression quotient;
+    quotient.divide(quotient.constant(1.0), quotient.input(0));
+    std::vector<Expression> quotients = {quotient};
+    CompiledProgram failing(quotients);
+
+    // Act & Assert
+    CHECK_THROWS_AS(
+        evaluate_parallel(failing, columns, outputs, TuningConfig{96, 3}),
+        std::invalid_argument);
+  }
+
+  SUBCASE("empty tiles are rejected") {
+    // Act & Assert
+    CHECK_THROWS_AS(
+        evaluate_parallel(program, columns, outputs, TuningConfig{0, 1}),
+        std::invalid_argument);
+  }
+}
+
+TEST_CASE("Autotuner - profile persistence") {
+  // Arrange
+  std::filesystem::path path =
+      std::filesystem::temp_directory_path() /
+      ("calculator-autotuner-unit-" + std::to_string(std::random_device{}())) /
+      "tuning.txt";
+  std::filesystem::create_directories(path.parent_path());
+
+  SUBCASE("size classes are tuned once") {
+    // Arrange
+    Autotuner autotuner(path);
+
+    // Act
+    TuningConfig first = autotuner.config_for(1000);
+    TuningConfig second = autotuner.config_for(600);
+
+    // Assert
+    CHECK(autotuner.tuned_size_classes() == 1);
+    CHECK(first.tile_rows == second.tile_rows);
+    CHECK(first.thread_count == second.thread_count);
+  }
+
+  SUBCASE("profiles from another host shape are ignored") {
+    // Arrange
+    {
+      std::ofstream file(path);
+      file << "calculator-tuning-v1 " << hardware_threads() + 1 << "\n"
+           << "1024 4096 2\n";
+    }
+
+    // Act
+    Autotuner autotuner(path);
+
+    // Assert
+    CHECK(autotuner.tuned_size_classes() == 0);
+  }
+
+  SUBCASE("malformed profiles are ignored") {
+    // Arrange
+    {
+      std::ofstream file(path);
+      file << "calculator-tuning-v1 " << hardware_threads() << "\n"
+           << "1024 four 2\n";
+    }
+
+    // Act
+    Autotuner autotuner(path);
+
+    // Assert
+    CHECK(autotuner.tuned_size_classes() == 0);
+  }
+
+  std::filesystem::remove_all(path.parent_path());
+}
@@ -0,0 +1,504 @@
+// First-party headers
+#include "calculator/big_integer.h"
+
+// Standard library headers
+#include <algorithm>
+#include <bit>
+#include <span>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+
+using Limbs = std::vector<std::uint32_t>;
+
+constexpr std::uint64_t BINARY_BASE = std::uint64_t{1} << 32;
+constexpr std::uint64_t DECIMAL_BASE = 1000000000;
+constexpr std::size_t DECIMAL_DIGITS = 9;
+constexpr std::size_t DECIMAL_ROWS = 16;
+
+// Operands up to this many limbs multiply by the schoolbook method, whose
+// lower constant wins on short numbers; the vectorized decimal schoolbook
+// wins for longer.
+template <std::uint64_t Base>
+constexpr std::size_t KARATSUBA_THRESHOLD = Base == DECIMAL_BASE ? 192 : 32;
+
+// Numbers up to this many limbs convert one digit at a time, multiplying
+// by the source base and adding.
+constexpr std::size_t CONVERSION_THRESHOLD = 64;
+
+// The helpers below work in any base up to 2^32 on little-endian limbs;
+// results carry no leading zero limbs.
+
+std::span<const std::uint32_t>
+trimmed(std::span<const std::uint32_t> limbs) {
+  while (!limbs.empty() && limbs.back() == 0) {
+    limbs = limbs.first(limbs.size() - 1);
+  }
+  return limbs;
+}
+
+void trim(Limbs& limbs) {
+  while (!limbs.empty() && limbs.back() == 0) {
+    limbs.pop_back();
+  }
+}
+
+std::strong_ordering compare_magnitudes(const Limbs& first,
+                                        const Limbs& second) {
+  if (first.size() != second.size()) {
+    return first.size() <=> second.size();
+  }
+  return std::lexicographical_compare_three_way(
+      first.rbegin(), first.rend(), second.rbegin(), second.rend());
+}
+
+// Adds part * Base^offset into target, which must be long enough to hold
+// the sum. Each carry is 0 or 1, so no step divides.
+template <std::uint64_t Base>
+void add_into(Limbs& target, std::span<const std::uint32_t> part,
+              std::size_t offset) {
+  std::uint64_t carry = 0;
+  std::size_t index = offset;
+  for (std::uint32_t limb : part) {
+    std::uint64_t sum = target[index] + carry + limb;
+    carry = sum >= Base ? 1 : 0;
+    sum -= carry * Base;
+    target[index++] = static_cast<std::uint32_t>(sum);
+  }
+  for (; carry != 0; ++index) {
+    std::uint64_t sum = target[index] + carry;
+    carry = sum >= Base ? 1 : 0;
+    sum -= carry * Base;
+    target[index] = static_cast<std::uint32_t>(sum);
+  }
+}
+
+template <std::uint64_t Base>
+Limbs add(std::span<const std::uint32_t> first,
+          std::span<const std::uint32_t> second) {
+  if (first.size() < second.size()) {
+    std::swap(first, second);
+  }
+  Limbs sum(first.begin(), first.end());
+  sum.push_back(0);
+  add_into<Base>(sum, second, 0);
+  trim(sum);
+  return sum;
+}
+
+// minuend -= subtrahend, where the minuend is not the smaller.
+template <std::uint64_t Base>
+void subtract_from(Limbs& minuend,
+                   std::span<const std::uint32_t> subtrahend) {
+  std::uint64_t borrow = 0;
+  for (std::size_t index = 0; index < minuend.size(); ++index) {
+    const std::uint64_t taken =
+        borrow + (index < subtrahend.size() ? subtrahend[index] : 0);
+    if (taken == 0 && index >= subtrahend.size()) {
+      break;
+    }
+    const bool wraps = minuend[index] < taken;
+    minuend[index] = static_cast<std::uint32_t>(minuend[index] +
+                                                (wraps ? Base : 0) - taken);
+    borrow = wraps ? 1 : 0;
+  }
+  trim(minuend);
+}
+
+// value = value * factor + addend, for factor and addend up to 2^32.
+template <std::uint64_t Base>
+void multiply_add(Limbs& value, std::uint64_t factor, std::uint64_t addend) {
+  std::uint64_t carry = addend;
+  for (std::uint32_t& limb : value) {
+    const std::uint64_t product = limb * factor + carry;
+    limb = static_cast<std::uint32_t>(product % Base);
+    carry = product / Base;
+  }
+  for (; carry != 0; carry /= Base) {
+    value.push_back(static_cast<std::uint32_t>(carry % Base));
+  }
+}
+
+// In binary every step stays below 2^64: an existing limb, a limb product
+// and a carry, each below 2^32. Decimal products are below 10^18, so sums
+// of DECIMAL_ROWS of them and a pending carry still fit in 64 bits; rows
+// accumulate without carries and the inner loop is a plain widening
+// multiply-add that vectorizes.
+template <std::uint64_t Base>
+Limbs multiply_schoolbook(std::span<const std::uint32_t> first,
+                          std::span<const std::uint32_t> second) {
+  Limbs product(first.size() + second.size(), 0);
+  if constexpr (Base == DECIMAL_BASE) {
+    std::vector<std::uint64_t> sums(product.size(), 0);
+    for (std::size_t block = 0; block < first.size(); block += DECIMAL_ROWS) {
+      const std::size_t end = std::min(block + DECIMAL_ROWS, first.size());
+      for (std::size_t row = block; row < end; ++row) {
+        const std::uint32_t factor = first[row];
+        std::uint64_t* row_sums = sums.data() + row;
+        for (std::size_t column = 0; column < second.size(); ++column) {
+          row_sums[column] += std::uint64_t{factor} * second[column];
+        }
+      }
+      std::uint64_t carry = 0;
+      for (std::size_t index = block; index < end + second.size() - 1;
+           ++index) {
+        const std::uint64_t sum = sums[index] + carry;
+        sums[index] = sum % Base;
+        carry = sum / Base;
+      }
+      sums[end + second.size() - 1] += carry;
+    }
+    std::transform(sums.begin(), sums.end(), product.begin(),
+                   [](std::uint64_t sum) {
+                     return static_cast<std::uint32_t>(sum);
+                   });
+  } else {
+    for (std::size_t row = 0; row < first.size(); ++row) {
+      const std::uint64_t factor = first[row];
+      std::uint64_t carry = 0;
+      for (std::size_t column = 0; column < second.size(); ++column) {
+        const std::uint64_t step =
+            product[row + column] + factor * second[column] + carry;
+        product[row + column] = static_cast<std::uint32_t>(step % Base);
+        carry = step / Base;
+      }
+      product[row + second.size()] = static_cast<std::uint32_t>(carry);
+    }
+  }
+  trim(product);
+  return product;
+}
+
+template <std::uint64_t Base>
+Limbs multiply(std::span<const std::uint32_t> first,
+               std::span<const std::uint32_t> second) {
+  first = trimmed(first);
+  second = trimmed(second);
+  if (first.size() < second.size()) {
+    std::swap(first, second);
+  }
+  if (second.empty()) {
+    return {};
+  }
+  if (second.size() <= KARATSUBA_THRESHOLD<Base>) {
+    return multiply_schoolbook<Base>(first, second);
+  }
+
+  Limbs product(first.size() + second.size(), 0);
+  const std::size_t half = (first.size() + 1) / 2;
+  if (second.size() <= half) {
+    // Unbalanced: the longer operand in pieces as long as the shorter.
+    for (std::size_t offset = 0; offset < first.size();
+         offset += second.size()) {
+      const std::size_t length =
+          std::min(second.size(), first.size() - offset);
+      add_into<Base>(product,
+                     multiply<Base>(first.subspan(offset, length), second),
+                     offset);
+    }
+  } else {
+    // (a1 B^h + a0)(b1 B^h + b0), with the middle term computed as
+    // (a0 + a1)(b0 + b1) - a0 b0 - a1 b1: three half-size products.
+    const auto first_low = first.first(half);
+    const auto first_high = first.subspan(half);
+    const auto second_low = second.first(half);
+    const auto second_high = second.subspan(half);
+    const Limbs low = multiply<Base>(first_low, second_low);
+    const Limbs high = multiply<Base>(first_high, second_high);
+    Limbs middle = multiply<Base>(add<Base>(first_low, first_high),
+                                  add<Base>(second_low, second_high));
+    subtract_from<Base>(middle, low);
+    subtract_from<Base>(middle, high);
+    add_into<Base>(product, low, 0);
+    add_into<Base>(product, middle, half);
+    add_into<Base>(product, high, 2 * half);
+  }
+  trim(product);
+  return product;
+}
+
+// powers[level] holds From^(2^level) in base To, for every level that
+// splits a number of count digits.
+template <std::uint64_t From, std::uint64_t To>
+std::vector<Limbs> conversion_powers(std::size_t count) {
+  std::vector<Limbs> powers;
+  if (count > 1) {
+    powers.push_back({1});
+    multiply_add<To>(powers.back(), From, 0);
+    const auto levels = static_cast<std::size_t>(std::bit_width(count - 1));
+    while (powers.size() < levels) {
+      powers.push_back(multiply<To>(powers.back(), powers.back()));
+    }
+  }
+  return powers;
+}
+
+// Value of digits in base From, written in base To. The digits above the
+// largest power of two below their count are converted and multiplied by
+// From to that power, then the rest are converted and added.
+template <std::uint64_t From, std::uint64_t To>
+Limbs convert(std::span<const std::uint32_t> digits,
+              const std::vector<Limbs>& powers) {
+  digits = trimmed(digits);
+  if (digits.size() <= CONVERSION_THRESHOLD) {
+    Limbs value;
+    for (auto digit = digits.rbegin(); digit != digits.rend(); ++digit) {
+      multiply_add<To>(value, From, *digit);
+    }
+    return value;
+  }
+  const auto level =
+      static_cast<std::size_t>(std::bit_width(digits.size() - 1) - 1);
+  const std::size_t half = std::size_t{1} << level;
+  const Limbs high =
+      multiply<To>(convert<From, To>(digits.subspan(half), powers),
+                   powers[level]);
+  return add<To>(high, convert<From, To>(digits.first(half), powers));
+}
+
+} // namespace
+
+BigInteger::BigInteger(std::int64_t value) : m_negative(value < 0) {
+  // Negated in unsigned arithmetic, which also covers the minimum.
+  std::uint64_t magnitude = static_cast<std::uint64_t>(value);
+  if (m_negative) {
+    magnitude = 0 - magnitude;
+  }
+  for (; magnitude != 0; magnitude >>= 32) {
+    m_magnitude.push_back(static_cast<std::uint32_t>(magnitude));
+  }
+}
+
+BigInteger::BigInteger(bool negative, std::vector<std::uint32_t> magnitude)
+    : m_magnitude(std::move(magnitude)) {
+  trim(m_magnitude);
+  m_negative = negative && !m_magnitude.empty();
+}
+
+BigInteger BigInteger::from_string(std::string_view text) {
+  const bool negative = !text.empty() && text.front() == '-';
+  if (negative) {
+    text.remove_prefix(1);
+  }
+  if (text.empty() ||
+      !std::all_of(text.begin(), text.end(),
+                   [](char digit) { return digit >= '0' && digit <= '9'; })) {
+    throw std::invalid_argument("Invalid decimal integer");
+  }
+
+  // Base-10^9 digits, least significant first, taken from the end.
+  Limbs decimal((text.size() + DECIMAL_DIGITS - 1) / DECIMAL_DIGITS);
+  for (std::size_t index = 0; index < decimal.size(); ++index) {
+    const std::size_t end = text.size() - index * DECIMAL_DIGITS;
+    const std::size_t begin = end - std::min(end, DECIMAL_DIGITS);
+    std::uint32_t digit = 0;
+    for (std::size_t position = begin; position < end; ++position) {
+      digit = digit * 10 + static_cast<std::uint32_t>(text[position] - '0');
+    }
+    decimal[index] = digit;
+  }
+  const auto powers =
+      conversion_powers<DECIMAL_BASE, BINARY_BASE>(decimal.size());
+  return BigInteger(negative, convert<DECIMAL_BASE, BINARY_BASE>(
+                                  decimal, powers));
+}
+
+std::string BigInteger::to_string() const {
+  const auto powers =
+      conversion_powers<BINARY_BASE, DECIMAL_BASE>(m_magnitude.size());
+  const Limbs decimal =
+      convert<BINARY_BASE, DECIMAL_BASE>(m_magnitude, powers);
+  if (decimal.empty()) {
+    return "0";
+  }
+
+  // The leading base-10^9 digit unpadded, every other one as nine digits.
+  std::string text = (m_negative ? "-" : "") + std::to_string(decimal.back());
+  std::size_t position = text.size();
+  text.resize(position + (decimal.size() - 1) * DECIMAL_DIGITS);
+  for (std::size_t index = decimal.size() - 1; index-- > 0;) {
+    std::uint32_t digit = decimal[index];
+    for (std::size_t offset = DECIMAL_DIGITS; offset-- > 0;) {
+      text[position + offset] = static_cast<char>('0' + digit % 10);
+      digit /= 10;
+    }
+    position += DECIMAL_DIGITS;
+  }
+  return text;
+}
+
+bool BigInteger::is_zero() const { return m_magnitude.empty(); }
+
+bool BigInteger::is_negative() const { return m_negative; }
+
+BigInteger BigInteger::operator-() const {
+  return BigInteger(!m_negative, m_magnitude);
+}
+
+BigInteger operator+(const BigInteger& first, const BigInteger& second) {
+  if (first.m_negative == second.m_negative) {
+    return BigInteger(first.m_negative, add<BINARY_BASE>(first.m_magnitude,
+                                                         second.m_magnitude));
+  }
+  // Opposite signs: the larger magnitude less the smaller, with its sign.
+  const bool first_larger =
+      compare_magnitudes(first.m_magnitude, second.m_magnitude) >= 0;
+  const BigInteger& larger = first_larger ? first : second;
+  const BigInteger& smaller = first_larger ? second : first;
+  Limbs difference = larger.m_magnitude;
+  subtract_from<BINARY_BASE>(difference, smaller.m_magnitude);
+  return BigInteger(larger.m_negative, std::move(difference));
+}
+
+BigInteger operator-(const BigInteger& first, const BigInteger& second) {
+  return first + -second;
+}
+
+BigInteger operator*(const BigInteger& first, const BigInteger& second) {
+  return BigInteger(first.m_negative != second.m_negative,
+                    multiply<BINARY_BASE>(first.m_magnitude,
+                                          second.m_magnitude));
+}
+
+std::strong_ordering operator<=>(const BigInteger& first,
+                                 const BigInteger& second) {
+  if (first.m_negative != second.m_negative) {
+    return second.m_negative <=> first.m_negative;
+  }
+  const std::strong_ordering magnitude =
+      compare_magnitudes(first.m_magnitude, second.m_magnitude);
+  return first.m_negative ? 0 <=> magnitude : magnitude;
+}
+
+// Unit tests (embedded in source file)
+// Disabled in production builds via DOCTEST_CONFIG_DISABLE
+#include <doctest/doctest.h>
+
+// Standard library headers
+#include <limits>
+#include <random>
+
+namespace {
+
+std::string random_digits(std::size_t count, std::uint64_t seed) {
+  std::mt19937_64 random(seed);
+  std::string digits(count, '0');
+  for (char& digit : digits) {
+    digit = static_cast<char>('0' + random() % 10);
+  }
+  digits[0] = static_cast<char>('1' + random() % 9);
+  return digits;
+}
+
+BigInteger power(std::int64_t base, std::size_t exponent) {
+  BigInteger result(1);
+  for (std::size_t step = 0; step < exponent; ++step) {
+    result = result * BigInteger(base);
+  }
+  return result;
+}
+
+} // namespace
+
+TEST_CASE("BigInteger - decimal round trip") {
+  // Arrange - sizes on both sides of the conversion and Karatsuba
+  // thresholds, positive and negative
+  for (std::size_t digits : {1, 9, 10, 18, 19, 100, 577, 1000, 4321, 20000}) {
+    for (bool negative : {false, true}) {
+      const std::string text =
+          (negative ? "-" : "") + random_digits(digits, digits);
+
+      // Act
+      const BigInteger value = BigInteger::from_string(text);
+
+      // Assert
+      CHECK(value.to_string() == text);
+      CHECK(value.is_negative() == negative);
+    }
+  }
+}
+
+TEST_CASE("BigInteger - conversion agrees with arithmetic") {
+  SUBCASE("powers of ten") {
+    for (std::size_t exponent : {0, 1, 9, 10, 300, 2000}) {
+      // Act
+      const BigInteger value = power(10, exponent);
+
+      // Assert
+      CHECK(value.to_string() == "1" + std::string(exponent, '0'));
+      CHECK(BigInteger::from_string("1" + std::string(exponent, '0')) ==
+            value);
+    }
+  }
+
+  SUBCASE("powers of two") {
+    // Act
+    const BigInteger value = power(2, 200);
+
+    // Assert
+    CHECK(value.to_string() ==
+          "1606938044258990275541962092341162602522202993782792835301376");
+    CHECK(power(2, 64) - BigInteger(1) ==
+          BigInteger::from_string("18446744073709551615"));
+  }
+
+  SUBCASE("int64 values") {
+    // Arrange
+    const std::int64_t values[] = {0, 7, -7, 1000000000, -4294967296,
+                                   std::numeric_limits<std::int64_t>::max(),
+                                   std::numeric_limits<std::int64_t>::min()};
+
+    for (std::int64_t value : values) {
+      // Act & Assert
+      CHECK(BigInteger(value).to_string() == std::to_string(value));
+      CHECK(BigInteger::from_string(std::to_string(value)) ==
+            BigInteger(value));
+    }
+  }
+}
+
+TEST_CASE("BigInteger - arithmetic") {
+  // Arrange - operands long enough for Karatsuba, balanced and not
+  const BigInteger first = BigInteger::from_string(random_digits(3000, 1));
+  const BigInteger second = BigInteger::from_string(random_digits(2500, 2));
+  const BigInteger small = BigInteger::from_string(random_digits(400, 3));
+  const BigInteger one(1);
+
+  SUBCASE("products") {
+    // Act & Assert - (a + 1)(a - 1) = a^2 - 1 and distributivity
+    CHECK((first + one) * (first - one) == first * first - one);
+    CHECK(first * (second + small) == first * second + first * small);
+    CHECK((first * second) * small == first * (second * small));
+    CHECK(power(10, 1500) * power(10, 2500) == power(10, 4000));
+  }
+
+  SUBCASE("signs") {
+    // Act & Assert
+    CHECK((first - first).is_zero());
+    CHECK(!(first - first).is_negative());
+    CHECK((small - first).is_negative());
+    CHECK(small - first == -(first - small));
+    CHECK((-first) * (-second) == first * second);
+    CHECK(((-first) * second).is_negative());
+    CHECK(BigInteger(-5) + BigInteger(3) == BigInteger(-2));
+    CHECK(BigInteger(-5) - BigInteger(-8) == BigInteger(3));
+  }
+
+  SUBCASE("ordering") {
+    // Act & Assert
+    CHECK(small < first);
+    CHECK(-first < -small);
+    CHECK(-small < BigInteger(0));
+    CHECK(BigInteger(0) == -BigInteger(0));
+    CHECK(BigInteger::from_string("-0") == BigInteger(0));
+    CHECK(BigInteger::from_string("000123") == BigInteger(123));
+  }
+}
+
+TEST_CASE("BigInteger - invalid strings throw") {
+  // Act & Assert
+  for (std::string_view text : {"", "-", "12a", "+5", " 1", "1.0", "--1"}) {
+    CHECK_THROWS_AS(BigInteger::from_string(text), std::invalid_argument);
+  }
+}
@@ -1,9 +1,124 @@
 // First-party headers
 #include "calculator/calculator.h"
+#include "probes.h"
 
 // Standard library headers
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <climits>
+#include <cstdint>
 #include <stdexcept>
 
+CALCULATOR_PROBE_SEMAPHORE(divide__by__zero);
+
+namespace {
+
+// Independent GCDs the batch variants advance together.
+constexpr std::size_t GCD_LANES = 4;
+
+// Above every magnitude's lowest set bit, so countr_zero of a value or'ed
+// with it is defined for zero and never shifts by 32.
+constexpr std::uint32_t HIGH_BIT = std::uint32_t{1} << 31;
+
+std::uint32_t magnitude(int value) {
+  // Negated in unsigned arithmetic, which also covers INT_MIN.
+  const auto bits = static_cast<std::uint32_t>(value);
+  return value < 0 ? 0u - bits : bits;
+}
+
+// Stein's binary GCD on Lanes pairs at once, stripping whole runs of
+// trailing zeros with countr_zero instead of dividing. first stays odd and
+// second becomes the even difference of two odd values. The minimum and
+// the absolute difference come from the sign of a 64-bit difference rather
+// than comparisons, which compilers turn into unpredictable branches. A
+// lane is done when second reaches zero: its odd part is then taken to be
+// first, so the difference stays zero. The loop runs until every lane is
+// done, so the lanes' dependency chains overlap and only the loop exit is
+// a branch to mispredict.
+template <std::size_t Lanes>
+void binary_gcd(const std::uint32_t* first_values,
+                const std::uint32_t* second_values, std::uint32_t* results) {
+  std::array<std::uint32_t, Lanes> first;
+  std::array<std::uint32_t, Lanes> second;
+  std::array<int, Lanes> shift;
+  for (std::size_t lane = 0; lane < Lanes; ++lane) {
+    // gcd(0, x) = x: start from the nonzero value when there is one.
+    const std::uint32_t start =
+        first_values[lane] != 0 ? first_values[lane] : second_values[lane];
+    shift[lane] =
+        std::countr_zero(first_values[lane] | second_values[lane] | HIGH_BIT);
+    first[lane] = start >> std::countr_zero(start | HIGH_BIT);
+    second[lane] = first_values[lane] != 0 ? second_values[lane] : 0;
+  }
+  for (std::uint32_t pending = 1; pending != 0;) {
+    pending = 0;
+    for (std::size_t lane = 0; lane < Lanes; ++lane) {
+      const std::uint32_t shifted =
+          second[lane] >> std::countr_zero(second[lane] | HIGH_BIT);
+      const std::uint32_t done = 0u - static_cast<std::uint32_t>(shifted == 0);
+      const std::uint32_t odd = shifted | (first[lane] & done);
+      const std::int64_t difference =
+          std::int64_t{odd} - std::int64_t{first[lane]};
+      const std::int64_t sign = difference >> 63;
+      first[lane] += static_cast<std::uint32_t>(difference & sign);
+      second[lane] = static_cast<std::uint32_t>((difference ^ sign) - sign);
+      pending |= second[lane];
+    }
+  }
+  for (std::size_t lane = 0; lane < Lanes; ++lane) {
+    results[lane] = first[lane] << shift[lane];
+  }
+}
+
+// Least common multiple from the GCD, in 64 bits so that the product
+// cannot wrap; a zero GCD means both values are zero and so is the LCM.
+std::uint64_t lcm_from_gcd(std::uint32_t first, std::uint32_t second,
+                           std::uint32_t gcd) {
+  return std::uint64_t{first / (gcd + (gcd == 0 ? 1u : 0u))} * second;
+}
+
+void check_spans(std::size_t first_count, std::size_t second_count,
+                 std::size_t result_count) {
+  if (first_count != second_count) {
+    throw std::invalid_argument("Operand counts do not match");
+  }
+  if (result_count < first_count) {
+    throw std::invalid_argument("Missing result values");
+  }
+}
+
+// Calls finish(index, first, second, gcd) for every pair, GCD_LANES at a
+// time, after both operands of the group are read.
+template <typename Finish>
+void batch_gcd(std::span<const int> first_values,
+               std::span<const int> second_values, const Finish& finish) {
+  const std::size_t count = first_values.size();
+  std::size_t index = 0;
+  auto run = [&]<std::size_t Lanes>() {
+    std::array<std::uint32_t, Lanes> first;
+    std::array<std::uint32_t, Lanes> second;
+    std::array<std::uint32_t, Lanes> gcds;
+    for (std::size_t lane = 0; lane < Lanes; ++lane) {
+      first[lane] = magnitude(first_values[index + lane]);
+      second[lane] = magnitude(second_values[index + lane]);
+    }
+    binary_gcd<Lanes>(first.data(), second.data(), gcds.data());
+    for (std::size_t lane = 0; lane < Lanes; ++lane) {
+      finish(index + lane, first[lane], second[lane], gcds[lane]);
+    }
+    index += Lanes;
+  };
+  while (index + GCD_LANES <= count) {
+    run.template operator()<GCD_LANES>();
+  }
+  while (index < count) {
+    run.template operator()<1>();
+  }
+}
+
+} // namespace
+
 int Calculator::add(int first_value, int second_value) {
   return first_value + second_value;
 }
@@ -18,17 +133,80 @@ int Calculator::multiply(int first_value, int second_value) {
 
 double Calculator::divide(int first_value, int second_value) {
   if (second_value == 0) {
+    CALCULATOR_PROBE0(divide__by__zero);
     throw std::invalid_argument("Division by zero");
   }
 
   return static_cast<double>(first_value) / second_value;
 }
 
+int Calculator::gcd(int first_value, int second_value) {
+  const std::uint32_t first = magnitude(first_value);
+  const std::uint32_t second = magnitude(second_value);
+  std::uint32_t result = 0;
+  binary_gcd<1>(&first, &second, &result);
+  if (result > INT_MAX) {
+    throw std::overflow_error("GCD overflows int");
+  }
+  return static_cast<int>(result);
+}
+
+int Calculator::lcm(int first_value, int second_value) {
+  const std::uint32_t first = magnitude(first_value);
+  const std::uint32_t second = magnitude(second_value);
+  std::uint32_t gcd = 0;
+  binary_gcd<1>(&first, &second, &gcd);
+  const std::uint64_t result = lcm_from_gcd(first, second, gcd);
+  if (result > INT_MAX) {
+    throw std::overflow_error("LCM overflows int");
+  }
+  return static_cast<int>(result);
+}
+
+void Calculator::gcd(std::span<const int> first_values,
+                     std::span<const int> second_values,
+                     std::span<int> results) {
+  check_spans(first_values.size(), second_values.size(), results.size());
+  bool overflow = false;
+  batch_gcd(first_values, second_values,
+            [&](std::size_t index, std::uint32_t, std::uint32_t,
+                std::uint32_t gcd) {
+              overflow |= gcd > INT_MAX;
+              results[index] = static_cast<int>(gcd);
+            });
+  if (overflow) {
+    throw std::overflow_error("GCD overflows int");
+  }
+}
+
+void Calculator::lcm(std::span<const int> first_values,
+                     std::span<const int> second_values,
+                     std::span<int> results) {
+  check_spans(first_values.size(), second_values.size(), results.size());
+  bool overflow = false;
+  batch_gcd(first_values, second_values,
+            [&](std::size_t index, std::uint32_t first, std::uint32_t second,
+                std::uint32_t gcd) {
+              const std::uint64_t lcm = lcm_from_gcd(first, second, gcd);
+              overflow |= lcm > INT_MAX;
+              results[index] = static_cast<int>(lcm);
+            });
+  if (overflow) {
+    throw std::overflow_error("LCM overflows int");
+  }
+}
+
 // Unit tests (embedded in source file)
 // Disabled in production builds via DOCTEST_CONFIG_DISABLE
 #define DOCTEST_CONFIG_IMPLEMENTATION_IN_DLL
 #include <doctest/doctest.h>
 
+// Standard library headers
+#include <limits>
+#include <numeric>
+#include <random>
+#include <vector>
+
 TEST_CASE("Calculator - addition operations") {
   Calculator calculator;
 
@@ -210,3 +388,137 @@ TEST_CASE("Calculator - division operations") {
                     std::invalid_argument);
   }
 }
+
+TEST_CASE("Calculator - gcd and lcm operations") {
+  Calculator calculator;
+
+  SUBCASE("gcd of positive numbers") {
+    // Arrange
+    int first_value = 84;
+    int second_value = 36;
+    int expected_gcd = 12;
+
+    // Act
+    int result = calculator.gcd(first_value, second_value);
+
+    // Assert
+    CHECK(result == expected_gcd);
+  }
+
+  SUBCASE("gcd and lcm use magnitudes") {
+    // Act & Assert
+    CHECK(calculator.gcd(-84, 36) == 12);
+    CHECK(calculator.gcd(84, -36) == 12);
+    CHECK(calculator.lcm(-4, 6) == 12);
+    CHECK(calculator.lcm(-4, -6) == 12);
+  }
+
+  SUBCASE("zero operands") {
+    // Act & Assert
+    CHECK(calculator.gcd(0, 0) == 0);
+    CHECK(calculator.gcd(0, -7) == 7);
+    CHECK(calculator.gcd(40, 0) == 40);
+    CHECK(calculator.lcm(0, 9) == 0);
+    CHECK(calculator.lcm(0, 0) == 0);
+  }
+
+  SUBCASE("extreme values") {
+    // Arrange
+    int minimum = std::numeric_limits<int>::min();
+    int maximum = std::numeric_limits<int>::max();
+
+    // Act & Assert
+    CHECK(calculator.gcd(minimum, 6) == 2);
+    CHECK(calculator.gcd(minimum, maximum) == 1);
+    CHECK(calculator.gcd(maximum, maximum) == maximum);
+    CHECK(calculator.lcm(maximum, 1) == maximum);
+    CHECK(calculator.lcm(1 << 30, 2) == 1 << 30);
+  }
+
+  SUBCASE("results beyond int throw") {
+    // Arrange
+    int minimum = std::numeric_limits<int>::min();
+
+    // Act & Assert
+    CHECK_THROWS_AS(calculator.gcd(minimum, 0), std::overflow_error);
+    CHECK_THROWS_AS(calculator.gcd(minimum, minimum), std::overflow_error);
+    CHECK_THROWS_AS(calculator.lcm(65536, 65537), std::overflow_error);
+    CHECK_THROWS_AS(calculator.lcm(minimum, 1), std::overflow_error);
+  }
+}
+
+TEST_CASE("Calculator - batch gcd and lcm operations") {
+  Calculator calculator;
+
+  // Arrange - random pairs sharing random factors, a count that leaves a
+  // partial group, and zeros and negatives mixed in
+  std::mt19937 random(5);
+  std::uniform_int_distribution<int> factor_of(1, 3000);
+  std::uniform_int_distribution<int> value_of(-1000, 1000);
+  std::vector<int> first_values(1003);
+  std::vector<int> second_values(first_values.size());
+  for (std::size_t index = 0; index < first_values.size(); ++index) {
+    const int common = factor_of(random);
+    first_values[index] = common * value_of(random);
+    second_values[index] = common * value_of(random);
+  }
+  std::vector<int> results(first_values.size());
+
+  SUBCASE("gcd matches std::gcd") {
+    // Act
+    calculator.gcd(first_values, second_values, results);
+
+    // Assert
+    for (std::size_t index = 0; index < results.size(); ++index) {
+      CHECK(results[index] == std::gcd(first_values[index],
+                                       second_values[index]));
+    }
+  }
+
+  SUBCASE("lcm matches std::lcm in 64 bits") {
+    // Arrange - factors small enough for every LCM to fit
+    for (int& value : second_values) {
+      value %= 512;
+    }
+
+    // Act
+    calculator.lcm(first_values, second_values, results);
+
+    // Assert
+    for (std::size_t index = 0; index < results.size(); ++index) {
+      CHECK(results[index] ==
+            std::lcm(std::int64_t{first_values[index]},
+                     std::int64_t{second_values[index]}));
+    }
+  }
+
+  SUBCASE("results may alias the inputs") {
+    // Arrange
+    std::vector<int> values = {12, -18, 0, 7, 100};
+    std::vector<int> divisors = {8, 27, 5, 0, 75};
+
+    // Act
+    calculator.gcd(values, divisors, values);
+
+    // Assert
+    CHECK(values == std::vector<int>{4, 9, 5, 7, 25});
+  }
+
+  SUBCASE("invalid spans and overflow throw") {
+    // Arrange
+    std::vector<int> short_results(3);
+    std::vector<int> overflowing = {1, 2, 3, 4, 5, 65536};
+    std::vector<int> coprime = {1, 1, 1, 1, 1, 65537};
+    std::vector<int> overflow_results(overflowing.size());
+
+    // Act & Assert
+    CHECK_THROWS_AS(calculator.gcd(first_values, second_values, short_results),
+                    std::invalid_argument);
+    CHECK_THROWS_AS(calculator.lcm(first_values,
+                                   std::span<const int>(coprime), results),
+                    std::invalid_argument);
+    CHECK_THROWS_AS(calculator.lcm(overflowing, coprime, overflow_results),
+                    std::overflow_error);
+    CHECK(overflow_results[0] == 1);
+  }
+}
@@ -0,0 +1,160 @@
+// First-party headers
+#include "calculator/calculator_backend.h"
+
+static_assert(CalculatorBackend<Calculator>);
+static_assert(CalculatorBackend<WrappingBackend>);
+static_assert(CalculatorBackend<CountingBackend<>>);
+static_assert(CalculatorBackend<AnyCalculator>);
+
+AnyCalculator::AnyCalculator() : AnyCalculator(Calculator()) {}
+
+AnyCalculator::AnyCalculator(std::unique_ptr<ICalculator> engine)
+    : m_engine(std::move(engine)) {
+  if (!m_engine) {
+    throw std::invalid_argument("Missing calculator engine");
+  }
+}
+
+// Unit tests (embedded in source file)
+// Disabled in production builds via DOCTEST_CONFIG_DISABLE
+#include <doctest/doctest.h>
+
+// Standard library headers
+#include <climits>
+#include <vector>
+
+namespace {
+
+// Operands of every sign, with a zero divisor last.
+const std::vector<int> FIRST_VALUES = {7, -12, 100000, -3, 0, 0};
+const std::vector<int> SECOND_VALUES = {3, 5, -7, -4, 9, 0};
+
+// Checks every operation of calculator against Calculator's.
+template <typename Engine>
+void check_matches_calculator(BasicCalculator<Engine>& calculator) {
+  Calculator reference;
+  const std::size_t count = FIRST_VALUES.size() - 1;
+  std::vector<int> sums(count);
+  std::vector<int> differences(count);
+  std::vector<int> products(count);
+  std::vector<double> quotients(count);
+  const std::span<const int> first(FIRST_VALUES.data(), count);
+  const std::span<const int> second(SECOND_VALUES.data(), count);
+
+  calculator.add(first, second, sums);
+  calculator.subtract(first, second, differences);
+  calculator.multiply(first, second, products);
+  calculator.divide(first, second, quotients);
+
+  for (std::size_t index = 0; index < count; ++index) {
+    const int first_value = first[index];
+    const int second_value = second[index];
+    CHECK(calculator.add(first_value, second_value) ==
+          reference.add(first_value, second_value));
+    CHECK(calculator.divide(first_value, second_value) ==
+          reference.divide(first_value, second_value));
+    CHECK(sums[index] == reference.add(first_value, second_value));
+    CHECK(differences[index] ==
+          reference.subtract(first_value, second_value));
+    CHECK(products[index] == reference.multiply(first_value, second_value));
+    CHECK(quotients[index] == reference.divide(first_value, second_value));
+  }
+  CHECK_THROWS_AS(calculator.divide(1, 0), std::invalid_argument);
+}
+
+} // namespace
+
+TEST_CASE("BasicCalculator - every engine matches Calculator") {
+  SUBCASE("Calculator") {
+    // Arrange
+    BasicCalculator<Calculator> calculator;
+
+    // Act & Assert
+    check_matches_calculator(calculator);
+  }
+
+  SUBCASE("WrappingBackend") {
+    // Arrange
+    BasicCalculator<WrappingBackend> calculator;
+
+    // Act & Assert
+    check_matches_calculator(calculator);
+  }
+
+  SUBCASE("CountingBackend") {
+    // Arrange
+    BasicCalculator<CountingBackend<WrappingBackend>> calculator;
+
+    // Act & Assert
+    check_matches_calculator(calculator);
+  }
+
+  SUBCASE("AnyCalculator over each engine") {
+    // Arrange
+    BasicCalculator<AnyCalculator> default_engine;
+    BasicCalculator<AnyCalculator> wrapping{AnyCalculator(WrappingBackend())};
+
+    // Act & Assert
+    check_matches_calculator(default_engine);
+    check_matches_calculator(wrapping);
+  }
+}
+
+TEST_CASE("BasicCalculator - batches, counting and errors") {
+  SUBCASE("each element is one backend call") {
+    // Arrange
+    BasicCalculator<CountingBackend<>> calculator;
+    const std::vector<int> values = {1, 2, 3, 4};
+    std::vector<int> results(4);
+
+    // Act
+    calculator.multiply(values, values, results);
+    calculator.add(1, 2);
+
+    // Assert
+    CHECK(results == std::vector<int>{1, 4, 9, 16});
+    CHECK(calculator.backend().operation_count() == 5);
+  }
+
+  SUBCASE("WrappingBackend wraps on overflow") {
+    // Arrange
+    BasicCalculator<WrappingBackend> calculator;
+
+    // Act & Assert
+    CHECK(calculator.add(INT_MAX, 1) == INT_MIN);
+    CHECK(calculator.subtract(INT_MIN, 1) == INT_MAX);
+    CHECK(calculator.multiply(46341, 46341) == -2147479015);
+    CHECK(calculator.multiply(INT_MIN, -1) == INT_MIN);
+  }
+
+  SUBCASE("results may alias the inputs") {
+    // Arrange
+    BasicCalculator<WrappingBackend> calculator;
+    std::vector<int> values = {1, 2, 3};
+
+    // Act
+    calculator.add(values, values, values);
+
+    // Assert
+    CHECK(values == std::vector<int>{2, 4, 6});
+  }
+
+  SUBCASE("invalid spans, zero divisors and missing engines") {
+    // Arrange
+    BasicCalculator<WrappingBackend> calculator;
+    std::vector<double> quotients(FIRST_VALUES.size());
+    std::vector<int> results(2);
+
+    // Act & Assert
+    CHECK_THROWS_AS(calculator.divide(FIRST_VALUES, SECOND_VALUES, quotients),
+                    std::invalid_argument);
+    CHECK(quotients[0] == 7.0 / 3.0);
+    CHECK_THROWS_AS(calculator.add(FIRST_VALUES, SECOND_VALUES, results),
+                    std::invalid_argument);
+    CHECK_THROWS_AS(calculator.add(std::span(FIRST_VALUES).first(2),
+                                   SECOND_VALUES, results),
+                    std::invalid_argument);
+    CHECK_THROWS_AS(AnyCalculator(std::unique_ptr<ICalculator>()),
+                    std::invalid_argument);
+  }
+}
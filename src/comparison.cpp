@@ -0,0 +1,746 @@
+// First-party headers
+#include "calculator/comparison.h"
+
+// Standard library headers
+#include <array>
+#include <bit>
+#include <stdexcept>
+#include <type_traits>
+
+namespace {
+
+constexpr std::size_t WORD_BITS = 64;
+
+// Unsigned lanes as wide as each value type. Masks are built and applied in
+// these, so the compare and select loops keep one lane per value.
+template <typename T> struct LaneTraits;
+
+template <> struct LaneTraits<int> {
+  using Bits = std::uint32_t;
+};
+
+template <> struct LaneTraits<double> {
+  using Bits = std::uint64_t;
+};
+
+template <typename T> using LaneBits = typename LaneTraits<T>::Bits;
+
+// LANE_BIT<Bits>[k] is 1 << k. Reading the shifted bit from a table rather
+// than shifting by the loop counter keeps the loops vectorizable on targets
+// without per-lane variable shifts, such as baseline x86-64.
+template <typename Bits>
+constexpr std::array<Bits, sizeof(Bits) * 8> LANE_BIT = [] {
+  std::array<Bits, sizeof(Bits) * 8> bits{};
+  for (std::size_t bit = 0; bit < bits.size(); ++bit) {
+    bits[bit] = Bits{1} << bit;
+  }
+  return bits;
+}();
+
+std::size_t word_count(std::size_t size) {
+  return (size + WORD_BITS - 1) / WORD_BITS;
+}
+
+void check_operands(std::size_t first_count, std::size_t second_count) {
+  if (first_count != second_count) {
+    throw std::invalid_argument("Operand counts do not match");
+  }
+}
+
+void check_results(std::size_t count, std::size_t result_count) {
+  if (result_count < count) {
+    throw std::invalid_argument("Missing result values");
+  }
+}
+
+template <Comparison Operation, typename T>
+inline bool compared(T first_value, T second_value) {
+  if constexpr (Operation == Comparison::Equal) {
+    return first_value == second_value;
+  } else if constexpr (Operation == Comparison::NotEqual) {
+    return first_value != second_value;
+  } else if constexpr (Operation == Comparison::Less) {
+    return first_value < second_value;
+  } else if constexpr (Operation == Comparison::LessEqual) {
+    return first_value <= second_value;
+  } else if constexpr (Operation == Comparison::Greater) {
+    return first_value > second_value;
+  } else {
+    return first_value >= second_value;
+  }
+}
+
+// Fills words from first[i] op second(i). Each full word is built as OR
+// reductions over groups of lanes, one group per LaneBits<T> width, and the
+// partial last word bit by bit.
+template <Comparison Operation, typename T, typename Second>
+void fill_words(const T* first, const Second& second, std::size_t count,
+                std::uint64_t* words) {
+  using Bits = LaneBits<T>;
+  constexpr std::size_t GROUP_BITS = sizeof(Bits) * 8;
+  std::size_t position = 0;
+  for (; position + WORD_BITS <= count; position += WORD_BITS) {
+    std::uint64_t word = 0;
+    for (std::size_t group = 0; group < WORD_BITS; group += GROUP_BITS) {
+      Bits bits = 0;
+      for (std::size_t bit = 0; bit < GROUP_BITS; ++bit) {
+        const std::size_t index = position + group + bit;
+        bits |= LANE_BIT<Bits>[bit] &
+                (Bits{0} - static_cast<Bits>(compared<Operation>(
+                               first[index], second(index))));
+      }
+      word |= static_cast<std::uint64_t>(bits) << group;
+    }
+    words[position / WORD_BITS] = word;
+  }
+  if (position < count) {
+    std::uint64_t word = 0;
+    for (std::size_t bit = 0; position + bit < count; ++bit) {
+      const std::size_t index = position + bit;
+      word |= static_cast<std::uint64_t>(
+                  compared<Operation>(first[index], second(index)))
+              << bit;
+    }
+    words[position / WORD_BITS] = word;
+  }
+}
+
+// Second is a callable from position to the right-hand operand, so a span
+// and a constant share the loops.
+template <typename T, typename Second>
+void compare(std::span<const T> values, const Second& second,
+             Comparison comparison, Bitmask& results) {
+  results.resize(values.size());
+  const T* first = values.data();
+  std::uint64_t* words = results.words().data();
+  switch (comparison) {
+  case Comparison::Equal:
+    fill_words<Comparison::Equal>(first, second, values.size(), words);
+    return;
+  case Comparison::NotEqual:
+    fill_words<Comparison::NotEqual>(first, second, values.size(), words);
+    return;
+  case Comparison::Less:
+    fill_words<Comparison::Less>(first, second, values.size(), words);
+    return;
+  case Comparison::LessEqual:
+    fill_words<Comparison::LessEqual>(first, second, values.size(), words);
+    return;
+  case Comparison::Greater:
+    fill_words<Comparison::Greater>(first, second, values.size(), words);
+    return;
+  case Comparison::GreaterEqual:
+    fill_words<Comparison::GreaterEqual>(first, second, values.size(), words);
+    return;
+  }
+}
+
+template <typename T>
+void compare_spans(std::span<const T> first_values,
+                   std::span<const T> second_values, Comparison comparison,
+                   Bitmask& results) {
+  check_operands(first_values.size(), second_values.size());
+  const T* second = second_values.data();
+  compare(
+      first_values,
+      [second](std::size_t position) { return second[position]; },
+      comparison, results);
+}
+
+template <typename T>
+void compare_operand(std::span<const T> values, T operand,
+                     Comparison comparison, Bitmask& results) {
+  compare(
+      values, [operand](std::size_t) { return operand; }, comparison,
+      results);
+}
+
+// Int abs and negate go through unsigned arithmetic, which wraps where int
+// overflow would be undefined; double abs clears the sign bit.
+template <typename T> inline T absolute(T value) {
+  if constexpr (std::is_same_v<T, int>) {
+    const auto bits = static_cast<std::uint32_t>(value);
+    return static_cast<int>(value < 0 ? 0u - bits : bits);
+  } else {
+    return std::bit_cast<double>(std::bit_cast<std::uint64_t>(value) &
+                                 ~(std::uint64_t{1} << 63));
+  }
+}
+
+template <typename T> inline T negated(T value) {
+  if constexpr (std::is_same_v<T, int>) {
+    return static_cast<int>(0u - static_cast<std::uint32_t>(value));
+  } else {
+    return -value;
+  }
+}
+
+// Written as the ternaries of std::min and std::max, which compilers turn
+// into vector min, max or blend instructions.
+template <typename T> inline T minimum(T first_value, T second_value) {
+  return second_value < first_value ? second_value : first_value;
+}
+
+template <typename T> inline T maximum(T first_value, T second_value) {
+  return first_value < second_value ? second_value : first_value;
+}
+
+// The element functions are template arguments, as in the elementary
+// functions, so that they are inlined and the loops vectorize.
+template <auto Element, typename T>
+void apply_elementwise(std::span<const T> values, std::span<T> results) {
+  check_results(values.size(), results.size());
+  const T* input = values.data();
+  T* output = results.data();
+  for (std::size_t index = 0; index < values.size(); ++index) {
+    output[index] = Element(input[index]);
+  }
+}
+
+template <auto Element, typename T>
+void apply_pairwise(std::span<const T> first_values,
+                    std::span<const T> second_values, std::span<T> results) {
+  check_operands(first_values.size(), second_values.size());
+  check_results(first_values.size(), results.size());
+  const T* first = first_values.data();
+  const T* second = second_values.data();
+  T* output = results.data();
+  for (std::size_t index = 0; index < first_values.size(); ++index) {
+    output[index] = Element(first[index], second[index]);
+  }
+}
+
+template <typename T>
+void clamp(std::span<const T> values, T low, T high, std::span<T> results) {
+  if (!(low <= high)) {
+    throw std::invalid_argument("Clamp bounds are reversed");
+  }
+  check_results(values.size(), results.size());
+  const T* input = values.data();
+  T* output = results.data();
+  for (std::size_t index = 0; index < values.size(); ++index) {
+    output[index] = minimum(maximum(input[index], low), high);
+  }
+}
+
+// Blends through lane masks of all ones or all zeros, built like the
+// compare words from LANE_BIT, which vectorizes on every target where a
+// conditional on the extracted bit does not.
+template <typename T>
+void select(const Bitmask& mask, std::span<const T> if_set,
+            std::span<const T> if_clear, std::span<T> results) {
+  using Bits = LaneBits<T>;
+  constexpr std::size_t GROUP_BITS = sizeof(Bits) * 8;
+  check_operands(if_set.size(), if_clear.size());
+  check_operands(mask.size(), if_set.size());
+  check_results(if_set.size(), results.size());
+  const std::uint64_t* words = mask.words().data();
+  const T* set = if_set.data();
+  const T* clear = if_clear.data();
+  T* output = results.data();
+  const auto blend = [&](std::size_t index, Bits lane) {
+    output[index] =
+        std::bit_cast<T>(static_cast<Bits>(
+            (std::bit_cast<Bits>(set[index]) & lane) |
+            (std::bit_cast<Bits>(clear[index]) & ~lane)));
+  };
+  std::size_t position = 0;
+  for (; position + WORD_BITS <= mask.size(); position += WORD_BITS) {
+    const std::uint64_t word = words[position / WORD_BITS];
+    for (std::size_t group = 0; group < WORD_BITS; group += GROUP_BITS) {
+      const auto bits = static_cast<Bits>(word >> group);
+      for (std::size_t bit = 0; bit < GROUP_BITS; ++bit) {
+        blend(position + group + bit,
+              Bits{0} - static_cast<Bits>((bits & LANE_BIT<Bits>[bit]) != 0));
+      }
+    }
+  }
+  for (; position < mask.size(); ++position) {
+    blend(position, mask.test(position) ? ~Bits{0} : Bits{0});
+  }
+}
+
+} // namespace
+
+Bitmask::Bitmask(std::size_t size, bool value)
+    : m_size(size), m_words(word_count(size), value ? ~std::uint64_t{0} : 0) {
+  if (value && size % WORD_BITS != 0) {
+    m_words.back() &= (std::uint64_t{1} << (size % WORD_BITS)) - 1;
+  }
+}
+
+std::size_t Bitmask::size() const { return m_size; }
+
+bool Bitmask::test(std::size_t position) const {
+  if (position >= m_size) {
+    throw std::out_of_range("Bit position exceeds mask size");
+  }
+  return (m_words[position / WORD_BITS] >> (position % WORD_BITS)) & 1;
+}
+
+void Bitmask::set(std::size_t position, bool value) {
+  if (position >= m_size) {
+    throw std::out_of_range("Bit position exceeds mask size");
+  }
+  const std::uint64_t bit = std::uint64_t{1} << (position % WORD_BITS);
+  std::uint64_t& word = m_words[position / WORD_BITS];
+  word = value ? word | bit : word & ~bit;
+}
+
+std::size_t Bitmask::count() const {
+  std::size_t total = 0;
+  for (const std::uint64_t word : m_words) {
+    total += static_cast<std::size_t>(std::popcount(word));
+  }
+  return total;
+}
+
+void Bitmask::resize(std::size_t size) {
+  if (size < m_size && size % WORD_BITS != 0) {
+    m_words[size / WORD_BITS] &= (std::uint64_t{1} << (size % WORD_BITS)) - 1;
+  }
+  m_words.resize(word_count(size), 0);
+  m_size = size;
+}
+
+Bitmask& Bitmask::operator&=(const Bitmask& other) {
+  check_operands(m_size, other.m_size);
+  for (std::size_t word = 0; word < m_words.size(); ++word) {
+    m_words[word] &= other.m_words[word];
+  }
+  return *this;
+}
+
+Bitmask& Bitmask::operator|=(const Bitmask& other) {
+  check_operands(m_size, other.m_size);
+  for (std::size_t word = 0; word < m_words.size(); ++word) {
+    m_words[word] |= other.m_words[word];
+  }
+  return *this;
+}
+
+void Bitmask::flip() {
+  for (std::uint64_t& word : m_words) {
+    word = ~word;
+  }
+  if (m_size % WORD_BITS != 0) {
+    m_words.back() &= (std::uint64_t{1} << (m_size % WORD_BITS)) - 1;
+  }
+}
+
+std::span<const std::uint64_t> Bitmask::words() const { return m_words; }
+
+std::span<std::uint64_t> Bitmask::words() { return m_words; }
+
+void batch_compare(std::span<const int> first_values,
+                   std::span<const int> second_values, Comparison comparison,
+                   Bitmask& results) {
+  compare_spans(first_values, second_values, comparison, results);
+}
+
+void batch_compare(std::span<const int> values, int operand,
+                   Comparison comparison, Bitmask& results) {
+  compare_operand(values, operand, comparison, results);
+}
+
+void batch_compare(std::span<const double> first_values,
+                   std::span<const double> second_values,
+                   Comparison comparison, Bitmask& results) {
+  compare_spans(first_values, second_values, comparison, results);
+}
+
+void batch_compare(std::span<const double> values, double operand,
+                   Comparison comparison, Bitmask& results) {
+  compare_operand(values, operand, comparison, results);
+}
+
+void batch_min(std::span<const int> first_values,
+               std::span<const int> second_values, std::span<int> results) {
+  apply_pairwise<minimum<int>>(first_values, second_values, results);
+}
+
+void batch_min(std::span<const double> first_values,
+               std::span<const double> second_values,
+               std::span<double> results) {
+  apply_pairwise<minimum<double>>(first_values, second_values, results);
+}
+
+void batch_max(std::span<const int> first_values,
+               std::span<const int> second_values, std::span<int> results) {
+  apply_pairwise<maximum<int>>(first_values, second_values, results);
+}
+
+void batch_max(std::span<const double> first_values,
+               std::span<const double> second_values,
+               std::span<double> results) {
+  apply_pairwise<maximum<double>>(first_values, second_values, results);
+}
+
+void batch_clamp(std::span<const int> values, int low, int high,
+                 std::span<int> results) {
+  clamp(values, low, high, results);
+}
+
+void batch_clamp(std::span<const double> values, double low, double high,
+                 std::span<double> results) {
+  clamp(values, low, high, results);
+}
+
+void batch_abs(std::span<const int> values, std::span<int> results) {
+  apply_elementwise<absolute<int>>(values, results);
+}
+
+void batch_abs(std::span<const double> values, std::span<double> results) {
+  apply_elementwise<absolute<double>>(values, results);
+}
+
+void batch_negate(std::span<const int> values, std::span<int> results) {
+  apply_elementwise<negated<int>>(values, results);
+}
+
+void batch_negate(std::span<const double> values, std::span<double> results) {
+  apply_elementwise<negated<double>>(values, results);
+}
+
+void batch_select(const Bitmask& mask, std::span<const int> if_set,
+                  std::span<const int> if_clear, std::span<int> results) {
+  select(mask, if_set, if_clear, results);
+}
+
+void batch_select(const Bitmask& mask, std::span<const double> if_set,
+                  std::span<const double> if_clear,
+                  std::span<double> results) {
+  select(mask, if_set, if_clear, results);
+}
+
+// Unit tests (embedded in source file)
+// Disabled in production builds via DOCTEST_CONFIG_DISABLE
+#include <doctest/doctest.h>
+
+// Standard library headers
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include <numeric>
+#include <random>
+
+namespace {
+
+// Sizes around the lane group and word boundaries.
+constexpr std::size_t SIZES[] = {0, 1, 5, 31, 32, 33, 63, 64, 65, 1000};
+
+constexpr Comparison COMPARISONS[] = {
+    Comparison::Equal,     Comparison::NotEqual, Comparison::Less,
+    Comparison::LessEqual, Comparison::Greater,  Comparison::GreaterEqual};
+
+template <typename T>
+bool expected_comparison(T first_value, T second_value,
+                         Comparison comparison) {
+  switch (comparison) {
+  case Comparison::Equal:
+    return first_value == second_value;
+  case Comparison::NotEqual:
+    return first_value != second_value;
+  case Comparison::Less:
+    return first_value < second_value;
+  case Comparison::LessEqual:
+    return first_value <= second_value;
+  case Comparison::Greater:
+    return first_value > second_value;
+  case Comparison::GreaterEqual:
+    return first_value >= second_value;
+  }
+  return false;
+}
+
+// Small values, so that equal pairs are common, with the extremes mixed in.
+std::vector<int> random_ints(std::size_t count, std::uint64_t seed) {
+  std::mt19937_64 random(seed);
+  std::vector<int> values(count);
+  for (int& value : values) {
+    value = static_cast<int>(random() % 7) - 3;
+  }
+  if (count > 2) {
+    values[1] = std::numeric_limits<int>::min();
+    values[2] = std::numeric_limits<int>::max();
+  }
+  return values;
+}
+
+std::vector<double> random_doubles(std::size_t count, std::uint64_t seed) {
+  std::vector<double> values(count);
+  const std::vector<int> ints = random_ints(count, seed);
+  std::transform(ints.begin(), ints.end(), values.begin(),
+                 [](int value) { return value * 0.5; });
+  if (count > 4) {
+    values[3] = std::numeric_limits<double>::quiet_NaN();
+    values[4] = -0.0;
+  }
+  return values;
+}
+
+} // namespace
+
+TEST_CASE("Bitmask - bits, counting and logic") {
+  SUBCASE("set, test and count") {
+    // Arrange
+    Bitmask mask(130);
+
+    // Act
+    mask.set(0);
+    mask.set(64);
+    mask.set(129);
+    mask.set(64, false);
+
+    // Assert
+    CHECK(mask.size() == 130);
+    CHECK(mask.test(0));
+    CHECK_FALSE(mask.test(64));
+    CHECK(mask.test(129));
+    CHECK(mask.count() == 2);
+    CHECK(mask.words().size() == 3);
+    CHECK_THROWS_AS(mask.test(130), std::out_of_range);
+    CHECK_THROWS_AS(mask.set(130), std::out_of_range);
+  }
+
+  SUBCASE("bits past the size stay clear") {
+    // Arrange
+    Bitmask ones(70, true);
+    Bitmask cleared(70);
+
+    // Act
+    cleared.flip();
+    ones.resize(65);
+    ones.resize(128);
+
+    // Assert
+    CHECK(cleared == Bitmask(70, true));
+    CHECK(cleared.count() == 70);
+    CHECK(cleared.words()[1] == 0x3f);
+    CHECK(ones.count() == 65);
+    CHECK_FALSE(ones.test(65));
+  }
+
+  SUBCASE("and, or") {
+    // Arrange
+    Bitmask first(100);
+    Bitmask second(100);
+    first.set(3);
+    first.set(99);
+    second.set(99);
+    second.set(50);
+    Bitmask both = first;
+    Bitmask either = first;
+
+    // Act
+    both &= second;
+    either |= second;
+
+    // Assert
+    CHECK(both.count() == 1);
+    CHECK(both.test(99));
+    CHECK(either.count() == 3);
+    CHECK_THROWS_AS(both &= Bitmask(99), std::invalid_argument);
+    CHECK_THROWS_AS(either |= Bitmask(101), std::invalid_argument);
+  }
+}
+
+TEST_CASE("Comparison - batch_compare matches scalar comparisons") {
+  for (std::size_t count : SIZES) {
+    const std::vector<int> first_ints = random_ints(count, 1);
+    const std::vector<int> second_ints = random_ints(count, 2);
+    const std::vector<double> first_doubles = random_doubles(count, 3);
+    const std::vector<double> second_doubles = random_doubles(count, 4);
+    for (Comparison comparison : COMPARISONS) {
+      // Arrange
+      Bitmask int_pairs(5, true);
+      Bitmask int_operand;
+      Bitmask double_pairs;
+      Bitmask double_operand;
+
+      // Act
+      batch_compare(first_ints, second_ints, comparison, int_pairs);
+      batch_compare(first_ints, 1, comparison, int_operand);
+      batch_compare(first_doubles, second_doubles, comparison, double_pairs);
+      batch_compare(first_doubles, 0.5, comparison, double_operand);
+
+      // Assert
+      REQUIRE(int_pairs.size() == count);
+      REQUIRE(double_operand.size() == count);
+      std::size_t matches = 0;
+      for (std::size_t position = 0; position < count; ++position) {
+        const bool pair = expected_comparison(
+            first_ints[position], second_ints[position], comparison);
+        matches += pair ? 1 : 0;
+        CHECK(int_pairs.test(position) == pair);
+        CHECK(int_operand.test(position) ==
+              expected_comparison(first_ints[position], 1, comparison));
+        CHECK(double_pairs.test(position) ==
+              expected_comparison(first_doubles[position],
+                                  second_doubles[position], comparison));
+        CHECK(double_operand.test(position) ==
+              expected_comparison(first_doubles[position], 0.5, comparison));
+      }
+      CHECK(int_pairs.count() == matches);
+    }
+  }
+
+  SUBCASE("mismatched operands") {
+    // Arrange
+    const std::vector<int> values(10);
+    Bitmask results;
+
+    // Act & Assert
+    CHECK_THROWS_AS(batch_compare(values, std::span(values).first(9),
+                                  Comparison::Less, results),
+                    std::invalid_argument);
+  }
+}
+
+TEST_CASE("Comparison - min, max, clamp, abs and negate") {
+  constexpr int INT_MIN_VALUE = std::numeric_limits<int>::min();
+  const double nan = std::numeric_limits<double>::quiet_NaN();
+
+  SUBCASE("ints wrap like Calculator") {
+    // Arrange
+    const std::vector<int> values = random_ints(300, 5);
+    const std::vector<int> others = random_ints(300, 6);
+    std::vector<int> minima(300);
+    std::vector<int> maxima(300);
+    std::vector<int> clamped(300);
+    std::vector<int> magnitudes(300);
+    std::vector<int> negations(300);
+
+    // Act
+    batch_min(values, others, minima);
+    batch_max(values, others, maxima);
+    batch_clamp(values, -2, 1, clamped);
+    batch_abs(values, magnitudes);
+    batch_negate(values, negations);
+
+    // Assert
+    for (std::size_t position = 0; position < values.size(); ++position) {
+      const int value = values[position];
+      CHECK(minima[position] == std::min(value, others[position]));
+      CHECK(maxima[position] == std::max(value, others[position]));
+      CHECK(clamped[position] == std::clamp(value, -2, 1));
+      if (value != INT_MIN_VALUE) {
+        CHECK(magnitudes[position] == std::abs(value));
+        CHECK(negations[position] == -value);
+      }
+    }
+    CHECK(magnitudes[1] == INT_MIN_VALUE);
+    CHECK(negations[1] == INT_MIN_VALUE);
+  }
+
+  SUBCASE("doubles pick like the standard library") {
+    // Arrange
+    const std::vector<double> values = {nan, 1.0, -0.0, -2.5, 7.0};
+    const std::vector<double> others = {1.0, nan, 0.0, 3.0, -7.0};
+    std::vector<double> minima(5);
+    std::vector<double> maxima(5);
+    std::vector<double> clamped(5);
+    std::vector<double> magnitudes(5);
+    std::vector<double> negations(5);
+
+    // Act
+    batch_min(values, others, minima);
+    batch_max(values, others, maxima);
+    batch_clamp(values, -1.0, 2.0, clamped);
+    batch_abs(values, magnitudes);
+    batch_negate(values, negations);
+
+    // Assert
+    CHECK(std::isnan(minima[0]));
+    CHECK(std::isnan(maxima[0]));
+    CHECK(std::isnan(clamped[0]));
+    CHECK(minima[1] == 1.0);
+    CHECK(maxima[1] == 1.0);
+    CHECK(std::signbit(minima[2]));
+    CHECK(std::signbit(maxima[2]));
+    CHECK(minima[3] == -2.5);
+    CHECK(maxima[4] == 7.0);
+    CHECK(std::vector<double>(clamped.begin() + 1, clamped.end()) ==
+          std::vector<double>{1.0, -0.0, -1.0, 2.0});
+    CHECK(std::isnan(magnitudes[0]));
+    CHECK_FALSE(std::signbit(magnitudes[2]));
+    CHECK(magnitudes[3] == 2.5);
+    CHECK(negations[4] == -7.0);
+    CHECK_FALSE(std::signbit(negations[2]));
+  }
+
+  SUBCASE("results may alias the values") {
+    // Arrange
+    std::vector<int> values = {-4, 5, -6};
+
+    // Act
+    batch_abs(values, values);
+
+    // Assert
+    CHECK(values == std::vector<int>{4, 5, 6});
+  }
+
+  SUBCASE("invalid spans and bounds") {
+    // Arrange
+    const std::vector<int> values(4);
+    std::vector<int> results(3);
+    std::vector<double> doubles(4);
+
+    // Act & Assert
+    CHECK_THROWS_AS(batch_abs(values, results), std::invalid_argument);
+    CHECK_THROWS_AS(batch_min(values, std::span(values).first(3),
+                              std::span(results).first(3)),
+                    std::invalid_argument);
+    CHECK_THROWS_AS(batch_clamp(values, 2, 1, results),
+                    std::invalid_argument);
+    CHECK_THROWS_AS(batch_clamp(doubles, 0.0, nan, doubles),
+                    std::invalid_argument);
+  }
+}
+
+TEST_CASE("Comparison - select blends by mask") {
+  SUBCASE("matches the mask bit by bit") {
+    for (std::size_t count : SIZES) {
+      // Arrange
+      const std::vector<int> values = random_ints(count, 7);
+      const std::vector<int> if_set(count, 10);
+      std::vector<int> if_clear(count);
+      std::iota(if_clear.begin(), if_clear.end(), 0);
+      const std::vector<double> doubles_set(count, 0.5);
+      const std::vector<double> doubles_clear(count, -0.5);
+      Bitmask mask;
+      batch_compare(values, 0, Comparison::Greater, mask);
+      std::vector<int> results(count);
+      std::vector<double> double_results(count);
+
+      // Act
+      batch_select(mask, if_set, if_clear, results);
+      batch_select(mask, doubles_set, doubles_clear, double_results);
+
+      // Assert
+      for (std::size_t position = 0; position < count; ++position) {
+        const bool set = values[position] > 0;
+        CHECK(results[position] == (set ? 10 : static_cast<int>(position)));
+        CHECK(double_results[position] == (set ? 0.5 : -0.5));
+      }
+    }
+  }
+
+  SUBCASE("mask and spans must agree") {
+    // Arrange
+    const std::vector<int> values(10);
+    std::vector<int> results(10);
+
+    // Act & Assert
+    CHECK_THROWS_AS(batch_select(Bitmask(9), values, values, results),
+                    std::invalid_argument);
+    CHECK_THROWS_AS(
+        batch_select(Bitmask(10), values, std::span(values).first(9),
+                     std::span(results).first(9)),
+        std::invalid_argument);
+    CHECK_THROWS_AS(batch_select(Bitmask(10), values, values,
+                                 std::span(results).first(9)),
+                    std::invalid_argument);
+  }
+}
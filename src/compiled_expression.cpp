@@ -0,0 +1,136 @@
+// First-party headers
+#include "calculator/compiled_expression.h"
+
+// Standard library headers
+#include <vector>
+
+CompiledExpression::CompiledExpression(const Expression& expression,
+                                       const CompileOptions& options)
+    : m_program(std::span<const Expression>(&expression, 1), options) {}
+
+double CompiledExpression::evaluate(std::span<const double> inputs) const {
+  double result = 0.0;
+  m_program.evaluate(inputs, std::span<double>(&result, 1));
+  return result;
+}
+
+void CompiledExpression::evaluate(
+    std::span<const std::span<const double>> columns,
+    std::span<double> results) const {
+  m_program.evaluate(columns, std::span<const std::span<double>>(&results, 1));
+}
+
+std::size_t CompiledExpression::step_count() const {
+  return m_program.step_count();
+}
+
+std::size_t CompiledExpression::checks_kept() const {
+  return m_program.checks_kept();
+}
+
+std::size_t CompiledExpression::checks_removed() const {
+  return m_program.checks_removed();
+}
+
+// Unit tests (embedded in source file)
+// Disabled in production builds via DOCTEST_CONFIG_DISABLE
+#include <doctest/doctest.h>
+
+TEST_CASE("CompiledExpression - optimization passes") {
+  SUBCASE("constant subtrees are folded away") {
+    // Arrange - x * (2 + 3)
+    Expression expression;
+    NodeId x = expression.input(0);
+    NodeId five = expression.add(expression.constant(2.0),
+                                 expression.constant(3.0));
+    expression.multiply(x, five);
+
+    // Act
+    CompiledExpression compiled(expression);
+
+    // Assert
+    CHECK(compiled.step_count() == 1);
+    CHECK(compiled.evaluate(std::vector<double>{4.0}) ==
+          doctest::Approx(20.0));
+  }
+
+  SUBCASE("commuted duplicates are merged") {
+    // Arrange - (x + y) * (y + x)
+    Expression expression;
+    NodeId x = expression.input(0);
+    NodeId y = expression.input(1);
+    expression.multiply(expression.add(x, y), expression.add(y, x));
+
+    // Act
+    CompiledExpression compiled(expression);
+
+    // Assert
+    CHECK(compiled.step_count() == 2);
+    CHECK(compiled.evaluate(std::vector<double>{1.0, 2.0}) ==
+          doctest::Approx(9.0));
+  }
+
+  SUBCASE("nodes the result does not use are dropped") {
+    // Arrange
+    Expression expression;
+    NodeId x = expression.input(0);
+    expression.multiply(x, x);
+    expression.add(x, expression.constant(1.0));
+
+    // Act
+    CompiledExpression compiled(expression);
+
+    // Assert
+    CHECK(compiled.step_count() == 1);
+  }
+
+  SUBCASE("constant division by zero is not folded") {
+    // Arrange
+    Expression expression;
+    expression.divide(expression.constant(1.0), expression.constant(0.0));
+
+    // Act
+    CompiledExpression compiled(expression);
+
+    // Assert
+    CHECK(compiled.step_count() == 1);
+    CHECK_THROWS_AS(compiled.evaluate(std::vector<double>{}),
+                    std::invalid_argument);
+  }
+}
+
+TEST_CASE("CompiledExpression - block evaluation") {
+  SUBCASE("partial trailing blocks are evaluated") {
+    // Arrange - x / y over more rows than one block
+    Expression expression;
+    expression.divide(expression.input(0), expression.input(1));
+    CompiledExpression compiled(expression);
+    std::vector<double> x(CompiledExpression::BLOCK_SIZE + 3, 6.0);
+    std::vector<double> y(x.size(), 4.0);
+    std::vector<std::span<const double>> columns = {x, y};
+    std::vector<double> results(x.size());
+
+    // Act
+    compiled.evaluate(columns, results);
+
+    // Assert
+    CHECK(results.front() == doctest::Approx(1.5));
+    CHECK(results.back() == doctest::Approx(1.5));
+  }
+
+  SUBCASE("expression reduced to an input copies the column") {
+    // Arrange
+    Expression expression;
+    expression.input(0);
+    CompiledExpression compiled(expression);
+    std::vector<double> x = {1.0, 2.0, 3.0};
+    std::vector<std::span<const double>> columns = {x};
+    std::vector<double> results(x.size());
+
+    // Act
+    compiled.evaluate(columns, results);
+
+    // Assert
+    CHECK(results == x);
+  }
+}
@@ -0,0 +1,898 @@
+// First-party headers
+#include "calculator/compiled_program.h"
+#include "probes.h"
+
+// Standard library headers
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <map>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+CALCULATOR_PROBE_SEMAPHORE(divide__by__zero);
+CALCULATOR_PROBE_SEMAPHORE(program__evaluate);
+
+namespace {
+
+// Throws when any unpoisoned value of a block left INT_RANGE. The reduction
+// is branch-free so that it vectorizes alongside the arithmetic loop.
+void check_block_overflow(const double* values, const std::uint64_t* poison,
+                          std::size_t count) {
+  bool has_overflow = false;
+  for (std::size_t index = 0; index < count; ++index) {
+    has_overflow |= !poison[index] && !INT_RANGE.contains(values[index]);
+  }
+  if (has_overflow) {
+    throw std::overflow_error("Integer overflow");
+  }
+}
+
+// True when every value of a block lies within bounds, which NaN does not.
+// Branch-free like the overflow check.
+bool block_within(const double* values, std::size_t count,
+                  const Interval& bounds) {
+  const double lower = bounds.lower;
+  const double upper = bounds.upper;
+  bool outside = false;
+  for (std::size_t index = 0; index < count; ++index) {
+    outside |= !(lower <= values[index] && values[index] <= upper);
+  }
+  return !outside;
+}
+
+template <typename Operation>
+void run_binary_kernel(const double* first, const double* second,
+                       double* output, std::size_t count,
+                       Operation operation) {
+  for (std::size_t index = 0; index < count; ++index) {
+    output[index] = operation(first[index], second[index]);
+  }
+}
+
+// Tight per-operation loops over one block; the compiler vectorizes these,
+// turning comparisons into masks and selects into blends. A checked divide
+// swaps zero divisors for one, since those lanes are poisoned anyway.
+void run_kernel(Opcode opcode, const double* first, const double* second,
+                const double* third, double* output, std::size_t count,
+                bool checked) {
+  switch (opcode) {
+  case Opcode::Add:
+    run_binary_kernel(first, second, output, count,
+                      [](double a, double b) { return a + b; });
+    break;
+  case Opcode::Subtract:
+    run_binary_kernel(first, second, output, count,
+                      [](double a, double b) { return a - b; });
+    break;
+  case Opcode::Multiply:
+    run_binary_kernel(first, second, output, count,
+                      [](double a, double b) { return a * b; });
+    break;
+  case Opcode::Divide:
+    if (checked) {
+      // Adding the zero test, rather than a ternary, stops the compiler from
+      // splitting a / 1.0 into its own branch.
+      run_binary_kernel(first, second, output, count, [](double a, double b) {
+        return a / (b + static_cast<double>(b == 0.0));
+      });
+    } else {
+      run_binary_kernel(first, second, output, count,
+                        [](double a, double b) { return a / b; });
+    }
+    break;
+  case Opcode::Less:
+    run_binary_kernel(first, second, output, count,
+                      [](double a, double b) { return a < b ? 1.0 : 0.0; });
+    break;
+  case Opcode::LessEqual:
+    run_binary_kernel(first, second, output, count,
+                      [](double a, double b) { return a <= b ? 1.0 : 0.0; });
+    break;
+  case Opcode::Greater:
+    run_binary_kernel(first, second, output, count,
+                      [](double a, double b) { return a > b ? 1.0 : 0.0; });
+    break;
+  case Opcode::GreaterEqual:
+    run_binary_kernel(first, second, output, count,
+                      [](double a, double b) { return a >= b ? 1.0 : 0.0; });
+    break;
+  case Opcode::Equal:
+    run_binary_kernel(first, second, output, count,
+                      [](double a, double b) { return a == b ? 1.0 : 0.0; });
+    break;
+  case Opcode::NotEqual:
+    run_binary_kernel(first, second, output, count,
+                      [](double a, double b) { return a != b ? 1.0 : 0.0; });
+    break;
+  case Opcode::Select:
+    // Both branches are loaded unconditionally so the loop if-converts to a
+    // blend instead of branching per row.
+    for (std::size_t index = 0; index < count; ++index) {
+      double if_true = second[index];
+      double if_false = third[index];
+      output[index] = first[index] != 0.0 ? if_true : if_false;
+    }
+    break;
+  default:
+    throw std::invalid_argument("Opcode is not an expression operation");
+  }
+}
+
+// Poison of a step's lanes: its operands' poison, narrowed to the chosen
+// branch for selects, plus the lanes where a checked divide saw zero. Lane
+// masks are as wide as the values so these loops vectorize alongside them.
+void run_poison_kernel(Opcode opcode, bool checked, const double* first,
+                       const double* second, const std::uint64_t* first_poison,
+                       const std::uint64_t* second_poison,
+                       const std::uint64_t* third_poison, std::uint64_t* output,
+                       std::size_t count) {
+  if (opcode == Opcode::Select) {
+    for (std::size_t index = 0; index < count; ++index) {
+      std::uint64_t chosen = -static_cast<std::uint64_t>(first[index] != 0.0);
+      output[index] = first_poison[index] | (second_poison[index] & chosen) |
+                      (third_poison[index] & ~chosen);
+    }
+    return;
+  }
+
+  for (std::size_t index = 0; index < count; ++index) {
+    output[index] = first_poison[index] | second_poison[index];
+  }
+  if (opcode == Opcode::Divide && checked) {
+    for (std::size_t index = 0; index < count; ++index) {
+      output[index] |= static_cast<std::uint64_t>(second[index] == 0.0);
+    }
+  }
+}
+
+bool is_commutative(Opcode opcode) {
+  return opcode == Opcode::Add || opcode == Opcode::Multiply ||
+         opcode == Opcode::Equal || opcode == Opcode::NotEqual;
+}
+
+bool can_overflow(Opcode opcode) {
+  return opcode == Opcode::Add || opcode == Opcode::Subtract ||
+         opcode == Opcode::Multiply;
+}
+
+bool needs_check(Opcode opcode, const CompileOptions& options) {
+  return opcode == Opcode::Divide ||
+         (options.check_overflow && can_overflow(opcode));
+}
+
+} // namespace
+
+CompiledProgram::CompiledProgram(std::span<const Expression> expressions,
+                                 const CompileOptions& options)
+    : m_clean_lanes(BLOCK_SIZE, 0) {
+  if (expressions.empty()) {
+    throw std::invalid_argument("Program needs at least one expression");
+  }
+
+  lower(expressions, options, m_plan);
+
+  const std::size_t declared = std::min(
+      options.input_bounds.size(), static_cast<std::size_t>(m_input_count));
+  const bool bounded = std::any_of(
+      options.input_bounds.begin(), options.input_bounds.begin() + declared,
+      [](const Interval& bounds) { return !Interval{}.is_within(bounds); });
+  if (bounded) {
+    m_input_bounds.assign(options.input_bounds.begin(),
+                          options.input_bounds.begin() + declared);
+    CompileOptions unbounded = options;
+    unbounded.input_bounds.clear();
+    lower(expressions, unbounded, m_checked_plan);
+  }
+
+  m_broadcast_constants.resize(m_constants.size() * BLOCK_SIZE);
+  for (std::size_t slot = 0; slot < m_constants.size(); ++slot) {
+    std::fill_n(m_broadcast_constants.begin() + slot * BLOCK_SIZE, BLOCK_SIZE,
+                m_constants[slot]);
+  }
+}
+
+void CompiledProgram::evaluate(std::span<const double> inputs,
+                               std::span<double> outputs) const {
+  if (inputs.size() < static_cast<std::size_t>(m_input_count)) {
+    throw std::invalid_argument("Missing input values");
+  }
+  if (outputs.size() < m_plan.outputs.size()) {
+    throw std::invalid_argument("Missing output values");
+  }
+
+  const Plan& plan = plan_for(inputs);
+  thread_local SlotBuffer slots;
+  thread_local TrackedVector<std::uint8_t, MemorySubsystem::Buffers> poison;
+  slots.resize(plan.slot_count);
+  poison.resize(plan.slot_count);
+  auto poison_of = [&](const Operand& operand) {
+    return operand.poisoned && poison[operand.index] != 0;
+  };
+
+  auto emit = plan.emits.begin();
+  for (std::size_t index = 0; index < plan.steps.size(); ++index) {
+    const Step& step = plan.steps[index];
+    double first = load(step.first, inputs, slots);
+    double second = load(step.second, inputs, slots);
+    double value = 0.0;
+    bool poisoned = poison_of(step.first);
+    if (step.opcode == Opcode::Select) {
+      bool condition = first != 0.0;
+      value = condition ? second : load(step.third, inputs, slots);
+      poisoned |= condition ? poison_of(step.second) : poison_of(step.third);
+    } else if (step.opcode == Opcode::Divide) {
+      poisoned |= poison_of(step.second) || (step.checked && second == 0.0);
+      value = poisoned ? 0.0 : first / second;
+    } else {
+      poisoned |= poison_of(step.second);
+      value = apply_operation(step.opcode, first, second);
+      if (step.checked && !poisoned && !INT_RANGE.contains(value)) {
+        throw std::overflow_error("Integer overflow");
+      }
+    }
+    slots[step.destination] = value;
+    poison[step.destination] = poisoned;
+
+    for (; emit != plan.emits.end() && emit->step == index; ++emit) {
+      if (poisoned) {
+        CALCULATOR_PROBE0(divide__by__zero);
+        throw std::invalid_argument("Division by zero");
+      }
+      outputs[emit->output] = value;
+    }
+  }
+
+  for (std::size_t output = 0; output < plan.outputs.size(); ++output) {
+    if (plan.outputs[output].kind != OperandKind::Temporary) {
+      outputs[output] = load(plan.outputs[output], inputs, slots);
+    }
+  }
+}
+
+void CompiledProgram::evaluate(
+    std::span<const std::span<const double>> columns,
+    std::span<const std::span<double>> outputs) const {
+  if (outputs.size() < m_plan.outputs.size()) {
+    throw std::invalid_argument("Missing output columns");
+  }
+
+  const std::size_t row_count = outputs.front().size();
+  for (std::size_t output = 0; output < m_plan.outputs.size(); ++output) {
+    if (outputs[output].size() != row_count) {
+      throw std::invalid_argument("Output columns differ in length");
+    }
+  }
+  validate_columns(columns, m_input_count, row_count);
+  CALCULATOR_PROBE2(program__evaluate, row_count, m_plan.outputs.size());
+
+  const std::size_t slot_count =
+      std::max(m_plan.slot_count, m_checked_plan.slot_count);
+  thread_local SlotBuffer slots;
+  thread_local PoisonBuffer poison;
+  slots.resize(slot_count * BLOCK_SIZE);
+  poison.resize(slot_count * BLOCK_SIZE);
+  for (std::size_t offset = 0; offset < row_count; offset += BLOCK_SIZE) {
+    const std::size_t count = std::min(BLOCK_SIZE, row_count - offset);
+    const Plan& plan = plan_for(columns, offset, count);
+    auto emit = plan.emits.begin();
+    for (std::size_t index = 0; index < plan.steps.size(); ++index) {
+      const Step& step = plan.steps[index];
+      const double* first = block_pointer(step.first, columns, offset, slots);
+      const double* second =
+          block_pointer(step.second, columns, offset, slots);
+      const double* third =
+          step.opcode == Opcode::Select
+              ? block_pointer(step.third, columns, offset, slots)
+              : nullptr;
+      double* destination = slots.data() + step.destination * BLOCK_SIZE;
+      std::uint64_t* destination_poison =
+          poison.data() + step.destination * BLOCK_SIZE;
+
+      // Poison is derived first because the destination may reuse an
+      // operand's slot.
+      if (step.poisoned) {
+        run_poison_kernel(step.opcode, step.checked, first, second,
+                          poison_pointer(step.first, poison),
+                          poison_pointer(step.second, poison),
+                          poison_pointer(step.third, poison),
+                          destination_poison, count);
+      }
+      run_kernel(step.opcode, first, second, third, destination, count,
+                 step.checked);
+      if (step.checked && can_overflow(step.opcode)) {
+        check_block_overflow(destination,
+                             step.poisoned ? destination_poison
+                                           : m_clean_lanes.data(),
+                             count);
+      }
+
+      for (; emit != plan.emits.end() && emit->step == index; ++emit) {
+        if (step.poisoned &&
+            std::any_of(destination_poison, destination_poison + count,
+                        [](std::uint64_t lane) { return lane != 0; })) {
+          CALCULATOR_PROBE0(divide__by__zero);
+          throw std::invalid_argument("Division by zero");
+        }
+        std::copy_n(destination, count,
+                    outputs[emit->output].begin() + offset);
+      }
+    }
+
+    for (std::size_t output = 0; output < plan.outputs.size(); ++output) {
+      if (plan.outputs[output].kind != OperandKind::Temporary) {
+        std::copy_n(block_pointer(plan.outputs[output], columns, offset, slots),
+                    count, outputs[output].begin() + offset);
+      }
+    }
+  }
+}
+
+int CompiledProgram::input_count() const { return m_input_count; }
+
+std::size_t CompiledProgram::output_count() const {
+  return m_plan.outputs.size();
+}
+
+std::size_t CompiledProgram::step_count() const { return m_plan.steps.size(); }
+
+std::size_t CompiledProgram::slot_count() const { return m_plan.slot_count; }
+
+std::size_t CompiledProgram::checks_kept() const {
+  return m_plan.checks_kept;
+}
+
+std::size_t CompiledProgram::checks_removed() const {
+  return m_plan.checks_removed;
+}
+
+void CompiledProgram::lower(std::span<const Expression> expressions,
+                            const CompileOptions& options, Plan& plan) {
+  // Constants are interned by bit pattern so that NaN and -0.0 stay distinct
+  // map keys, and are shared with any earlier lowering; steps are keyed by
+  // opcode and operands so that duplicates are merged within and across
+  // expressions.
+  std::map<std::uint64_t, int> constant_slots;
+  for (std::size_t slot = 0; slot < m_constants.size(); ++slot) {
+    constant_slots.emplace(std::bit_cast<std::uint64_t>(m_constants[slot]),
+                           static_cast<int>(slot));
+  }
+  std::map<std::tuple<Opcode, OperandKind, int, OperandKind, int, OperandKind,
+                      int>,
+           int>
+      step_slots;
+  std::vector<Step> steps;
+  std::vector<Interval> step_ranges;
+
+  auto range_of = [&](const Operand& operand) {
+    switch (operand.kind) {
+    case OperandKind::Input:
+      return static_cast<std::size_t>(operand.index) <
+                     options.input_bounds.size()
+                 ? options.input_bounds[operand.index]
+                 : Interval{};
+    case OperandKind::Constant:
+      return Interval::point(m_constants[operand.index]);
+    case OperandKind::Temporary:
+      return step_ranges[operand.index];
+    default:
+      return Interval{};
+    }
+  };
+
+  auto intern_constant = [&](double value) {
+    auto [slot, inserted] = constant_slots.try_emplace(
+        std::bit_cast<std::uint64_t>(value),
+        static_cast<int>(m_constants.size()));
+    if (inserted) {
+      m_constants.push_back(value);
+    }
+    return Operand{OperandKind::Constant, slot->second};
+  };
+
+  for (const Expression& expression : expressions) {
+    const std::vector<Instruction>& instructions = expression.instructions();
+    if (instructions.empty()) {
+      throw std::logic_error("Expression has no instructions");
+    }
+    m_input_count = std::max(m_input_count, expression.input_count());
+
+    std::vector<Operand> operands(instructions.size());
+    for (std::size_t node = 0; node < instructions.size(); ++node) {
+      const Instruction& instruction = instructions[node];
+      if (instruction.opcode == Opcode::Input) {
+        operands[node] = {OperandKind::Input, instruction.first_operand};
+        continue;
+      }
+      if (instruction.opcode == Opcode::Constant) {
+        operands[node] = intern_constant(instruction.constant);
+        continue;
+      }
+
+      Operand first = operands[instruction.first_operand];
+      Operand second = operands[instruction.second_operand];
+      Operand third;
+      if (instruction.opcode == Opcode::Select) {
+        third = operands[instruction.third_operand];
+        // A constant condition picks its branch at compile time.
+        if (first.kind == OperandKind::Constant) {
+          operands[node] = m_constants[first.index] != 0.0 ? second : third;
+          continue;
+        }
+      }
+
+      // Fold constant operands, except a zero divisor or an overflowing
+      // result, which must still throw when the program is evaluated.
+      bool both_constant = first.kind == OperandKind::Constant &&
+                           second.kind == OperandKind::Constant;
+      if (instruction.opcode != Opcode::Select && both_constant &&
+          !(instruction.opcode == Opcode::Divide &&
+            m_constants[second.index] == 0.0)) {
+        double folded =
+            apply_operation(instruction.opcode, m_constants[first.index],
+                            m_constants[second.index]);
+        if (!options.check_overflow || !can_overflow(instruction.opcode) ||
+            INT_RANGE.contains(folded)) {
+          operands[node] = intern_constant(folded);
+          continue;
+        }
+      }
+
+      if (is_commutative(instruction.opcode) &&
+          std::tie(second.kind, second.index) <
+              std::tie(first.kind, first.index)) {
+        std::swap(first, second);
+      }
+
+      auto [slot, inserted] = step_slots.try_emplace(
+          {instruction.opcode, first.kind, first.index, second.kind,
+           second.index, third.kind, third.index},
+          static_cast<int>(steps.size()));
+      if (inserted) {
+        // A check is only kept when the operand ranges cannot rule out a
+        // zero divisor or a result outside INT_RANGE.
+        Interval first_range = range_of(first);
+        Interval second_range = range_of(second);
+        Interval range =
+            instruction.opcode == Opcode::Select
+                ? select_interval(first_range, second_range, range_of(third))
+                : apply_interval(instruction.opcode, first_range,
+                                 second_range);
+        bool checked = instruction.opcode == Opcode::Divide
+                           ? second_range.contains(0.0)
+                           : options.check_overflow &&
+                                 can_overflow(instruction.opcode) &&
+                                 !range.is_within(INT_RANGE);
+        bool poisoned = (instruction.opcode == Opcode::Divide && checked) ||
+                        first.poisoned || second.poisoned || third.poisoned;
+        steps.push_back({instruction.opcode, first, second, third, checked,
+                         poisoned, -1});
+        step_ranges.push_back(range);
+      }
+      operands[node] = {OperandKind::Temporary, slot->second,
+                        steps[slot->second].poisoned};
+    }
+    plan.outputs.push_back(operands.back());
+  }
+
+  allocate_slots(std::move(steps), options, plan);
+}
+
+void CompiledProgram::allocate_slots(std::vector<Step> steps,
+                                     const CompileOptions& options,
+                                     Plan& plan) {
+  auto temporaries_of = [](const Step& step) {
+    std::vector<int> temporaries;
+    for (const Operand& operand : {step.first, step.second, step.third}) {
+      if (operand.kind == OperandKind::Temporary &&
+          std::find(temporaries.begin(), temporaries.end(), operand.index) ==
+              temporaries.end()) {
+        temporaries.push_back(operand.index);
+      }
+    }
+    return temporaries;
+  };
+
+  // Steps are in dependency order, so one backwards sweep finds every step
+  // an output depends on.
+  std::vector<bool> live(steps.size(), false);
+  for (const Operand& output : plan.outputs) {
+    if (output.kind == OperandKind::Temporary) {
+      live[output.index] = true;
+    }
+  }
+  for (std::size_t index = steps.size(); index-- > 0;) {
+    if (!live[index]) {
+      continue;
+    }
+    for (int temporary : temporaries_of(steps[index])) {
+      live[temporary] = true;
+    }
+  }
+
+  std::vector<int> renumbered(steps.size(), -1);
+  std::vector<Step> kept;
+  for (std::size_t index = 0; index < steps.size(); ++index) {
+    if (!live[index]) {
+      continue;
+    }
+    renumbered[index] = static_cast<int>(kept.size());
+    kept.push_back(steps[index]);
+    if (steps[index].checked) {
+      ++plan.checks_kept;
+    } else if (needs_check(steps[index].opcode, options)) {
+      ++plan.checks_removed;
+    }
+  }
+  auto renumber = [&](Operand& operand) {
+    if (operand.kind == OperandKind::Temporary) {
+      operand.index = renumbered[operand.index];
+    }
+  };
+  for (Step& step : kept) {
+    renumber(step.first);
+    renumber(step.second);
+    renumber(step.third);
+  }
+  for (Operand& output : plan.outputs) {
+    renumber(output);
+  }
+
+  std::vector<std::size_t> last_use(kept.size());
+  for (std::size_t index = 0; index < kept.size(); ++index) {
+    last_use[index] = index;
+    for (int temporary : temporaries_of(kept[index])) {
+      last_use[temporary] = index;
+    }
+  }
+
+  for (std::size_t output = 0; output < plan.outputs.size(); ++output) {
+    if (plan.outputs[output].kind == OperandKind::Temporary) {
+      plan.emits.push_back(
+          {static_cast<std::size_t>(plan.outputs[output].index),
+           static_cast<int>(output)});
+    }
+  }
+  std::sort(plan.emits.begin(), plan.emits.end(),
+            [](const Emit& first, const Emit& second) {
+              return first.step < second.step;
+            });
+
+  // Linear-scan allocation: a slot returns to the free list after its last
+  // reader, and elementwise kernels may write over their own operands.
+  std::vector<int> slot_of(kept.size(), -1);
+  std::vector<int> free_slots;
+  auto resolve = [&](Operand operand) {
+    if (operand.kind == OperandKind::Temporary) {
+      operand.index = slot_of[operand.index];
+    }
+    return operand;
+  };
+  for (std::size_t index = 0; index < kept.size(); ++index) {
+    const Step& step = kept[index];
+    Step lowered{step.opcode,         resolve(step.first),
+                 resolve(step.second), resolve(step.third),
+                 step.checked,        step.poisoned,
+                 -1};
+
+    for (int temporary : temporaries_of(step)) {
+      if (last_use[temporary] == index) {
+        free_slots.push_back(slot_of[temporary]);
+      }
+    }
+
+    if (free_slots.empty()) {
+      lowered.destination = static_cast<int>(plan.slot_count++);
+    } else {
+      lowered.destination = free_slots.back();
+      free_slots.pop_back();
+    }
+    slot_of[index] = lowered.destination;
+    if (last_use[index] == index) {
+      free_slots.push_back(lowered.destination);
+    }
+    plan.steps.push_back(lowered);
+  }
+}
+
+double CompiledProgram::load(const Operand& operand,
+                             std::span<const double> inputs,
+                             const SlotBuffer& slots) const {
+  switch (operand.kind) {
+  case OperandKind::Input:
+    return inputs[operand.index];
+  case OperandKind::Constant:
+    return m_constants[operand.index];
+  case OperandKind::Temporary:
+    return slots[operand.index];
+  default:
+    return 0.0;
+  }
+}
+
+const std::uint64_t*
+CompiledProgram::poison_pointer(const Operand& operand,
+                                const PoisonBuffer& poison) const {
+  return operand.poisoned ? poison.data() + operand.index * BLOCK_SIZE
+                          : m_clean_lanes.data();
+}
+
+const double* CompiledProgram::block_pointer(
+    const Operand& operand, std::span<const std::span<const double>> columns,
+    std::size_t offset, const SlotBuffer& slots) const {
+  switch (operand.kind) {
+  case OperandKind::Input:
+    return columns[operand.index].data() + offset;
+  case OperandKind::Constant:
+    return m_broadcast_constants.data() + operand.index * BLOCK_SIZE;
+  case OperandKind::Temporary:
+    return slots.data() + operand.index * BLOCK_SIZE;
+  default:
+    return nullptr;
+  }
+}
+
+const CompiledProgram::Plan&
+CompiledProgram::plan_for(std::span<const double> inputs) const {
+  for (std::size_t input = 0; input < m_input_bounds.size(); ++input) {
+    if (!m_input_bounds[input].contains(inputs[input])) {
+      return m_checked_plan;
+    }
+  }
+  return m_plan;
+}
+
+const CompiledProgram::Plan&
+CompiledProgram::plan_for(std::span<const std::span<const double>> columns,
+                          std::size_t offset, std::size_t count) const {
+  for (std::size_t input = 0; input < m_input_bounds.size(); ++input) {
+    if (!block_within(columns[input].data() + offset, count,
+                      m_input_bounds[input])) {
+      return m_checked_plan;
+    }
+  }
+  return m_plan;
+}
+
+// Unit tests (embedded in source file)
+// Disabled in production builds via DOCTEST_CONFIG_DISABLE
+#include <doctest/doctest.h>
+
+TEST_CASE("CompiledProgram - cross-expression merging") {
+  // Arrange - f = (a + b) * c and g = (b + a) - c share a + b
+  Expression f;
+  f.multiply(f.add(f.input(0), f.input(1)), f.input(2));
+  Expression g;
+  g.subtract(g.add(g.input(1), g.input(0)), g.input(2));
+  std::vector<Expression> expressions = {f, g};
+
+  SUBCASE("shared subexpressions are computed once") {
+    // Act
+    CompiledProgram program(expressions);
+
+    // Assert
+    CHECK(program.input_count() == 3);
+    CHECK(program.output_count() == 2);
+    CHECK(program.step_count() == 3);
+  }
+
+  SUBCASE("each output receives its own expression result") {
+    // Arrange
+    CompiledProgram program(expressions);
+    std::vector<double> inputs = {1.0, 2.0, 4.0};
+    std::vector<double> outputs(2);
+
+    // Act
+    program.evaluate(inputs, outputs);
+
+    // Assert
+    CHECK(outputs[0] == doctest::Approx(12.0));
+    CHECK(outputs[1] == doctest::Approx(-1.0));
+  }
+}
+
+TEST_CASE("CompiledProgram - slot recycling") {
+  SUBCASE("a chain reuses slots instead of growing") {
+    // Arrange - ((((x + 1) * 2) + 3) * 4)
+    Expression expression;
+    NodeId node = expression.input(0);
+    for (double constant : {1.0, 2.0, 3.0, 4.0}) {
+      NodeId value = expression.constant(constant);
+      node = constant == 2.0 || constant == 4.0
+                 ? expression.multiply(node, value)
+                 : expression.add(node, value);
+    }
+    std::vector<Expression> expressions = {expression};
+
+    // Act
+    CompiledProgram program(expressions);
+    std::vector<double> output(1);
+    program.evaluate(std::vector<double>{1.0}, output);
+
+    // Assert
+    CHECK(program.step_count() == 4);
+    CHECK(program.slot_count() == 1);
+    CHECK(output[0] == doctest::Approx(28.0));
+  }
+
+  SUBCASE("outputs that are plain inputs or constants are copied") {
+    // Arrange
+    Expression input_only;
+    input_only.input(1);
+    Expression constant_only;
+    constant_only.constant(7.0);
+    std::vector<Expression> expressions = {input_only, constant_only};
+    CompiledProgram program(expressions);
+    std::vector<double> x = {1.0, 2.0};
+    std::vector<double> y = {3.0, 4.0};
+    std::vector<std::span<const double>> columns = {x, y};
+    std::vector<double> first(2);
+    std::vector<double> second(2);
+    std::vector<std::span<double>> outputs = {first, second};
+
+    // Act
+    program.evaluate(columns, outputs);
+
+    // Assert
+    CHECK(first == y);
+    CHECK(second == std::vector<double>{7.0, 7.0});
+  }
+}
+
+TEST_CASE("CompiledProgram - range analysis") {
+  // Arrange - (a * b) / (c + 1)
+  Expression expression;
+  NodeId product =
+      expression.multiply(expression.input(0), expression.input(1));
+  NodeId divisor =
+      expression.add(expression.input(2), expression.constant(1.0));
+  expression.divide(product, divisor);
+  std::vector<Expression> expressions = {expression};
+  CompileOptions options;
+  options.check_overflow = true;
+
+  SUBCASE("unbounded inputs keep every check") {
+    // Act
+    CompiledProgram program(expressions, options);
+
+    // Assert
+    CHECK(program.checks_kept() == 3);
+    CHECK(program.checks_removed() == 0);
+  }
+
+  SUBCASE("declared bounds prove every check redundant") {
+    // Arrange
+    options.input_bounds = {{-1000.0, 1000.0}, {0.0, 1000.0}, {0.0, 50.0}};
+
+    // Act
+    CompiledProgram program(expressions, options);
+    std::vector<double> output(1);
+    program.evaluate(std::vector<double>{10.0, 6.0, 3.0}, output);
+
+    // Assert
+    CHECK(program.checks_kept() == 0);
+    CHECK(program.checks_removed() == 3);
+    CHECK(output[0] == doctest::Approx(15.0));
+  }
+
+  SUBCASE("rows outside the declared bounds run every check") {
+    // Arrange
+    options.input_bounds = {{-1000.0, 1000.0}, {0.0, 1000.0}, {0.0, 50.0}};
+    CompiledProgram program(expressions, options);
+    std::vector<double> output(1);
+    std::vector<double> first(300, 1.0);
+    std::vector<double> second(300, 1.0);
+    std::vector<double> third(300, 1.0);
+    std::vector<std::span<const double>> columns = {first, second, third};
+    std::vector<double> results(300);
+    std::vector<std::span<double>> outputs = {results};
+    third[270] = -1.0;
+
+    // Act & Assert - the second block leaves the bounds of the divisor
+    CHECK_THROWS_AS(
+        program.evaluate(std::vector<double>{1.0, 1.0, -1.0}, output),
+        std::invalid_argument);
+    CHECK_THROWS_AS(
+        program.evaluate(std::vector<double>{1e6, 1e6, 1.0}, output),
+        std::overflow_error);
+    CHECK_THROWS_AS(program.evaluate(columns, outputs),
+                    std::invalid_argument);
+    CHECK(results[0] == 0.5);
+  }
+
+  SUBCASE("bounds that reach zero keep the division check") {
+    // Arrange
+    options.input_bounds = {{0.0, 10.0}, {0.0, 10.0}, {-1.0, 10.0}};
+
+    // Act
+    CompiledProgram program(expressions, options);
+    std::vector<double> output(1);
+
+    // Assert
+    CHECK(program.checks_kept() == 1);
+    CHECK_THROWS_AS(
+        program.evaluate(std::vector<double>{1.0, 1.0, -1.0}, output),
+        std::invalid_argument);
+  }
+
+  SUBCASE("overflow check fires outside the int range") {
+    // Act
+    CompiledProgram program(expressions, options);
+    std::vector<double> output(1);
+
+    // Assert
+    CHECK_THROWS_AS(
+        program.evaluate(std::vector<double>{1e6, 1e6, 1.0}, output),
+        std::overflow_error);
+  }
+
+  SUBCASE("overflowing constants are not folded away") {
+    // Arrange
+    Expression constants;
+    constants.multiply(constants.constant(1e6), constants.constant(1e6));
+    std::vector<Expression> folded = {constants};
+
+    // Act
+    CompiledProgram program(folded, options);
+    std::vector<double> output(1);
+
+    // Assert
+    CHECK(program.step_count() == 1);
+    CHECK_THROWS_AS(program.evaluate(std::vector<double>{}, output),
+                    std::overflow_error);
+  }
+}
+
+TEST_CASE("CompiledProgram - conditional evaluation") {
+  // Arrange - select(qty > 0, price / qty, -1)
+  Expression expression;
+  NodeId price = expression.input(0);
+  NodeId qty = expression.input(1);
+  expression.select(expression.greater(qty, expression.constant(0.0)),
+                    expression.divide(price, qty), expression.constant(-1.0));
+  std::vector<Expression> expressions = {expression};
+  CompiledProgram program(expressions);
+
+  SUBCASE("masked-out zero divisors do not throw in blocks") {
+    // Arrange
+    std::vector<double> prices = {10.0, 5.0, 8.0};
+    std::vector<double> quantities = {4.0, 0.0, 2.0};
+    std::vector<std::span<const double>> columns = {prices, quantities};
+    std::vector<double> results(3);
+    std::vector<std::span<double>> outputs = {results};
+
+    // Act
+    program.evaluate(columns, outputs);
+
+    // Assert
+    CHECK(results == std::vector<double>{2.5, -1.0, 4.0});
+  }
+
+  SUBCASE("masked-out zero divisors do not throw for single rows") {
+    // Arrange
+    std::vector<double> output(1);
+
+    // Act
+    program.evaluate(std::vector<double>{5.0, 0.0}, output);
+
+    // Assert
+    CHECK(output[0] == -1.0);
+  }
+
+  SUBCASE("constant conditions pick their branch at compile time") {
+    // Arrange
+    Expression constant_condition;
+    NodeId x = constant_condition.input(0);
+    constant_condition.select(constant_condition.constant(1.0), x,
+                              constant_condition.multiply(x, x));
+    std::vector<Expression> folded = {constant_condition};
+
+    // Act
+    CompiledProgram folded_program(folded);
+
+    // Assert
+    CHECK(folded_program.step_count() == 0);
+  }
+}
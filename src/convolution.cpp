@@ -0,0 +1,568 @@
+// First-party headers
+#include "calculator/convolution.h"
+#include "parallel_for.h"
+#include "wide_sum.h"
+
+// Standard library headers
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <numbers>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+namespace {
+
+// Outputs per block of the direct kernel, accumulated in L1 while every
+// tap is applied to them.
+constexpr std::size_t BLOCK_SIZE = 256;
+
+// Taps up to which the direct kernel beats the FFT; float's lanes are twice
+// as wide and int multiplies in 64 bits, while the FFT always runs in
+// double.
+template <typename T>
+constexpr std::size_t DIRECT_MAX_TAPS = std::is_same_v<T, float>    ? 128
+                                        : std::is_same_v<T, double> ? 64
+                                                                    : 40;
+
+// Largest output magnitude for which the double FFT of int inputs still
+// rounds back to the exact integer, with room for the transform's error.
+constexpr double EXACT_FFT_LIMIT = 68719476736.0; // 2^36
+
+// Bound on every partial sum below which int inputs accumulate in plain
+// 64-bit arithmetic; half of int64's range leaves room for the rounding of
+// the bound itself. Larger inputs sum each output in 128 bits.
+constexpr double PLAIN_INT_LIMIT = 4611686018427387904.0; // 2^62
+
+// Transform size of the FFT path relative to the kernel; larger segments
+// keep more outputs per transform at the cost of a longer transform.
+constexpr std::size_t FFT_KERNEL_RATIO = 4;
+
+// Radix-2 FFT of one power-of-two size over separate real and imaginary
+// arrays, so that the butterflies vectorize. The forward transform leaves
+// the spectrum in bit-reversed order and the inverse takes it in that
+// order, which is all a pointwise product needs, so neither transform
+// permutes. The twiddles of the stages on halves of length h sit
+// contiguously at [h, 2h).
+class FftPlan {
+public:
+  explicit FftPlan(std::size_t size)
+      : m_size(size), m_twiddle_real(size), m_twiddle_imag(size) {
+    for (std::size_t half = 1; half < size; half *= 2) {
+      for (std::size_t step = 0; step < half; ++step) {
+        const double angle = std::numbers::pi * static_cast<double>(step) /
+                             static_cast<double>(half);
+        m_twiddle_real[half + step] = std::cos(angle);
+        m_twiddle_imag[half + step] = -std::sin(angle);
+      }
+    }
+  }
+
+  std::size_t size() const { return m_size; }
+
+  // Decimation in frequency: natural order in, bit-reversed order out.
+  void forward(double* real, double* imag) const {
+    for (std::size_t half = m_size / 2; half >= 1; half /= 2) {
+      const double* twiddle_real = m_twiddle_real.data() + half;
+      const double* twiddle_imag = m_twiddle_imag.data() + half;
+      for (std::size_t start = 0; start < m_size; start += 2 * half) {
+        double* low_real = real + start;
+        double* low_imag = imag + start;
+        double* high_real = low_real + half;
+        double* high_imag = low_imag + half;
+        for (std::size_t step = 0; step < half; ++step) {
+          const double difference_real = low_real[step] - high_real[step];
+          const double difference_imag = low_imag[step] - high_imag[step];
+          low_real[step] += high_real[step];
+          low_imag[step] += high_imag[step];
+          high_real[step] = difference_real * twiddle_real[step] -
+                            difference_imag * twiddle_imag[step];
+          high_imag[step] = difference_real * twiddle_imag[step] +
+                            difference_imag * twiddle_real[step];
+        }
+      }
+    }
+  }
+
+  // Decimation in time with conjugate twiddles: bit-reversed order in,
+  // natural order out, unscaled.
+  void inverse(double* real, double* imag) const {
+    for (std::size_t half = 1; half < m_size; half *= 2) {
+      const double* twiddle_real = m_twiddle_real.data() + half;
+      const double* twiddle_imag = m_twiddle_imag.data() + half;
+      for (std::size_t start = 0; start < m_size; start += 2 * half) {
+        double* low_real = real + start;
+        double* low_imag = imag + start;
+        double* high_real = low_real + half;
+        double* high_imag = low_imag + half;
+        for (std::size_t step = 0; step < half; ++step) {
+          const double product_real = high_real[step] * twiddle_real[step] +
+                                      high_imag[step] * twiddle_imag[step];
+          const double product_imag = high_imag[step] * twiddle_real[step] -
+                                      high_real[step] * twiddle_imag[step];
+          high_real[step] = low_real[step] - product_real;
+          high_imag[step] = low_imag[step] - product_imag;
+          low_real[step] += product_real;
+          low_imag[step] += product_imag;
+        }
+      }
+    }
+  }
+
+private:
+  std::size_t m_size;
+  std::vector<double> m_twiddle_real;
+  std::vector<double> m_twiddle_imag;
+};
+
+template <typename Result> Result from_transform(double value) {
+  if constexpr (std::is_integral_v<Result>) {
+    return static_cast<Result>(std::llround(value));
+  } else {
+    return static_cast<Result>(value);
+  }
+}
+
+// results[i] = sum_j window[i + j] * taps[j] for count outputs, one block
+// at a time. Four taps per pass over the block halve the loads and stores
+// of the accumulators; the inner loops run across outputs and vectorize.
+template <typename T, typename Result>
+void direct_block(const T* window, const T* taps, std::size_t tap_count,
+                  Result* results, std::size_t count) {
+  std::array<Result, BLOCK_SIZE> sums{};
+  std::size_t tap = 0;
+  for (; tap + 4 <= tap_count; tap += 4) {
+    const Result first = taps[tap];
+    const Result second = taps[tap + 1];
+    const Result third = taps[tap + 2];
+    const Result fourth = taps[tap + 3];
+    const T* values = window + tap;
+    for (std::size_t index = 0; index < count; ++index) {
+      sums[index] += first * static_cast<Result>(values[index]) +
+                     second * static_cast<Result>(values[index + 1]) +
+                     third * static_cast<Result>(values[index + 2]) +
+                     fourth * static_cast<Result>(values[index + 3]);
+    }
+  }
+  for (; tap < tap_count; ++tap) {
+    const Result weight = taps[tap];
+    const T* values = window + tap;
+    for (std::size_t index = 0; index < count; ++index) {
+      sums[index] += weight * static_cast<Result>(values[index]);
+    }
+  }
+  std::copy_n(sums.begin(), count, results);
+}
+
+// direct_block for int inputs whose sums may leave int64: each output is
+// summed exactly. Returns false when one of them does not fit.
+bool direct_block_exact(const int* window, const int* taps,
+                        std::size_t tap_count, std::int64_t* results,
+                        std::size_t count) {
+  for (std::size_t index = 0; index < count; ++index) {
+    WideSum sum;
+    for (std::size_t tap = 0; tap < tap_count; ++tap) {
+      sum.add(static_cast<std::int64_t>(taps[tap]) * window[index + tap]);
+    }
+    if (!sum.fits()) {
+      return false;
+    }
+    results[index] = sum.value();
+  }
+  return true;
+}
+
+// Full convolution of signal with a kernel no longer than it, written as
+// a correlation of the zero-padded signal with the reversed kernel.
+template <typename T, typename Result>
+void convolve_direct(std::span<const T> signal, std::span<const T> kernel,
+                     Result* results, unsigned thread_count, bool exact) {
+  const std::size_t padding = kernel.size() - 1;
+  const std::size_t output_count = signal.size() + padding;
+  std::vector<T> padded(signal.size() + 2 * padding, T{});
+  std::copy(signal.begin(), signal.end(), padded.begin() + padding);
+  const std::vector<T> taps(kernel.rbegin(), kernel.rend());
+
+  // Workers cannot throw, so an output that overflows is flagged and
+  // reported once they have joined.
+  std::atomic<bool> overflow{false};
+  const std::size_t blocks = (output_count + BLOCK_SIZE - 1) / BLOCK_SIZE;
+  parallel_for(blocks, thread_count, [&](std::size_t first, std::size_t last) {
+    for (std::size_t block = first; block < last; ++block) {
+      const std::size_t offset = block * BLOCK_SIZE;
+      const std::size_t count = std::min(BLOCK_SIZE, output_count - offset);
+      if constexpr (std::is_integral_v<T>) {
+        if (exact) {
+          if (!direct_block_exact(padded.data() + offset, taps.data(),
+                                  taps.size(), results + offset, count)) {
+            overflow.store(true, std::memory_order_relaxed);
+          }
+          continue;
+        }
+      }
+      direct_block(padded.data() + offset, taps.data(), taps.size(),
+                   results + offset, count);
+    }
+  });
+  if (overflow.load(std::memory_order_relaxed)) {
+    throw std::overflow_error("Integer overflow");
+  }
+}
+
+// Overlap-save: each segment of the padded signal is transformed,
+// multiplied by the kernel's spectrum and transformed back, and the
+// outputs not wrapped around by the circular convolution are kept. The
+// kernel is real, so two segments share one complex transform, one in the
+// real part and one in the imaginary part. The inverse's 1/size scale is
+// folded into the kernel's spectrum.
+template <typename T, typename Result>
+void convolve_fft(std::span<const T> signal, std::span<const T> kernel,
+                  Result* results, unsigned thread_count) {
+  const std::size_t padding = kernel.size() - 1;
+  const std::size_t output_count = signal.size() + padding;
+  // Segments of about FFT_KERNEL_RATIO kernel lengths, or one covering
+  // everything.
+  const FftPlan plan(
+      std::min(std::bit_ceil(FFT_KERNEL_RATIO * kernel.size()),
+               std::bit_ceil(output_count + padding)));
+  const std::size_t size = plan.size();
+  const std::size_t step = size - padding;
+
+  std::vector<double> spectrum_real(size);
+  std::vector<double> spectrum_imag(size);
+  for (std::size_t index = 0; index < kernel.size(); ++index) {
+    spectrum_real[index] =
+        static_cast<double>(kernel[index]) / static_cast<double>(size);
+  }
+  plan.forward(spectrum_real.data(), spectrum_imag.data());
+
+  // Segment s holds padded signal values [s * step, s * step + size).
+  auto load = [&](std::size_t segment, double* buffer) {
+    const std::size_t start = segment * step;
+    const std::size_t first = std::max(start, padding);
+    const std::size_t last = std::min(start + size, signal.size() + padding);
+    std::fill_n(buffer, size, 0.0);
+    for (std::size_t index = first; index < last; ++index) {
+      buffer[index - start] = static_cast<double>(signal[index - padding]);
+    }
+  };
+  auto store = [&](std::size_t segment, const double* buffer) {
+    const std::size_t start = segment * step;
+    const std::size_t count = std::min(step, output_count - start);
+    for (std::size_t index = 0; index < count; ++index) {
+      results[start + index] = from_transform<Result>(buffer[index + padding]);
+    }
+  };
+
+  const std::size_t segments = (output_count + step - 1) / step;
+  const std::size_t pairs = (segments + 1) / 2;
+  parallel_for(pairs, thread_count, [&](std::size_t first, std::size_t last) {
+    std::vector<double> real(size);
+    std::vector<double> imag(size);
+    for (std::size_t pair = first; pair < last; ++pair) {
+      const bool second_segment = 2 * pair + 1 < segments;
+      load(2 * pair, real.data());
+      if (second_segment) {
+        load(2 * pair + 1, imag.data());
+      } else {
+        std::fill(imag.begin(), imag.end(), 0.0);
+      }
+      plan.forward(real.data(), imag.data());
+      for (std::size_t index = 0; index < size; ++index) {
+        const double product_real = real[index] * spectrum_real[index] -
+                                    imag[index] * spectrum_imag[index];
+        imag[index] = real[index] * spectrum_imag[index] +
+                      imag[index] * spectrum_real[index];
+        real[index] = product_real;
+      }
+      plan.inverse(real.data(), imag.data());
+      store(2 * pair, real.data());
+      if (second_segment) {
+        store(2 * pair + 1, imag.data());
+      }
+    }
+  });
+}
+
+template <typename T> double largest_magnitude(std::span<const T> values) {
+  double largest = 0.0;
+  for (T value : values) {
+    largest = std::max(largest, std::abs(static_cast<double>(value)));
+  }
+  return largest;
+}
+
+template <typename T, typename Result>
+void convolve_full(std::span<const T> signal, std::span<const T> kernel,
+                   std::span<Result> results, ConvolutionMethod method,
+                   unsigned thread_count, bool correlation) {
+  if (signal.empty() || kernel.empty()) {
+    throw std::invalid_argument("Signal and kernel must not be empty");
+  }
+  if (results.size() < signal.size() + kernel.size() - 1) {
+    throw std::invalid_argument("Missing result values");
+  }
+  if (thread_count == 0) {
+    throw std::invalid_argument("Thread count must be positive");
+  }
+
+  // Correlation is convolution with the reversed kernel, and convolution
+  // is symmetric, so the shorter operand always serves as the kernel.
+  std::vector<T> reversed;
+  if (correlation) {
+    reversed.assign(kernel.rbegin(), kernel.rend());
+    kernel = reversed;
+  }
+  if (kernel.size() > signal.size()) {
+    std::swap(signal, kernel);
+  }
+
+  bool use_fft = method == ConvolutionMethod::Fft ||
+                 (method == ConvolutionMethod::Automatic &&
+                  kernel.size() > DIRECT_MAX_TAPS<T>);
+  bool exact = false;
+  if constexpr (std::is_integral_v<T>) {
+    // No partial sum of an output exceeds the largest product times the
+    // number of taps.
+    const double bound = largest_magnitude(signal) *
+                         largest_magnitude(kernel) *
+                         static_cast<double>(kernel.size());
+    use_fft = use_fft && bound < EXACT_FFT_LIMIT;
+    exact = bound >= PLAIN_INT_LIMIT;
+  }
+  if (use_fft) {
+    convolve_fft(signal, kernel, results.data(), thread_count);
+  } else {
+    convolve_direct(signal, kernel, results.data(), thread_count, exact);
+  }
+}
+
+} // namespace
+
+void convolve(std::span<const float> signal, std::span<const float> kernel,
+              std::span<float> results, ConvolutionMethod method,
+              unsigned thread_count) {
+  convolve_full(signal, kernel, results, method, thread_count, false);
+}
+
+void convolve(std::span<const double> signal, std::span<const double> kernel,
+              std::span<double> results, ConvolutionMethod method,
+              unsigned thread_count) {
+  convolve_full(signal, kernel, results, method, thread_count, false);
+}
+
+void convolve(std::span<const int> signal, std::span<const int> kernel,
+              std::span<std::int64_t> results, ConvolutionMethod method,
+              unsigned thread_count) {
+  convolve_full(signal, kernel, results, method, thread_count, false);
+}
+
+void correlate(std::span<const float> signal, std::span<const float> kernel,
+               std::span<float> results, ConvolutionMethod method,
+               unsigned thread_count) {
+  convolve_full(signal, kernel, results, method, thread_count, true);
+}
+
+void correlate(std::span<const double> signal, std::span<const double> kernel,
+               std::span<double> results, ConvolutionMethod method,
+               unsigned thread_count) {
+  convolve_full(signal, kernel, results, method, thread_count, true);
+}
+
+void correlate(std::span<const int> signal, std::span<const int> kernel,
+               std::span<std::int64_t> results, ConvolutionMethod method,
+               unsigned thread_count) {
+  convolve_full(signal, kernel, results, method, thread_count, true);
+}
+
+// Unit tests (embedded in source file)
+// Disabled in production builds via DOCTEST_CONFIG_DISABLE
+#include <doctest/doctest.h>
+
+// Standard library headers
+#include <random>
+
+namespace {
+
+template <typename T>
+std::vector<T> random_values(std::size_t count, std::uint64_t seed) {
+  std::mt19937_64 random(seed);
+  std::uniform_int_distribution<int> value_of(-100, 100);
+  std::vector<T> values(count);
+  for (T& value : values) {
+    value = static_cast<T>(value_of(random));
+  }
+  return values;
+}
+
+// Naive full convolution, or correlation, in 64-bit integers; the test
+// values are integers, so this is exact for every element type.
+template <typename T>
+std::vector<std::int64_t> naive(const std::vector<T>& signal,
+                                const std::vector<T>& kernel,
+                                bool correlation) {
+  std::vector<std::int64_t> results(signal.size() + kernel.size() - 1);
+  for (std::size_t index = 0; index < signal.size(); ++index) {
+    for (std::size_t tap = 0; tap < kernel.size(); ++tap) {
+      const std::size_t output =
+          correlation ? index + kernel.size() - 1 - tap : index + tap;
+      results[output] += static_cast<std::int64_t>(signal[index]) *
+                         static_cast<std::int64_t>(kernel[tap]);
+    }
+  }
+  return results;
+}
+
+} // namespace
+
+TEST_CASE("Convolution - matches the naive sums") {
+  // Arrange - kernels on both sides of the crossover and longer than the
+  // signal, small enough values for float sums to be exact
+  const std::vector<std::pair<std::size_t, std::size_t>> shapes = {
+      {1, 1}, {1, 7}, {5, 3}, {1000, 1}, {1000, 13}, {777, 100},
+      {3000, 257}, {40, 300}};
+  const std::array<ConvolutionMethod, 3> methods = {
+      ConvolutionMethod::Automatic, ConvolutionMethod::Direct,
+      ConvolutionMethod::Fft};
+
+  for (const auto& [signal_size, kernel_size] : shapes) {
+    const auto signal = random_values<double>(signal_size, 1);
+    const auto kernel = random_values<double>(kernel_size, 2);
+    const auto float_signal = random_values<float>(signal_size, 1);
+    const auto float_kernel = random_values<float>(kernel_size, 2);
+    const auto int_signal = random_values<int>(signal_size, 1);
+    const auto int_kernel = random_values<int>(kernel_size, 2);
+    const std::size_t output_count = signal_size + kernel_size - 1;
+    std::vector<double> results(output_count);
+    std::vector<float> float_results(output_count);
+    std::vector<std::int64_t> int_results(output_count);
+
+    for (bool correlation : {false, true}) {
+      const auto expected = naive(int_signal, int_kernel, correlation);
+      for (ConvolutionMethod method : methods) {
+        for (unsigned threads : {1u, 3u}) {
+
+          // Act
+          if (correlation) {
+            correlate(signal, kernel, results, method, threads);
+            correlate(float_signal, float_kernel, float_results, method,
+                      threads);
+            correlate(int_signal, int_kernel, int_results, method, threads);
+          } else {
+            convolve(signal, kernel, results, method, threads);
+            convolve(float_signal, float_kernel, float_results, method,
+                     threads);
+            convolve(int_signal, int_kernel, int_results, method, threads);
+          }
+
+          // Assert - exact for int, and within the FFT's rounding error
+          CHECK(int_results == expected);
+          double worst = 0.0;
+          double float_worst = 0.0;
+          for (std::size_t index = 0; index < output_count; ++index) {
+            const auto exact = static_cast<double>(expected[index]);
+            worst = std::max(worst, std::abs(results[index] - exact));
+            float_worst = std::max(
+                float_worst,
+                std::abs(static_cast<double>(float_results[index]) - exact));
+          }
+          CHECK(worst < 1e-6);
+          CHECK(float_worst < 0.01);
+        }
+      }
+    }
+  }
+}
+
+TEST_CASE("Convolution - int outputs beyond the exact FFT range") {
+  // Arrange - every product is 2^30, so the sums exceed the FFT's range
+  const std::vector<int> signal(500, 1 << 15);
+  const std::vector<int> kernel(200, -(1 << 15));
+  std::vector<std::int64_t> results(signal.size() + kernel.size() - 1);
+
+  // Act
+  convolve(signal, kernel, results, ConvolutionMethod::Fft);
+
+  // Assert - computed directly instead
+  CHECK(results[0] == -(std::int64_t{1} << 30));
+  CHECK(results[300] == -(std::int64_t{200} << 30));
+  CHECK(results == naive(signal, kernel, false));
+}
+
+TEST_CASE("Convolution - full-range int inputs") {
+  // Arrange - alternating extremes against a constant INT_MIN kernel, so
+  // that each output is INT_MIN times a window sum of the signal
+  constexpr int low = std::numeric_limits<int>::min();
+  constexpr int high = std::numeric_limits<int>::max();
+  std::vector<int> signal(300);
+  for (std::size_t index = 0; index < signal.size(); ++index) {
+    signal[index] = index % 2 == 0 ? low : high;
+  }
+  const std::vector<int> kernel(5, low);
+  std::vector<std::int64_t> expected(signal.size() + kernel.size() - 1);
+  for (std::size_t output = 0; output < expected.size(); ++output) {
+    std::int64_t window = 0;
+    for (std::size_t tap = 0; tap < kernel.size(); ++tap) {
+      if (output >= tap && output - tap < signal.size()) {
+        window += signal[output - tap];
+      }
+    }
+    expected[output] = window * low;
+  }
+  const std::array<ConvolutionMethod, 3> methods = {
+      ConvolutionMethod::Automatic, ConvolutionMethod::Direct,
+      ConvolutionMethod::Fft};
+
+  SUBCASE("sums that fit in 64 bits are exact") {
+    for (ConvolutionMethod method : methods) {
+      for (unsigned threads : {1u, 3u}) {
+        // Act
+        std::vector<std::int64_t> results(expected.size());
+        convolve(signal, kernel, results, method, threads);
+
+        // Assert
+        CHECK(results == expected);
+      }
+    }
+  }
+
+  SUBCASE("sums beyond 64 bits throw") {
+    // Arrange - five products of about -2^62 per output
+    const std::vector<int> highs(300, high);
+    std::vector<std::int64_t> results(expected.size());
+
+    for (ConvolutionMethod method : methods) {
+      for (unsigned threads : {1u, 3u}) {
+        // Act & Assert
+        CHECK_THROWS_AS(convolve(highs, kernel, results, method, threads),
+                        std::overflow_error);
+        CHECK_THROWS_AS(correlate(kernel, highs, results, method, threads),
+                        std::overflow_error);
+      }
+    }
+  }
+}
+
+TEST_CASE("Convolution - invalid arguments") {
+  // Arrange
+  const std::vector<double> signal = {1.0, 2.0, 3.0};
+  const std::vector<double> kernel = {1.0, 1.0};
+  std::vector<double> results(4);
+  std::vector<double> short_results(3);
+
+  // Act & Assert
+  CHECK_THROWS_AS(convolve(std::span<const double>(), kernel, results),
+                  std::invalid_argument);
+  CHECK_THROWS_AS(correlate(signal, std::span<const double>(), results),
+                  std::invalid_argument);
+  CHECK_THROWS_AS(convolve(signal, kernel, short_results),
+                  std::invalid_argument);
+  CHECK_THROWS_AS(
+      convolve(signal, kernel, results, ConvolutionMethod::Direct, 0),
+      std::invalid_argument);
+}
@@ -0,0 +1,506 @@
+// First-party headers
+#include "calculator/dictionary_column.h"
+
+// Standard library headers
+#include <algorithm>
+#include <bit>
+#include <stdexcept>
+
+namespace {
+
+// Widest range of values encoded through a table indexed by value; its
+// 16-bit entries (512 KiB) stay within L2.
+constexpr std::int64_t DENSE_RANGE_LIMIT = std::int64_t{1} << 18;
+
+// Most entries in a table of per-pair results before computing per row
+// is cheaper than filling the table and reading it back from memory.
+constexpr std::size_t PAIR_TABLE_LIMIT = std::size_t{1} << 16;
+
+// Slots the hash table starts with; it doubles whenever it is half full.
+constexpr std::size_t INITIAL_HASH_SLOTS = 1024;
+
+constexpr std::uint32_t EMPTY_SLOT = 0xFFFFFFFF;
+
+void check_distinct_count(std::size_t count) {
+  if (count > DictionaryColumn::MAX_DISTINCT_VALUES) {
+    throw std::invalid_argument("Too many distinct values for a dictionary");
+  }
+}
+
+// Marks the values present in a table indexed by value - minimum, then
+// turns the marks into codes in ascending order of value, so the lookup of
+// each row is a single indexed load.
+void encode_dense(std::span<const int> values, int minimum, std::size_t range,
+                  std::vector<int>& dictionary,
+                  std::vector<std::uint16_t>& codes) {
+  std::vector<std::uint16_t> table(range, 0);
+  for (int value : values) {
+    table[static_cast<std::size_t>(value - minimum)] = 1;
+  }
+  std::size_t next_code = 0;
+  for (std::size_t offset = 0; offset < range; ++offset) {
+    if (table[offset] != 0) {
+      check_distinct_count(next_code + 1);
+      dictionary.push_back(minimum + static_cast<int>(offset));
+      table[offset] = static_cast<std::uint16_t>(next_code++);
+    }
+  }
+  for (std::size_t row = 0; row < values.size(); ++row) {
+    codes[row] = table[static_cast<std::size_t>(values[row] - minimum)];
+  }
+}
+
+// Open-addressing table from values to codes with Fibonacci hashing and
+// linear probing, kept at most half full so probes stay short.
+class CodeTable {
+public:
+  CodeTable() { resize(INITIAL_HASH_SLOTS); }
+
+  // Returns whether the value was not present before.
+  bool insert(int value) {
+    std::size_t slot = find(value);
+    if (m_codes[slot] != EMPTY_SLOT) {
+      return false;
+    }
+    if (2 * (m_count + 1) > m_values.size()) {
+      grow();
+      slot = find(value);
+    }
+    m_values[slot] = value;
+    m_codes[slot] = 0;
+    ++m_count;
+    return true;
+  }
+
+  // Code of a value inserted earlier.
+  std::uint32_t& code(int value) { return m_codes[find(value)]; }
+
+private:
+  std::size_t find(int value) const {
+    std::size_t slot = (static_cast<std::uint32_t>(value) * 0x9E3779B9u) >>
+                       m_shift;
+    while (m_codes[slot] != EMPTY_SLOT && m_values[slot] != value) {
+      slot = (slot + 1) & (m_values.size() - 1);
+    }
+    return slot;
+  }
+
+  void resize(std::size_t slots) {
+    m_values.assign(slots, 0);
+    m_codes.assign(slots, EMPTY_SLOT);
+    m_shift = 32 - std::countr_zero(slots);
+  }
+
+  void grow() {
+    const std::vector<int> values = std::move(m_values);
+    const std::vector<std::uint32_t> codes = std::move(m_codes);
+    resize(2 * values.size());
+    for (std::size_t slot = 0; slot < values.size(); ++slot) {
+      if (codes[slot] != EMPTY_SLOT) {
+        const std::size_t target = find(values[slot]);
+        m_values[target] = values[slot];
+        m_codes[target] = codes[slot];
+      }
+    }
+  }
+
+  std::vector<int> m_values;
+  std::vector<std::uint32_t> m_codes;
+  std::size_t m_count = 0;
+  int m_shift = 0;
+};
+
+// Collects the distinct values in a hash table, sorts them and stores each
+// one's position back as its code before looking up the rows.
+void encode_sparse(std::span<const int> values, std::vector<int>& dictionary,
+                   std::vector<std::uint16_t>& codes) {
+  CodeTable table;
+  for (int value : values) {
+    if (table.insert(value)) {
+      dictionary.push_back(value);
+      check_distinct_count(dictionary.size());
+    }
+  }
+  std::sort(dictionary.begin(), dictionary.end());
+  for (std::size_t code = 0; code < dictionary.size(); ++code) {
+    table.code(dictionary[code]) = static_cast<std::uint32_t>(code);
+  }
+  for (std::size_t row = 0; row < values.size(); ++row) {
+    codes[row] = static_cast<std::uint16_t>(table.code(values[row]));
+  }
+}
+
+template <typename Result>
+void check_results(std::size_t row_count, std::span<Result> results) {
+  if (results.size() < row_count) {
+    throw std::invalid_argument("Missing result values");
+  }
+}
+
+// Applies operation once per distinct value and reads every row's result
+// from the table through its code.
+template <typename Result, typename Operation>
+void apply_to_values(const DictionaryColumn& column, std::span<Result> results,
+                     const Operation& operation) {
+  check_results(column.size(), results);
+  const std::span<const int> dictionary = column.dictionary();
+  std::vector<Result> table(dictionary.size());
+  for (std::size_t code = 0; code < dictionary.size(); ++code) {
+    table[code] = operation(dictionary[code]);
+  }
+  const std::span<const std::uint16_t> codes = column.codes();
+  for (std::size_t row = 0; row < codes.size(); ++row) {
+    results[row] = table[codes[row]];
+  }
+}
+
+// Applies operation once per pair of values that occurs in some row, into
+// a table indexed by both codes, or once per row when there are more pairs
+// than rows or the table would not fit in cache. Pairs that never share a
+// row are skipped, so the operation is only ever called on operands that
+// per-row evaluation would see.
+template <typename Result, typename Operation>
+void apply_to_pairs(const DictionaryColumn& first,
+                    const DictionaryColumn& second, std::span<Result> results,
+                    const Operation& operation) {
+  if (first.size() != second.size()) {
+    throw std::invalid_argument("Column sizes do not match");
+  }
+  check_results(first.size(), results);
+  const std::span<const int> first_dictionary = first.dictionary();
+  const std::span<const int> second_dictionary = second.dictionary();
+  const std::span<const std::uint16_t> first_codes = first.codes();
+  const std::span<const std::uint16_t> second_codes = second.codes();
+  const std::size_t stride = second_dictionary.size();
+  const std::size_t pair_count = first_dictionary.size() * stride;
+  if (pair_count > std::min(PAIR_TABLE_LIMIT, first.size())) {
+    for (std::size_t row = 0; row < first_codes.size(); ++row) {
+      results[row] = operation(first_dictionary[first_codes[row]],
+                               second_dictionary[second_codes[row]]);
+    }
+    return;
+  }
+  std::vector<std::uint8_t> occurs(pair_count);
+  for (std::size_t row = 0; row < first_codes.size(); ++row) {
+    occurs[std::size_t{first_codes[row]} * stride + second_codes[row]] = 1;
+  }
+  std::vector<Result> table(pair_count);
+  for (std::size_t first_code = 0; first_code < first_dictionary.size();
+       ++first_code) {
+    for (std::size_t second_code = 0; second_code < stride; ++second_code) {
+      const std::size_t pair = first_code * stride + second_code;
+      if (occurs[pair] != 0) {
+        table[pair] = operation(first_dictionary[first_code],
+                                second_dictionary[second_code]);
+      }
+    }
+  }
+  for (std::size_t row = 0; row < first_codes.size(); ++row) {
+    results[row] =
+        table[std::size_t{first_codes[row]} * stride + second_codes[row]];
+  }
+}
+
+} // namespace
+
+DictionaryColumn DictionaryColumn::encode(std::span<const int> values) {
+  DictionaryColumn column;
+  column.m_codes.resize(values.size());
+  if (values.empty()) {
+    return column;
+  }
+  // A plain reduction vectorizes where std::minmax_element, which tracks
+  // positions, does not.
+  int minimum = values[0];
+  int maximum = values[0];
+  for (int value : values) {
+    minimum = std::min(minimum, value);
+    maximum = std::max(maximum, value);
+  }
+  const std::int64_t range = std::int64_t{maximum} - std::int64_t{minimum} + 1;
+  if (range <= DENSE_RANGE_LIMIT) {
+    encode_dense(values, minimum, static_cast<std::size_t>(range),
+                 column.m_dictionary, column.m_codes);
+  } else {
+    encode_sparse(values, column.m_dictionary, column.m_codes);
+  }
+  return column;
+}
+
+std::size_t DictionaryColumn::size() const { return m_codes.size(); }
+
+std::span<const int> DictionaryColumn::dictionary() const {
+  return m_dictionary;
+}
+
+std::span<const std::uint16_t> DictionaryColumn::codes() const {
+  return m_codes;
+}
+
+void DictionaryColumn::decode(std::span<int> results) const {
+  check_results(size(), results);
+  for (std::size_t row = 0; row < m_codes.size(); ++row) {
+    results[row] = m_dictionary[m_codes[row]];
+  }
+}
+
+void DictionaryCalculator::add(const DictionaryColumn& column, int value,
+                               std::span<int> results) {
+  apply_to_values(column, results, [&](int first_value) {
+    return m_calculator.add(first_value, value);
+  });
+}
+
+void DictionaryCalculator::subtract(const DictionaryColumn& column, int value,
+                                    std::span<int> results) {
+  apply_to_values(column, results, [&](int first_value) {
+    return m_calculator.subtract(first_value, value);
+  });
+}
+
+void DictionaryCalculator::multiply(const DictionaryColumn& column, int value,
+                                    std::span<int> results) {
+  apply_to_values(column, results, [&](int first_value) {
+    return m_calculator.multiply(first_value, value);
+  });
+}
+
+void DictionaryCalculator::divide(const DictionaryColumn& column, int value,
+                                  std::span<double> results) {
+  apply_to_values(column, results, [&](int first_value) {
+    return m_calculator.divide(first_value, value);
+  });
+}
+
+void DictionaryCalculator::add(const DictionaryColumn& first,
+                               const DictionaryColumn& second,
+                               std::span<int> results) {
+  apply_to_pairs(first, second, results,
+                 [&](int first_value, int second_value) {
+                   return m_calculator.add(first_value, second_value);
+                 });
+}
+
+void DictionaryCalculator::subtract(const DictionaryColumn& first,
+                                    const DictionaryColumn& second,
+                                    std::span<int> results) {
+  apply_to_pairs(first, second, results,
+                 [&](int first_value, int second_value) {
+                   return m_calculator.subtract(first_value, second_value);
+                 });
+}
+
+void DictionaryCalculator::multiply(const DictionaryColumn& first,
+                                    const DictionaryColumn& second,
+                                    std::span<int> results) {
+  apply_to_pairs(first, second, results,
+                 [&](int first_value, int second_value) {
+                   return m_calculator.multiply(first_value, second_value);
+                 });
+}
+
+void DictionaryCalculator::divide(const DictionaryColumn& first,
+                                  const DictionaryColumn& second,
+                                  std::span<double> results) {
+  apply_to_pairs(first, second, results,
+                 [&](int first_value, int second_value) {
+                   return m_calculator.divide(first_value, second_value);
+                 });
+}
+
+// Unit tests (embedded in source file)
+// Disabled in production builds via DOCTEST_CONFIG_DISABLE
+#include <doctest/doctest.h>
+
+// Standard library headers
+#include <climits>
+#include <random>
+
+namespace {
+
+std::vector<int> random_column(std::size_t count, std::size_t distinct,
+                               int spacing, std::uint64_t seed) {
+  std::mt19937_64 random(seed);
+  std::uniform_int_distribution<std::size_t> index_of(0, distinct - 1);
+  std::vector<int> values(count);
+  for (int& value : values) {
+    value = static_cast<int>(index_of(random)) * spacing - 500 * spacing;
+  }
+  return values;
+}
+
+} // namespace
+
+TEST_CASE("DictionaryColumn - encode and decode") {
+  SUBCASE("dense and sparse value ranges round-trip") {
+    for (int spacing : {1, 7, 100000}) {
+      // Arrange
+      const std::vector<int> values = random_column(5000, 1000, spacing, 3);
+
+      // Act
+      const DictionaryColumn column = DictionaryColumn::encode(values);
+      std::vector<int> decoded(values.size());
+      column.decode(decoded);
+
+      // Assert
+      CHECK(column.size() == values.size());
+      CHECK(decoded == values);
+      std::vector<int> distinct = values;
+      std::sort(distinct.begin(), distinct.end());
+      distinct.erase(std::unique(distinct.begin(), distinct.end()),
+                     distinct.end());
+      CHECK(std::equal(distinct.begin(), distinct.end(),
+                       column.dictionary().begin(),
+                       column.dictionary().end()));
+      for (std::size_t row = 0; row < values.size(); ++row) {
+        CHECK(column.dictionary()[column.codes()[row]] == values[row]);
+      }
+    }
+  }
+
+  SUBCASE("extreme values and empty columns") {
+    // Arrange
+    const std::vector<int> values = {INT_MAX, INT_MIN, 0, INT_MIN, INT_MAX};
+
+    // Act
+    const DictionaryColumn column = DictionaryColumn::encode(values);
+    const DictionaryColumn empty = DictionaryColumn::encode({});
+    std::vector<int> decoded(values.size());
+    column.decode(decoded);
+
+    // Assert
+    CHECK(decoded == values);
+    CHECK(column.dictionary().size() == 3);
+    CHECK(empty.size() == 0);
+    CHECK(empty.dictionary().empty());
+  }
+
+  SUBCASE("too many distinct values") {
+    for (int spacing : {1, 1000}) {
+      // Arrange
+      std::vector<int> values(DictionaryColumn::MAX_DISTINCT_VALUES);
+      for (std::size_t index = 0; index < values.size(); ++index) {
+        values[index] = static_cast<int>(index) * spacing;
+      }
+
+      // Act & Assert - one more distinct value than codes can hold
+      CHECK(DictionaryColumn::encode(values).dictionary().size() ==
+            values.size());
+      values.push_back(-spacing);
+      CHECK_THROWS_AS(DictionaryColumn::encode(values), std::invalid_argument);
+    }
+  }
+
+  SUBCASE("short result span") {
+    // Arrange
+    const DictionaryColumn column = DictionaryColumn::encode(
+        std::vector<int>{1, 2, 3});
+    std::vector<int> decoded(2);
+
+    // Act & Assert
+    CHECK_THROWS_AS(column.decode(decoded), std::invalid_argument);
+  }
+}
+
+TEST_CASE("DictionaryCalculator - matches Calculator row by row") {
+  DictionaryCalculator dictionary_calculator;
+  Calculator calculator;
+
+  SUBCASE("operations with a constant") {
+    // Arrange
+    const std::vector<int> values = random_column(3000, 200, 3, 5);
+    const DictionaryColumn column = DictionaryColumn::encode(values);
+    std::vector<int> sums(values.size());
+    std::vector<int> differences(values.size());
+    std::vector<int> products(values.size());
+    std::vector<double> quotients(values.size());
+
+    // Act
+    dictionary_calculator.add(column, 17, sums);
+    dictionary_calculator.subtract(column, 17, differences);
+    dictionary_calculator.multiply(column, -4, products);
+    dictionary_calculator.divide(column, 8, quotients);
+
+    // Assert
+    for (std::size_t row = 0; row < values.size(); ++row) {
+      CHECK(sums[row] == calculator.add(values[row], 17));
+      CHECK(differences[row] == calculator.subtract(values[row], 17));
+      CHECK(products[row] == calculator.multiply(values[row], -4));
+      CHECK(quotients[row] == calculator.divide(values[row], 8));
+    }
+  }
+
+  SUBCASE("operations between columns, through a pair table or per row") {
+    // Second distinct counts giving fewer pairs than rows, and more
+    for (std::size_t second_distinct : {10, 3000}) {
+      // Arrange
+      const std::vector<int> first_values = random_column(4000, 50, 11, 7);
+      std::vector<int> second_values =
+          random_column(4000, second_distinct, 1, 8);
+      std::replace(second_values.begin(), second_values.end(), 0, 1);
+      const DictionaryColumn first = DictionaryColumn::encode(first_values);
+      const DictionaryColumn second = DictionaryColumn::encode(second_values);
+      std::vector<int> sums(first_values.size());
+      std::vector<int> differences(first_values.size());
+      std::vector<int> products(first_values.size());
+      std::vector<double> quotients(first_values.size());
+
+      // Act
+      dictionary_calculator.add(first, second, sums);
+      dictionary_calculator.subtract(first, second, differences);
+      dictionary_calculator.multiply(first, second, products);
+      dictionary_calculator.divide(first, second, quotients);
+
+      // Assert
+      for (std::size_t row = 0; row < first_values.size(); ++row) {
+        const int x = first_values[row];
+        const int y = second_values[row];
+        CHECK(sums[row] == calculator.add(x, y));
+        CHECK(differences[row] == calculator.subtract(x, y));
+        CHECK(products[row] == calculator.multiply(x, y));
+        CHECK(quotients[row] == calculator.divide(x, y));
+      }
+    }
+  }
+
+  SUBCASE("pairs that never share a row are not evaluated") {
+    // Arrange - INT_MAX + 1 and INT_MAX * 2 would only come from unseen
+    // pairs
+    const std::vector<int> first_values = {INT_MAX, 0, INT_MAX, 0};
+    const std::vector<int> second_values = {0, 1, 0, 2};
+    const DictionaryColumn first = DictionaryColumn::encode(first_values);
+    const DictionaryColumn second = DictionaryColumn::encode(second_values);
+    std::vector<int> sums(first_values.size());
+    std::vector<int> products(first_values.size());
+
+    // Act
+    dictionary_calculator.add(first, second, sums);
+    dictionary_calculator.multiply(first, second, products);
+
+    // Assert
+    CHECK(sums == std::vector<int>{INT_MAX, 1, INT_MAX, 2});
+    CHECK(products == std::vector<int>{0, 0, 0, 0});
+  }
+
+  SUBCASE("division by zero and mismatched columns") {
+    // Arrange
+    const DictionaryColumn first =
+        DictionaryColumn::encode(std::vector<int>{4, 6, 8});
+    const DictionaryColumn second =
+        DictionaryColumn::encode(std::vector<int>{2, 0, 2});
+    const DictionaryColumn shorter =
+        DictionaryColumn::encode(std::vector<int>{1, 2});
+    std::vector<double> quotients(3);
+    std::vector<int> sums(3);
+
+    // Act & Assert
+    CHECK_THROWS_AS(dictionary_calculator.divide(first, 0, quotients),
+                    std::invalid_argument);
+    CHECK_THROWS_AS(dictionary_calculator.divide(first, second, quotients),
+                    std::invalid_argument);
+    CHECK_THROWS_AS(dictionary_calculator.add(first, shorter, sums),
+                    std::invalid_argument);
+    CHECK_THROWS_AS(dictionary_calculator.add(first, 1, std::span<int>()),
+                    std::invalid_argument);
+  }
+}
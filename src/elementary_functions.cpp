@@ -0,0 +1,840 @@
+// First-party headers
+#include "calculator/elementary_functions.h"
+#include "calculator/polynomial.h"
+
+// Standard library headers
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
+
+namespace {
+
+// Elements per block of pow, whose intermediate products stay in L1.
+constexpr std::size_t BLOCK_SIZE = 256;
+
+template <typename T> struct FloatTraits;
+
+template <> struct FloatTraits<double> {
+  using Bits = std::uint64_t;
+  using SignedBits = std::int64_t;
+  static constexpr int MANTISSA_BITS = 52;
+  static constexpr SignedBits EXPONENT_BIAS = 1023;
+  // Adding this to |v| < 2^51 leaves round(v) in the low mantissa bits.
+  static constexpr double ROUNDING_MAGIC = 0x1.8p52;
+  // ln(2) split so that n * LN2_HIGH is exact for every exponent n.
+  static constexpr double LN2_HIGH = 0x1.62e42feep-1;
+  static constexpr double LN2_LOW = 0x1.a39ef35793c76p-33;
+  // exp is zero or infinite beyond this, and 2^round(x / ln 2) can still be
+  // applied in two halves up to it.
+  static constexpr double EXP_LIMIT = 746.0;
+  static constexpr int SUBNORMAL_SHIFT = 54;
+  static constexpr Bits RSQRT_MAGIC = 0x5fe6eb50c7b537a9;
+};
+
+template <> struct FloatTraits<float> {
+  using Bits = std::uint32_t;
+  using SignedBits = std::int32_t;
+  static constexpr int MANTISSA_BITS = 23;
+  static constexpr SignedBits EXPONENT_BIAS = 127;
+  static constexpr float ROUNDING_MAGIC = 0x1.8p23f;
+  static constexpr float LN2_HIGH = 0x1.63p-1f;
+  static constexpr float LN2_LOW = -0x1.bd0106p-13f;
+  static constexpr float EXP_LIMIT = 105.0f;
+  static constexpr int SUBNORMAL_SHIFT = 26;
+  static constexpr Bits RSQRT_MAGIC = 0x5f3759df;
+};
+
+// Polynomial sizes per tier, chosen so that truncation stays well inside
+// the tier's error bound.
+struct TierShape {
+  std::size_t exp_degree;
+  std::size_t log_terms;
+  int sqrt_iterations;
+};
+
+constexpr TierShape DOUBLE_PRECISE{13, 11, 0};
+constexpr TierShape DOUBLE_RELAXED{12, 9, 0};
+constexpr TierShape DOUBLE_FAST{5, 3, 3};
+// Precise floats are computed in double arithmetic and rounded once.
+constexpr TierShape FLOAT_PRECISE{7, 5, 0};
+constexpr TierShape FLOAT_RELAXED{6, 4, 0};
+constexpr TierShape FLOAT_FAST{5, 3, 2};
+
+// Taylor coefficients of e^r, 1 / k!.
+template <typename T, std::size_t Degree>
+constexpr std::array<T, Degree + 1> exp_coefficients() {
+  std::array<T, Degree + 1> coefficients{};
+  double factorial = 1.0;
+  for (std::size_t k = 0; k <= Degree; ++k) {
+    factorial *= k == 0 ? 1.0 : static_cast<double>(k);
+    coefficients[k] = static_cast<T>(1.0 / factorial);
+  }
+  return coefficients;
+}
+
+// Coefficients of R(z) / z with log(1 + f) = f - f^2 / 2 + s (f^2 / 2 +
+// R(s^2)), s = f / (2 + f): 2 / (2k + 1) for k = 1..Terms.
+template <typename T, std::size_t Terms>
+constexpr std::array<T, Terms> log_coefficients() {
+  std::array<T, Terms> coefficients{};
+  for (std::size_t k = 1; k <= Terms; ++k) {
+    coefficients[k - 1] = static_cast<T>(2.0 / static_cast<double>(2 * k + 1));
+  }
+  return coefficients;
+}
+
+template <typename T>
+inline T from_exponent(typename FloatTraits<T>::SignedBits exponent) {
+  using Traits = FloatTraits<T>;
+  using Bits = typename Traits::Bits;
+  return std::bit_cast<T>(static_cast<Bits>(exponent + Traits::EXPONENT_BIAS)
+                          << Traits::MANTISSA_BITS);
+}
+
+// The kernels below are branch-free so that their loops vectorize. Special
+// cases are handled with all-ones or all-zeros masks built from shifts and
+// subtractions of the bit patterns, and blended in at the end: a
+// conditional expression lets the compiler move the work of one side into
+// a branch, and SSE2 has no 64-bit integer comparison to build a mask from.
+template <typename Bits> constexpr int SIGN_SHIFT = sizeof(Bits) * 8 - 1;
+
+// All ones when value is non-zero.
+template <typename Bits> inline Bits mask_if_nonzero(Bits value) {
+  return Bits{0} - ((value | (Bits{0} - value)) >> SIGN_SHIFT<Bits>);
+}
+
+// All ones when value < limit, from the borrow out of value - limit.
+template <typename Bits> inline Bits mask_if_below(Bits value, Bits limit) {
+  const Bits borrow = (~value & limit) | (~(value ^ limit) & (value - limit));
+  return Bits{0} - (borrow >> SIGN_SHIFT<Bits>);
+}
+
+template <typename T>
+inline T blend(typename FloatTraits<T>::Bits mask, T if_set, T if_clear) {
+  using Bits = typename FloatTraits<T>::Bits;
+  return std::bit_cast<T>((std::bit_cast<Bits>(if_set) & mask) |
+                          (std::bit_cast<Bits>(if_clear) & ~mask));
+}
+
+template <typename T> inline typename FloatTraits<T>::Bits magnitude_bits(T x) {
+  using Bits = typename FloatTraits<T>::Bits;
+  return std::bit_cast<Bits>(x) & ~(Bits{1} << SIGN_SHIFT<Bits>);
+}
+
+// SUBNORMAL_SHIFT for zero and subnormal magnitudes, whose exponent field
+// is zero, and 0 otherwise.
+template <typename T>
+inline typename FloatTraits<T>::Bits
+subnormal_shift(typename FloatTraits<T>::Bits magnitude) {
+  using Traits = FloatTraits<T>;
+  using Bits = typename Traits::Bits;
+  constexpr Bits MIN_NORMAL =
+      std::bit_cast<Bits>(std::numeric_limits<T>::min());
+  return mask_if_below(magnitude, MIN_NORMAL) & Traits::SUBNORMAL_SHIFT;
+}
+
+// All ones for positive finite x, the domain of log and sqrt proper.
+template <typename T>
+inline typename FloatTraits<T>::Bits finite_positive(T x) {
+  using Bits = typename FloatTraits<T>::Bits;
+  constexpr Bits INFINITY_BITS =
+      std::bit_cast<Bits>(std::numeric_limits<T>::infinity());
+  return mask_if_below(std::bit_cast<Bits>(x) - 1, INFINITY_BITS - 1);
+}
+
+// e^x = 2^n e^r with n = round(x / ln 2) and |r| <= ln(2) / 2. 2^n is
+// applied in two halves, so that beyond the clamped range the product
+// overflows to infinity or underflows to zero by itself.
+template <typename T, std::size_t Degree> inline T exp_element(T x) {
+  using Traits = FloatTraits<T>;
+  using Bits = typename Traits::Bits;
+  using SignedBits = typename Traits::SignedBits;
+  static constexpr auto COEFFICIENTS = exp_coefficients<T, Degree>();
+  // Keeps the exponent positive while it is halved, as SSE2 has no
+  // arithmetic shift of 64-bit lanes.
+  constexpr SignedBits OFFSET = SignedBits{1} << (SIGN_SHIFT<Bits> - 1);
+
+  // NaN is not clamped and passes through the arithmetic below.
+  constexpr Bits LIMIT_BITS = std::bit_cast<Bits>(Traits::EXP_LIMIT);
+  constexpr Bits INFINITY_BITS =
+      std::bit_cast<Bits>(std::numeric_limits<T>::infinity());
+  const Bits magnitude = magnitude_bits(x);
+  const T clamped = blend(mask_if_below(LIMIT_BITS, magnitude) &
+                              mask_if_below(magnitude, INFINITY_BITS + 1),
+                          std::copysign(Traits::EXP_LIMIT, x), x);
+  const T shifted = clamped * static_cast<T>(1.4426950408889634) +
+                    Traits::ROUNDING_MAGIC;
+  const T n = shifted - Traits::ROUNDING_MAGIC;
+  const T r = (clamped - n * Traits::LN2_HIGH) - n * Traits::LN2_LOW;
+  const auto exponent =
+      static_cast<SignedBits>(std::bit_cast<Bits>(shifted) -
+                              std::bit_cast<Bits>(Traits::ROUNDING_MAGIC));
+  const SignedBits low_half =
+      static_cast<SignedBits>(static_cast<Bits>(exponent + OFFSET) >> 1) -
+      OFFSET / 2;
+  return horner<Degree>(COEFFICIENTS, r) * from_exponent<T>(low_half) *
+         from_exponent<T>(exponent - low_half);
+}
+
+// log(x) = e ln(2) + log(m) with m in [sqrt(1/2), sqrt(2)), and log(m)
+// from the odd series in s = (m - 1) / (m + 1), as in fdlibm. The
+// reduction runs on |x| and gives a finite value for every input, which
+// is replaced for the special ones.
+template <typename T, std::size_t Terms> inline T log_element(T x) {
+  using Traits = FloatTraits<T>;
+  using Bits = typename Traits::Bits;
+  using SignedBits = typename Traits::SignedBits;
+  static constexpr auto COEFFICIENTS = log_coefficients<T, Terms>();
+  constexpr Bits MANTISSA_MASK = (Bits{1} << Traits::MANTISSA_BITS) - 1;
+  constexpr Bits ONE = std::bit_cast<Bits>(T{1});
+  constexpr Bits SQRT2_MANTISSA =
+      std::bit_cast<Bits>(static_cast<T>(1.4142135623730951)) & MANTISSA_MASK;
+
+  const Bits magnitude = magnitude_bits(x);
+  const Bits shift = subnormal_shift<T>(magnitude);
+  const Bits bits =
+      std::bit_cast<Bits>(std::bit_cast<T>(magnitude) *
+                          from_exponent<T>(static_cast<SignedBits>(shift)));
+
+  // Mantissas from sqrt(2) up are halved.
+  const Bits mantissa = bits & MANTISSA_MASK;
+  const Bits high = (mantissa + (MANTISSA_MASK + 1 - SQRT2_MANTISSA)) >>
+                    Traits::MANTISSA_BITS;
+  const T m =
+      std::bit_cast<T>(mantissa | (ONE - (high << Traits::MANTISSA_BITS)));
+  const auto exponent =
+      static_cast<SignedBits>((bits >> Traits::MANTISSA_BITS) + high - shift) -
+      Traits::EXPONENT_BIAS;
+
+  // The exponent as T through the rounding constant rather than an
+  // int-to-float conversion, which SSE2 lacks for 64-bit lanes.
+  const T e = std::bit_cast<T>(std::bit_cast<Bits>(Traits::ROUNDING_MAGIC) +
+                               static_cast<Bits>(exponent)) -
+              Traits::ROUNDING_MAGIC;
+  const T f = m - T{1};
+  const T s = f / (T{2} + f);
+  const T z = s * s;
+  const T half_square = T{0.5} * f * f;
+  const T r = z * horner<Terms - 1>(COEFFICIENTS, z);
+  const T result = e * Traits::LN2_HIGH -
+                   ((half_square - (s * (half_square + r) +
+                                    e * Traits::LN2_LOW)) -
+                    f);
+
+  // Zeros give -inf, negative values NaN, and infinity and NaN themselves.
+  const T special =
+      blend(~mask_if_nonzero(magnitude), -std::numeric_limits<T>::infinity(),
+            blend(Bits{0} - (std::bit_cast<Bits>(x) >> SIGN_SHIFT<Bits>),
+                  std::numeric_limits<T>::quiet_NaN(), x));
+  return blend(finite_positive(x), result, special);
+}
+
+// x * rsqrt(x), with the reciprocal square root estimated from the bit
+// pattern and refined by Newton iterations.
+template <typename T, int Iterations> inline T fast_sqrt_element(T x) {
+  using Traits = FloatTraits<T>;
+  using Bits = typename Traits::Bits;
+  using SignedBits = typename Traits::SignedBits;
+
+  const Bits magnitude = magnitude_bits(x);
+  const auto shift = static_cast<SignedBits>(subnormal_shift<T>(magnitude));
+  const T scaled = std::bit_cast<T>(magnitude) * from_exponent<T>(shift);
+  T estimate = std::bit_cast<T>(Traits::RSQRT_MAGIC -
+                                (std::bit_cast<Bits>(scaled) >> 1));
+  for (int iteration = 0; iteration < Iterations; ++iteration) {
+    estimate *= T{1.5} - T{0.5} * scaled * estimate * estimate;
+  }
+  const T root = scaled * estimate * from_exponent<T>(-shift / 2);
+
+  // Zeros, infinity and NaN are their own square roots; other negative
+  // values give NaN.
+  const T special =
+      blend(mask_if_nonzero(magnitude) &
+                (Bits{0} - (std::bit_cast<Bits>(x) >> SIGN_SHIFT<Bits>)),
+            std::numeric_limits<T>::quiet_NaN(), x);
+  return blend(finite_positive(x), root, special);
+}
+
+// pow(x, y) = exp(y log|x|) with the sign and special cases of std::pow,
+// in two steps run as separate passes; see apply_pow.
+
+// All ones where pow is 1 even though y log|x| is NaN; those are computed
+// as pow(1, 0).
+template <typename T> inline typename FloatTraits<T>::Bits pow_one(T x, T y) {
+  using Bits = typename FloatTraits<T>::Bits;
+  constexpr Bits INFINITY_BITS =
+      std::bit_cast<Bits>(std::numeric_limits<T>::infinity());
+  const Bits y_magnitude = magnitude_bits(y);
+  const Bits x_bits = std::bit_cast<Bits>(x);
+  return ~mask_if_nonzero(y_magnitude) |
+         ~mask_if_nonzero(x_bits ^ std::bit_cast<Bits>(T{1})) |
+         (~mask_if_nonzero(x_bits ^ std::bit_cast<Bits>(T{-1})) &
+          ~mask_if_nonzero(y_magnitude ^ INFINITY_BITS));
+}
+
+template <typename T, TierShape Shape> inline T pow_product(T x, T y) {
+  const auto one = pow_one(x, y);
+  return blend(one, T{0}, y) *
+         log_element<T, Shape.log_terms>(std::abs(blend(one, T{1}, x)));
+}
+
+// Cases taken as pow(1, 0) above come out as 1 here without being masked
+// again: their x is positive or y an even integer.
+template <typename T, TierShape Shape>
+inline T pow_result(T x, T y, T product) {
+  using Traits = FloatTraits<T>;
+  using Bits = typename Traits::Bits;
+
+  // Adding ROUNDING_MAGIC to |y| rounds it to an integer whose parity is
+  // the lowest bit. Values of 2^51 (2^22 for float) and above are taken as
+  // even integers, which is exact two binades higher and only matters for
+  // pow(-1, y) in between.
+  const T magnitude = std::abs(y);
+  const T shifted = magnitude + Traits::ROUNDING_MAGIC;
+  const Bits small =
+      mask_if_below(std::bit_cast<Bits>(magnitude),
+                    std::bit_cast<Bits>(Traits::ROUNDING_MAGIC / T{3}));
+  const Bits fraction =
+      small & mask_if_nonzero(std::bit_cast<Bits>(magnitude) ^
+                              std::bit_cast<Bits>(shifted -
+                                                  Traits::ROUNDING_MAGIC));
+  const Bits x_bits = std::bit_cast<Bits>(x);
+  const Bits odd_sign = x_bits & small & ~fraction &
+                        (std::bit_cast<Bits>(shifted) << SIGN_SHIFT<Bits>);
+
+  // Negative x to a non-integer power is NaN, except for -0.
+  const T result = std::bit_cast<T>(
+      std::bit_cast<Bits>(exp_element<T, Shape.exp_degree>(product)) ^
+      odd_sign);
+  return blend((Bits{0} - (x_bits >> SIGN_SHIFT<Bits>)) & fraction &
+                   mask_if_nonzero(magnitude_bits(x)),
+               std::numeric_limits<T>::quiet_NaN(), result);
+}
+
+// The element functions are declared inline and passed as template
+// arguments rather than function pointers, so that they are inlined into
+// the loop and the loop vectorizes.
+template <auto Element, typename T>
+void apply_elementwise(std::span<const T> values, std::span<T> results) {
+  if (results.size() < values.size()) {
+    throw std::invalid_argument("Missing result values");
+  }
+  const T* input = values.data();
+  T* output = results.data();
+  for (std::size_t index = 0; index < values.size(); ++index) {
+    output[index] = Element(input[index]);
+  }
+}
+
+template <typename T>
+void check_pow_spans(std::span<const T> bases, std::span<const T> exponents,
+                     std::span<T> results) {
+  if (exponents.size() != bases.size()) {
+    throw std::invalid_argument("Exponents do not match the bases");
+  }
+  if (results.size() < bases.size()) {
+    throw std::invalid_argument("Missing result values");
+  }
+}
+
+// pow over blocks: y log|x| for the whole block, then exp and the sign.
+// Chained per element, log and exp form a dependency chain too long for
+// successive iterations to overlap. T is the arithmetic type, double for
+// the precise float tiers.
+template <typename T, TierShape Shape, typename Value>
+void apply_pow(std::span<const Value> bases, std::span<const Value> exponents,
+               std::span<Value> results) {
+  check_pow_spans(bases, exponents, results);
+  const Value* first = bases.data();
+  const Value* second = exponents.data();
+  Value* output = results.data();
+  std::array<T, BLOCK_SIZE> products;
+  for (std::size_t offset = 0; offset < bases.size(); offset += BLOCK_SIZE) {
+    const std::size_t block = std::min(BLOCK_SIZE, bases.size() - offset);
+    for (std::size_t row = 0; row < block; ++row) {
+      products[row] =
+          pow_product<T, Shape>(first[offset + row], second[offset + row]);
+    }
+    for (std::size_t row = 0; row < block; ++row) {
+      output[offset + row] = static_cast<Value>(pow_result<T, Shape>(
+          first[offset + row], second[offset + row], products[row]));
+    }
+  }
+}
+
+void apply_libm_pow(std::span<const double> bases,
+                    std::span<const double> exponents,
+                    std::span<double> results) {
+  check_pow_spans(bases, exponents, results);
+  for (std::size_t index = 0; index < bases.size(); ++index) {
+    results[index] = std::pow(bases[index], exponents[index]);
+  }
+}
+
+// Runs a float tier in double arithmetic, rounding once at the end.
+template <auto Element> inline float widened(float x) {
+  return static_cast<float>(Element(static_cast<double>(x)));
+}
+
+template <typename T> inline T sqrt_element(T x) { return std::sqrt(x); }
+
+template <typename T> std::uint64_t ordered(T value) {
+  using Bits = typename FloatTraits<T>::Bits;
+  constexpr Bits SIGN = Bits{1} << (sizeof(T) * 8 - 1);
+  const Bits bits = std::bit_cast<Bits>(value);
+  // Maps the sign-magnitude encoding onto a monotonic unsigned scale.
+  return (bits & SIGN) ? static_cast<std::uint64_t>(SIGN - (bits & ~SIGN))
+                       : static_cast<std::uint64_t>(SIGN + bits);
+}
+
+template <typename T> std::uint64_t distance(T first_value, T second_value) {
+  if (std::isnan(first_value) || std::isnan(second_value)) {
+    return std::isnan(first_value) && std::isnan(second_value)
+               ? 0
+               : std::numeric_limits<std::uint64_t>::max();
+  }
+  const std::uint64_t first = ordered(first_value);
+  const std::uint64_t second = ordered(second_value);
+  return first > second ? first - second : second - first;
+}
+
+} // namespace
+
+void batch_sqrt(std::span<const double> values, std::span<double> results,
+                MathAccuracy accuracy) {
+  // The hardware square root is correctly rounded, so it serves both
+  // Precise and Relaxed.
+  if (accuracy == MathAccuracy::Fast) {
+    apply_elementwise<fast_sqrt_element<double, DOUBLE_FAST.sqrt_iterations>>(
+        values, results);
+  } else {
+    apply_elementwise<sqrt_element<double>>(values, results);
+  }
+}
+
+void batch_sqrt(std::span<const float> values, std::span<float> results,
+                MathAccuracy accuracy) {
+  if (accuracy == MathAccuracy::Fast) {
+    apply_elementwise<fast_sqrt_element<float, FLOAT_FAST.sqrt_iterations>>(
+        values, results);
+  } else {
+    apply_elementwise<sqrt_element<float>>(values, results);
+  }
+}
+
+void batch_exp(std::span<const double> values, std::span<double> results,
+               MathAccuracy accuracy) {
+  switch (accuracy) {
+  case MathAccuracy::Precise:
+    apply_elementwise<exp_element<double, DOUBLE_PRECISE.exp_degree>>(
+        values, results);
+    break;
+  case MathAccuracy::Relaxed:
+    apply_elementwise<exp_element<double, DOUBLE_RELAXED.exp_degree>>(
+        values, results);
+    break;
+  case MathAccuracy::Fast:
+    apply_elementwise<exp_element<double, DOUBLE_FAST.exp_degree>>(values,
+                                                                   results);
+    break;
+  }
+}
+
+void batch_exp(std::span<const float> values, std::span<float> results,
+               MathAccuracy accuracy) {
+  switch (accuracy) {
+  case MathAccuracy::Precise:
+    apply_elementwise<widened<exp_element<double, FLOAT_PRECISE.exp_degree>>>(
+        values, results);
+    break;
+  case MathAccuracy::Relaxed:
+    apply_elementwise<exp_element<float, FLOAT_RELAXED.exp_degree>>(values,
+                                                                    results);
+    break;
+  case MathAccuracy::Fast:
+    apply_elementwise<exp_element<float, FLOAT_FAST.exp_degree>>(values,
+                                                                 results);
+    break;
+  }
+}
+
+void batch_log(std::span<const double> values, std::span<double> results,
+               MathAccuracy accuracy) {
+  switch (accuracy) {
+  case MathAccuracy::Precise:
+    apply_elementwise<log_element<double, DOUBLE_PRECISE.log_terms>>(values,
+                                                                     results);
+    break;
+  case MathAccuracy::Relaxed:
+    apply_elementwise<log_element<double, DOUBLE_RELAXED.log_terms>>(values,
+                                                                     results);
+    break;
+  case MathAccuracy::Fast:
+    apply_elementwise<log_element<double, DOUBLE_FAST.log_terms>>(values,
+                                                                  results);
+    break;
+  }
+}
+
+void batch_log(std::span<const float> values, std::span<float> results,
+               MathAccuracy accuracy) {
+  switch (accuracy) {
+  case MathAccuracy::Precise:
+    apply_elementwise<widened<log_element<double, FLOAT_PRECISE.log_terms>>>(
+        values, results);
+    break;
+  case MathAccuracy::Relaxed:
+    apply_elementwise<log_element<float, FLOAT_RELAXED.log_terms>>(values,
+                                                                   results);
+    break;
+  case MathAccuracy::Fast:
+    apply_elementwise<log_element<float, FLOAT_FAST.log_terms>>(values,
+                                                                results);
+    break;
+  }
+}
+
+void batch_pow(std::span<const double> bases, std::span<const double> exponents,
+               std::span<double> results, MathAccuracy accuracy) {
+  switch (accuracy) {
+  case MathAccuracy::Precise:
+    // exp(y log x) would need log in extended precision to stay within
+    // 1 ULP, so this tier keeps libm.
+    apply_libm_pow(bases, exponents, results);
+    break;
+  case MathAccuracy::Relaxed:
+    apply_pow<double, DOUBLE_PRECISE>(bases, exponents, results);
+    break;
+  case MathAccuracy::Fast:
+    apply_pow<double, DOUBLE_FAST>(bases, exponents, results);
+    break;
+  }
+}
+
+void batch_pow(std::span<const float> bases, std::span<const float> exponents,
+               std::span<float> results, MathAccuracy accuracy) {
+  // Double arithmetic has ample headroom for float pow: |y log x| stays
+  // below about 104 wherever the result is finite.
+  switch (accuracy) {
+  case MathAccuracy::Precise:
+    apply_pow<double, DOUBLE_RELAXED>(bases, exponents, results);
+    break;
+  case MathAccuracy::Relaxed:
+    apply_pow<double, FLOAT_PRECISE>(bases, exponents, results);
+    break;
+  case MathAccuracy::Fast:
+    apply_pow<float, FLOAT_FAST>(bases, exponents, results);
+    break;
+  }
+}
+
+std::uint64_t ulp_distance(double first_value, double second_value) {
+  return distance(first_value, second_value);
+}
+
+std::uint64_t ulp_distance(float first_value, float second_value) {
+  return distance(first_value, second_value);
+}
+
+// Unit tests (embedded in source file)
+// Disabled in production builds via DOCTEST_CONFIG_DISABLE
+#include <doctest/doctest.h>
+
+// Standard library headers
+#include <random>
+#include <vector>
+
+namespace {
+
+// 10007 values evenly spaced over [low, high], or their exponentials.
+template <typename T>
+std::vector<T> spread_values(double low, double high, bool exponential) {
+  std::vector<T> values(10007);
+  for (std::size_t index = 0; index < values.size(); ++index) {
+    const double value = low + (high - low) * static_cast<double>(index) /
+                                   static_cast<double>(values.size() - 1);
+    values[index] = static_cast<T>(exponential ? std::exp(value) : value);
+  }
+  return values;
+}
+
+struct Errors {
+  std::uint64_t ulp = 0;
+  double relative = 0.0;
+};
+
+// Errors against the standard library in double, rounded to T.
+template <typename T, typename Batch, typename Reference>
+Errors measure_errors(const std::vector<T>& values, MathAccuracy accuracy,
+                      Batch batch, Reference reference) {
+  std::vector<T> results(values.size());
+  batch(std::span<const T>(values), std::span<T>(results), accuracy);
+  Errors errors;
+  for (std::size_t index = 0; index < values.size(); ++index) {
+    const double exact = reference(static_cast<double>(values[index]));
+    errors.ulp = std::max(errors.ulp,
+                          ulp_distance(results[index], static_cast<T>(exact)));
+    errors.relative = std::max(
+        errors.relative,
+        std::abs((static_cast<double>(results[index]) - exact) / exact));
+  }
+  return errors;
+}
+
+// libm is itself only within 1 ULP, so double results may be one more
+// away from it than the tier allows.
+template <typename T, typename Batch, typename Reference>
+void check_tiers(const std::vector<T>& values, Batch batch,
+                 Reference reference) {
+  constexpr std::uint64_t SLACK = sizeof(T) == sizeof(double) ? 1 : 0;
+  CHECK(measure_errors(values, MathAccuracy::Precise, batch, reference).ulp <=
+        1 + SLACK);
+  CHECK(measure_errors(values, MathAccuracy::Relaxed, batch, reference).ulp <=
+        4 + SLACK);
+  CHECK(measure_errors(values, MathAccuracy::Fast, batch, reference).relative <
+        1e-5);
+}
+
+// Equal results, with NaN equal to NaN and the sign of zero significant.
+template <typename T> bool same_result(T result, T expected) {
+  if (std::isnan(expected)) {
+    return std::isnan(result);
+  }
+  return result == expected && std::signbit(result) == std::signbit(expected);
+}
+
+// Special results exactly, and ordinary ones within the fast tier.
+template <typename T> bool matches_libm(T result, T expected) {
+  if (std::isnormal(expected)) {
+    return result == doctest::Approx(expected).epsilon(1e-5);
+  }
+  return same_result(result, expected);
+}
+
+template <typename T> void check_special_values(MathAccuracy accuracy) {
+  constexpr T INF = std::numeric_limits<T>::infinity();
+  constexpr T NaN = std::numeric_limits<T>::quiet_NaN();
+  const std::vector<T> exp_values = {INF,    -INF,   NaN,
+                                     T{710}, T{746}, T{-746}};
+  const std::vector<T> log_values = {T{0}, T{-0.0}, T{1}, T{-1},
+                                     INF,  -INF,    NaN};
+  std::vector<T> results(log_values.size());
+
+  batch_exp(exp_values, results, accuracy);
+  for (std::size_t index = 0; index < exp_values.size(); ++index) {
+    CHECK(matches_libm(results[index], std::exp(exp_values[index])));
+  }
+  batch_log(log_values, results, accuracy);
+  for (std::size_t index = 0; index < log_values.size(); ++index) {
+    CHECK(matches_libm(results[index], std::log(log_values[index])));
+  }
+  batch_sqrt(log_values, results, accuracy);
+  for (std::size_t index = 0; index < log_values.size(); ++index) {
+    CHECK(matches_libm(results[index], std::sqrt(log_values[index])));
+  }
+}
+
+} // namespace
+
+TEST_CASE("Elementary functions - accuracy tiers") {
+  // Arrange
+  const auto exp_batch = [](auto values, auto results, MathAccuracy accuracy) {
+    batch_exp(values, results, accuracy);
+  };
+  const auto log_batch = [](auto values, auto results, MathAccuracy accuracy) {
+    batch_log(values, results, accuracy);
+  };
+  const auto sqrt_batch = [](auto values, auto results,
+                             MathAccuracy accuracy) {
+    batch_sqrt(values, results, accuracy);
+  };
+  const auto exact_exp = [](double x) { return std::exp(x); };
+  const auto exact_log = [](double x) { return std::log(x); };
+  const auto exact_sqrt = [](double x) { return std::sqrt(x); };
+
+  SUBCASE("double with normal results") {
+    // Act & Assert
+    check_tiers(spread_values<double>(-700, 700, false), exp_batch, exact_exp);
+    check_tiers(spread_values<double>(-700, 700, true), log_batch, exact_log);
+    check_tiers(spread_values<double>(0.5, 2, false), log_batch, exact_log);
+    check_tiers(spread_values<double>(-700, 700, true), sqrt_batch,
+                exact_sqrt);
+  }
+
+  SUBCASE("float with normal results") {
+    // Act & Assert
+    check_tiers(spread_values<float>(-87, 88, false), exp_batch, exact_exp);
+    check_tiers(spread_values<float>(-87, 88, true), log_batch, exact_log);
+    check_tiers(spread_values<float>(0.5, 2, false), log_batch, exact_log);
+    check_tiers(spread_values<float>(-87, 88, true), sqrt_batch, exact_sqrt);
+  }
+
+  SUBCASE("subnormal inputs and results") {
+    // Arrange - down to the smallest subnormal
+    const std::vector<double> tiny = spread_values<double>(-745, -700, true);
+    const std::vector<double> arguments =
+        spread_values<double>(-745, -708, false);
+
+    // Act & Assert
+    CHECK(measure_errors(tiny, MathAccuracy::Precise, log_batch, exact_log)
+              .ulp <= 2);
+    CHECK(measure_errors(tiny, MathAccuracy::Fast, sqrt_batch, exact_sqrt)
+              .relative < 1e-5);
+    CHECK(measure_errors(arguments, MathAccuracy::Precise, exp_batch,
+                         exact_exp)
+              .ulp <= 2);
+  }
+}
+
+TEST_CASE("Elementary functions - pow tiers") {
+  // Arrange
+  std::mt19937_64 random(7);
+  std::uniform_real_distribution<double> log_base_of(-20.0, 20.0);
+  std::uniform_real_distribution<double> exponent_of(-8.0, 8.0);
+  std::vector<double> bases(10000);
+  std::vector<double> exponents(bases.size());
+  for (std::size_t index = 0; index < bases.size(); ++index) {
+    bases[index] = std::exp(log_base_of(random));
+    exponents[index] = exponent_of(random);
+  }
+  std::vector<double> results(bases.size());
+
+  SUBCASE("double error grows with |y log x| outside the precise tier") {
+    for (MathAccuracy accuracy : {MathAccuracy::Precise, MathAccuracy::Relaxed,
+                                  MathAccuracy::Fast}) {
+      // Act
+      batch_pow(bases, exponents, results, accuracy);
+
+      // Assert
+      for (std::size_t index = 0; index < bases.size(); ++index) {
+        const double exact = std::pow(bases[index], exponents[index]);
+        const double scale =
+            1.0 + std::abs(exponents[index] * std::log(bases[index]));
+        if (accuracy == MathAccuracy::Precise) {
+          CHECK(results[index] == exact);
+        } else if (accuracy == MathAccuracy::Relaxed) {
+          CHECK(static_cast<double>(ulp_distance(results[index], exact)) <=
+                2.0 * scale);
+        } else {
+          CHECK(std::abs(results[index] - exact) <= 1e-5 * scale * exact);
+        }
+      }
+    }
+  }
+
+  SUBCASE("float") {
+    // Arrange - square roots keep the results in the float range
+    std::vector<float> float_bases(bases.size());
+    std::vector<float> float_exponents(bases.size());
+    std::vector<float> float_results(bases.size());
+    for (std::size_t index = 0; index < bases.size(); ++index) {
+      float_bases[index] = static_cast<float>(std::sqrt(bases[index]));
+      float_exponents[index] = static_cast<float>(exponents[index]);
+    }
+
+    for (MathAccuracy accuracy : {MathAccuracy::Precise, MathAccuracy::Relaxed,
+                                  MathAccuracy::Fast}) {
+      // Act
+      batch_pow(float_bases, float_exponents, float_results, accuracy);
+
+      // Assert
+      for (std::size_t index = 0; index < bases.size(); ++index) {
+        const double base = float_bases[index];
+        const double exponent = float_exponents[index];
+        const double exact = std::pow(base, exponent);
+        if (accuracy == MathAccuracy::Fast) {
+          const double scale = 1.0 + std::abs(exponent * std::log(base));
+          CHECK(std::abs(float_results[index] - exact) <=
+                1e-5 * scale * exact);
+        } else {
+          CHECK(ulp_distance(float_results[index], static_cast<float>(exact)) <=
+                (accuracy == MathAccuracy::Precise ? 1u : 4u));
+        }
+      }
+    }
+  }
+
+  SUBCASE("negative bases take the sign of odd integer powers") {
+    // Arrange
+    const std::vector<double> negative = {-2.0, -2.0, -0.5, -3.0, -2.0};
+    const std::vector<double> powers = {3.0, 4.0, -3.0, 0.5, -1e300};
+    std::vector<double> signed_results(negative.size());
+
+    for (MathAccuracy accuracy : {MathAccuracy::Relaxed, MathAccuracy::Fast}) {
+      // Act
+      batch_pow(negative, powers, signed_results, accuracy);
+
+      // Assert
+      CHECK(signed_results[0] == doctest::Approx(-8.0).epsilon(1e-4));
+      CHECK(signed_results[1] == doctest::Approx(16.0).epsilon(1e-4));
+      CHECK(signed_results[2] == doctest::Approx(-8.0).epsilon(1e-4));
+      CHECK(std::isnan(signed_results[3]));
+      CHECK(same_result(signed_results[4], 0.0));
+    }
+  }
+}
+
+TEST_CASE("Elementary functions - special values follow libm") {
+  for (MathAccuracy accuracy :
+       {MathAccuracy::Precise, MathAccuracy::Relaxed, MathAccuracy::Fast}) {
+    // Act & Assert
+    check_special_values<double>(accuracy);
+    check_special_values<float>(accuracy);
+  }
+
+  SUBCASE("pow") {
+    // Arrange
+    constexpr double INF = std::numeric_limits<double>::infinity();
+    constexpr double NaN = std::numeric_limits<double>::quiet_NaN();
+    const std::vector<double> bases = {-0.0, -0.0, 0.0,  0.0,  1.0,
+                                       NaN,  -1.0, INF,  -INF, -INF,
+                                       2.0,  0.5,  -2.0, NaN};
+    const std::vector<double> exponents = {3.0,   -3.0, -1.0, 0.0, NaN,
+                                           0.0,   INF,  -1.0, 3.0, 2.0,
+                                           1e308, -INF, 0.5,  1.0};
+    std::vector<double> results(bases.size());
+
+    for (MathAccuracy accuracy : {MathAccuracy::Precise, MathAccuracy::Relaxed,
+                                  MathAccuracy::Fast}) {
+      // Act
+      batch_pow(bases, exponents, results, accuracy);
+
+      // Assert
+      for (std::size_t index = 0; index < bases.size(); ++index) {
+        CHECK(same_result(results[index],
+                          std::pow(bases[index], exponents[index])));
+      }
+    }
+  }
+}
+
+TEST_CASE("Elementary functions - spans") {
+  // Arrange
+  std::vector<double> values = {0.5, 1.0, 2.0};
+  std::vector<double> short_results(2);
+
+  SUBCASE("results may alias the inputs") {
+    // Act
+    batch_sqrt(values, values);
+    batch_pow(values, values, values, MathAccuracy::Relaxed);
+
+    // Assert - sqrt(2) ^ sqrt(2)
+    CHECK(values[1] == 1.0);
+    CHECK(values[2] == doctest::Approx(std::pow(std::sqrt(2.0),
+                                                std::sqrt(2.0))));
+  }
+
+  SUBCASE("mismatched sizes throw") {
+    // Act & Assert
+    CHECK_THROWS_AS(batch_sqrt(values, short_results), std::invalid_argument);
+    CHECK_THROWS_AS(batch_exp(values, short_results), std::invalid_argument);
+    CHECK_THROWS_AS(batch_pow(values, short_results, values),
+                    std::invalid_argument);
+    CHECK_THROWS_AS(batch_pow(values, values, short_results),
+                    std::invalid_argument);
+  }
+}
@@ -0,0 +1,465 @@
+// First-party headers
+#include "calculator/expression.h"
+#include "calculator/interval.h"
+#include "probes.h"
+
+// Standard library headers
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+CALCULATOR_PROBE_SEMAPHORE(divide__by__zero);
+
+double apply_operation(Opcode opcode, double first_value,
+                       double second_value) {
+  switch (opcode) {
+  case Opcode::Add:
+    return first_value + second_value;
+  case Opcode::Subtract:
+    return first_value - second_value;
+  case Opcode::Multiply:
+    return first_value * second_value;
+  case Opcode::Divide:
+    if (second_value == 0.0) {
+      CALCULATOR_PROBE0(divide__by__zero);
+      throw std::invalid_argument("Division by zero");
+    }
+    return first_value / second_value;
+  case Opcode::Less:
+    return first_value < second_value ? 1.0 : 0.0;
+  case Opcode::LessEqual:
+    return first_value <= second_value ? 1.0 : 0.0;
+  case Opcode::Greater:
+    return first_value > second_value ? 1.0 : 0.0;
+  case Opcode::GreaterEqual:
+    return first_value >= second_value ? 1.0 : 0.0;
+  case Opcode::Equal:
+    return first_value == second_value ? 1.0 : 0.0;
+  case Opcode::NotEqual:
+    return first_value != second_value ? 1.0 : 0.0;
+  default:
+    throw std::invalid_argument("Opcode is not a binary operation");
+  }
+}
+
+namespace {
+
+bool can_overflow(Opcode opcode) {
+  return opcode == Opcode::Add || opcode == Opcode::Subtract ||
+         opcode == Opcode::Multiply;
+}
+
+} // namespace
+
+bool is_comparison(Opcode opcode) {
+  switch (opcode) {
+  case Opcode::Less:
+  case Opcode::LessEqual:
+  case Opcode::Greater:
+  case Opcode::GreaterEqual:
+  case Opcode::Equal:
+  case Opcode::NotEqual:
+    return true;
+  default:
+    return false;
+  }
+}
+
+void validate_columns(std::span<const std::span<const double>> columns,
+                      int input_count, std::size_t row_count) {
+  if (columns.size() < static_cast<std::size_t>(input_count)) {
+    throw std::invalid_argument("Missing input columns");
+  }
+
+  for (int index = 0; index < input_count; ++index) {
+    if (columns[index].size() < row_count) {
+      throw std::invalid_argument("Input column is shorter than results");
+    }
+  }
+}
+
+NodeId Expression::input(int index) {
+  if (index < 0) {
+    throw std::invalid_argument("Negative input index");
+  }
+
+  m_input_count = std::max(m_input_count, index + 1);
+  return append({Opcode::Input, index, 0, 0, 0.0});
+}
+
+NodeId Expression::constant(double value) {
+  return append({Opcode::Constant, 0, 0, 0, value});
+}
+
+NodeId Expression::add(NodeId first_node, NodeId second_node) {
+  return append_binary(Opcode::Add, first_node, second_node);
+}
+
+NodeId Expression::subtract(NodeId first_node, NodeId second_node) {
+  return append_binary(Opcode::Subtract, first_node, second_node);
+}
+
+NodeId Expression::multiply(NodeId first_node, NodeId second_node) {
+  return append_binary(Opcode::Multiply, first_node, second_node);
+}
+
+NodeId Expression::divide(NodeId first_node, NodeId second_node) {
+  return append_binary(Opcode::Divide, first_node, second_node);
+}
+
+NodeId Expression::less(NodeId first_node, NodeId second_node) {
+  return append_binary(Opcode::Less, first_node, second_node);
+}
+
+NodeId Expression::less_equal(NodeId first_node, NodeId second_node) {
+  return append_binary(Opcode::LessEqual, first_node, second_node);
+}
+
+NodeId Expression::greater(NodeId first_node, NodeId second_node) {
+  return append_binary(Opcode::Greater, first_node, second_node);
+}
+
+NodeId Expression::greater_equal(NodeId first_node, NodeId second_node) {
+  return append_binary(Opcode::GreaterEqual, first_node, second_node);
+}
+
+NodeId Expression::equal(NodeId first_node, NodeId second_node) {
+  return append_binary(Opcode::Equal, first_node, second_node);
+}
+
+NodeId Expression::not_equal(NodeId first_node, NodeId second_node) {
+  return append_binary(Opcode::NotEqual, first_node, second_node);
+}
+
+NodeId Expression::select(NodeId condition_node, NodeId true_node,
+                          NodeId false_node) {
+  validate_node(condition_node);
+  validate_node(true_node);
+  validate_node(false_node);
+  return append({Opcode::Select, condition_node, true_node, false_node, 0.0});
+}
+
+double Expression::evaluate(std::span<const double> inputs,
+                            bool check_overflow) const {
+  return evaluate_row(inputs, check_overflow ? overflow_checked_nodes()
+                                             : std::vector<bool>());
+}
+
+void Expression::evaluate(std::span<const std::span<const double>> columns,
+                          std::span<double> results,
+                          bool check_overflow) const {
+  validate_columns(columns, m_input_count, results.size());
+
+  const std::vector<bool> checked =
+      check_overflow ? overflow_checked_nodes() : std::vector<bool>();
+  std::vector<double> row(m_input_count);
+  for (std::size_t index = 0; index < results.size(); ++index) {
+    for (int column = 0; column < m_input_count; ++column) {
+      row[column] = columns[column][index];
+    }
+    results[index] = evaluate_row(row, checked);
+  }
+}
+
+std::vector<bool> Expression::overflow_checked_nodes() const {
+  // Mirrors CompiledProgram's lowering so that both tiers check the same
+  // nodes: constant subtrees fold unless they divide by zero or overflow, a
+  // select on a constant condition stands for the branch it picks, and only
+  // nodes the result depends on are kept.
+  const std::size_t count = m_instructions.size();
+  std::vector<bool> constant(count, false);
+  std::vector<double> values(count, 0.0);
+  std::vector<NodeId> resolved(count);
+  for (std::size_t node = 0; node < count; ++node) {
+    const Instruction& instruction = m_instructions[node];
+    resolved[node] = static_cast<NodeId>(node);
+    if (instruction.opcode == Opcode::Input) {
+      continue;
+    }
+    if (instruction.opcode == Opcode::Constant) {
+      constant[node] = true;
+      values[node] = instruction.constant;
+      continue;
+    }
+
+    NodeId first = resolved[instruction.first_operand];
+    NodeId second = resolved[instruction.second_operand];
+    if (instruction.opcode == Opcode::Select) {
+      if (constant[first]) {
+        NodeId chosen = values[first] != 0.0
+                            ? second
+                            : resolved[instruction.third_operand];
+        resolved[node] = chosen;
+        constant[node] = constant[chosen];
+        values[node] = values[chosen];
+      }
+      continue;
+    }
+    if (constant[first] && constant[second] &&
+        !(instruction.opcode == Opcode::Divide && values[second] == 0.0)) {
+      double folded =
+          apply_operation(instruction.opcode, values[first], values[second]);
+      if (!can_overflow(instruction.opcode) || INT_RANGE.contains(folded)) {
+        constant[node] = true;
+        values[node] = folded;
+      }
+    }
+  }
+
+  std::vector<bool> live(count, false);
+  live[resolved[result()]] = true;
+  std::vector<bool> checked(count, false);
+  for (std::size_t node = count; node-- > 0;) {
+    const Instruction& instruction = m_instructions[node];
+    if (!live[node] || constant[node] || instruction.opcode == Opcode::Input) {
+      continue;
+    }
+    checked[node] = can_overflow(instruction.opcode);
+    live[resolved[instruction.first_operand]] = true;
+    live[resolved[instruction.second_operand]] = true;
+    if (instruction.opcode == Opcode::Select) {
+      live[resolved[instruction.third_operand]] = true;
+    }
+  }
+  return checked;
+}
+
+double Expression::evaluate_row(std::span<const double> inputs,
+                                const std::vector<bool>& checked) const {
+  if (m_instructions.empty()) {
+    throw std::logic_error("Expression has no instructions");
+  }
+  if (inputs.size() < static_cast<std::size_t>(m_input_count)) {
+    throw std::invalid_argument("Missing input values");
+  }
+
+  // The interpreter favours zero set-up cost over per-row speed: one value
+  // slot per node and a switch per instruction. A zero divisor marks its
+  // node as poisoned; the poison follows data flow and only throws when it
+  // reaches the result, so an unselected branch cannot fail.
+  std::vector<double> values(m_instructions.size());
+  std::vector<bool> poisoned(m_instructions.size(), false);
+  for (std::size_t node = 0; node < m_instructions.size(); ++node) {
+    const Instruction& instruction = m_instructions[node];
+    switch (instruction.opcode) {
+    case Opcode::Input:
+      values[node] = inputs[instruction.first_operand];
+      break;
+    case Opcode::Constant:
+      values[node] = instruction.constant;
+      break;
+    case Opcode::Select: {
+      bool condition = values[instruction.first_operand] != 0.0;
+      NodeId chosen =
+          condition ? instruction.second_operand : instruction.third_operand;
+      values[node] = values[chosen];
+      poisoned[node] = poisoned[instruction.first_operand] || poisoned[chosen];
+      break;
+    }
+    case Opcode::Divide:
+      poisoned[node] = poisoned[instruction.first_operand] ||
+                       poisoned[instruction.second_operand] ||
+                       values[instruction.second_operand] == 0.0;
+      values[node] = poisoned[node] ? 0.0
+                                    : values[instruction.first_operand] /
+                                          values[instruction.second_operand];
+      break;
+    default:
+      poisoned[node] = poisoned[instruction.first_operand] ||
+                       poisoned[instruction.second_operand];
+      values[node] = apply_operation(instruction.opcode,
+                                     values[instruction.first_operand],
+                                     values[instruction.second_operand]);
+      if (!checked.empty() && checked[node] && !poisoned[node] &&
+          !INT_RANGE.contains(values[node])) {
+        throw std::overflow_error("Integer overflow");
+      }
+      break;
+    }
+  }
+
+  if (poisoned.back()) {
+    CALCULATOR_PROBE0(divide__by__zero);
+    throw std::invalid_argument("Division by zero");
+  }
+  return values.back();
+}
+
+const std::vector<Instruction>& Expression::instructions() const {
+  return m_instructions;
+}
+
+int Expression::input_count() const { return m_input_count; }
+
+NodeId Expression::result() const {
+  if (m_instructions.empty()) {
+    throw std::logic_error("Expression has no instructions");
+  }
+
+  return static_cast<NodeId>(m_instructions.size() - 1);
+}
+
+NodeId Expression::append(Instruction instruction) {
+  m_instructions.push_back(instruction);
+  return static_cast<NodeId>(m_instructions.size() - 1);
+}
+
+NodeId Expression::append_binary(Opcode opcode, NodeId first_node,
+                                 NodeId second_node) {
+  validate_node(first_node);
+  validate_node(second_node);
+  return append({opcode, first_node, second_node, 0, 0.0});
+}
+
+void Expression::validate_node(NodeId node) const {
+  if (node < 0 || node >= static_cast<NodeId>(m_instructions.size())) {
+    throw std::invalid_argument("Operand does not refer to an existing node");
+  }
+}
+
+// Unit tests (embedded in source file)
+// Disabled in production builds via DOCTEST_CONFIG_DISABLE
+#include <doctest/doctest.h>
+
+TEST_CASE("Expression - interpreter evaluation") {
+  SUBCASE("evaluates nested arithmetic in node order") {
+    // Arrange - (x + 2) * y
+    Expression expression;
+    NodeId x = expression.input(0);
+    NodeId y = expression.input(1);
+    NodeId sum = expression.add(x, expression.constant(2.0));
+    expression.multiply(sum, y);
+    std::vector<double> inputs = {3.0, 4.0};
+
+    // Act
+    double result = expression.evaluate(inputs);
+
+    // Assert
+    CHECK(result == doctest::Approx(20.0));
+  }
+
+  SUBCASE("input count tracks the highest input index") {
+    // Arrange
+    Expression expression;
+
+    // Act
+    expression.input(3);
+
+    // Assert
+    CHECK(expression.input_count() == 4);
+  }
+
+  SUBCASE("division by zero throws like Calculator::divide") {
+    // Arrange
+    Expression expression;
+    expression.divide(expression.input(0), expression.constant(0.0));
+    std::vector<double> inputs = {1.0};
+
+    // Act & Assert
+    CHECK_THROWS_AS(expression.evaluate(inputs), std::invalid_argument);
+  }
+}
+
+TEST_CASE("Expression - builder validation") {
+  Expression expression;
+
+  SUBCASE("operands must refer to existing nodes") {
+    // Arrange
+    NodeId x = expression.input(0);
+
+    // Act & Assert
+    CHECK_THROWS_AS(expression.add(x, 5), std::invalid_argument);
+  }
+
+  SUBCASE("empty expressions cannot be evaluated") {
+    // Arrange
+    std::vector<double> inputs;
+
+    // Act & Assert
+    CHECK_THROWS_AS(expression.evaluate(inputs), std::logic_error);
+  }
+}
+
+TEST_CASE("Expression - conditional evaluation") {
+  // Arrange - select(qty > 0, price / qty, 0)
+  Expression expression;
+  NodeId price = expression.input(0);
+  NodeId qty = expression.input(1);
+  NodeId zero = expression.constant(0.0);
+  expression.select(expression.greater(qty, zero),
+                    expression.divide(price, qty), zero);
+
+  SUBCASE("selected branch is returned") {
+    // Act
+    double result = expression.evaluate(std::vector<double>{10.0, 4.0});
+
+    // Assert
+    CHECK(result == doctest::Approx(2.5));
+  }
+
+  SUBCASE("zero divisor in the unselected branch does not throw") {
+    // Act
+    double result = expression.evaluate(std::vector<double>{10.0, 0.0});
+
+    // Assert
+    CHECK(result == 0.0);
+  }
+
+  SUBCASE("zero divisor that reaches the result still throws") {
+    // Arrange
+    Expression unguarded;
+    unguarded.divide(unguarded.input(0), unguarded.input(1));
+
+    // Act & Assert
+    CHECK_THROWS_AS(unguarded.evaluate(std::vector<double>{1.0, 0.0}),
+                    std::invalid_argument);
+  }
+
+  SUBCASE("comparisons yield one or zero") {
+    // Arrange
+    Expression comparison;
+    comparison.less_equal(comparison.input(0), comparison.input(1));
+
+    // Act & Assert
+    CHECK(comparison.evaluate(std::vector<double>{1.0, 1.0}) == 1.0);
+    CHECK(comparison.evaluate(std::vector<double>{2.0, 1.0}) == 0.0);
+  }
+}
+
+TEST_CASE("Expression - overflow checks") {
+  // Arrange - select(flag, x * x, 0)
+  Expression expression;
+  NodeId x = expression.input(0);
+  expression.select(expression.input(1), expression.multiply(x, x),
+                    expression.constant(0.0));
+
+  SUBCASE("unchecked evaluation keeps the double result") {
+    // Act
+    double result = expression.evaluate(std::vector<double>{1e5, 1.0});
+
+    // Assert
+    CHECK(result == 1e10);
+  }
+
+  SUBCASE("nodes the result depends on are checked, selected or not") {
+    // Act & Assert
+    CHECK_THROWS_AS(expression.evaluate(std::vector<double>{1e5, 0.0}, true),
+                    std::overflow_error);
+    CHECK(expression.evaluate(std::vector<double>{10.0, 1.0}, true) == 100.0);
+  }
+
+  SUBCASE("a constant condition drops the branch it does not pick") {
+    // Arrange
+    Expression folded;
+    NodeId value = folded.input(0);
+    folded.select(folded.less(folded.constant(1.0), folded.constant(0.0)),
+                  folded.multiply(value, value), value);
+
+    // Act
+    double result = folded.evaluate(std::vector<double>{1e6}, true);
+
+    // Assert
+    CHECK(result == 1e6);
+  }
+}
@@ -0,0 +1,399 @@
+// First-party headers
+#include "calculator/calculator.h"
+#include "calculator/gather.h"
+
+// Standard library headers
+#include <algorithm>
+#include <stdexcept>
+
+#if !defined(__GNUC__) && defined(_MSC_VER) &&                               \
+    (defined(_M_X64) || defined(_M_IX86))
+#define CALCULATOR_MM_PREFETCH
+#include <xmmintrin.h>
+#endif
+
+namespace {
+
+// Indices between an access and the prefetch issued with it; the clustered
+// gather benchmark gains most around here, and random gathers are flat
+// from 8 to 256.
+constexpr std::size_t PREFETCH_DISTANCE = 64;
+
+// Values that fit in L2 are served from cache anyway, and prefetching them
+// only costs issue slots.
+constexpr std::size_t PREFETCH_MIN_BYTES = std::size_t{1} << 20;
+
+// Indices checked and then processed at a time, so that they are read
+// from L1 the second time; chunks that strictly ascend take the run loop.
+constexpr std::size_t CHUNK_SIZE = 2048;
+
+// Strictly ascending indices handled at a time; a stretch whose last index
+// is its first plus RUN_LENGTH - 1 is then a consecutive run.
+constexpr std::size_t RUN_LENGTH = 64;
+
+// A hint only, so compilers without one simply skip it.
+inline void prefetch(const void* address) {
+#if defined(__GNUC__)
+  __builtin_prefetch(address);
+#elif defined(CALCULATOR_MM_PREFETCH)
+  _mm_prefetch(static_cast<const char*>(address), _MM_HINT_T0);
+#else
+  static_cast<void>(address);
+#endif
+}
+
+void check_counts(std::size_t index_count, std::size_t operand_count) {
+  if (index_count != operand_count) {
+    throw std::invalid_argument("Operand counts do not match");
+  }
+}
+
+void check_results(std::size_t index_count, std::size_t result_count) {
+  if (result_count < index_count) {
+    throw std::invalid_argument("Missing result values");
+  }
+}
+
+// Visits every position of indices chunk by chunk. Each chunk is checked
+// against value_count first and then goes through one of three loops:
+//   sorted:  (strictly ascending, so without repeats)
+//            run(position, RUN_LENGTH) for stretches of consecutive
+//            indices, element(position) for the rest;
+//   large:   element(position) after prefetching the value at the index
+//            PREFETCH_DISTANCE positions ahead;
+//   small:   element(position) alone.
+// An index out of range throws once the chunks before it are done.
+template <typename T, typename Element, typename Run>
+void visit(const T* values, std::size_t value_count,
+           std::span<const std::uint32_t> indices, const Element& element,
+           const Run& run) {
+  const bool prefetching = value_count * sizeof(T) > PREFETCH_MIN_BYTES;
+  for (std::size_t first = 0; first < indices.size(); first += CHUNK_SIZE) {
+    const std::size_t last = std::min(first + CHUNK_SIZE, indices.size());
+    // Both reductions are branch-free, so the check vectorizes.
+    std::uint32_t maximum = indices[first];
+    std::uint32_t non_ascents = 0;
+    for (std::size_t position = first + 1; position < last; ++position) {
+      maximum = std::max(maximum, indices[position]);
+      non_ascents += indices[position] <= indices[position - 1] ? 1u : 0u;
+    }
+    if (maximum >= value_count) {
+      throw std::out_of_range("Index exceeds value count");
+    }
+
+    std::size_t position = first;
+    if (non_ascents == 0) {
+      for (; position + RUN_LENGTH <= last; position += RUN_LENGTH) {
+        if (indices[position + RUN_LENGTH - 1] - indices[position] ==
+            RUN_LENGTH - 1) {
+          run(position, RUN_LENGTH);
+          continue;
+        }
+        for (std::size_t offset = 0; offset < RUN_LENGTH; ++offset) {
+          element(position + offset);
+        }
+      }
+    } else if (prefetching) {
+      for (; position + PREFETCH_DISTANCE < last; ++position) {
+        prefetch(values + indices[position + PREFETCH_DISTANCE]);
+        element(position);
+      }
+    }
+    for (; position < last; ++position) {
+      element(position);
+    }
+  }
+}
+
+// results[i] = operation(values[indices[i]], operands[i]).
+template <typename Result, typename Operation>
+void gather_apply(std::span<const int> values,
+                  std::span<const std::uint32_t> indices,
+                  std::span<const int> operands, std::span<Result> results,
+                  const Operation& operation) {
+  check_counts(indices.size(), operands.size());
+  check_results(indices.size(), results.size());
+  visit(
+      values.data(), values.size(), indices,
+      [&](std::size_t position) {
+        results[position] =
+            operation(values[indices[position]], operands[position]);
+      },
+      [&](std::size_t position, std::size_t length) {
+        const int* source = values.data() + indices[position];
+        for (std::size_t offset = 0; offset < length; ++offset) {
+          results[position + offset] =
+              operation(source[offset], operands[position + offset]);
+        }
+      });
+}
+
+// Wrapping arithmetic, as lambdas so that the loops inline and vectorize.
+constexpr auto WRAPPING_ADD = [](int first_value, int second_value) {
+  return static_cast<int>(static_cast<std::uint32_t>(first_value) +
+                          static_cast<std::uint32_t>(second_value));
+};
+
+constexpr auto WRAPPING_SUBTRACT = [](int first_value, int second_value) {
+  return static_cast<int>(static_cast<std::uint32_t>(first_value) -
+                          static_cast<std::uint32_t>(second_value));
+};
+
+constexpr auto WRAPPING_MULTIPLY = [](int first_value, int second_value) {
+  return static_cast<int>(static_cast<std::uint32_t>(first_value) *
+                          static_cast<std::uint32_t>(second_value));
+};
+
+} // namespace
+
+void take(std::span<const int> values, std::span<const std::uint32_t> indices,
+          std::span<int> results) {
+  check_results(indices.size(), results.size());
+  visit(
+      values.data(), values.size(), indices,
+      [&](std::size_t position) {
+        results[position] = values[indices[position]];
+      },
+      [&](std::size_t position, std::size_t length) {
+        std::copy_n(values.begin() +
+                        static_cast<std::ptrdiff_t>(indices[position]),
+                    length,
+                    results.begin() + static_cast<std::ptrdiff_t>(position));
+      });
+}
+
+void put(std::span<int> values, std::span<const std::uint32_t> indices,
+         std::span<const int> sources) {
+  check_counts(indices.size(), sources.size());
+  visit(
+      values.data(), values.size(), indices,
+      [&](std::size_t position) {
+        values[indices[position]] = sources[position];
+      },
+      [&](std::size_t position, std::size_t length) {
+        std::copy_n(sources.begin() + static_cast<std::ptrdiff_t>(position),
+                    length,
+                    values.begin() +
+                        static_cast<std::ptrdiff_t>(indices[position]));
+      });
+}
+
+void GatherCalculator::add(std::span<const int> values,
+                           std::span<const std::uint32_t> indices,
+                           std::span<const int> operands,
+                           std::span<int> results) {
+  gather_apply(values, indices, operands, results, WRAPPING_ADD);
+}
+
+void GatherCalculator::subtract(std::span<const int> values,
+                                std::span<const std::uint32_t> indices,
+                                std::span<const int> operands,
+                                std::span<int> results) {
+  gather_apply(values, indices, operands, results, WRAPPING_SUBTRACT);
+}
+
+void GatherCalculator::multiply(std::span<const int> values,
+                                std::span<const std::uint32_t> indices,
+                                std::span<const int> operands,
+                                std::span<int> results) {
+  gather_apply(values, indices, operands, results, WRAPPING_MULTIPLY);
+}
+
+void GatherCalculator::divide(std::span<const int> values,
+                              std::span<const std::uint32_t> indices,
+                              std::span<const int> operands,
+                              std::span<double> results) {
+  check_counts(indices.size(), operands.size());
+  if (std::find(operands.begin(), operands.end(), 0) != operands.end()) {
+    throw std::invalid_argument("Division by zero");
+  }
+  gather_apply(values, indices, operands, results,
+               [](int first_value, int second_value) {
+                 return static_cast<double>(first_value) / second_value;
+               });
+}
+
+// Unit tests (embedded in source file)
+// Disabled in production builds via DOCTEST_CONFIG_DISABLE
+#include <doctest/doctest.h>
+
+// Standard library headers
+#include <numeric>
+#include <random>
+#include <vector>
+
+namespace {
+
+// Index patterns reaching each loop: sorted with consecutive runs, sorted
+// with gaps, shuffled, and consecutive runs wrapping every 1500 positions
+// so that sorted and unsorted chunks alternate.
+std::vector<std::vector<std::uint32_t>>
+index_patterns(std::size_t count, std::uint32_t value_count) {
+  std::mt19937_64 random(11);
+  std::vector<std::uint32_t> consecutive(count);
+  std::iota(consecutive.begin(), consecutive.end(), 5u);
+  std::vector<std::uint32_t> sorted(count);
+  for (std::uint32_t& index : sorted) {
+    index = static_cast<std::uint32_t>(random() % value_count);
+  }
+  std::sort(sorted.begin(), sorted.end());
+  std::vector<std::uint32_t> shuffled(count);
+  for (std::uint32_t& index : shuffled) {
+    index = static_cast<std::uint32_t>(random() % value_count);
+  }
+  std::vector<std::uint32_t> wrapping(count);
+  for (std::size_t position = 0; position < count; ++position) {
+    wrapping[position] = static_cast<std::uint32_t>(position % 1500);
+  }
+  return {consecutive, sorted, shuffled, wrapping};
+}
+
+std::vector<int> iota_values(std::size_t count, int first) {
+  std::vector<int> values(count);
+  std::iota(values.begin(), values.end(), first);
+  return values;
+}
+
+} // namespace
+
+TEST_CASE("Gather - take and put") {
+  SUBCASE("take matches indexing for every index pattern") {
+    // Tables in cache and large enough to be prefetched
+    for (std::size_t value_count : {std::size_t{6000}, std::size_t{1} << 19}) {
+      // Arrange
+      const std::vector<int> values = iota_values(value_count, -100);
+      for (const auto& indices :
+           index_patterns(5000, static_cast<std::uint32_t>(value_count))) {
+        std::vector<int> results(indices.size());
+
+        // Act
+        take(values, indices, results);
+
+        // Assert
+        for (std::size_t position = 0; position < indices.size();
+             ++position) {
+          CHECK(results[position] == values[indices[position]]);
+        }
+      }
+    }
+  }
+
+  SUBCASE("put keeps the last of repeated indices") {
+    for (const auto& indices : index_patterns(5000, 6000)) {
+      // Arrange
+      std::vector<int> values(6000, -1);
+      std::vector<int> expected = values;
+      const std::vector<int> sources = iota_values(indices.size(), 1);
+      for (std::size_t position = 0; position < indices.size(); ++position) {
+        expected[indices[position]] = sources[position];
+      }
+
+      // Act
+      put(values, indices, sources);
+
+      // Assert
+      CHECK(values == expected);
+    }
+  }
+
+  SUBCASE("a repeat and a gap in one stretch are not a run") {
+    // Arrange - 0, 0, 2, 3, ..., 63 spans 63 like a consecutive run
+    std::vector<std::uint32_t> indices(64);
+    std::iota(indices.begin() + 1, indices.end(), 1u);
+    indices[1] = 0;
+    std::vector<int> values = iota_values(64, 100);
+    std::vector<int> results(indices.size());
+    const std::vector<int> sources = iota_values(indices.size(), 1);
+    std::vector<int> expected = values;
+    for (std::size_t position = 0; position < indices.size(); ++position) {
+      expected[indices[position]] = sources[position];
+    }
+
+    // Act
+    take(values, indices, results);
+    put(values, indices, sources);
+
+    // Assert
+    CHECK(results[0] == 100);
+    CHECK(results[1] == 100);
+    CHECK(results[2] == 102);
+    CHECK(values == expected);
+    CHECK(values[0] == 2);
+    CHECK(values[1] == 101);
+  }
+
+  SUBCASE("invalid spans") {
+    // Arrange
+    std::vector<int> values = {1, 2, 3};
+    const std::vector<std::uint32_t> indices = {0, 3};
+    const std::vector<std::uint32_t> valid = {2, 1};
+    std::vector<int> results(2);
+    const std::vector<int> sources = {7};
+
+    // Act & Assert
+    CHECK_THROWS_AS(take(values, indices, results), std::out_of_range);
+    CHECK_THROWS_AS(put(values, indices, std::vector<int>{7, 8}),
+                    std::out_of_range);
+    CHECK_THROWS_AS(take(values, valid, std::span<int>(results).first(1)),
+                    std::invalid_argument);
+    CHECK_THROWS_AS(put(values, valid, sources), std::invalid_argument);
+    take(values, std::span<const std::uint32_t>(), std::span<int>());
+    CHECK(values == std::vector<int>{1, 2, 3});
+  }
+}
+
+TEST_CASE("GatherCalculator - matches Calculator on gathered values") {
+  // Arrange
+  GatherCalculator gather_calculator;
+  Calculator calculator;
+  const std::vector<int> values = iota_values(std::size_t{1} << 19, -5000);
+  const std::vector<int> weights = iota_values(5000, -2500);
+  std::vector<int> divisors = weights;
+  std::replace(divisors.begin(), divisors.end(), 0, 1);
+
+  SUBCASE("every operation and index pattern") {
+    for (const auto& indices :
+         index_patterns(weights.size(),
+                        static_cast<std::uint32_t>(values.size()))) {
+      std::vector<int> sums(indices.size());
+      std::vector<int> differences(indices.size());
+      std::vector<int> products(indices.size());
+      std::vector<double> quotients(indices.size());
+
+      // Act
+      gather_calculator.add(values, indices, weights, sums);
+      gather_calculator.subtract(values, indices, weights, differences);
+      gather_calculator.multiply(values, indices, weights, products);
+      gather_calculator.divide(values, indices, divisors, quotients);
+
+      // Assert
+      for (std::size_t position = 0; position < indices.size();
+           ++position) {
+        const int value = values[indices[position]];
+        CHECK(sums[position] == calculator.add(value, weights[position]));
+        CHECK(differences[position] ==
+              calculator.subtract(value, weights[position]));
+        CHECK(products[position] ==
+              calculator.multiply(value, weights[position]));
+        CHECK(quotients[position] ==
+              calculator.divide(value, divisors[position]));
+      }
+    }
+  }
+
+  SUBCASE("division by zero and mismatched operands") {
+    // Arrange
+    const std::vector<std::uint32_t> indices(weights.size(), 0);
+    std::vector<double> quotients(weights.size());
+    std::vector<int> products(weights.size());
+
+    // Act & Assert
+    CHECK_THROWS_AS(gather_calculator.divide(values, indices, weights,
+                                             quotients),
+                    std::invalid_argument);
+    CHECK_THROWS_AS(gather_calculator.multiply(
+                        values, std::span(indices).first(10), weights,
+                        products),
+                    std::invalid_argument);
+  }
+}
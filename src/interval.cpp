@@ -0,0 +1,170 @@
+// First-party headers
+#include "calculator/interval.h"
+
+// Standard library headers
+#include <algorithm>
+#include <cmath>
+#include <initializer_list>
+#include <stdexcept>
+
+namespace {
+
+Interval hull(std::initializer_list<double> candidates) {
+  Interval result{std::numeric_limits<double>::infinity(),
+                  -std::numeric_limits<double>::infinity()};
+  for (double candidate : candidates) {
+    if (std::isnan(candidate)) {
+      return Interval{};
+    }
+    result.lower = std::min(result.lower, candidate);
+    result.upper = std::max(result.upper, candidate);
+  }
+  return result;
+}
+
+// Product of two bounds where zero times infinity is zero, which is the
+// limit the interval endpoints stand for.
+double bound_product(double first_bound, double second_bound) {
+  if (first_bound == 0.0 || second_bound == 0.0) {
+    return 0.0;
+  }
+  return first_bound * second_bound;
+}
+
+} // namespace
+
+Interval Interval::point(double value) { return Interval{value, value}; }
+
+bool Interval::contains(double value) const {
+  return lower <= value && value <= upper;
+}
+
+bool Interval::is_within(const Interval& other) const {
+  return other.lower <= lower && upper <= other.upper;
+}
+
+Interval apply_interval(Opcode opcode, const Interval& first,
+                        const Interval& second) {
+  switch (opcode) {
+  case Opcode::Add:
+    return hull({first.lower + second.lower, first.upper + second.upper});
+  case Opcode::Subtract:
+    return hull({first.lower - second.upper, first.upper - second.lower});
+  case Opcode::Multiply:
+    return hull({bound_product(first.lower, second.lower),
+                 bound_product(first.lower, second.upper),
+                 bound_product(first.upper, second.lower),
+                 bound_product(first.upper, second.upper)});
+  case Opcode::Divide:
+    if (second.contains(0.0)) {
+      return Interval{};
+    }
+    return hull({first.lower / second.lower, first.lower / second.upper,
+                 first.upper / second.lower, first.upper / second.upper});
+  default:
+    if (is_comparison(opcode)) {
+      return Interval{0.0, 1.0};
+    }
+    throw std::invalid_argument("Opcode is not a binary operation");
+  }
+}
+
+Interval select_interval(const Interval& condition, const Interval& if_true,
+                         const Interval& if_false) {
+  if (!condition.contains(0.0)) {
+    return if_true;
+  }
+  if (condition.lower == 0.0 && condition.upper == 0.0) {
+    return if_false;
+  }
+  return hull({if_true.lower, if_true.upper, if_false.lower, if_false.upper});
+}
+
+// Unit tests (embedded in source file)
+// Disabled in production builds via DOCTEST_CONFIG_DISABLE
+#include <doctest/doctest.h>
+
+TEST_CASE("Interval - arithmetic") {
+  Interval small{-2.0, 3.0};
+  Interval positive{1.0, 4.0};
+
+  SUBCASE("addition and subtraction combine opposite bounds") {
+    // Act
+    Interval sum = apply_interval(Opcode::Add, small, positive);
+    Interval difference = apply_interval(Opcode::Subtract, small, positive);
+
+    // Assert
+    CHECK(sum.lower == -1.0);
+    CHECK(sum.upper == 7.0);
+    CHECK(difference.lower == -6.0);
+    CHECK(difference.upper == 2.0);
+  }
+
+  SUBCASE("multiplication takes the hull of endpoint products") {
+    // Act
+    Interval product = apply_interval(Opcode::Multiply, small, small);
+
+    // Assert
+    CHECK(product.lower == -6.0);
+    CHECK(product.upper == 9.0);
+  }
+
+  SUBCASE("zero times an unbounded side stays zero") {
+    // Act
+    Interval product =
+        apply_interval(Opcode::Multiply, Interval::point(0.0), Interval{});
+
+    // Assert
+    CHECK(product.lower == 0.0);
+    CHECK(product.upper == 0.0);
+  }
+
+  SUBCASE("divisor range containing zero is unbounded") {
+    // Act
+    Interval quotient = apply_interval(Opcode::Divide, positive, small);
+
+    // Assert
+    CHECK(std::isinf(quotient.lower));
+    CHECK(std::isinf(quotient.upper));
+  }
+
+  SUBCASE("divisor range excluding zero is bounded") {
+    // Act
+    Interval quotient = apply_interval(Opcode::Divide, small, positive);
+
+    // Assert
+    CHECK(quotient.lower == -2.0);
+    CHECK(quotient.upper == 3.0);
+  }
+}
+
+TEST_CASE("Interval - conditionals") {
+  SUBCASE("comparisons are boolean") {
+    // Act
+    Interval result = apply_interval(Opcode::Less, Interval{}, Interval{});
+
+    // Assert
+    CHECK(result.lower == 0.0);
+    CHECK(result.upper == 1.0);
+  }
+
+  SUBCASE("undecided selects cover both branches") {
+    // Act
+    Interval result = select_interval(Interval{0.0, 1.0}, Interval{5.0, 6.0},
+                                      Interval::point(0.0));
+
+    // Assert
+    CHECK(result.lower == 0.0);
+    CHECK(result.upper == 6.0);
+  }
+
+  SUBCASE("decided selects keep one branch") {
+    // Act
+    Interval result = select_interval(Interval::point(1.0),
+                                      Interval{5.0, 6.0}, Interval{});
+
+    // Assert
+    CHECK(result.lower == 5.0);
+    CHECK(result.upper == 6.0);
+  }
+}
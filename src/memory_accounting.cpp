@@ -0,0 +1,367 @@
+// First-party headers
+#include "calculator/memory_accounting.h"
+
+// Standard library headers
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <new>
+#include <string_view>
+#include <thread>
+
+namespace {
+
+std::size_t index_of(MemorySubsystem subsystem) {
+  return static_cast<std::size_t>(subsystem);
+}
+
+struct SharedCounters {
+  std::atomic<std::int64_t> current_bytes{0};
+  std::atomic<std::int64_t> peak_bytes{0};
+  // Counts left by exited threads and by threads that are exiting.
+  std::atomic<std::uint64_t> allocations{0};
+  std::atomic<std::uint64_t> deallocations{0};
+};
+
+struct Registry {
+  std::mutex mutex;
+  std::vector<ThreadMemoryCounters*> threads;
+  std::array<SharedCounters, MEMORY_SUBSYSTEM_COUNT> shared;
+};
+
+// Constructed in static storage, so creating it cannot fail, and never
+// destroyed, so memory released during static destruction is still
+// counted.
+Registry& registry() {
+  alignas(Registry) static unsigned char storage[sizeof(Registry)];
+  static Registry* instance = new (storage) Registry;
+  return *instance;
+}
+
+void raise_peak(SharedCounters& shared, std::int64_t current) {
+  std::int64_t peak = shared.peak_bytes.load(std::memory_order_relaxed);
+  while (current > peak && !shared.peak_bytes.compare_exchange_weak(
+                               peak, current, std::memory_order_relaxed)) {
+  }
+}
+
+void add_shared_bytes(SharedCounters& shared, std::int64_t bytes) {
+  raise_peak(shared, shared.current_bytes.fetch_add(
+                         bytes, std::memory_order_relaxed) +
+                         bytes);
+}
+
+// Folds a thread's pending bytes into the shared count, first raising the
+// shared peak by the thread's own high-water mark since the last fold.
+void flush(ThreadMemoryCounters::Subsystem& counters,
+           SharedCounters& shared) {
+  const std::int64_t pending =
+      counters.pending_bytes.load(std::memory_order_relaxed);
+  const std::int64_t peak =
+      counters.pending_peak.load(std::memory_order_relaxed);
+  counters.pending_bytes.store(0, std::memory_order_relaxed);
+  counters.pending_peak.store(0, std::memory_order_relaxed);
+  raise_peak(shared,
+             shared.current_bytes.load(std::memory_order_relaxed) + peak);
+  add_shared_bytes(shared, pending);
+}
+
+constinit thread_local bool counters_retired = false;
+
+// Registers the thread's counters on its first allocation and folds them
+// into the shared counters when the thread exits.
+class ThreadRegistration {
+public:
+  ThreadRegistration() {
+    Registry& shared_registry = registry();
+    std::lock_guard lock(shared_registry.mutex);
+    shared_registry.threads.push_back(&m_counters);
+    thread_memory_counters = &m_counters;
+  }
+
+  ~ThreadRegistration() {
+    // Thread-local containers destroyed after this point count directly
+    // into the shared counters.
+    thread_memory_counters = nullptr;
+    counters_retired = true;
+
+    Registry& shared_registry = registry();
+    std::lock_guard lock(shared_registry.mutex);
+    for (std::size_t index = 0; index < MEMORY_SUBSYSTEM_COUNT; ++index) {
+      ThreadMemoryCounters::Subsystem& counters =
+          m_counters.subsystems[index];
+      SharedCounters& shared = shared_registry.shared[index];
+      flush(counters, shared);
+      shared.allocations.fetch_add(counters.allocations.load(),
+                                   std::memory_order_relaxed);
+      shared.deallocations.fetch_add(counters.deallocations.load(),
+                                     std::memory_order_relaxed);
+    }
+    std::erase(shared_registry.threads, &m_counters);
+  }
+
+  ThreadRegistration(const ThreadRegistration&) = delete;
+  ThreadRegistration& operator=(const ThreadRegistration&) = delete;
+
+private:
+  ThreadMemoryCounters m_counters;
+};
+
+// Null once the thread has started tearing down its thread-locals, or when
+// registering fails; the caller then counts into the shared counters and
+// the next allocation tries again.
+ThreadMemoryCounters* register_thread() noexcept {
+  if (counters_retired) {
+    return nullptr;
+  }
+  try {
+    thread_local ThreadRegistration registration;
+    return thread_memory_counters;
+  } catch (...) {
+    return nullptr;
+  }
+}
+
+} // namespace
+
+constinit thread_local ThreadMemoryCounters* thread_memory_counters = nullptr;
+
+const char* memory_subsystem_name(MemorySubsystem subsystem) {
+  switch (subsystem) {
+  case MemorySubsystem::Programs:
+    return "programs";
+  case MemorySubsystem::Buffers:
+    return "buffers";
+  case MemorySubsystem::Caches:
+    return "caches";
+  case MemorySubsystem::Profiler:
+    return "profiler";
+  }
+  return "unknown";
+}
+
+const MemoryUsage& MemorySnapshot::operator[](MemorySubsystem subsystem) const {
+  return subsystems[index_of(subsystem)];
+}
+
+std::int64_t MemorySnapshot::total_current_bytes() const {
+  std::int64_t total = 0;
+  for (const MemoryUsage& usage : subsystems) {
+    total += usage.current_bytes;
+  }
+  return total;
+}
+
+MemorySnapshot memory_snapshot() {
+  Registry& shared_registry = registry();
+  std::lock_guard lock(shared_registry.mutex);
+
+  MemorySnapshot snapshot;
+  for (std::size_t index = 0; index < MEMORY_SUBSYSTEM_COUNT; ++index) {
+    SharedCounters& shared = shared_registry.shared[index];
+    MemoryUsage& usage = snapshot.subsystems[index];
+    usage.current_bytes = shared.current_bytes.load(std::memory_order_relaxed);
+    usage.allocation_count = shared.allocations.load(std::memory_order_relaxed);
+    usage.deallocation_count =
+        shared.deallocations.load(std::memory_order_relaxed);
+    // The highest unfolded bytes of any one thread, beyond its current
+    // ones.
+    std::int64_t excess = 0;
+    for (const ThreadMemoryCounters* thread : shared_registry.threads) {
+      const ThreadMemoryCounters::Subsystem& counters =
+          thread->subsystems[index];
+      const std::int64_t pending =
+          counters.pending_bytes.load(std::memory_order_relaxed);
+      usage.current_bytes += pending;
+      usage.allocation_count +=
+          counters.allocations.load(std::memory_order_relaxed);
+      usage.deallocation_count +=
+          counters.deallocations.load(std::memory_order_relaxed);
+      excess = std::max(
+          excess,
+          counters.pending_peak.load(std::memory_order_relaxed) - pending);
+    }
+    raise_peak(shared, usage.current_bytes + excess);
+    usage.peak_bytes = shared.peak_bytes.load(std::memory_order_relaxed);
+  }
+  return snapshot;
+}
+
+void record_allocation_slow(MemorySubsystem subsystem,
+                            std::size_t bytes) noexcept {
+  if (register_thread() != nullptr) {
+    record_allocation(subsystem, bytes);
+    return;
+  }
+
+  SharedCounters& shared = registry().shared[index_of(subsystem)];
+  shared.allocations.fetch_add(1, std::memory_order_relaxed);
+  add_shared_bytes(shared, static_cast<std::int64_t>(bytes));
+}
+
+// Releases never register the thread, as registering may allocate; a
+// thread that has not allocated yet counts straight into the shared
+// counters.
+void record_deallocation_slow(MemorySubsystem subsystem,
+                              std::size_t bytes) noexcept {
+  SharedCounters& shared = registry().shared[index_of(subsystem)];
+  shared.deallocations.fetch_add(1, std::memory_order_relaxed);
+  shared.current_bytes.fetch_sub(static_cast<std::int64_t>(bytes),
+                                 std::memory_order_relaxed);
+}
+
+void flush_memory_counters(MemorySubsystem subsystem) noexcept {
+  const std::size_t index = index_of(subsystem);
+  flush(thread_memory_counters->subsystems[index], registry().shared[index]);
+}
+
+TrackedMemoryResource::TrackedMemoryResource(
+    MemorySubsystem subsystem, std::pmr::memory_resource* upstream)
+    : m_subsystem(subsystem), m_upstream(upstream) {}
+
+MemorySubsystem TrackedMemoryResource::subsystem() const {
+  return m_subsystem;
+}
+
+void* TrackedMemoryResource::do_allocate(std::size_t bytes,
+                                         std::size_t alignment) {
+  void* pointer = m_upstream->allocate(bytes, alignment);
+  record_allocation(m_subsystem, bytes);
+  return pointer;
+}
+
+void TrackedMemoryResource::do_deallocate(void* pointer, std::size_t bytes,
+                                          std::size_t alignment) {
+  record_deallocation(m_subsystem, bytes);
+  m_upstream->deallocate(pointer, bytes, alignment);
+}
+
+bool TrackedMemoryResource::do_is_equal(
+    const std::pmr::memory_resource& other) const noexcept {
+  // Memory is charged per subsystem, so any resource over the same
+  // upstream and subsystem can release it.
+  const auto* tracked = dynamic_cast<const TrackedMemoryResource*>(&other);
+  return tracked != nullptr && tracked->m_subsystem == m_subsystem &&
+         tracked->m_upstream->is_equal(*m_upstream);
+}
+
+// Unit tests (embedded in source file)
+// Disabled in production builds via DOCTEST_CONFIG_DISABLE
+#include <doctest/doctest.h>
+
+TEST_CASE("MemoryAccounting - tracked allocator") {
+  SUBCASE("counts bytes and allocations while a container is alive") {
+    // Arrange
+    const MemoryUsage before = memory_snapshot()[MemorySubsystem::Caches];
+
+    // Act
+    MemoryUsage during;
+    {
+      TrackedVector<double, MemorySubsystem::Caches> values(1000);
+      during = memory_snapshot()[MemorySubsystem::Caches];
+    }
+    const MemoryUsage after = memory_snapshot()[MemorySubsystem::Caches];
+
+    // Assert
+    CHECK(during.current_bytes ==
+          before.current_bytes + 1000 * std::int64_t{sizeof(double)});
+    CHECK(during.allocation_count == before.allocation_count + 1);
+    CHECK(after.current_bytes == before.current_bytes);
+    CHECK(after.deallocation_count == before.deallocation_count + 1);
+  }
+
+  SUBCASE("peak covers a released allocation") {
+    // Arrange
+    const MemoryUsage before = memory_snapshot()[MemorySubsystem::Caches];
+    const std::size_t count = 4 * PEAK_GRANULARITY;
+
+    // Act
+    { TrackedVector<char, MemorySubsystem::Caches> bytes(count); }
+    const MemoryUsage after = memory_snapshot()[MemorySubsystem::Caches];
+
+    // Assert
+    CHECK(after.peak_bytes >=
+          before.current_bytes + static_cast<std::int64_t>(count));
+    CHECK(after.current_bytes == before.current_bytes);
+  }
+
+  SUBCASE("peak covers an allocation below the granularity") {
+    // Arrange
+    const MemoryUsage before = memory_snapshot()[MemorySubsystem::Caches];
+
+    // Act
+    { TrackedVector<double, MemorySubsystem::Caches> values(100); }
+    const MemoryUsage after = memory_snapshot()[MemorySubsystem::Caches];
+
+    // Assert
+    CHECK(after.peak_bytes >=
+          before.current_bytes + 100 * std::int64_t{sizeof(double)});
+    CHECK(after.current_bytes == before.current_bytes);
+  }
+
+  SUBCASE("memory released on another thread nets out") {
+    // Arrange
+    const MemoryUsage before = memory_snapshot()[MemorySubsystem::Caches];
+    TrackedVector<double, MemorySubsystem::Caches> values;
+
+    // Act
+    std::thread([&values] { values.resize(100); }).join();
+    const MemoryUsage during = memory_snapshot()[MemorySubsystem::Caches];
+    values = TrackedVector<double, MemorySubsystem::Caches>();
+    const MemoryUsage after = memory_snapshot()[MemorySubsystem::Caches];
+
+    // Assert
+    CHECK(during.current_bytes ==
+          before.current_bytes + 100 * std::int64_t{sizeof(double)});
+    CHECK(during.allocation_count == before.allocation_count + 1);
+    CHECK(after.current_bytes == before.current_bytes);
+  }
+
+  SUBCASE("a thread that only releases memory counts into the shared "
+          "counters") {
+    // Arrange
+    const MemoryUsage before = memory_snapshot()[MemorySubsystem::Caches];
+    TrackedVector<double, MemorySubsystem::Caches> values(100);
+
+    // Act
+    std::thread([&values] {
+      values = TrackedVector<double, MemorySubsystem::Caches>();
+    }).join();
+    const MemoryUsage after = memory_snapshot()[MemorySubsystem::Caches];
+
+    // Assert
+    CHECK(after.current_bytes == before.current_bytes);
+    CHECK(after.deallocation_count == before.deallocation_count + 1);
+  }
+}
+
+TEST_CASE("MemoryAccounting - tracked memory resource") {
+  // Arrange
+  TrackedMemoryResource resource(MemorySubsystem::Buffers);
+  TrackedMemoryResource same(MemorySubsystem::Buffers);
+  TrackedMemoryResource other(MemorySubsystem::Caches);
+  const MemoryUsage before = memory_snapshot()[MemorySubsystem::Buffers];
+
+  // Act
+  MemoryUsage during;
+  {
+    std::pmr::vector<int> values(64, &resource);
+    during = memory_snapshot()[MemorySubsystem::Buffers];
+  }
+  const MemoryUsage after = memory_snapshot()[MemorySubsystem::Buffers];
+
+  // Assert
+  CHECK(during.current_bytes ==
+        before.current_bytes + 64 * std::int64_t{sizeof(int)});
+  CHECK(after.current_bytes == before.current_bytes);
+  CHECK(resource.is_equal(same));
+  CHECK_FALSE(resource.is_equal(other));
+}
+
+TEST_CASE("MemoryAccounting - subsystem names") {
+  // Act & Assert
+  CHECK(std::string_view(memory_subsystem_name(MemorySubsystem::Programs)) ==
+        "programs");
+  CHECK(std::string_view(memory_subsystem_name(MemorySubsystem::Profiler)) ==
+        "profiler");
+}
@@ -0,0 +1,427 @@
+// First-party headers
+#include "calculator/narrowed_expression.h"
+#include "probes.h"
+
+// Standard library headers
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <type_traits>
+#include <variant>
+#include <vector>
+
+CALCULATOR_PROBE_SEMAPHORE(divide__by__zero);
+
+namespace {
+
+using SourcePointer = std::variant<const std::int16_t*, const std::int32_t*,
+                                   const float*, const double*>;
+using TargetPointer = std::variant<std::int16_t*, std::int32_t*, double*>;
+
+Interval type_range(ValueType type) {
+  switch (type) {
+  case ValueType::Int16:
+    return Interval{-32768.0, 32767.0};
+  case ValueType::Int32:
+    return INT_RANGE;
+  default:
+    return Interval{};
+  }
+}
+
+bool is_integral(ValueType type) {
+  return type == ValueType::Int16 || type == ValueType::Int32;
+}
+
+ValueType narrowest_integral(const Interval& range) {
+  if (range.is_within(type_range(ValueType::Int16))) {
+    return ValueType::Int16;
+  }
+  if (range.is_within(type_range(ValueType::Int32))) {
+    return ValueType::Int32;
+  }
+  return ValueType::Float64;
+}
+
+// Integer nodes compute in uint32_t and double nodes in double. Integer
+// results are proven to fit the output type, so wrapping arithmetic and the
+// narrowing store are exact for inputs within their declared ranges, and
+// inputs outside them wrap instead of overflowing a signed type.
+template <typename Output, typename First, typename Second>
+void run_narrowed_kernel(Opcode opcode, bool checked, const First* first,
+                         const Second* second, Output* output,
+                         std::size_t count) {
+  using Compute =
+      std::conditional_t<std::is_integral_v<Output>, std::uint32_t,
+                         std::common_type_t<Output, First, Second>>;
+  switch (opcode) {
+  case Opcode::Add:
+    for (std::size_t index = 0; index < count; ++index) {
+      output[index] = static_cast<Output>(static_cast<Compute>(first[index]) +
+                                          static_cast<Compute>(second[index]));
+    }
+    break;
+  case Opcode::Subtract:
+    for (std::size_t index = 0; index < count; ++index) {
+      output[index] = static_cast<Output>(static_cast<Compute>(first[index]) -
+                                          static_cast<Compute>(second[index]));
+    }
+    break;
+  case Opcode::Multiply:
+    for (std::size_t index = 0; index < count; ++index) {
+      output[index] = static_cast<Output>(static_cast<Compute>(first[index]) *
+                                          static_cast<Compute>(second[index]));
+    }
+    break;
+  case Opcode::Divide:
+    if (checked) {
+      bool has_zero_divisor = false;
+      for (std::size_t index = 0; index < count; ++index) {
+        has_zero_divisor |= second[index] == 0;
+      }
+      if (has_zero_divisor) {
+        CALCULATOR_PROBE0(divide__by__zero);
+        throw std::invalid_argument("Division by zero");
+      }
+    }
+    for (std::size_t index = 0; index < count; ++index) {
+      output[index] = static_cast<Output>(static_cast<double>(first[index]) /
+                                          static_cast<double>(second[index]));
+    }
+    break;
+  default:
+    throw std::invalid_argument("Opcode is not an arithmetic operation");
+  }
+}
+
+} // namespace
+
+NarrowedExpression::NarrowedExpression(
+    const Expression& expression,
+    std::span<const InputDeclaration> declarations) {
+  const std::vector<Instruction>& instructions = expression.instructions();
+  if (instructions.empty()) {
+    throw std::logic_error("Expression has no instructions");
+  }
+  if (declarations.size() <
+      static_cast<std::size_t>(expression.input_count())) {
+    throw std::invalid_argument("Missing input declarations");
+  }
+
+  for (const Instruction& instruction : instructions) {
+    if (instruction.opcode == Opcode::Select ||
+        is_comparison(instruction.opcode)) {
+      throw std::invalid_argument(
+          "Narrowed expressions do not support conditionals");
+    }
+  }
+
+  for (int input = 0; input < expression.input_count(); ++input) {
+    m_input_types.push_back(declarations[input].type);
+  }
+
+  std::vector<Interval> ranges(instructions.size());
+  std::vector<bool> integer_valued(instructions.size(), false);
+  auto allocate_slot = [&](ValueType type) {
+    switch (type) {
+    case ValueType::Int16:
+      return static_cast<int>(m_int16_slots++);
+    case ValueType::Int32:
+      return static_cast<int>(m_int32_slots++);
+    default:
+      return static_cast<int>(m_float64_slots++);
+    }
+  };
+
+  for (std::size_t node = 0; node < instructions.size(); ++node) {
+    const Instruction& instruction = instructions[node];
+    Node lowered{instruction.opcode,
+                 instruction.first_operand,
+                 instruction.second_operand,
+                 -1,
+                 false,
+                 instruction.constant};
+    ValueType type = ValueType::Float64;
+
+    switch (instruction.opcode) {
+    case Opcode::Input: {
+      const InputDeclaration& declaration =
+          declarations[instruction.first_operand];
+      Interval storage = type_range(declaration.type);
+      type = declaration.type;
+      ranges[node] = {std::max(declaration.range.lower, storage.lower),
+                      std::min(declaration.range.upper, storage.upper)};
+      integer_valued[node] = is_integral(type);
+      break;
+    }
+    case Opcode::Constant:
+      ranges[node] = Interval::point(instruction.constant);
+      integer_valued[node] = std::isfinite(instruction.constant) &&
+                             std::trunc(instruction.constant) ==
+                                 instruction.constant;
+      type = integer_valued[node] ? narrowest_integral(ranges[node])
+                                  : ValueType::Float64;
+      lowered.slot = allocate_slot(type);
+      break;
+    default: {
+      const Interval& divisor_range = ranges[instruction.second_operand];
+      ranges[node] = apply_interval(instruction.opcode,
+                                    ranges[instruction.first_operand],
+                                    divisor_range);
+      integer_valued[node] = instruction.opcode != Opcode::Divide &&
+                             integer_valued[instruction.first_operand] &&
+                             integer_valued[instruction.second_operand];
+      type = integer_valued[node] ? narrowest_integral(ranges[node])
+                                  : ValueType::Float64;
+      lowered.checked = instruction.opcode == Opcode::Divide &&
+                        divisor_range.contains(0.0);
+      lowered.slot = allocate_slot(type);
+      break;
+    }
+    }
+
+    m_nodes.push_back(lowered);
+    m_types.push_back(type);
+  }
+}
+
+void NarrowedExpression::evaluate(std::span<const TypedColumn> columns,
+                                  std::span<double> results) const {
+  if (columns.size() < m_input_types.size()) {
+    throw std::invalid_argument("Missing input columns");
+  }
+  for (std::size_t input = 0; input < m_input_types.size(); ++input) {
+    if (columns[input].index() !=
+        static_cast<std::size_t>(m_input_types[input])) {
+      throw std::invalid_argument(
+          "Input column type does not match its declaration");
+    }
+    std::size_t size = std::visit(
+        [](const auto& column) { return column.size(); }, columns[input]);
+    if (size < results.size()) {
+      throw std::invalid_argument("Input column is shorter than results");
+    }
+  }
+
+  TrackedVector<std::int16_t, MemorySubsystem::Buffers> int16_slots(
+      m_int16_slots * BLOCK_SIZE);
+  TrackedVector<std::int32_t, MemorySubsystem::Buffers> int32_slots(
+      m_int32_slots * BLOCK_SIZE);
+  TrackedVector<double, MemorySubsystem::Buffers> float64_slots(
+      m_float64_slots * BLOCK_SIZE);
+
+  auto target = [&](std::size_t node) -> TargetPointer {
+    const std::size_t offset = m_nodes[node].slot * BLOCK_SIZE;
+    switch (m_types[node]) {
+    case ValueType::Int16:
+      return int16_slots.data() + offset;
+    case ValueType::Int32:
+      return int32_slots.data() + offset;
+    default:
+      return float64_slots.data() + offset;
+    }
+  };
+  auto source = [&](std::size_t node, std::size_t row) -> SourcePointer {
+    const Node& current = m_nodes[node];
+    if (current.opcode == Opcode::Input) {
+      return std::visit(
+          [row](const auto& column) -> SourcePointer {
+            return column.data() + row;
+          },
+          columns[current.first_operand]);
+    }
+    return std::visit(
+        [](auto* values) -> SourcePointer { return values; }, target(node));
+  };
+
+  // Constants keep their slot for the whole call, so they are broadcast once.
+  for (std::size_t node = 0; node < m_nodes.size(); ++node) {
+    if (m_nodes[node].opcode == Opcode::Constant) {
+      std::visit(
+          [&](auto* values) {
+            using Value = std::remove_pointer_t<decltype(values)>;
+            std::fill_n(values, BLOCK_SIZE,
+                        static_cast<Value>(m_nodes[node].constant));
+          },
+          target(node));
+    }
+  }
+
+  for (std::size_t row = 0; row < results.size(); row += BLOCK_SIZE) {
+    const std::size_t count = std::min(BLOCK_SIZE, results.size() - row);
+    for (std::size_t node = 0; node < m_nodes.size(); ++node) {
+      const Node& current = m_nodes[node];
+      if (current.opcode == Opcode::Input ||
+          current.opcode == Opcode::Constant) {
+        continue;
+      }
+      std::visit(
+          [&](const auto* first, const auto* second, auto* output) {
+            run_narrowed_kernel(current.opcode, current.checked, first, second,
+                                output, count);
+          },
+          source(current.first_operand, row),
+          source(current.second_operand, row), target(node));
+    }
+
+    std::visit(
+        [&](const auto* values) {
+          for (std::size_t index = 0; index < count; ++index) {
+            results[row + index] = static_cast<double>(values[index]);
+          }
+        },
+        source(m_nodes.size() - 1, row));
+  }
+}
+
+const std::vector<ValueType>& NarrowedExpression::node_types() const {
+  return m_types;
+}
+
+// Unit tests (embedded in source file)
+// Disabled in production builds via DOCTEST_CONFIG_DISABLE
+#include <doctest/doctest.h>
+
+TEST_CASE("NarrowedExpression - type inference") {
+  // Arrange - a and b are int16 in [-100, 100], c is float32
+  std::vector<InputDeclaration> declarations = {
+      {ValueType::Int16, {-100.0, 100.0}},
+      {ValueType::Int16, {-100.0, 100.0}},
+      {ValueType::Float32, {}}};
+  Expression expression;
+  NodeId a = expression.input(0);
+  NodeId b = expression.input(1);
+  NodeId c = expression.input(2);
+
+  SUBCASE("products that fit int16 stay int16") {
+    // Arrange
+    NodeId product = expression.multiply(a, b);
+
+    // Act
+    NarrowedExpression narrowed(expression, declarations);
+
+    // Assert
+    CHECK(narrowed.node_types()[product] == ValueType::Int16);
+  }
+
+  SUBCASE("results beyond int16 widen to int32") {
+    // Arrange
+    NodeId square = expression.multiply(expression.multiply(a, b), a);
+
+    // Act
+    NarrowedExpression narrowed(expression, declarations);
+
+    // Assert
+    CHECK(narrowed.node_types()[square] == ValueType::Int32);
+  }
+
+  SUBCASE("division and float inputs compute in double") {
+    // Arrange
+    NodeId quotient = expression.divide(a, b);
+    NodeId mixed = expression.add(a, c);
+
+    // Act
+    NarrowedExpression narrowed(expression, declarations);
+
+    // Assert
+    CHECK(narrowed.node_types()[quotient] == ValueType::Float64);
+    CHECK(narrowed.node_types()[mixed] == ValueType::Float64);
+  }
+
+  SUBCASE("integral constants take the narrowest type") {
+    // Arrange
+    NodeId small = expression.constant(7.0);
+    NodeId fraction = expression.constant(0.5);
+
+    // Act
+    NarrowedExpression narrowed(expression, declarations);
+
+    // Assert
+    CHECK(narrowed.node_types()[small] == ValueType::Int16);
+    CHECK(narrowed.node_types()[fraction] == ValueType::Float64);
+  }
+
+  SUBCASE("missing declarations are rejected") {
+    // Arrange
+    std::vector<InputDeclaration> too_few = {declarations[0]};
+
+    // Act & Assert
+    CHECK_THROWS_AS(NarrowedExpression(expression, too_few),
+                    std::invalid_argument);
+  }
+}
+
+TEST_CASE("NarrowedExpression - evaluation") {
+  SUBCASE("int16 arithmetic is widened only for the final result") {
+    // Arrange - (a * b) - 300 with a, b in [-100, 100]
+    std::vector<InputDeclaration> declarations = {
+        {ValueType::Int16, {-100.0, 100.0}},
+        {ValueType::Int16, {-100.0, 100.0}}};
+    Expression expression;
+    expression.subtract(
+        expression.multiply(expression.input(0), expression.input(1)),
+        expression.constant(300.0));
+    NarrowedExpression narrowed(expression, declarations);
+    std::vector<std::int16_t> a = {100, -100, 7};
+    std::vector<std::int16_t> b = {100, 100, -3};
+    std::vector<TypedColumn> columns = {std::span<const std::int16_t>(a),
+                                        std::span<const std::int16_t>(b)};
+    std::vector<double> results(3);
+
+    // Act
+    narrowed.evaluate(columns, results);
+
+    // Assert
+    CHECK(results == std::vector<double>{9700.0, -10300.0, -321.0});
+  }
+
+  SUBCASE("inputs outside their declared ranges wrap") {
+    // Arrange - a * b + a, computed in int32 for a, b in [-1000, 1000]
+    std::vector<InputDeclaration> declarations = {
+        {ValueType::Int32, {-1000.0, 1000.0}},
+        {ValueType::Int32, {-1000.0, 1000.0}}};
+    Expression expression;
+    expression.add(
+        expression.multiply(expression.input(0), expression.input(1)),
+        expression.input(0));
+    NarrowedExpression narrowed(expression, declarations);
+    std::vector<std::int32_t> a = {INT32_MAX, 3};
+    std::vector<std::int32_t> b = {INT32_MAX, -4};
+    std::vector<TypedColumn> columns = {std::span<const std::int32_t>(a),
+                                        std::span<const std::int32_t>(b)};
+    std::vector<double> results(2);
+
+    // Act
+    narrowed.evaluate(columns, results);
+
+    // Assert - the first row is unspecified but defined
+    CHECK(std::isfinite(results[0]));
+    CHECK(results[1] == -9.0);
+  }
+
+  SUBCASE("column types must match the declarations") {
+    // Arrange
+    std::vector<InputDeclaration> declarations = {{ValueType::Int32, {}}};
+    Expression expression;
+    expression.input(0);
+    NarrowedExpression narrowed(expression, declarations);
+    std::vector<double> values = {1.0};
+    std::vector<TypedColumn> columns = {std::span<const double>(values)};
+    std::vector<double> results(1);
+
+    // Act & Assert
+    CHECK_THROWS_AS(narrowed.evaluate(columns, results),
+                    std::invalid_argument);
+  }
+
+  SUBCASE("conditionals are rejected") {
+    // Arrange
+    std::vector<InputDeclaration> declarations = {{ValueType::Int32, {}}};
+    Expression expression;
+    expression.less(expression.input(0), expression.constant(0.0));
+
+    // Act & Assert
+    CHECK_THROWS_AS(NarrowedExpression(expression, declarations),
+                    std::invalid_argument);
+  }
+}
@@ -0,0 +1,488 @@
+// First-party headers
+#include "calculator/calculator.h"
+#include "calculator/packed_column.h"
+
+// Standard library headers
+#include <algorithm>
+#include <bit>
+#include <climits>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+
+constexpr std::size_t LANES = 4;
+
+// Rows of LANES values in a block; each lane packs its rows into width
+// consecutive words of its own.
+constexpr std::size_t ROWS = PackedColumn::BLOCK_SIZE / LANES;
+
+// Unpacks the LANES values of one row packed at Width bits. The row starts
+// at the same bit of every lane, so the shifts and masks are constants and
+// the lanes unpack as one vector.
+template <unsigned Width, std::size_t Row>
+void unpack_row(const std::uint32_t* words, std::uint32_t* values) {
+  constexpr std::size_t FIRST_BIT = Row * Width;
+  constexpr std::size_t WORD = FIRST_BIT / 32;
+  constexpr unsigned SHIFT = FIRST_BIT % 32;
+  constexpr std::uint32_t MASK =
+      Width == 32 ? 0xFFFFFFFFu : (std::uint32_t{1} << Width) - 1;
+  for (std::size_t lane = 0; lane < LANES; ++lane) {
+    std::uint32_t value = 0;
+    if constexpr (Width != 0) {
+      value = words[WORD * LANES + lane] >> SHIFT;
+      if constexpr (SHIFT + Width > 32) {
+        value |= words[(WORD + 1) * LANES + lane] << (32 - SHIFT);
+      }
+    }
+    values[Row * LANES + lane] = value & MASK;
+  }
+}
+
+template <unsigned Width>
+void unpack_fixed(const std::uint32_t* words, std::uint32_t* values) {
+  [&]<std::size_t... Rows>(std::index_sequence<Rows...>) {
+    (unpack_row<Width, Rows>(words, values), ...);
+  }(std::make_index_sequence<ROWS>());
+}
+
+using UnpackKernel = void (*)(const std::uint32_t*, std::uint32_t*);
+
+template <unsigned... Widths>
+constexpr std::array<UnpackKernel, sizeof...(Widths)>
+make_unpack_kernels(std::integer_sequence<unsigned, Widths...>) {
+  return {&unpack_fixed<Widths>...};
+}
+
+// One fully unrolled kernel per bit width, 0 to 32.
+constexpr std::array<UnpackKernel, 33> UNPACK_KERNELS =
+    make_unpack_kernels(std::make_integer_sequence<unsigned, 33>());
+
+// Packs a block of values below 2^width into width * LANES zeroed words,
+// in the layout unpack_row reads.
+void pack(const std::uint32_t* values, unsigned width, std::uint32_t* words) {
+  if (width == 0) {
+    return;
+  }
+  for (std::size_t index = 0; index < PackedColumn::BLOCK_SIZE; ++index) {
+    const std::size_t lane = index % LANES;
+    const std::size_t first_bit = index / LANES * width;
+    const std::size_t word = first_bit / 32;
+    const unsigned shift = first_bit % 32;
+    words[word * LANES + lane] |= values[index] << shift;
+    if (shift + width > 32) {
+      words[(word + 1) * LANES + lane] |= values[index] >> (32 - shift);
+    }
+  }
+}
+
+void check_results(std::size_t row_count, std::size_t result_count) {
+  if (result_count < row_count) {
+    throw std::invalid_argument("Missing result values");
+  }
+}
+
+} // namespace
+
+PackedColumn PackedColumn::encode(std::span<const int> values,
+                                  PackedEncoding encoding) {
+  PackedColumn column;
+  column.m_encoding = encoding;
+  column.m_size = values.size();
+  std::array<std::uint32_t, BLOCK_SIZE> stored;
+  if (!values.empty()) {
+    column.m_base = values[0];
+  }
+  Lanes previous = column.initial_lanes();
+  for (std::size_t first = 0; first < values.size(); first += BLOCK_SIZE) {
+    const std::size_t count = std::min(BLOCK_SIZE, values.size() - first);
+    int minimum = INT_MAX;
+    int maximum = INT_MIN;
+    for (std::size_t index = 0; index < count; ++index) {
+      const auto value = static_cast<std::uint32_t>(values[first + index]);
+      stored[index] = value;
+      if (encoding == PackedEncoding::Delta) {
+        stored[index] = value - previous[index % LANES];
+        previous[index % LANES] = value;
+      }
+      minimum = std::min(minimum, static_cast<int>(stored[index]));
+      maximum = std::max(maximum, static_cast<int>(stored[index]));
+    }
+    const auto reference = static_cast<std::uint32_t>(minimum);
+    std::fill(stored.begin() + static_cast<std::ptrdiff_t>(count),
+              stored.end(), reference);
+    for (std::uint32_t& value : stored) {
+      value -= reference;
+    }
+    const auto width = static_cast<std::uint32_t>(
+        std::bit_width(static_cast<std::uint32_t>(maximum) - reference));
+    column.m_blocks.push_back({minimum, width, column.m_words.size()});
+    column.m_words.resize(column.m_words.size() + width * LANES, 0);
+    pack(stored.data(), width,
+         column.m_words.data() + column.m_blocks.back().offset);
+  }
+  return column;
+}
+
+PackedColumn::Lanes PackedColumn::initial_lanes() const {
+  const auto base = static_cast<std::uint32_t>(m_base);
+  return {base, base, base, base};
+}
+
+std::size_t PackedColumn::size() const { return m_size; }
+
+PackedEncoding PackedColumn::encoding() const { return m_encoding; }
+
+std::size_t PackedColumn::byte_size() const {
+  return m_words.size() * sizeof(std::uint32_t) +
+         m_blocks.size() * sizeof(Block);
+}
+
+template <typename Consume>
+void PackedColumn::scan(const Consume& consume) const {
+  Lanes previous = initial_lanes();
+  std::array<int, BLOCK_SIZE> values;
+  for (std::size_t block = 0; block < m_blocks.size(); ++block) {
+    decode_block(block, previous, values.data());
+    const std::size_t first = block * BLOCK_SIZE;
+    const std::size_t count = std::min(BLOCK_SIZE, m_size - first);
+    for (std::size_t index = 0; index < count; ++index) {
+      consume(first + index, values[index]);
+    }
+  }
+}
+
+// Frame of reference adds the reference to each value; delta adds it to
+// the running value of the lane, which then holds the decoded value.
+void PackedColumn::decode_block(std::size_t block, Lanes& previous,
+                                int* values) const {
+  const Block& header = m_blocks[block];
+  std::array<std::uint32_t, BLOCK_SIZE> unpacked;
+  UNPACK_KERNELS[header.width](m_words.data() + header.offset,
+                               unpacked.data());
+  const auto reference = static_cast<std::uint32_t>(header.reference);
+  if (m_encoding == PackedEncoding::FrameOfReference) {
+    for (std::size_t index = 0; index < BLOCK_SIZE; ++index) {
+      values[index] = static_cast<int>(unpacked[index] + reference);
+    }
+    return;
+  }
+  // A local copy of the running values stays in one vector register.
+  Lanes running = previous;
+  for (std::size_t row = 0; row < BLOCK_SIZE; row += LANES) {
+    for (std::size_t lane = 0; lane < LANES; ++lane) {
+      running[lane] += unpacked[row + lane] + reference;
+      values[row + lane] = static_cast<int>(running[lane]);
+    }
+  }
+  previous = running;
+}
+
+void PackedColumn::decode(std::span<int> results) const {
+  check_results(m_size, results.size());
+  scan([&](std::size_t row, int value) { results[row] = value; });
+}
+
+void PackedCalculator::affine(const PackedColumn& column, std::uint32_t scale,
+                              std::uint32_t offset, std::span<int> results) {
+  check_results(column.size(), results.size());
+  column.scan([&](std::size_t row, int value) {
+    results[row] =
+        static_cast<int>(static_cast<std::uint32_t>(value) * scale + offset);
+  });
+}
+
+template <typename Result, typename Operation>
+void PackedCalculator::apply_to_pairs(const PackedColumn& first,
+                                      const PackedColumn& second,
+                                      std::span<Result> results,
+                                      const Operation& operation) {
+  if (first.size() != second.size()) {
+    throw std::invalid_argument("Column sizes do not match");
+  }
+  check_results(first.size(), results.size());
+  PackedColumn::Lanes first_previous = first.initial_lanes();
+  PackedColumn::Lanes second_previous = second.initial_lanes();
+  std::array<int, PackedColumn::BLOCK_SIZE> first_values;
+  std::array<int, PackedColumn::BLOCK_SIZE> second_values;
+  for (std::size_t block = 0; block < first.m_blocks.size(); ++block) {
+    first.decode_block(block, first_previous, first_values.data());
+    second.decode_block(block, second_previous, second_values.data());
+    const std::size_t row = block * PackedColumn::BLOCK_SIZE;
+    const std::size_t count =
+        std::min(PackedColumn::BLOCK_SIZE, first.size() - row);
+    for (std::size_t index = 0; index < count; ++index) {
+      results[row + index] = operation(first_values[index],
+                                       second_values[index]);
+    }
+  }
+}
+
+void PackedCalculator::add(const PackedColumn& column, int value,
+                           std::span<int> results) {
+  affine(column, 1, static_cast<std::uint32_t>(value), results);
+}
+
+void PackedCalculator::subtract(const PackedColumn& column, int value,
+                                std::span<int> results) {
+  affine(column, 1, 0u - static_cast<std::uint32_t>(value), results);
+}
+
+void PackedCalculator::multiply(const PackedColumn& column, int value,
+                                std::span<int> results) {
+  affine(column, static_cast<std::uint32_t>(value), 0, results);
+}
+
+void PackedCalculator::divide(const PackedColumn& column, int value,
+                              std::span<double> results) {
+  check_results(column.size(), results.size());
+  if (value == 0 && column.size() != 0) {
+    throw std::invalid_argument("Division by zero");
+  }
+  const auto divisor = static_cast<double>(value);
+  column.scan([&](std::size_t row, int first_value) {
+    results[row] = static_cast<double>(first_value) / divisor;
+  });
+}
+
+void PackedCalculator::add(const PackedColumn& first,
+                           const PackedColumn& second,
+                           std::span<int> results) {
+  apply_to_pairs(first, second, results,
+                 [](int first_value, int second_value) {
+                   return static_cast<int>(
+                       static_cast<std::uint32_t>(first_value) +
+                       static_cast<std::uint32_t>(second_value));
+                 });
+}
+
+void PackedCalculator::subtract(const PackedColumn& first,
+                                const PackedColumn& second,
+                                std::span<int> results) {
+  apply_to_pairs(first, second, results,
+                 [](int first_value, int second_value) {
+                   return static_cast<int>(
+                       static_cast<std::uint32_t>(first_value) -
+                       static_cast<std::uint32_t>(second_value));
+                 });
+}
+
+void PackedCalculator::multiply(const PackedColumn& first,
+                                const PackedColumn& second,
+                                std::span<int> results) {
+  apply_to_pairs(first, second, results,
+                 [](int first_value, int second_value) {
+                   return static_cast<int>(
+                       static_cast<std::uint32_t>(first_value) *
+                       static_cast<std::uint32_t>(second_value));
+                 });
+}
+
+void PackedCalculator::divide(const PackedColumn& first,
+                              const PackedColumn& second,
+                              std::span<double> results) {
+  apply_to_pairs(first, second, results,
+                 [](int first_value, int second_value) {
+                   if (second_value == 0) {
+                     throw std::invalid_argument("Division by zero");
+                   }
+                   return static_cast<double>(first_value) / second_value;
+                 });
+}
+
+std::int64_t PackedCalculator::sum(const PackedColumn& column) {
+  std::int64_t total = 0;
+  column.scan([&](std::size_t, int value) { total += value; });
+  return total;
+}
+
+// Unit tests (embedded in source file)
+// Disabled in production builds via DOCTEST_CONFIG_DISABLE
+#include <doctest/doctest.h>
+
+// Standard library headers
+#include <numeric>
+#include <random>
+
+namespace {
+
+// Values spread over width bits above an offset, so frame of reference
+// packs them at exactly that width.
+std::vector<int> random_values(std::size_t count, unsigned width, int offset,
+                               std::uint64_t seed) {
+  std::mt19937_64 random(seed);
+  std::vector<int> values(count);
+  for (int& value : values) {
+    const auto bits =
+        width == 0 ? std::uint32_t{0}
+                   : static_cast<std::uint32_t>(random()) >> (32 - width);
+    value = static_cast<int>(bits + static_cast<std::uint32_t>(offset));
+  }
+  return values;
+}
+
+const std::array<PackedEncoding, 2> ENCODINGS = {
+    PackedEncoding::FrameOfReference, PackedEncoding::Delta};
+
+} // namespace
+
+TEST_CASE("PackedColumn - encode and decode") {
+  SUBCASE("round trip at every bit width") {
+    for (unsigned width = 1; width <= 32; ++width) {
+      for (PackedEncoding encoding : ENCODINGS) {
+        // Arrange - a partial last block after two full ones
+        const std::vector<int> values = random_values(300, width, -7, width);
+
+        // Act
+        const PackedColumn column = PackedColumn::encode(values, encoding);
+        std::vector<int> decoded(values.size());
+        column.decode(decoded);
+
+        // Assert
+        CHECK(column.size() == values.size());
+        CHECK(decoded == values);
+      }
+    }
+  }
+
+  SUBCASE("packed size follows the bit width") {
+    // Arrange - sorted timestamps one to four ticks apart
+    std::vector<int> timestamps(1 << 12);
+    std::mt19937_64 random(9);
+    int timestamp = 1700000000;
+    for (int& value : timestamps) {
+      timestamp += static_cast<int>(random() % 4) + 1;
+      value = timestamp;
+    }
+    const std::vector<int> constant(1000, 42);
+
+    // Act
+    const PackedColumn delta =
+        PackedColumn::encode(timestamps, PackedEncoding::Delta);
+    const PackedColumn frame = PackedColumn::encode(timestamps);
+    const PackedColumn constant_column = PackedColumn::encode(constant);
+    std::vector<int> decoded(timestamps.size());
+    delta.decode(decoded);
+
+    // Assert - four-row differences of 4 to 16 fit in 4 bits
+    CHECK(decoded == timestamps);
+    CHECK(delta.byte_size() <= timestamps.size() / 2 + 32 * 16);
+    CHECK(delta.byte_size() < frame.byte_size());
+    CHECK(constant_column.byte_size() < constant.size());
+  }
+
+  SUBCASE("extreme values and empty columns") {
+    for (PackedEncoding encoding : ENCODINGS) {
+      // Arrange
+      const std::vector<int> values = {INT_MIN, INT_MAX, 0, -1, INT_MAX,
+                                       INT_MIN};
+
+      // Act
+      const PackedColumn column = PackedColumn::encode(values, encoding);
+      const PackedColumn empty = PackedColumn::encode({}, encoding);
+      std::vector<int> decoded(values.size());
+      column.decode(decoded);
+
+      // Assert
+      CHECK(decoded == values);
+      CHECK(empty.size() == 0);
+      CHECK(empty.byte_size() == 0);
+    }
+  }
+
+  SUBCASE("short result span") {
+    // Arrange
+    const PackedColumn column =
+        PackedColumn::encode(std::vector<int>{1, 2, 3});
+    std::vector<int> decoded(2);
+
+    // Act & Assert
+    CHECK_THROWS_AS(column.decode(decoded), std::invalid_argument);
+  }
+}
+
+TEST_CASE("PackedCalculator - matches Calculator row by row") {
+  PackedCalculator packed_calculator;
+  Calculator calculator;
+
+  SUBCASE("operations with a constant and sums") {
+    for (unsigned width : {0u, 3u, 11u, 17u}) {
+      for (PackedEncoding encoding : ENCODINGS) {
+        // Arrange
+        const std::vector<int> values =
+            random_values(1000, width, -1000, width + 1);
+        const PackedColumn column = PackedColumn::encode(values, encoding);
+        std::vector<int> sums(values.size());
+        std::vector<int> differences(values.size());
+        std::vector<int> products(values.size());
+        std::vector<double> quotients(values.size());
+
+        // Act
+        packed_calculator.add(column, 25, sums);
+        packed_calculator.subtract(column, 25, differences);
+        packed_calculator.multiply(column, -3, products);
+        packed_calculator.divide(column, 6, quotients);
+
+        // Assert
+        for (std::size_t row = 0; row < values.size(); ++row) {
+          CHECK(sums[row] == calculator.add(values[row], 25));
+          CHECK(differences[row] == calculator.subtract(values[row], 25));
+          CHECK(products[row] == calculator.multiply(values[row], -3));
+          CHECK(quotients[row] == calculator.divide(values[row], 6));
+        }
+        CHECK(packed_calculator.sum(column) ==
+              std::accumulate(values.begin(), values.end(), std::int64_t{0}));
+      }
+    }
+  }
+
+  SUBCASE("operations between columns of different encodings") {
+    // Arrange
+    const std::vector<int> first_values = random_values(777, 13, -4000, 1);
+    const std::vector<int> second_values = random_values(777, 5, 1, 2);
+    const PackedColumn first = PackedColumn::encode(first_values);
+    const PackedColumn second =
+        PackedColumn::encode(second_values, PackedEncoding::Delta);
+    std::vector<int> sums(first_values.size());
+    std::vector<int> differences(first_values.size());
+    std::vector<int> products(first_values.size());
+    std::vector<double> quotients(first_values.size());
+
+    // Act
+    packed_calculator.add(first, second, sums);
+    packed_calculator.subtract(first, second, differences);
+    packed_calculator.multiply(first, second, products);
+    packed_calculator.divide(first, second, quotients);
+
+    // Assert
+    for (std::size_t row = 0; row < first_values.size(); ++row) {
+      const int x = first_values[row];
+      const int y = second_values[row];
+      CHECK(sums[row] == calculator.add(x, y));
+      CHECK(differences[row] == calculator.subtract(x, y));
+      CHECK(products[row] == calculator.multiply(x, y));
+      CHECK(quotients[row] == calculator.divide(x, y));
+    }
+  }
+
+  SUBCASE("invalid operands") {
+    // Arrange
+    const PackedColumn column =
+        PackedColumn::encode(std::vector<int>{4, 6, 8});
+    const PackedColumn divisors =
+        PackedColumn::encode(std::vector<int>{2, 0, 2});
+    const PackedColumn shorter = PackedColumn::encode(std::vector<int>{1, 2});
+    std::vector<double> quotients(3);
+    std::vector<int> sums(3);
+
+    // Act & Assert
+    CHECK_THROWS_AS(packed_calculator.divide(column, 0, quotients),
+                    std::invalid_argument);
+    CHECK_THROWS_AS(packed_calculator.divide(column, divisors, quotients),
+                    std::invalid_argument);
+    CHECK_THROWS_AS(packed_calculator.add(column, shorter, sums),
+                    std::invalid_argument);
+    CHECK_THROWS_AS(packed_calculator.add(column, 1, std::span<int>()),
+                    std::invalid_argument);
+  }
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+// First-party headers
+#include "calculator/sampling_profiler.h"
+
+// Standard library headers
+#include <algorithm>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+// Calls body(first, last) on thread_count contiguous shares of [0, count),
+// one of them on the calling thread. Workers are profiled threads, so the
+// sampling profiler sees them while it runs.
+template <typename Body>
+void parallel_for(std::size_t count, unsigned thread_count, const Body& body) {
+  const std::size_t worker_count = std::min<std::size_t>(thread_count, count);
+  if (worker_count <= 1) {
+    body(std::size_t{0}, count);
+    return;
+  }
+  auto share = [&](std::size_t worker) {
+    body(count * worker / worker_count, count * (worker + 1) / worker_count);
+  };
+  std::vector<std::jthread> workers;
+  for (std::size_t worker = 1; worker < worker_count; ++worker) {
+    workers.emplace_back([&share, worker] {
+      ProfiledThread profiled;
+      share(worker);
+    });
+  }
+  share(0);
+}
@@ -0,0 +1,156 @@
+// First-party headers
+#include "calculator/polynomial.h"
+
+// Standard library headers
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+
+// x values per block of the generic kernel, kept in L1 while every
+// coefficient is applied to them.
+constexpr std::size_t BLOCK_SIZE = 256;
+
+using Kernel = void (*)(const double* coefficients, const double* xs,
+                        double* results, std::size_t count);
+
+template <std::size_t Degree, PolynomialScheme Scheme>
+void evaluate_fixed(const double* coefficients, const double* xs,
+                    double* results, std::size_t count) {
+  std::array<double, Degree + 1> fixed;
+  std::copy_n(coefficients, fixed.size(), fixed.begin());
+  for (std::size_t index = 0; index < count; ++index) {
+    if constexpr (Scheme == PolynomialScheme::Horner) {
+      results[index] = horner<Degree>(fixed, xs[index]);
+    } else {
+      results[index] = estrin<Degree>(fixed, xs[index]);
+    }
+  }
+}
+
+template <PolynomialScheme Scheme, std::size_t... Degrees>
+constexpr std::array<Kernel, sizeof...(Degrees)>
+make_kernels(std::index_sequence<Degrees...>) {
+  return {&evaluate_fixed<Degrees, Scheme>...};
+}
+
+constexpr auto HORNER_KERNELS = make_kernels<PolynomialScheme::Horner>(
+    std::make_index_sequence<Polynomial::MAX_SPECIALIZED_DEGREE + 1>());
+constexpr auto ESTRIN_KERNELS = make_kernels<PolynomialScheme::Estrin>(
+    std::make_index_sequence<Polynomial::MAX_SPECIALIZED_DEGREE + 1>());
+
+// Horner's scheme one coefficient at a time over a block of x values; the
+// inner loop is independent across x and vectorizes.
+void evaluate_generic(const std::vector<double>& coefficients,
+                      const double* xs, double* results, std::size_t count) {
+  for (std::size_t offset = 0; offset < count; offset += BLOCK_SIZE) {
+    const std::size_t block = std::min(BLOCK_SIZE, count - offset);
+    std::fill_n(results + offset, block, coefficients.back());
+    for (std::size_t index = coefficients.size() - 1; index-- > 0;) {
+      const double coefficient = coefficients[index];
+      for (std::size_t row = offset; row < offset + block; ++row) {
+        results[row] = results[row] * xs[row] + coefficient;
+      }
+    }
+  }
+}
+
+} // namespace
+
+Polynomial::Polynomial(std::vector<double> coefficients)
+    : m_coefficients(std::move(coefficients)) {
+  if (m_coefficients.empty()) {
+    throw std::invalid_argument("Polynomial needs at least one coefficient");
+  }
+}
+
+std::size_t Polynomial::degree() const { return m_coefficients.size() - 1; }
+
+const std::vector<double>& Polynomial::coefficients() const {
+  return m_coefficients;
+}
+
+double Polynomial::evaluate(double x) const {
+  double result = m_coefficients.back();
+  for (std::size_t index = m_coefficients.size() - 1; index-- > 0;) {
+    result = result * x + m_coefficients[index];
+  }
+  return result;
+}
+
+void Polynomial::evaluate(std::span<const double> xs,
+                          std::span<double> results,
+                          PolynomialScheme scheme) const {
+  if (results.size() < xs.size()) {
+    throw std::invalid_argument("Missing result values");
+  }
+  if (degree() > MAX_SPECIALIZED_DEGREE) {
+    evaluate_generic(m_coefficients, xs.data(), results.data(), xs.size());
+    return;
+  }
+  const auto& kernels =
+      scheme == PolynomialScheme::Horner ? HORNER_KERNELS : ESTRIN_KERNELS;
+  kernels[degree()](m_coefficients.data(), xs.data(), results.data(),
+                    xs.size());
+}
+
+// Unit tests (embedded in source file)
+// Disabled in production builds via DOCTEST_CONFIG_DISABLE
+#include <doctest/doctest.h>
+
+TEST_CASE("Polynomial - fixed-degree schemes") {
+  // Arrange - 1 - 2x + 3x^2 - 4x^3 + 5x^4
+  constexpr std::array<double, 5> COEFFICIENTS = {1, -2, 3, -4, 5};
+
+  // Act & Assert - exact in doubles for small integers
+  static_assert(horner<4>(COEFFICIENTS, 2.0) == 57.0);
+  static_assert(estrin<4>(COEFFICIENTS, 2.0) == 57.0);
+  CHECK(estrin<4>(COEFFICIENTS, -3.0) == 547.0);
+  CHECK(estrin<0>(std::array<double, 1>{7.0}, 3.0) == 7.0);
+  CHECK(estrin<1>(std::array<double, 2>{7.0, 2.0}, 3.0) == 13.0);
+}
+
+TEST_CASE("Polynomial - batch evaluation") {
+  // Arrange
+  std::vector<double> xs(1000);
+  for (std::size_t index = 0; index < xs.size(); ++index) {
+    xs[index] = -1.0 + 2.0 * static_cast<double>(index) / xs.size();
+  }
+  std::vector<double> results(xs.size());
+
+  SUBCASE("every degree and scheme matches the scalar evaluation") {
+    for (std::size_t degree = 0; degree <= 20; ++degree) {
+      // Arrange
+      std::vector<double> coefficients(degree + 1);
+      for (std::size_t index = 0; index <= degree; ++index) {
+        coefficients[index] = 1.0 / static_cast<double>(index + 1);
+      }
+      Polynomial polynomial(coefficients);
+
+      for (PolynomialScheme scheme :
+           {PolynomialScheme::Horner, PolynomialScheme::Estrin}) {
+        // Act
+        polynomial.evaluate(xs, results, scheme);
+
+        // Assert
+        for (std::size_t index = 0; index < xs.size(); index += 37) {
+          CHECK(results[index] ==
+                doctest::Approx(polynomial.evaluate(xs[index])));
+        }
+      }
+    }
+  }
+
+  SUBCASE("invalid input throws") {
+    // Arrange
+    Polynomial polynomial({1.0, 2.0});
+
+    // Act & Assert
+    CHECK(polynomial.degree() == 1);
+    CHECK_THROWS_AS(Polynomial({}), std::invalid_argument);
+    CHECK_THROWS_AS(
+        polynomial.evaluate(xs, std::span<double>(results).first(10)),
+        std::invalid_argument);
+  }
+}
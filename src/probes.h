@@ -0,0 +1,116 @@
+#pragma once
+
+// Standard library headers
+#include <cstdint>
+
+// USDT (SystemTap SDT) probes for bpftrace, perf and SystemTap. A probe site
+// is a single nop plus an ELF note that tells tracers where it is, so a
+// detached probe costs one nop. Each probe has a semaphore that tracers
+// increment while attached; argument computation that is not free belongs
+// inside an if on CALCULATOR_PROBE_ENABLED.
+//
+// This is a self-contained subset of <sys/sdt.h>, so building needs no
+// systemtap headers and the library has no runtime dependency. Arguments
+// are passed as signed 64-bit integers. Probes compile to nothing unless
+// CALCULATOR_ENABLE_PROBES is defined on Linux x86-64 or AArch64.
+//
+// Usage, at namespace scope of the translation unit firing the probe:
+//   CALCULATOR_PROBE_SEMAPHORE(batch__done);
+// and at the probe site:
+//   if (CALCULATOR_PROBE_ENABLED(batch__done)) {
+//     CALCULATOR_PROBE2(batch__done, rows, elapsed_nanoseconds());
+//   }
+
+#if defined(CALCULATOR_ENABLE_PROBES) && defined(__linux__) &&               \
+    defined(__GNUC__) && (defined(__x86_64__) || defined(__aarch64__))
+
+#if defined(__x86_64__)
+#define CALCULATOR_PROBE_ARG_CONSTRAINT "nor"
+#else
+#define CALCULATOR_PROBE_ARG_CONSTRAINT "r"
+#endif
+
+#define CALCULATOR_PROBE_SEMAPHORE(name)                                       \
+  __attribute__((section(".probes"), used)) static volatile unsigned short     \
+      calculator_##name##_semaphore = 0
+
+#define CALCULATOR_PROBE_ENABLED(name)                                         \
+  __builtin_expect(calculator_##name##_semaphore != 0, 0)
+
+// Note layout read by tracers: probe address, link-time base used to
+// correct for prelinking, semaphore address, provider, name and argument
+// format.
+#define CALCULATOR_PROBE_ASM(name, arguments)                                  \
+  "990: nop\n"                                                                 \
+  ".pushsection .note.stapsdt,\"?\",\"note\"\n"                                \
+  ".balign 4\n"                                                                \
+  ".4byte 992f-991f, 994f-993f, 3\n"                                           \
+  "991: .asciz \"stapsdt\"\n"                                                  \
+  "992: .balign 4\n"                                                           \
+  "993: .8byte 990b\n"                                                         \
+  ".8byte _.stapsdt.base\n"                                                    \
+  ".8byte %c[semaphore]\n"                                                     \
+  ".asciz \"calculator\"\n"                                                    \
+  ".asciz \"" #name "\"\n"                                                     \
+  ".asciz \"" arguments "\"\n"                                                 \
+  "994: .balign 4\n"                                                           \
+  ".popsection\n"                                                              \
+  ".ifndef _.stapsdt.base\n"                                                   \
+  ".pushsection .stapsdt.base,\"aG\",\"progbits\",.stapsdt.base,comdat\n"     \
+  ".weak _.stapsdt.base\n"                                                     \
+  ".hidden _.stapsdt.base\n"                                                   \
+  "_.stapsdt.base: .space 1\n"                                                 \
+  ".size _.stapsdt.base, 1\n"                                                  \
+  ".popsection\n"                                                              \
+  ".endif\n"
+
+#define CALCULATOR_PROBE_SEMAPHORE_OPERAND(name)                               \
+  [semaphore] "i"(&calculator_##name##_semaphore)
+
+#define CALCULATOR_PROBE_ARG(operand, value)                                   \
+  [operand] CALCULATOR_PROBE_ARG_CONSTRAINT(static_cast<std::int64_t>(value))
+
+#define CALCULATOR_PROBE0(name)                                                \
+  __asm__ __volatile__(CALCULATOR_PROBE_ASM(name, "")                          \
+                       :                                                       \
+                       : CALCULATOR_PROBE_SEMAPHORE_OPERAND(name))
+
+#define CALCULATOR_PROBE1(name, first_argument)                                \
+  __asm__ __volatile__(CALCULATOR_PROBE_ASM(name, "-8@%[first]")               \
+                       :                                                       \
+                       : CALCULATOR_PROBE_SEMAPHORE_OPERAND(name),             \
+                         CALCULATOR_PROBE_ARG(first, first_argument))
+
+#define CALCULATOR_PROBE2(name, first_argument, second_argument)               \
+  __asm__ __volatile__(                                                        \
+      CALCULATOR_PROBE_ASM(name, "-8@%[first] -8@%[second]")                   \
+      :                                                                        \
+      : CALCULATOR_PROBE_SEMAPHORE_OPERAND(name),                              \
+        CALCULATOR_PROBE_ARG(first, first_argument),                           \
+        CALCULATOR_PROBE_ARG(second, second_argument))
+
+#define CALCULATOR_PROBE3(name, first_argument, second_argument,               \
+                          third_argument)                                      \
+  __asm__ __volatile__(                                                        \
+      CALCULATOR_PROBE_ASM(name, "-8@%[first] -8@%[second] -8@%[third]")       \
+      :                                                                        \
+      : CALCULATOR_PROBE_SEMAPHORE_OPERAND(name),                              \
+        CALCULATOR_PROBE_ARG(first, first_argument),                           \
+        CALCULATOR_PROBE_ARG(second, second_argument),                         \
+        CALCULATOR_PROBE_ARG(third, third_argument))
+
+#else
+
+#define CALCULATOR_PROBE_SEMAPHORE(name) static_assert(true)
+#define CALCULATOR_PROBE_ENABLED(name) false
+#define CALCULATOR_PROBE0(name) static_cast<void>(0)
+#define CALCULATOR_PROBE1(name, first_argument)                                \
+  static_cast<void>(sizeof(first_argument))
+#define CALCULATOR_PROBE2(name, first_argument, second_argument)               \
+  static_cast<void>(sizeof(first_argument) + sizeof(second_argument))
+#define CALCULATOR_PROBE3(name, first_argument, second_argument,               \
+                          third_argument)                                      \
+  static_cast<void>(sizeof(first_argument) + sizeof(second_argument) +       \
+                    sizeof(third_argument))
+
+#endif
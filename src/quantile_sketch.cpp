@@ -0,0 +1,688 @@
+// First-party headers
+#include "calculator/quantile_sketch.h"
+
+// Standard library headers
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace {
+
+constexpr const char* DD_SKETCH_HEADER = "calculator-ddsketch-v1";
+constexpr const char* KLL_SKETCH_HEADER = "calculator-kll-v1";
+
+// Magnitudes below this are counted as zero; their logarithm would leave
+// the range of bucket indices.
+constexpr double MIN_INDEXABLE = std::numeric_limits<double>::min();
+
+void validate_value(double value) {
+  if (!std::isfinite(value)) {
+    throw std::invalid_argument("Sketch values must be finite");
+  }
+}
+
+void validate_quantile(double q, std::uint64_t count) {
+  if (!(q >= 0.0 && q <= 1.0)) {
+    throw std::invalid_argument("Quantile must be in [0, 1]");
+  }
+  if (count == 0) {
+    throw std::invalid_argument("Quantile of an empty sketch");
+  }
+}
+
+// Levels a KLL sketch can have while its weights, 2^level, fit in 64 bits.
+constexpr std::size_t MAX_KLL_LEVELS = 64;
+
+// Puts a stream into the plain decimal format the sketches are written in,
+// with enough digits for doubles to read back the same value, and restores
+// the caller's flags and precision when it goes out of scope.
+class SketchFormat {
+public:
+  explicit SketchFormat(std::ios_base& stream)
+      : m_stream(stream), m_flags(stream.flags()),
+        m_precision(stream.precision(17)) {
+    stream.flags(std::ios_base::dec | std::ios_base::skipws);
+  }
+  ~SketchFormat() {
+    m_stream.flags(m_flags);
+    m_stream.precision(m_precision);
+  }
+
+  SketchFormat(const SketchFormat&) = delete;
+  SketchFormat& operator=(const SketchFormat&) = delete;
+
+private:
+  std::ios_base& m_stream;
+  std::ios_base::fmtflags m_flags;
+  std::streamsize m_precision;
+};
+
+void write_header(std::ostream& output, const char* header) {
+  output << header;
+}
+
+void read_header(std::istream& input, const char* header) {
+  std::string name;
+  if (!(input >> name) || name != header) {
+    throw std::invalid_argument("Malformed sketch");
+  }
+}
+
+template <typename T> T read_value(std::istream& input) {
+  T value{};
+  if (!(input >> value)) {
+    throw std::invalid_argument("Malformed sketch");
+  }
+  return value;
+}
+
+// Reads a length written by serialize, which never exceeds limit.
+std::size_t read_length(std::istream& input, std::size_t limit) {
+  const auto length = read_value<std::size_t>(input);
+  if (length > limit) {
+    throw std::invalid_argument("Malformed sketch");
+  }
+  return length;
+}
+
+// Adds to a total read from a stream, rejecting totals past 64 bits.
+void add_to_total(std::uint64_t& total, std::uint64_t count) {
+  if (count > std::numeric_limits<std::uint64_t>::max() - total) {
+    throw std::invalid_argument("Malformed sketch");
+  }
+  total += count;
+}
+
+} // namespace
+
+void DdSketch::Store::add(int index, std::uint64_t count) {
+  if (counts.empty()) {
+    offset = index;
+  } else if (index < offset) {
+    counts.insert(counts.begin(), static_cast<std::size_t>(offset - index),
+                  0);
+    offset = index;
+  }
+  const auto position = static_cast<std::size_t>(index - offset);
+  if (position >= counts.size()) {
+    counts.resize(position + 1, 0);
+  }
+  counts[position] += count;
+}
+
+void DdSketch::Store::collapse_lowest(std::size_t max_buckets) {
+  if (counts.size() <= max_buckets) {
+    return;
+  }
+  const std::size_t excess = counts.size() - max_buckets;
+  std::uint64_t collapsed = 0;
+  for (std::size_t position = 0; position <= excess; ++position) {
+    collapsed += counts[position];
+  }
+  counts.erase(counts.begin(),
+               counts.begin() + static_cast<std::ptrdiff_t>(excess));
+  counts.front() = collapsed;
+  offset += static_cast<int>(excess);
+}
+
+std::uint64_t DdSketch::Store::total() const {
+  std::uint64_t total = 0;
+  for (std::uint64_t count : counts) {
+    total += count;
+  }
+  return total;
+}
+
+DdSketch::DdSketch(double relative_accuracy, std::size_t max_buckets)
+    : m_relative_accuracy(relative_accuracy),
+      m_gamma((1.0 + relative_accuracy) / (1.0 - relative_accuracy)),
+      m_log_gamma(std::log(m_gamma)), m_max_buckets(max_buckets),
+      m_min(std::numeric_limits<double>::infinity()),
+      m_max(-std::numeric_limits<double>::infinity()) {
+  if (!(relative_accuracy > 0.0 && relative_accuracy < 1.0)) {
+    throw std::invalid_argument("Relative accuracy must be in (0, 1)");
+  }
+  if (max_buckets == 0) {
+    throw std::invalid_argument("Bucket limit must be positive");
+  }
+}
+
+void DdSketch::add(double value) {
+  add(std::span<const double>(&value, 1));
+}
+
+void DdSketch::add(std::span<const double> values) {
+  // Buckets are only collapsed once per batch.
+  for (double value : values) {
+    validate_value(value);
+    m_min = std::min(m_min, value);
+    m_max = std::max(m_max, value);
+    if (value >= MIN_INDEXABLE) {
+      m_positive.add(index_of(value), 1);
+    } else if (value <= -MIN_INDEXABLE) {
+      m_negative.add(index_of(-value), 1);
+    } else {
+      ++m_zero_count;
+    }
+  }
+  m_positive.collapse_lowest(m_max_buckets);
+  m_negative.collapse_lowest(m_max_buckets);
+}
+
+void DdSketch::merge(const DdSketch& other) {
+  if (other.m_gamma != m_gamma) {
+    throw std::invalid_argument("Sketches use different accuracy");
+  }
+  for (std::size_t position = 0; position < other.m_positive.counts.size();
+       ++position) {
+    m_positive.add(other.m_positive.offset + static_cast<int>(position),
+                   other.m_positive.counts[position]);
+  }
+  for (std::size_t position = 0; position < other.m_negative.counts.size();
+       ++position) {
+    m_negative.add(other.m_negative.offset + static_cast<int>(position),
+                   other.m_negative.counts[position]);
+  }
+  m_positive.collapse_lowest(m_max_buckets);
+  m_negative.collapse_lowest(m_max_buckets);
+  m_zero_count += other.m_zero_count;
+  m_min = std::min(m_min, other.m_min);
+  m_max = std::max(m_max, other.m_max);
+}
+
+double DdSketch::quantile(double q) const {
+  const std::uint64_t total = count();
+  validate_quantile(q, total);
+  if (q == 0.0 || q == 1.0) {
+    return q == 0.0 ? m_min : m_max;
+  }
+
+  // Values in rank order: negatives from the largest magnitude down, then
+  // zeros, then positives from the smallest magnitude up.
+  const double rank = q * static_cast<double>(total - 1);
+  double estimate = m_max;
+  std::uint64_t seen = 0;
+  auto passes = [&](std::uint64_t count) {
+    seen += count;
+    return static_cast<double>(seen) > rank;
+  };
+  bool found = false;
+  for (std::size_t position = m_negative.counts.size();
+       !found && position-- > 0;) {
+    if (passes(m_negative.counts[position])) {
+      estimate = -value_of(m_negative.offset + static_cast<int>(position));
+      found = true;
+    }
+  }
+  if (!found && passes(m_zero_count)) {
+    estimate = 0.0;
+    found = true;
+  }
+  for (std::size_t position = 0;
+       !found && position < m_positive.counts.size(); ++position) {
+    if (passes(m_positive.counts[position])) {
+      estimate = value_of(m_positive.offset + static_cast<int>(position));
+      found = true;
+    }
+  }
+  return std::clamp(estimate, m_min, m_max);
+}
+
+std::uint64_t DdSketch::count() const {
+  return m_positive.total() + m_negative.total() + m_zero_count;
+}
+
+double DdSketch::relative_accuracy() const { return m_relative_accuracy; }
+
+void DdSketch::serialize(std::ostream& output) const {
+  const bool empty = count() == 0;
+  const SketchFormat format(output);
+  write_header(output, DD_SKETCH_HEADER);
+  output << ' ' << m_relative_accuracy << ' ' << m_max_buckets << ' '
+         << m_zero_count << ' ' << (empty ? 0.0 : m_min) << ' '
+         << (empty ? 0.0 : m_max) << '\n';
+  for (const Store* store : {&m_positive, &m_negative}) {
+    output << store->offset << ' ' << store->counts.size();
+    for (std::uint64_t count : store->counts) {
+      output << ' ' << count;
+    }
+    output << '\n';
+  }
+}
+
+DdSketch DdSketch::deserialize(std::istream& input) {
+  // Counts are read one at a time, so a corrupt length fails at the end of
+  // the input instead of allocating what it claims.
+  const SketchFormat format(input);
+  read_header(input, DD_SKETCH_HEADER);
+  const auto relative_accuracy = read_value<double>(input);
+  const auto max_buckets = read_value<std::size_t>(input);
+  DdSketch sketch(relative_accuracy, max_buckets);
+  sketch.m_zero_count = read_value<std::uint64_t>(input);
+  const auto min = read_value<double>(input);
+  const auto max = read_value<double>(input);
+  std::uint64_t total = sketch.m_zero_count;
+  for (Store* store : {&sketch.m_positive, &sketch.m_negative}) {
+    store->offset = read_value<int>(input);
+    const std::size_t length = read_length(input, max_buckets);
+    // Bucket indices past the last one must still fit in an int.
+    const std::int64_t room =
+        std::int64_t{std::numeric_limits<int>::max()} - store->offset;
+    if (length > 0 && length - 1 > static_cast<std::uint64_t>(room)) {
+      throw std::invalid_argument("Malformed sketch");
+    }
+    for (std::size_t position = 0; position < length; ++position) {
+      store->counts.push_back(read_value<std::uint64_t>(input));
+      add_to_total(total, store->counts.back());
+    }
+  }
+  if (total > 0) {
+    if (!(std::isfinite(min) && std::isfinite(max) && min <= max)) {
+      throw std::invalid_argument("Malformed sketch");
+    }
+    sketch.m_min = min;
+    sketch.m_max = max;
+  }
+  return sketch;
+}
+
+int DdSketch::index_of(double magnitude) const {
+  return static_cast<int>(std::ceil(std::log(magnitude) / m_log_gamma));
+}
+
+double DdSketch::value_of(int index) const {
+  // Midpoint, in relative terms, of (gamma^(index-1), gamma^index].
+  return 2.0 * std::pow(m_gamma, index) / (m_gamma + 1.0);
+}
+
+KllSketch::KllSketch(std::size_t k, std::uint64_t seed)
+    : m_k(k), m_state(seed == 0 ? 0x9E3779B97F4A7C15ull : seed),
+      m_levels(1), m_min(std::numeric_limits<double>::infinity()),
+      m_max(-std::numeric_limits<double>::infinity()) {
+  if (k < 8) {
+    throw std::invalid_argument("KLL k must be at least 8");
+  }
+  update_capacity();
+}
+
+void KllSketch::add(double value) { add(std::span<const double>(&value, 1)); }
+
+void KllSketch::add(std::span<const double> values) {
+  for (double value : values) {
+    validate_value(value);
+    m_min = std::min(m_min, value);
+    m_max = std::max(m_max, value);
+    m_levels.front().push_back(value);
+    ++m_count;
+    if (++m_retained >= m_total_capacity) {
+      compress();
+    }
+  }
+}
+
+void KllSketch::merge(const KllSketch& other) {
+  if (other.m_k != m_k) {
+    throw std::invalid_argument("Sketches use different k");
+  }
+  if (other.m_levels.size() > m_levels.size()) {
+    m_levels.resize(other.m_levels.size());
+    update_capacity();
+  }
+  for (std::size_t level = 0; level < other.m_levels.size(); ++level) {
+    m_levels[level].insert(m_levels[level].end(),
+                           other.m_levels[level].begin(),
+                           other.m_levels[level].end());
+  }
+  m_count += other.m_count;
+  m_retained += other.m_retained;
+  m_min = std::min(m_min, other.m_min);
+  m_max = std::max(m_max, other.m_max);
+  compress();
+}
+
+double KllSketch::quantile(double q) const {
+  validate_quantile(q, m_count);
+  if (q == 0.0 || q == 1.0) {
+    return q == 0.0 ? m_min : m_max;
+  }
+
+  std::vector<std::pair<double, std::uint64_t>> weighted;
+  weighted.reserve(retained());
+  for (std::size_t level = 0; level < m_levels.size(); ++level) {
+    for (double value : m_levels[level]) {
+      weighted.emplace_back(value, std::uint64_t{1} << level);
+    }
+  }
+  std::sort(weighted.begin(), weighted.end());
+
+  const double rank = q * static_cast<double>(m_count - 1);
+  std::uint64_t seen = 0;
+  for (const auto& [value, weight] : weighted) {
+    seen += weight;
+    if (static_cast<double>(seen) > rank) {
+      return std::clamp(value, m_min, m_max);
+    }
+  }
+  return m_max;
+}
+
+std::uint64_t KllSketch::count() const { return m_count; }
+
+std::size_t KllSketch::retained() const { return m_retained; }
+
+void KllSketch::serialize(std::ostream& output) const {
+  const bool empty = m_count == 0;
+  const SketchFormat format(output);
+  write_header(output, KLL_SKETCH_HEADER);
+  output << ' ' << m_k << ' ' << m_state << ' ' << m_count << ' '
+         << (empty ? 0.0 : m_min) << ' ' << (empty ? 0.0 : m_max) << ' '
+         << m_levels.size() << '\n';
+  for (const std::vector<double>& items : m_levels) {
+    output << items.size();
+    for (double value : items) {
+      output << ' ' << value;
+    }
+    output << '\n';
+  }
+}
+
+KllSketch KllSketch::deserialize(std::istream& input) {
+  // Items are read one at a time, so a corrupt length fails at the end of
+  // the input instead of allocating what it claims. A sketch never retains
+  // more than its total capacity, and its weights add up to its count.
+  const SketchFormat format(input);
+  read_header(input, KLL_SKETCH_HEADER);
+  const auto k = read_value<std::size_t>(input);
+  KllSketch sketch(k, read_value<std::uint64_t>(input));
+  sketch.m_count = read_value<std::uint64_t>(input);
+  const auto min = read_value<double>(input);
+  const auto max = read_value<double>(input);
+  sketch.m_levels.resize(
+      std::max<std::size_t>(1, read_length(input, MAX_KLL_LEVELS)));
+  sketch.update_capacity();
+  std::uint64_t total = 0;
+  for (std::size_t level = 0; level < sketch.m_levels.size(); ++level) {
+    std::vector<double>& items = sketch.m_levels[level];
+    const std::size_t length =
+        read_length(input, sketch.m_total_capacity - sketch.m_retained);
+    for (std::size_t index = 0; index < length; ++index) {
+      items.push_back(read_value<double>(input));
+      validate_value(items.back());
+      add_to_total(total, std::uint64_t{1} << level);
+    }
+    sketch.m_retained += length;
+  }
+  if (total != sketch.m_count) {
+    throw std::invalid_argument("Malformed sketch");
+  }
+  if (sketch.m_count > 0) {
+    if (!(std::isfinite(min) && std::isfinite(max) && min <= max)) {
+      throw std::invalid_argument("Malformed sketch");
+    }
+    sketch.m_min = min;
+    sketch.m_max = max;
+  }
+  return sketch;
+}
+
+std::size_t KllSketch::capacity(std::size_t level) const {
+  // Capacities shrink by 2/3 per level below the top one.
+  const std::size_t depth = m_levels.size() - 1 - level;
+  const double scaled =
+      std::ceil(static_cast<double>(m_k) * std::pow(2.0 / 3.0, depth));
+  return std::max<std::size_t>(2, static_cast<std::size_t>(scaled));
+}
+
+void KllSketch::update_capacity() {
+  m_total_capacity = 0;
+  for (std::size_t level = 0; level < m_levels.size(); ++level) {
+    m_total_capacity += capacity(level);
+  }
+}
+
+void KllSketch::compress() {
+  // Retaining at least the total capacity means some level is full.
+  while (m_retained >= m_total_capacity) {
+    std::size_t level = 0;
+    while (m_levels[level].size() < capacity(level)) {
+      ++level;
+    }
+    compact(level);
+  }
+}
+
+void KllSketch::compact(std::size_t level) {
+  if (level + 1 == m_levels.size()) {
+    m_levels.emplace_back();
+    update_capacity();
+  }
+
+  // Keep the odd or even items of the sorted level at twice the weight; an
+  // odd item out stays behind.
+  std::vector<double>& items = m_levels[level];
+  std::vector<double>& above = m_levels[level + 1];
+  std::sort(items.begin(), items.end());
+  const std::size_t held = items.size() % 2;
+  const std::size_t promoted = (items.size() - held) / 2;
+  for (std::size_t index = held + (random_bit() ? 1 : 0);
+       index < items.size(); index += 2) {
+    above.push_back(items[index]);
+  }
+  m_retained -= items.size() - held - promoted;
+  items.resize(held);
+}
+
+bool KllSketch::random_bit() {
+  // xorshift64
+  m_state ^= m_state << 13;
+  m_state ^= m_state >> 7;
+  m_state ^= m_state << 17;
+  return (m_state >> 63) != 0;
+}
+
+// Unit tests (embedded in source file)
+// Disabled in production builds via DOCTEST_CONFIG_DISABLE
+#include <doctest/doctest.h>
+
+// Standard library headers
+#include <iomanip>
+#include <sstream>
+
+namespace {
+
+std::vector<double> skewed_values(std::size_t count) {
+  std::vector<double> values(count);
+  for (std::size_t index = 0; index < count; ++index) {
+    const double position = static_cast<double>(index) / count;
+    values[index] = std::exp(10.0 * position) - 5.0;
+  }
+  return values;
+}
+
+double exact_quantile(std::vector<double> values, double q) {
+  std::sort(values.begin(), values.end());
+  return values[static_cast<std::size_t>(q * (values.size() - 1))];
+}
+
+} // namespace
+
+TEST_CASE("DdSketch - quantiles") {
+  // Arrange
+  std::vector<double> values = skewed_values(10000);
+  DdSketch sketch(0.01);
+
+  SUBCASE("estimates stay within the relative accuracy") {
+    // Act
+    sketch.add(values);
+
+    // Assert
+    CHECK(sketch.count() == values.size());
+    for (double q : {0.0, 0.1, 0.5, 0.9, 0.99, 1.0}) {
+      const double exact = exact_quantile(values, q);
+      CHECK(std::abs(sketch.quantile(q) - exact) <=
+            0.01 * std::abs(exact) + 1e-12);
+    }
+  }
+
+  SUBCASE("merging equals adding everything to one sketch") {
+    // Arrange
+    DdSketch first(0.01);
+    DdSketch second(0.01);
+    first.add(std::span<const double>(values).first(3000));
+    second.add(std::span<const double>(values).subspan(3000));
+    sketch.add(values);
+
+    // Act
+    first.merge(second);
+
+    // Assert
+    for (double q : {0.25, 0.5, 0.99}) {
+      CHECK(first.quantile(q) == sketch.quantile(q));
+    }
+    CHECK_THROWS_AS(first.merge(DdSketch(0.02)), std::invalid_argument);
+  }
+
+  SUBCASE("serialization round-trips") {
+    // Arrange
+    sketch.add(values);
+    std::stringstream stream;
+
+    // Act
+    sketch.serialize(stream);
+    DdSketch restored = DdSketch::deserialize(stream);
+
+    // Assert
+    CHECK(restored.count() == sketch.count());
+    CHECK(restored.quantile(0.5) == sketch.quantile(0.5));
+    CHECK(restored.quantile(1.0) == sketch.quantile(1.0));
+  }
+
+  SUBCASE("bucket limits collapse the values nearest zero") {
+    // Arrange
+    DdSketch bounded(0.01, 64);
+
+    // Act
+    bounded.add(values);
+
+    // Assert
+    const double exact = exact_quantile(values, 0.99);
+    CHECK(std::abs(bounded.quantile(0.99) - exact) <= 0.01 * exact);
+  }
+
+  SUBCASE("invalid input throws") {
+    // Act & Assert
+    CHECK_THROWS_AS(sketch.quantile(0.5), std::invalid_argument);
+    CHECK_THROWS_AS(sketch.add(std::nan("")), std::invalid_argument);
+    CHECK_THROWS_AS(DdSketch(0.0), std::invalid_argument);
+    sketch.add(1.0);
+    CHECK_THROWS_AS(sketch.quantile(1.5), std::invalid_argument);
+  }
+}
+
+TEST_CASE("KllSketch - quantiles") {
+  // Arrange
+  std::vector<double> values = skewed_values(100000);
+  std::vector<double> sorted = values;
+  std::sort(sorted.begin(), sorted.end());
+  auto rank_error = [&](double estimate, double q) {
+    const auto rank = std::lower_bound(sorted.begin(), sorted.end(), estimate) -
+                      sorted.begin();
+    return std::abs(static_cast<double>(rank) / sorted.size() - q);
+  };
+  KllSketch sketch(200);
+
+  SUBCASE("estimates stay within the rank error in bounded space") {
+    // Act
+    sketch.add(values);
+
+    // Assert
+    CHECK(sketch.count() == values.size());
+    CHECK(sketch.retained() < 2000);
+    for (double q : {0.1, 0.5, 0.9, 0.99}) {
+      CHECK(rank_error(sketch.quantile(q), q) < 0.02);
+    }
+    CHECK(sketch.quantile(0.0) == sorted.front());
+    CHECK(sketch.quantile(1.0) == sorted.back());
+  }
+
+  SUBCASE("merged sketches keep the rank error") {
+    // Arrange
+    KllSketch other(200, 7);
+    sketch.add(std::span<const double>(values).first(40000));
+    other.add(std::span<const double>(values).subspan(40000));
+
+    // Act
+    sketch.merge(other);
+
+    // Assert
+    CHECK(sketch.count() == values.size());
+    for (double q : {0.1, 0.5, 0.9}) {
+      CHECK(rank_error(sketch.quantile(q), q) < 0.02);
+    }
+    CHECK_THROWS_AS(sketch.merge(KllSketch(100)), std::invalid_argument);
+  }
+
+  SUBCASE("serialization round-trips") {
+    // Arrange
+    sketch.add(values);
+    std::stringstream stream;
+
+    // Act
+    sketch.serialize(stream);
+    KllSketch restored = KllSketch::deserialize(stream);
+
+    // Assert
+    CHECK(restored.count() == sketch.count());
+    CHECK(restored.retained() == sketch.retained());
+    CHECK(restored.quantile(0.5) == sketch.quantile(0.5));
+  }
+
+  SUBCASE("serialization keeps the caller's stream format") {
+    // Arrange
+    sketch.add(values);
+    std::stringstream stream;
+    stream << std::fixed << std::setprecision(2);
+
+    // Act
+    sketch.serialize(stream);
+    KllSketch restored = KllSketch::deserialize(stream);
+
+    // Assert
+    CHECK(restored.quantile(0.5) == sketch.quantile(0.5));
+    CHECK(stream.precision() == 2);
+    CHECK((stream.flags() & std::ios_base::fixed) != 0);
+  }
+}
+
+TEST_CASE("QuantileSketch - malformed serialized sketches") {
+  // Arrange - lengths far beyond the input, and weights or bucket counts
+  // that do not add up
+  const std::vector<std::string> kll_inputs = {
+      "calculator-kll-v1 200 1 5 0 0 1 99999999999999",
+      "calculator-kll-v1 200 1 5 0 0 99999999999999 1 0",
+      "calculator-kll-v1 200 1 5 0 1 1 2 0.5 1",
+      "calculator-kll-v1 200 1 2 1 0 1 2 0.5 1",
+      "calculator-kll-v1 200 1 1 0 1 1 1 nan",
+      "calculator-kll-v1 200 1 1 0 1 1 1"};
+  const std::vector<std::string> dd_inputs = {
+      "calculator-ddsketch-v1 0.01 2048 0 0 0 0 99999999999999",
+      "calculator-ddsketch-v1 0.01 4 0 0 0 0 5 1 1 1 1 1 0 0",
+      "calculator-ddsketch-v1 0.01 2048 0 0 1 0 1 18446744073709551615 "
+      "0 1 1",
+      "calculator-ddsketch-v1 0.01 2048 0 2 1 0 1 1 0 0",
+      "calculator-ddsketch-v1 0.01 2048 0 0 1 2147483647 2 1 1 0 0"};
+
+  for (const std::string& text : kll_inputs) {
+    // Act & Assert
+    std::istringstream input(text);
+    CHECK_THROWS_AS(KllSketch::deserialize(input), std::invalid_argument);
+  }
+  for (const std::string& text : dd_inputs) {
+    // Act & Assert
+    std::istringstream input(text);
+    CHECK_THROWS_AS(DdSketch::deserialize(input), std::invalid_argument);
+  }
+}
@@ -0,0 +1,342 @@
+// First-party headers
+#include "calculator/range_index.h"
+
+// Standard library headers
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <stdexcept>
+
+namespace {
+
+// Queries walked through the levels together by the batch APIs.
+constexpr std::size_t QUERY_BATCH = 16;
+
+template <typename T, typename Result, typename Combine>
+void fold(const T* data, std::size_t first, std::size_t last, Result& result,
+          Combine combine) {
+  for (std::size_t index = first; index < last; ++index) {
+    result = combine(result, static_cast<Result>(data[index]));
+  }
+}
+
+} // namespace
+
+RangeIndex::RangeIndex(std::span<const int> values)
+    : m_values(values.begin(), values.end()) {
+  std::size_t below = m_values.size();
+  while (below > 1) {
+    const std::size_t count = (below + FANOUT - 1) / FANOUT;
+    Level level;
+    level.sums.resize(count);
+    level.mins.resize(count);
+    level.maxs.resize(count);
+    m_levels.push_back(std::move(level));
+    for (std::size_t entry = 0; entry < count; ++entry) {
+      refresh(m_levels.size(), entry);
+    }
+    below = count;
+  }
+}
+
+std::size_t RangeIndex::size() const { return m_values.size(); }
+
+int RangeIndex::value(std::size_t position) const {
+  if (position >= m_values.size()) {
+    throw std::out_of_range("Position exceeds index size");
+  }
+  return m_values[position];
+}
+
+void RangeIndex::update(std::size_t position, int value) {
+  if (position >= m_values.size()) {
+    throw std::out_of_range("Position exceeds index size");
+  }
+  m_values[position] = value;
+  std::size_t entry = position;
+  for (std::size_t level = 1; level <= m_levels.size(); ++level) {
+    entry /= FANOUT;
+    refresh(level, entry);
+  }
+}
+
+void RangeIndex::update(std::span<const PointUpdate> updates) {
+  // Validated up front so that a bad position leaves the index unchanged.
+  for (const PointUpdate& update : updates) {
+    if (update.position >= m_values.size()) {
+      throw std::out_of_range("Position exceeds index size");
+    }
+  }
+
+  std::vector<std::size_t> entries;
+  entries.reserve(updates.size());
+  for (const PointUpdate& update : updates) {
+    m_values[update.position] = update.value;
+    entries.push_back(update.position);
+  }
+  std::sort(entries.begin(), entries.end());
+  for (std::size_t level = 1; level <= m_levels.size(); ++level) {
+    // Dividing keeps the entries sorted, so duplicates stay adjacent.
+    for (std::size_t& entry : entries) {
+      entry /= FANOUT;
+    }
+    entries.erase(std::unique(entries.begin(), entries.end()), entries.end());
+    for (std::size_t entry : entries) {
+      refresh(level, entry);
+    }
+  }
+}
+
+std::int64_t RangeIndex::sum(IndexRange range) const {
+  std::int64_t result = 0;
+  query<Aggregate::Sum>({&range, 1}, {&result, 1});
+  return result;
+}
+
+int RangeIndex::min(IndexRange range) const {
+  int result = 0;
+  query<Aggregate::Min>({&range, 1}, {&result, 1});
+  return result;
+}
+
+int RangeIndex::max(IndexRange range) const {
+  int result = 0;
+  query<Aggregate::Max>({&range, 1}, {&result, 1});
+  return result;
+}
+
+void RangeIndex::sum(std::span<const IndexRange> ranges,
+                     std::span<std::int64_t> results) const {
+  query<Aggregate::Sum>(ranges, results);
+}
+
+void RangeIndex::min(std::span<const IndexRange> ranges,
+                     std::span<int> results) const {
+  query<Aggregate::Min>(ranges, results);
+}
+
+void RangeIndex::max(std::span<const IndexRange> ranges,
+                     std::span<int> results) const {
+  query<Aggregate::Max>(ranges, results);
+}
+
+void RangeIndex::validate(IndexRange range, bool allow_empty) const {
+  if (range.first > range.last || range.last > m_values.size()) {
+    throw std::out_of_range("Range exceeds index size");
+  }
+  if (!allow_empty && range.first == range.last) {
+    throw std::invalid_argument("Empty range");
+  }
+}
+
+void RangeIndex::refresh(std::size_t level, std::size_t entry) {
+  auto summarize = [&](const auto* sums, const auto* mins, const auto* maxs,
+                       std::size_t count) {
+    const std::size_t first = entry * FANOUT;
+    const std::size_t last = std::min(first + FANOUT, count);
+    std::int64_t sum = 0;
+    int min = std::numeric_limits<int>::max();
+    int max = std::numeric_limits<int>::lowest();
+    for (std::size_t index = first; index < last; ++index) {
+      sum += sums[index];
+      min = std::min<int>(min, mins[index]);
+      max = std::max<int>(max, maxs[index]);
+    }
+    Level& summaries = m_levels[level - 1];
+    summaries.sums[entry] = sum;
+    summaries.mins[entry] = min;
+    summaries.maxs[entry] = max;
+  };
+
+  if (level == 1) {
+    const int* values = m_values.data();
+    summarize(values, values, values, m_values.size());
+  } else {
+    const Level& below = m_levels[level - 2];
+    summarize(below.sums.data(), below.mins.data(), below.maxs.data(),
+              below.sums.size());
+  }
+}
+
+template <RangeIndex::Aggregate Kind>
+void RangeIndex::query(std::span<const IndexRange> ranges,
+                       std::span<Result<Kind>> results) const {
+  if (results.size() < ranges.size()) {
+    throw std::invalid_argument("Missing result values");
+  }
+  for (const IndexRange& range : ranges) {
+    validate(range, Kind == Aggregate::Sum);
+  }
+
+  Result<Kind> identity = 0;
+  if constexpr (Kind == Aggregate::Min) {
+    identity = std::numeric_limits<int>::max();
+  } else if constexpr (Kind == Aggregate::Max) {
+    identity = std::numeric_limits<int>::lowest();
+  }
+
+  // Every query of a batch is on the same level in each round, so the
+  // loads of different queries are independent and overlap.
+  for (std::size_t offset = 0; offset < ranges.size();
+       offset += QUERY_BATCH) {
+    const std::size_t count = std::min(QUERY_BATCH, ranges.size() - offset);
+    std::array<std::size_t, QUERY_BATCH> firsts{};
+    std::array<std::size_t, QUERY_BATCH> lasts{};
+    std::array<Result<Kind>, QUERY_BATCH> partials{};
+    std::array<bool, QUERY_BATCH> finished{};
+    for (std::size_t query = 0; query < count; ++query) {
+      firsts[query] = ranges[offset + query].first;
+      lasts[query] = ranges[offset + query].last;
+      partials[query] = identity;
+    }
+
+    bool pending = true;
+    for (std::size_t level = 0; pending; ++level) {
+      pending = false;
+      for (std::size_t query = 0; query < count; ++query) {
+        if (!finished[query]) {
+          finished[query] = step<Kind>(level, firsts[query], lasts[query],
+                                       partials[query]);
+          pending |= !finished[query];
+        }
+      }
+    }
+    std::copy_n(partials.begin(), count, results.begin() + offset);
+  }
+}
+
+template <RangeIndex::Aggregate Kind>
+bool RangeIndex::step(std::size_t level, std::size_t& first,
+                      std::size_t& last, Result<Kind>& result) const {
+  const std::size_t first_block = (first + FANOUT - 1) / FANOUT;
+  const std::size_t last_block = last / FANOUT;
+  if (level == m_levels.size() || first_block >= last_block) {
+    scan<Kind>(level, first, last, result);
+    return true;
+  }
+  scan<Kind>(level, first, first_block * FANOUT, result);
+  scan<Kind>(level, last_block * FANOUT, last, result);
+  first = first_block;
+  last = last_block;
+  return false;
+}
+
+template <RangeIndex::Aggregate Kind>
+void RangeIndex::scan(std::size_t level, std::size_t first, std::size_t last,
+                      Result<Kind>& result) const {
+  auto combine = [](Result<Kind> accumulated, Result<Kind> value) {
+    if constexpr (Kind == Aggregate::Sum) {
+      return accumulated + value;
+    } else if constexpr (Kind == Aggregate::Min) {
+      return std::min(accumulated, value);
+    } else {
+      return std::max(accumulated, value);
+    }
+  };
+
+  if (level == 0) {
+    fold(m_values.data(), first, last, result, combine);
+    return;
+  }
+  const Level& summaries = m_levels[level - 1];
+  if constexpr (Kind == Aggregate::Sum) {
+    fold(summaries.sums.data(), first, last, result, combine);
+  } else if constexpr (Kind == Aggregate::Min) {
+    fold(summaries.mins.data(), first, last, result, combine);
+  } else {
+    fold(summaries.maxs.data(), first, last, result, combine);
+  }
+}
+
+// Unit tests (embedded in source file)
+// Disabled in production builds via DOCTEST_CONFIG_DISABLE
+#include <doctest/doctest.h>
+
+TEST_CASE("RangeIndex - queries") {
+  // Arrange - 1000 values spanning three levels
+  std::vector<int> values(1000);
+  for (std::size_t index = 0; index < values.size(); ++index) {
+    values[index] = static_cast<int>(index % 37) - 18;
+  }
+  RangeIndex index(values);
+  auto naive_sum = [&](IndexRange range) {
+    std::int64_t sum = 0;
+    for (std::size_t position = range.first; position < range.last;
+         ++position) {
+      sum += values[position];
+    }
+    return sum;
+  };
+
+  SUBCASE("sums, minimums and maximums match a linear scan") {
+    // Arrange
+    std::vector<IndexRange> ranges = {
+        {0, 1000}, {0, 1}, {15, 17}, {16, 272}, {3, 997}, {500, 500}};
+
+    // Act & Assert
+    for (const IndexRange& range : ranges) {
+      CHECK(index.sum(range) == naive_sum(range));
+    }
+    CHECK(index.min({0, 1000}) == -18);
+    CHECK(index.max({0, 1000}) == 18);
+    CHECK(index.min({19, 36}) == 1);
+    CHECK(index.max({37, 38}) == -18);
+  }
+
+  SUBCASE("single and batched updates refresh every level") {
+    // Act
+    index.update(999, 1000);
+    std::vector<PointUpdate> updates = {{0, -500}, {1, 7}, {0, -400}};
+    index.update(updates);
+    values[999] = 1000;
+    values[0] = -400;
+    values[1] = 7;
+
+    // Assert
+    CHECK(index.value(0) == -400);
+    CHECK(index.sum({0, 1000}) == naive_sum({0, 1000}));
+    CHECK(index.min({0, 1000}) == -400);
+    CHECK(index.max({500, 1000}) == 1000);
+  }
+
+  SUBCASE("batched queries answer every range") {
+    // Arrange - more ranges than one batch
+    std::vector<IndexRange> ranges;
+    for (std::size_t first = 0; first < 40; ++first) {
+      ranges.push_back({first * 20, first * 20 + 150});
+    }
+    std::vector<std::int64_t> sums(ranges.size());
+
+    // Act
+    index.sum(ranges, sums);
+
+    // Assert
+    for (std::size_t query = 0; query < ranges.size(); ++query) {
+      CHECK(sums[query] == naive_sum(ranges[query]));
+    }
+  }
+
+  SUBCASE("invalid ranges throw") {
+    // Act & Assert
+    CHECK_THROWS_AS(index.sum({10, 1001}), std::out_of_range);
+    CHECK_THROWS_AS(index.sum({10, 9}), std::out_of_range);
+    CHECK_THROWS_AS(index.min({10, 10}), std::invalid_argument);
+    CHECK_THROWS_AS(index.update(1000, 1), std::out_of_range);
+    std::vector<PointUpdate> updates = {{0, 1}, {1000, 1}};
+    CHECK_THROWS_AS(index.update(updates), std::out_of_range);
+    CHECK(index.value(0) == -18);
+  }
+}
+
+TEST_CASE("RangeIndex - small sizes") {
+  // Arrange
+  std::vector<int> single = {5};
+  RangeIndex empty(std::span<const int>{});
+  RangeIndex one(single);
+
+  // Act & Assert
+  CHECK(empty.size() == 0);
+  CHECK(empty.sum({0, 0}) == 0);
+  CHECK(one.sum({0, 1}) == 5);
+  CHECK(one.max({0, 1}) == 5);
+}
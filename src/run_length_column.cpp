@@ -0,0 +1,493 @@
+// First-party headers
+#include "calculator/run_length_column.h"
+#include "wide_sum.h"
+
+// Standard library headers
+#include <algorithm>
+#include <bit>
+#include <stdexcept>
+
+namespace {
+
+// Bitwise equality, so that runs never join -0.0 with 0.0 and NaNs with
+// the same payload still form one run.
+bool same_value(int first, int second) { return first == second; }
+
+bool same_value(double first, double second) {
+  return std::bit_cast<std::uint64_t>(first) ==
+         std::bit_cast<std::uint64_t>(second);
+}
+
+void check_sizes(std::size_t first_size, std::size_t second_size) {
+  if (first_size != second_size) {
+    throw std::invalid_argument("Column sizes do not match");
+  }
+}
+
+template <typename T> void check_not_empty(const RunLengthColumn<T>& column) {
+  if (column.run_count() == 0) {
+    throw std::invalid_argument("Column is empty");
+  }
+}
+
+// Applies operation to the value of every run; the run boundaries stay
+// where they are unless neighbouring results are equal.
+template <typename Result, typename Operation>
+RunLengthColumn<Result> apply_to_runs(const RunLengthColumn<int>& column,
+                                      const Operation& operation) {
+  RunLengthColumn<Result> results;
+  results.reserve(column.run_count());
+  const std::span<const int> values = column.values();
+  const std::span<const std::size_t> ends = column.ends();
+  std::size_t start = 0;
+  for (std::size_t run = 0; run < values.size(); ++run) {
+    results.append(operation(values[run]), ends[run] - start);
+    start = ends[run];
+  }
+  return results;
+}
+
+// Walks both columns' runs together. Each output run ends at the nearer
+// of the two current run ends, after which whichever input run ended (or
+// both) advances.
+template <typename Result, typename Operation>
+RunLengthColumn<Result> apply_to_merged_runs(const RunLengthColumn<int>& first,
+                                             const RunLengthColumn<int>& second,
+                                             const Operation& operation) {
+  check_sizes(first.size(), second.size());
+  RunLengthColumn<Result> results;
+  results.reserve(first.run_count() + second.run_count());
+  const std::span<const int> first_values = first.values();
+  const std::span<const std::size_t> first_ends = first.ends();
+  const std::span<const int> second_values = second.values();
+  const std::span<const std::size_t> second_ends = second.ends();
+  std::size_t first_run = 0;
+  std::size_t second_run = 0;
+  std::size_t start = 0;
+  while (first_run < first_values.size()) {
+    const std::size_t end =
+        std::min(first_ends[first_run], second_ends[second_run]);
+    results.append(
+        operation(first_values[first_run], second_values[second_run]),
+        end - start);
+    first_run += first_ends[first_run] == end ? 1 : 0;
+    second_run += second_ends[second_run] == end ? 1 : 0;
+    start = end;
+  }
+  return results;
+}
+
+double weighted_sum(const RunLengthColumn<double>& column) {
+  const std::span<const double> values = column.values();
+  const std::span<const std::size_t> ends = column.ends();
+  double sum = 0.0;
+  std::size_t start = 0;
+  for (std::size_t run = 0; run < values.size(); ++run) {
+    sum += values[run] * static_cast<double>(ends[run] - start);
+    start = ends[run];
+  }
+  return sum;
+}
+
+// Each run adds value * length, with the length split into 32-bit halves
+// so both partial products fit in int64, to a 128-bit total; runs appended
+// with large counts can pass 64 bits long before the column does.
+std::int64_t weighted_sum(const RunLengthColumn<int>& column) {
+  const std::span<const int> values = column.values();
+  const std::span<const std::size_t> ends = column.ends();
+  WideSum sum;
+  std::size_t start = 0;
+  for (std::size_t run = 0; run < values.size(); ++run) {
+    const auto length = static_cast<std::uint64_t>(ends[run] - start);
+    const std::int64_t value = values[run];
+    sum.add(value * static_cast<std::int64_t>(length & 0xFFFFFFFFu));
+    sum.add_shifted(value * static_cast<std::int64_t>(length >> 32));
+    start = ends[run];
+  }
+  if (!sum.fits()) {
+    throw std::overflow_error("Integer overflow");
+  }
+  return sum.value();
+}
+
+} // namespace
+
+template <typename T>
+RunLengthColumn<T> RunLengthColumn<T>::encode(std::span<const T> values) {
+  RunLengthColumn column;
+  for (std::size_t row = 1; row < values.size(); ++row) {
+    if (!same_value(values[row], values[row - 1])) {
+      column.m_values.push_back(values[row - 1]);
+      column.m_ends.push_back(row);
+    }
+  }
+  if (!values.empty()) {
+    column.m_values.push_back(values.back());
+    column.m_ends.push_back(values.size());
+  }
+  return column;
+}
+
+template <typename T>
+void RunLengthColumn<T>::append(T value, std::size_t count) {
+  if (count == 0) {
+    return;
+  }
+  if (!m_values.empty() && same_value(m_values.back(), value)) {
+    m_ends.back() += count;
+    return;
+  }
+  m_values.push_back(value);
+  m_ends.push_back(size() + count);
+}
+
+template <typename T>
+void RunLengthColumn<T>::reserve(std::size_t run_count) {
+  m_values.reserve(run_count);
+  m_ends.reserve(run_count);
+}
+
+template <typename T> std::size_t RunLengthColumn<T>::size() const {
+  return m_ends.empty() ? 0 : m_ends.back();
+}
+
+template <typename T> std::size_t RunLengthColumn<T>::run_count() const {
+  return m_values.size();
+}
+
+template <typename T> std::span<const T> RunLengthColumn<T>::values() const {
+  return m_values;
+}
+
+template <typename T>
+std::span<const std::size_t> RunLengthColumn<T>::ends() const {
+  return m_ends;
+}
+
+template <typename T>
+void RunLengthColumn<T>::decode(std::span<T> results) const {
+  if (results.size() < size()) {
+    throw std::invalid_argument("Missing result values");
+  }
+  std::size_t start = 0;
+  for (std::size_t run = 0; run < m_values.size(); ++run) {
+    std::fill(results.begin() + static_cast<std::ptrdiff_t>(start),
+              results.begin() + static_cast<std::ptrdiff_t>(m_ends[run]),
+              m_values[run]);
+    start = m_ends[run];
+  }
+}
+
+template class RunLengthColumn<int>;
+template class RunLengthColumn<double>;
+
+RunLengthColumn<int>
+RunLengthCalculator::add(const RunLengthColumn<int>& column, int value) {
+  return apply_to_runs<int>(column, [&](int first_value) {
+    return m_calculator.add(first_value, value);
+  });
+}
+
+RunLengthColumn<int>
+RunLengthCalculator::subtract(const RunLengthColumn<int>& column, int value) {
+  return apply_to_runs<int>(column, [&](int first_value) {
+    return m_calculator.subtract(first_value, value);
+  });
+}
+
+RunLengthColumn<int>
+RunLengthCalculator::multiply(const RunLengthColumn<int>& column, int value) {
+  return apply_to_runs<int>(column, [&](int first_value) {
+    return m_calculator.multiply(first_value, value);
+  });
+}
+
+RunLengthColumn<double>
+RunLengthCalculator::divide(const RunLengthColumn<int>& column, int value) {
+  return apply_to_runs<double>(column, [&](int first_value) {
+    return m_calculator.divide(first_value, value);
+  });
+}
+
+RunLengthColumn<int>
+RunLengthCalculator::add(const RunLengthColumn<int>& first,
+                         const RunLengthColumn<int>& second) {
+  return apply_to_merged_runs<int>(
+      first, second, [&](int first_value, int second_value) {
+        return m_calculator.add(first_value, second_value);
+      });
+}
+
+RunLengthColumn<int>
+RunLengthCalculator::subtract(const RunLengthColumn<int>& first,
+                              const RunLengthColumn<int>& second) {
+  return apply_to_merged_runs<int>(
+      first, second, [&](int first_value, int second_value) {
+        return m_calculator.subtract(first_value, second_value);
+      });
+}
+
+RunLengthColumn<int>
+RunLengthCalculator::multiply(const RunLengthColumn<int>& first,
+                              const RunLengthColumn<int>& second) {
+  return apply_to_merged_runs<int>(
+      first, second, [&](int first_value, int second_value) {
+        return m_calculator.multiply(first_value, second_value);
+      });
+}
+
+RunLengthColumn<double>
+RunLengthCalculator::divide(const RunLengthColumn<int>& first,
+                            const RunLengthColumn<int>& second) {
+  return apply_to_merged_runs<double>(
+      first, second, [&](int first_value, int second_value) {
+        return m_calculator.divide(first_value, second_value);
+      });
+}
+
+std::int64_t RunLengthCalculator::sum(const RunLengthColumn<int>& column) {
+  return weighted_sum(column);
+}
+
+double RunLengthCalculator::sum(const RunLengthColumn<double>& column) {
+  return weighted_sum(column);
+}
+
+int RunLengthCalculator::min(const RunLengthColumn<int>& column) {
+  check_not_empty(column);
+  return *std::min_element(column.values().begin(), column.values().end());
+}
+
+int RunLengthCalculator::max(const RunLengthColumn<int>& column) {
+  check_not_empty(column);
+  return *std::max_element(column.values().begin(), column.values().end());
+}
+
+double RunLengthCalculator::min(const RunLengthColumn<double>& column) {
+  check_not_empty(column);
+  return *std::min_element(column.values().begin(), column.values().end());
+}
+
+double RunLengthCalculator::max(const RunLengthColumn<double>& column) {
+  check_not_empty(column);
+  return *std::max_element(column.values().begin(), column.values().end());
+}
+
+// Unit tests (embedded in source file)
+// Disabled in production builds via DOCTEST_CONFIG_DISABLE
+#include <doctest/doctest.h>
+
+// Standard library headers
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <random>
+
+namespace {
+
+// Values in runs of 1 to 2 * average_run - 1 rows.
+std::vector<int> random_runs(std::size_t count, std::size_t average_run,
+                             std::uint64_t seed) {
+  std::mt19937_64 random(seed);
+  std::uniform_int_distribution<std::size_t> length_of(1,
+                                                       2 * average_run - 1);
+  std::uniform_int_distribution<int> value_of(-20, 20);
+  std::vector<int> values;
+  while (values.size() < count) {
+    const std::size_t length =
+        std::min(length_of(random), count - values.size());
+    values.insert(values.end(), length, value_of(random));
+  }
+  return values;
+}
+
+} // namespace
+
+TEST_CASE("RunLengthColumn - encode, append and decode") {
+  SUBCASE("round trip with minimal runs") {
+    // Arrange
+    const std::vector<int> values = {5, 5, 5, -1, 7, 7, 5};
+
+    // Act
+    const auto column = RunLengthColumn<int>::encode(values);
+    std::vector<int> decoded(values.size());
+    column.decode(decoded);
+
+    // Assert
+    CHECK(decoded == values);
+    CHECK(column.size() == 7);
+    CHECK(std::vector<int>(column.values().begin(), column.values().end()) ==
+          std::vector<int>{5, -1, 7, 5});
+    CHECK(std::vector<std::size_t>(column.ends().begin(),
+                                   column.ends().end()) ==
+          std::vector<std::size_t>{3, 4, 6, 7});
+  }
+
+  SUBCASE("append joins equal neighbours and skips empty runs") {
+    // Arrange
+    RunLengthColumn<int> column;
+
+    // Act
+    column.append(1, 2);
+    column.append(1, 3);
+    column.append(2, 0);
+    column.append(2, 1);
+
+    // Assert
+    CHECK(column.size() == 6);
+    CHECK(column.run_count() == 2);
+  }
+
+  SUBCASE("doubles compare bit for bit") {
+    // Arrange
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    const std::vector<double> values = {0.0, -0.0, -0.0, nan, nan, 1.5};
+
+    // Act
+    const auto column = RunLengthColumn<double>::encode(values);
+    std::vector<double> decoded(values.size());
+    column.decode(decoded);
+
+    // Assert
+    CHECK(column.run_count() == 4);
+    CHECK(std::signbit(decoded[1]));
+    CHECK(std::isnan(decoded[4]));
+  }
+
+  SUBCASE("empty columns and short result spans") {
+    // Arrange
+    const auto empty = RunLengthColumn<int>::encode({});
+    const auto column = RunLengthColumn<int>::encode(std::vector<int>{1, 2});
+    std::vector<int> decoded(1);
+
+    // Act & Assert
+    CHECK(empty.size() == 0);
+    CHECK(empty.run_count() == 0);
+    CHECK_THROWS_AS(column.decode(decoded), std::invalid_argument);
+  }
+}
+
+TEST_CASE("RunLengthCalculator - matches Calculator row by row") {
+  RunLengthCalculator run_length_calculator;
+  Calculator calculator;
+
+  SUBCASE("operations with a constant") {
+    // Arrange
+    const std::vector<int> values = random_runs(2000, 8, 1);
+    const auto column = RunLengthColumn<int>::encode(values);
+
+    // Act
+    std::vector<int> sums(values.size());
+    std::vector<int> products(values.size());
+    std::vector<double> quotients(values.size());
+    run_length_calculator.add(column, 3).decode(sums);
+    run_length_calculator.multiply(column, -2).decode(products);
+    run_length_calculator.divide(column, 4).decode(quotients);
+    const auto zeros = run_length_calculator.multiply(column, 0);
+
+    // Assert
+    for (std::size_t row = 0; row < values.size(); ++row) {
+      CHECK(sums[row] == calculator.add(values[row], 3));
+      CHECK(products[row] == calculator.multiply(values[row], -2));
+      CHECK(quotients[row] == calculator.divide(values[row], 4));
+    }
+    CHECK(zeros.run_count() == 1);
+    CHECK(zeros.size() == values.size());
+  }
+
+  SUBCASE("operations between columns with misaligned runs") {
+    for (std::size_t average_run : {1, 5, 40}) {
+      // Arrange
+      const std::vector<int> first_values = random_runs(3000, average_run, 2);
+      std::vector<int> second_values = random_runs(3000, 7, 3);
+      std::replace(second_values.begin(), second_values.end(), 0, 9);
+      const auto first = RunLengthColumn<int>::encode(first_values);
+      const auto second = RunLengthColumn<int>::encode(second_values);
+
+      // Act
+      std::vector<int> differences(first_values.size());
+      std::vector<int> products(first_values.size());
+      std::vector<double> quotients(first_values.size());
+      const auto sums = run_length_calculator.add(first, second);
+      run_length_calculator.subtract(first, second).decode(differences);
+      run_length_calculator.multiply(first, second).decode(products);
+      run_length_calculator.divide(first, second).decode(quotients);
+
+      // Assert
+      std::vector<int> decoded_sums(first_values.size());
+      sums.decode(decoded_sums);
+      for (std::size_t row = 0; row < first_values.size(); ++row) {
+        const int x = first_values[row];
+        const int y = second_values[row];
+        CHECK(decoded_sums[row] == calculator.add(x, y));
+        CHECK(differences[row] == calculator.subtract(x, y));
+        CHECK(products[row] == calculator.multiply(x, y));
+        CHECK(quotients[row] == calculator.divide(x, y));
+      }
+      CHECK(sums.run_count() <= first.run_count() + second.run_count());
+      CHECK(sums.run_count() == RunLengthColumn<int>::encode(decoded_sums)
+                                    .run_count());
+    }
+  }
+
+  SUBCASE("reductions") {
+    // Arrange
+    const std::vector<int> values = random_runs(5000, 10, 4);
+    const auto column = RunLengthColumn<int>::encode(values);
+    const std::vector<double> halves = {0.5, 0.5, -2.0, 4.0, 4.0, 4.0};
+    const auto double_column = RunLengthColumn<double>::encode(halves);
+
+    // Act & Assert
+    CHECK(run_length_calculator.sum(column) ==
+          std::accumulate(values.begin(), values.end(), std::int64_t{0}));
+    CHECK(run_length_calculator.min(column) ==
+          *std::min_element(values.begin(), values.end()));
+    CHECK(run_length_calculator.max(column) ==
+          *std::max_element(values.begin(), values.end()));
+    CHECK(run_length_calculator.sum(double_column) == 11.0);
+    CHECK(run_length_calculator.min(double_column) == -2.0);
+    CHECK(run_length_calculator.max(double_column) == 4.0);
+    CHECK(run_length_calculator.sum(RunLengthColumn<int>()) == 0);
+  }
+
+  SUBCASE("int sums of columns past 2^32 rows") {
+    // Arrange - runs whose products pass 64 bits
+    constexpr int max = std::numeric_limits<int>::max();
+    constexpr int min = std::numeric_limits<int>::min();
+    const std::size_t long_run = std::size_t{1} << 33;
+    RunLengthColumn<int> cancelling;
+    cancelling.append(max, long_run);
+    cancelling.append(-max, long_run);
+    cancelling.append(7, 3);
+    RunLengthColumn<int> lowest;
+    lowest.append(min, std::size_t{1} << 32);
+    RunLengthColumn<int> overflowing;
+    overflowing.append(max, long_run);
+
+    // Act & Assert
+    CHECK(run_length_calculator.sum(cancelling) == 21);
+    CHECK(run_length_calculator.sum(lowest) ==
+          std::numeric_limits<std::int64_t>::min());
+    CHECK_THROWS_AS(run_length_calculator.sum(overflowing),
+                    std::overflow_error);
+  }
+
+  SUBCASE("invalid operands") {
+    // Arrange
+    const auto column = RunLengthColumn<int>::encode(std::vector<int>{1, 2});
+    const auto divisors =
+        RunLengthColumn<int>::encode(std::vector<int>{3, 0});
+    const auto longer =
+        RunLengthColumn<int>::encode(std::vector<int>{1, 2, 3});
+
+    // Act & Assert
+    CHECK_THROWS_AS(run_length_calculator.divide(column, 0),
+                    std::invalid_argument);
+    CHECK_THROWS_AS(run_length_calculator.divide(column, divisors),
+                    std::invalid_argument);
+    CHECK_THROWS_AS(run_length_calculator.add(column, longer),
+                    std::invalid_argument);
+    CHECK_THROWS_AS(run_length_calculator.min(RunLengthColumn<int>()),
+                    std::invalid_argument);
+  }
+}
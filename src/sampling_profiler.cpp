@@ -0,0 +1,607 @@
+// First-party headers
+#include "calculator/memory_accounting.h"
+#include "calculator/sampling_profiler.h"
+
+// Standard library headers
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#if defined(__linux__)
+#include <cerrno>
+#include <csignal>
+#include <ctime>
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <pthread.h>
+#include <sys/syscall.h>
+#include <ucontext.h>
+#include <unistd.h>
+#endif
+
+struct SamplingProfiler::ThreadBuffer {
+  ThreadBuffer(std::size_t capacity, std::size_t max_depth)
+      : frames(capacity * max_depth), depths(capacity), capacity(capacity),
+        max_depth(max_depth) {}
+
+  // capacity samples of max_depth frames each, innermost frame first.
+  TrackedVector<std::uintptr_t, MemorySubsystem::Profiler> frames;
+  TrackedVector<std::size_t, MemorySubsystem::Profiler> depths;
+  std::size_t capacity;
+  std::size_t max_depth;
+  // Samples before count are complete; the handler publishes each one with
+  // a release store.
+  std::atomic<std::size_t> count{0};
+  std::atomic<std::size_t> dropped{0};
+  // Bounds of the thread's stack, used to stop walks at corrupt frames.
+  std::uintptr_t stack_low = 0;
+  std::uintptr_t stack_high = 0;
+#if defined(__linux__)
+  timer_t timer{};
+#endif
+  bool attached = false;
+};
+
+namespace {
+
+// Guards every profiler's buffer list and changes to the active profiler.
+// The active profiler is atomic only so that threads starting while none
+// runs can skip the lock.
+std::mutex registry_mutex;
+std::atomic<SamplingProfiler*> active_profiler{nullptr};
+
+// A thread's buffer is only valid while its generation matches the running
+// one, so threads left attached to a stopped profiler are ignored.
+std::atomic<std::uint64_t> running_generation{0};
+thread_local SamplingProfiler::ThreadBuffer* current_buffer = nullptr;
+thread_local std::uint64_t current_generation = 0;
+
+std::string to_hex(std::uintptr_t value) {
+  std::array<char, 2 * sizeof(value)> digits{};
+  auto result = std::to_chars(digits.data(), digits.data() + digits.size(),
+                              value, 16);
+  return "0x" + std::string(digits.data(), result.ptr);
+}
+
+#if defined(__linux__)
+
+struct sigaction previous_action;
+
+std::uintptr_t program_counter(const ucontext_t* context) {
+#if defined(__x86_64__)
+  return static_cast<std::uintptr_t>(context->uc_mcontext.gregs[REG_RIP]);
+#elif defined(__aarch64__)
+  return static_cast<std::uintptr_t>(context->uc_mcontext.pc);
+#else
+  static_cast<void>(context);
+  return 0;
+#endif
+}
+
+std::uintptr_t frame_pointer(const ucontext_t* context) {
+#if defined(__x86_64__)
+  return static_cast<std::uintptr_t>(context->uc_mcontext.gregs[REG_RBP]);
+#elif defined(__aarch64__)
+  return static_cast<std::uintptr_t>(context->uc_mcontext.regs[29]);
+#else
+  static_cast<void>(context);
+  return 0;
+#endif
+}
+
+// SIGPROF handler. Only touches the interrupted thread's own buffer and
+// lock-free atomics, so it is async-signal-safe.
+void record_sample(int, siginfo_t*, void* context) {
+  SamplingProfiler::ThreadBuffer* buffer = current_buffer;
+  if (buffer == nullptr ||
+      current_generation !=
+          running_generation.load(std::memory_order_relaxed)) {
+    return;
+  }
+
+  const int saved_errno = errno;
+  const std::size_t index = buffer->count.load(std::memory_order_relaxed);
+  if (index == buffer->capacity) {
+    buffer->dropped.fetch_add(1, std::memory_order_relaxed);
+    errno = saved_errno;
+    return;
+  }
+
+  const auto* user_context = static_cast<const ucontext_t*>(context);
+  std::uintptr_t* frames = buffer->frames.data() + index * buffer->max_depth;
+  std::size_t depth = 0;
+  frames[depth++] = program_counter(user_context);
+
+  // Each frame record holds the caller's frame pointer followed by the
+  // return address. Callers live higher on the stack, so the walk stops at
+  // anything that does not move up within the thread's stack.
+  std::uintptr_t frame = frame_pointer(user_context);
+  while (depth < buffer->max_depth && frame >= buffer->stack_low &&
+         frame + 2 * sizeof(std::uintptr_t) <= buffer->stack_high &&
+         frame % alignof(std::uintptr_t) == 0) {
+    const auto* record = reinterpret_cast<const std::uintptr_t*>(frame);
+    if (record[1] == 0) {
+      break;
+    }
+    frames[depth++] = record[1];
+    if (record[0] <= frame) {
+      break;
+    }
+    frame = record[0];
+  }
+
+  buffer->depths[index] = depth;
+  buffer->count.store(index + 1, std::memory_order_release);
+  errno = saved_errno;
+}
+
+std::string symbolize(std::uintptr_t address) {
+  Dl_info info{};
+  if (dladdr(reinterpret_cast<void*>(address), &info) != 0) {
+    if (info.dli_sname != nullptr) {
+      int status = 0;
+      char* demangled =
+          abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status);
+      std::string name = status == 0 ? demangled : info.dli_sname;
+      std::free(demangled);
+      return name;
+    }
+    if (info.dli_fname != nullptr) {
+      std::string module = info.dli_fname;
+      module = module.substr(module.find_last_of('/') + 1);
+      auto base = reinterpret_cast<std::uintptr_t>(info.dli_fbase);
+      return module + "+" + to_hex(address - base);
+    }
+  }
+  return to_hex(address);
+}
+
+#else
+
+std::string symbolize(std::uintptr_t address) { return to_hex(address); }
+
+#endif
+
+} // namespace
+
+SamplingProfiler::SamplingProfiler(ProfilerOptions options)
+    : m_options(options) {
+  if (m_options.frequency_hz == 0 || m_options.max_depth == 0 ||
+      m_options.samples_per_thread == 0) {
+    throw std::invalid_argument(
+        "Frequency, depth and sample capacity must be positive");
+  }
+  if (m_options.frequency_hz > 1'000'000'000) {
+    throw std::invalid_argument("Frequency exceeds timer resolution");
+  }
+}
+
+SamplingProfiler::~SamplingProfiler() { stop(); }
+
+void SamplingProfiler::start() {
+#if defined(__linux__)
+  std::unique_lock lock(registry_mutex);
+  if (active_profiler.load(std::memory_order_relaxed) != nullptr) {
+    throw std::logic_error("Another sampling profiler is running");
+  }
+
+  struct sigaction action{};
+  action.sa_sigaction = record_sample;
+  action.sa_flags = SA_SIGINFO | SA_RESTART;
+  sigemptyset(&action.sa_mask);
+  if (sigaction(SIGPROF, &action, &previous_action) != 0) {
+    throw std::system_error(errno, std::generic_category(), "sigaction");
+  }
+
+  running_generation.fetch_add(1, std::memory_order_relaxed);
+  active_profiler.store(this, std::memory_order_relaxed);
+  m_running = true;
+  try {
+    attach(lock);
+  } catch (...) {
+    if (active_profiler.load(std::memory_order_relaxed) == this) {
+      active_profiler.store(nullptr, std::memory_order_relaxed);
+      m_running = false;
+      sigaction(SIGPROF, &previous_action, nullptr);
+    }
+    throw;
+  }
+#else
+  throw std::runtime_error("Sampling profiler requires Linux");
+#endif
+}
+
+void SamplingProfiler::stop() {
+  std::lock_guard lock(registry_mutex);
+  if (!m_running) {
+    return;
+  }
+
+  // Deleting a timer also discards its pending signal, so no sample can
+  // arrive after the previous handler is restored.
+  for (const std::unique_ptr<ThreadBuffer>& buffer : m_buffers) {
+    detach_locked(buffer.get());
+  }
+#if defined(__linux__)
+  sigaction(SIGPROF, &previous_action, nullptr);
+#endif
+  running_generation.fetch_add(1, std::memory_order_relaxed);
+  active_profiler.store(nullptr, std::memory_order_relaxed);
+  m_running = false;
+}
+
+bool SamplingProfiler::is_running() const {
+  std::lock_guard lock(registry_mutex);
+  return m_running;
+}
+
+ProfiledThread SamplingProfiler::attach_current_thread() {
+  std::unique_lock lock(registry_mutex);
+  if (active_profiler.load(std::memory_order_relaxed) != this) {
+    throw std::logic_error("Sampling profiler is not running");
+  }
+  return ProfiledThread(this, attach(lock));
+}
+
+std::size_t SamplingProfiler::sample_count() const {
+  std::lock_guard lock(registry_mutex);
+  std::size_t total = 0;
+  for (const std::unique_ptr<ThreadBuffer>& buffer : m_buffers) {
+    total += buffer->count.load(std::memory_order_acquire);
+  }
+  return total;
+}
+
+std::size_t SamplingProfiler::dropped_samples() const {
+  std::lock_guard lock(registry_mutex);
+  std::size_t total = 0;
+  for (const std::unique_ptr<ThreadBuffer>& buffer : m_buffers) {
+    total += buffer->dropped.load(std::memory_order_relaxed);
+  }
+  return total;
+}
+
+void SamplingProfiler::write_folded(std::ostream& output) const {
+  // Stacks are counted by raw address first so each distinct address is
+  // symbolized once. Return addresses point after the call, so one is
+  // subtracted to land inside the calling function.
+  std::map<std::vector<std::uintptr_t>, std::size_t> stacks;
+  {
+    std::lock_guard lock(registry_mutex);
+    for (const std::unique_ptr<ThreadBuffer>& buffer : m_buffers) {
+      const std::size_t count = buffer->count.load(std::memory_order_acquire);
+      for (std::size_t sample = 0; sample < count; ++sample) {
+        const std::uintptr_t* frames =
+            buffer->frames.data() + sample * buffer->max_depth;
+        std::vector<std::uintptr_t> stack;
+        for (std::size_t frame = buffer->depths[sample]; frame-- > 0;) {
+          stack.push_back(frame == 0 ? frames[frame] : frames[frame] - 1);
+        }
+        ++stacks[stack];
+      }
+    }
+  }
+
+  // Different addresses within one function fold into the same line.
+  std::map<std::uintptr_t, std::string> names;
+  std::map<std::string, std::size_t> lines;
+  for (const auto& [stack, count] : stacks) {
+    std::string line;
+    for (std::uintptr_t address : stack) {
+      auto name = names.find(address);
+      if (name == names.end()) {
+        name = names.emplace(address, symbolize(address)).first;
+      }
+      if (!line.empty()) {
+        line += ';';
+      }
+      line += name->second;
+    }
+    lines[line] += count;
+  }
+
+  for (const auto& [line, count] : lines) {
+    output << line << ' ' << count << '\n';
+  }
+}
+
+SamplingProfiler::ThreadBuffer*
+SamplingProfiler::attach(std::unique_lock<std::mutex>& lock) {
+  std::unique_ptr<ThreadBuffer> spare;
+  while (active_profiler.load(std::memory_order_relaxed) == this) {
+    if (current_buffer != nullptr &&
+        current_generation ==
+            running_generation.load(std::memory_order_relaxed)) {
+      return nullptr;
+    }
+
+    auto detached = std::find_if(
+        m_buffers.begin(), m_buffers.end(),
+        [](const std::unique_ptr<ThreadBuffer>& buffer) {
+          return !buffer->attached;
+        });
+    if (detached != m_buffers.end()) {
+      return attach_locked(detached->get());
+    }
+    // While the lock was released this profiler may have been replaced by
+    // another at the same address, so the spare's sizes are checked again.
+    if (spare != nullptr && spare->capacity == m_options.samples_per_thread &&
+        spare->max_depth == m_options.max_depth) {
+      m_buffers.push_back(std::move(spare));
+      return attach_locked(m_buffers.back().get());
+    }
+
+    const ProfilerOptions options = m_options;
+    lock.unlock();
+    try {
+      spare = std::make_unique<ThreadBuffer>(options.samples_per_thread,
+                                             options.max_depth);
+    } catch (...) {
+      lock.lock();
+      throw;
+    }
+    lock.lock();
+  }
+  return nullptr;
+}
+
+SamplingProfiler::ThreadBuffer*
+SamplingProfiler::attach_locked(ThreadBuffer* buffer) {
+#if defined(__linux__)
+  pthread_attr_t attributes;
+  if (pthread_getattr_np(pthread_self(), &attributes) == 0) {
+    void* stack = nullptr;
+    std::size_t stack_size = 0;
+    if (pthread_attr_getstack(&attributes, &stack, &stack_size) == 0) {
+      buffer->stack_low = reinterpret_cast<std::uintptr_t>(stack);
+      buffer->stack_high = buffer->stack_low + stack_size;
+    }
+    pthread_attr_destroy(&attributes);
+  }
+
+  // The buffer is published before the timer exists, so the first signal
+  // already finds it.
+  current_buffer = buffer;
+  current_generation = running_generation.load(std::memory_order_relaxed);
+
+  sigevent event{};
+  event.sigev_notify = SIGEV_THREAD_ID;
+  event.sigev_signo = SIGPROF;
+  const auto thread_id = static_cast<pid_t>(syscall(SYS_gettid));
+#if defined(sigev_notify_thread_id)
+  event.sigev_notify_thread_id = thread_id;
+#else
+  event._sigev_un._tid = thread_id;
+#endif
+  if (timer_create(CLOCK_THREAD_CPUTIME_ID, &event, &buffer->timer) != 0) {
+    current_buffer = nullptr;
+    throw std::system_error(errno, std::generic_category(), "timer_create");
+  }
+
+  const long interval_ns = 1'000'000'000L / m_options.frequency_hz;
+  itimerspec period{};
+  period.it_interval.tv_sec = interval_ns / 1'000'000'000L;
+  period.it_interval.tv_nsec = interval_ns % 1'000'000'000L;
+  period.it_value = period.it_interval;
+  timer_settime(buffer->timer, 0, &period, nullptr);
+  buffer->attached = true;
+  return buffer;
+#else
+  static_cast<void>(buffer);
+  return nullptr;
+#endif
+}
+
+void SamplingProfiler::detach_locked(ThreadBuffer* buffer) {
+  // The buffer may belong to a profiler that has since been destroyed, so
+  // it is only dereferenced once it is known to be one of ours.
+  bool owned = std::any_of(m_buffers.begin(), m_buffers.end(),
+                           [buffer](const std::unique_ptr<ThreadBuffer>& own) {
+                             return own.get() == buffer;
+                           });
+  if (!owned || !buffer->attached) {
+    return;
+  }
+
+#if defined(__linux__)
+  timer_delete(buffer->timer);
+#endif
+  buffer->attached = false;
+  if (current_buffer == buffer) {
+    current_buffer = nullptr;
+  }
+}
+
+ProfiledThread::ProfiledThread() {
+  if (active_profiler.load(std::memory_order_relaxed) == nullptr) {
+    return;
+  }
+  std::unique_lock lock(registry_mutex);
+  m_profiler = active_profiler.load(std::memory_order_relaxed);
+  if (m_profiler != nullptr) {
+    m_buffer = m_profiler->attach(lock);
+  }
+}
+
+ProfiledThread::ProfiledThread(SamplingProfiler* profiler,
+                               SamplingProfiler::ThreadBuffer* buffer)
+    : m_profiler(profiler), m_buffer(buffer) {}
+
+ProfiledThread::~ProfiledThread() {
+  if (m_buffer == nullptr) {
+    return;
+  }
+  std::lock_guard lock(registry_mutex);
+  // After a restart the buffer may already serve another thread, so it is
+  // only detached while it is still this thread's current one.
+  if (active_profiler.load(std::memory_order_relaxed) == m_profiler &&
+      current_buffer == m_buffer &&
+      current_generation ==
+          running_generation.load(std::memory_order_relaxed)) {
+    m_profiler->detach_locked(m_buffer);
+  }
+  if (current_buffer == m_buffer) {
+    current_buffer = nullptr;
+  }
+}
+
+// Unit tests (embedded in source file)
+// Disabled in production builds via DOCTEST_CONFIG_DISABLE
+#include <doctest/doctest.h>
+
+TEST_CASE("SamplingProfiler - options") {
+  SUBCASE("zero frequency is rejected") {
+    // Arrange
+    ProfilerOptions options;
+    options.frequency_hz = 0;
+
+    // Act & Assert
+    CHECK_THROWS_AS(SamplingProfiler{options}, std::invalid_argument);
+  }
+}
+
+#if defined(__linux__)
+
+namespace {
+
+// Spins for the given wall time so that the thread consumes CPU time.
+void burn_cpu(std::chrono::milliseconds duration) {
+  volatile double sink = 0.0;
+  auto end = std::chrono::steady_clock::now() + duration;
+  while (std::chrono::steady_clock::now() < end) {
+    for (int index = 0; index < 1000; ++index) {
+      sink = sink + index * 0.5;
+    }
+  }
+}
+
+} // namespace
+
+TEST_CASE("SamplingProfiler - sampling") {
+  // Arrange
+  ProfilerOptions options;
+  options.frequency_hz = 1000;
+  SamplingProfiler profiler(options);
+
+  SUBCASE("samples the starting thread into folded stacks") {
+    // Act
+    profiler.start();
+    burn_cpu(std::chrono::milliseconds(100));
+    profiler.stop();
+    std::ostringstream folded;
+    profiler.write_folded(folded);
+
+    // Assert - line counts add up to the samples taken
+    REQUIRE(profiler.sample_count() > 0);
+    std::istringstream lines(folded.str());
+    std::size_t total = 0;
+    for (std::string line; std::getline(lines, line);) {
+      total += std::stoul(line.substr(line.find_last_of(' ') + 1));
+    }
+    CHECK(total == profiler.sample_count());
+  }
+
+  SUBCASE("profiled worker threads are sampled") {
+    // Act
+    profiler.start();
+    std::size_t before = profiler.sample_count();
+    std::jthread worker([] {
+      ProfiledThread profiled;
+      burn_cpu(std::chrono::milliseconds(100));
+    });
+    worker.join();
+    profiler.stop();
+
+    // Assert
+    CHECK(profiler.sample_count() > before);
+  }
+
+  SUBCASE("workers started one after another share one buffer") {
+    // Arrange
+    profiler.start();
+    const std::uint64_t before =
+        memory_snapshot()[MemorySubsystem::Profiler].allocation_count;
+
+    // Act
+    for (int run = 0; run < 4; ++run) {
+      std::jthread worker([] { ProfiledThread profiled; });
+      worker.join();
+    }
+    const std::uint64_t after =
+        memory_snapshot()[MemorySubsystem::Profiler].allocation_count;
+    profiler.stop();
+
+    // Assert - one buffer is two allocations: frames and depths
+    CHECK(after - before == 2);
+  }
+
+  SUBCASE("explicitly attached threads detach with their guard") {
+    // Arrange
+    profiler.start();
+    const std::uint64_t before =
+        memory_snapshot()[MemorySubsystem::Profiler].allocation_count;
+
+    // Act
+    for (int run = 0; run < 4; ++run) {
+      std::jthread worker([&profiler] {
+        ProfiledThread attached = profiler.attach_current_thread();
+        burn_cpu(std::chrono::milliseconds(10));
+      });
+      worker.join();
+    }
+    const std::uint64_t after =
+        memory_snapshot()[MemorySubsystem::Profiler].allocation_count;
+    profiler.stop();
+
+    // Assert - every worker reused the buffer the previous one released
+    CHECK(after - before == 2);
+  }
+
+  SUBCASE("only one profiler runs at a time") {
+    // Arrange
+    SamplingProfiler other(options);
+    profiler.start();
+
+    // Act & Assert
+    CHECK_THROWS_AS(other.start(), std::logic_error);
+  }
+
+  SUBCASE("full buffers count dropped samples") {
+    // Arrange
+    options.samples_per_thread = 1;
+    SamplingProfiler small(options);
+
+    // Act
+    small.start();
+    burn_cpu(std::chrono::milliseconds(50));
+    small.stop();
+
+    // Assert
+    CHECK(small.sample_count() == 1);
+    CHECK(small.dropped_samples() > 0);
+  }
+}
+
+#else
+
+TEST_CASE("SamplingProfiler - sampling") {
+  // Arrange
+  SamplingProfiler profiler;
+
+  // Act & Assert
+  CHECK_THROWS_AS(profiler.start(), std::runtime_error);
+}
+
+#endif
@@ -0,0 +1,512 @@
+// First-party headers
+#include "calculator/spilling_aggregator.h"
+
+// Standard library headers
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <fstream>
+#include <queue>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+namespace {
+
+using Group = std::pair<std::int64_t, int>;
+
+// Run files hold fixed-size records of key then sum, in host byte order;
+// they never outlive the aggregator that wrote them. Records move through
+// blocks of BLOCK_RECORDS so that stream calls stay off the per-group path.
+constexpr std::size_t RECORD_BYTES = sizeof(std::int64_t) + sizeof(int);
+constexpr std::size_t BLOCK_RECORDS = 4096;
+
+// Sequential writer of one sorted run.
+class RunWriter {
+public:
+  explicit RunWriter(std::filesystem::path path)
+      : m_path(std::move(path)),
+        m_file(m_path, std::ios::binary | std::ios::trunc),
+        m_block(BLOCK_RECORDS * RECORD_BYTES) {}
+
+  void write(const Group& group) {
+    if (m_position == m_block.size()) {
+      flush();
+    }
+    std::memcpy(m_block.data() + m_position, &group.first,
+                sizeof(std::int64_t));
+    std::memcpy(m_block.data() + m_position + sizeof(std::int64_t),
+                &group.second, sizeof(int));
+    m_position += RECORD_BYTES;
+    m_bytes += RECORD_BYTES;
+  }
+
+  // Returns the bytes written.
+  std::uint64_t close() {
+    flush();
+    m_file.close();
+    if (!m_file) {
+      throw std::runtime_error("Cannot write spill file " + m_path.string());
+    }
+    return m_bytes;
+  }
+
+private:
+  void flush() {
+    m_file.write(m_block.data(), static_cast<std::streamsize>(m_position));
+    m_position = 0;
+  }
+
+  std::filesystem::path m_path;
+  std::ofstream m_file;
+  std::vector<char> m_block;
+  std::size_t m_position = 0;
+  std::uint64_t m_bytes = 0;
+};
+
+// Sequential reader over one sorted run.
+class RunReader {
+public:
+  explicit RunReader(const std::filesystem::path& path)
+      : m_file(path, std::ios::binary), m_block(BLOCK_RECORDS * RECORD_BYTES) {
+    if (!m_file) {
+      throw std::runtime_error("Cannot open spill file " + path.string());
+    }
+  }
+
+  bool next(Group& group) {
+    if (m_position == m_size) {
+      m_file.read(m_block.data(), static_cast<std::streamsize>(m_block.size()));
+      m_size = static_cast<std::size_t>(m_file.gcount());
+      m_position = 0;
+      if (m_size < RECORD_BYTES) {
+        return false;
+      }
+    }
+    std::memcpy(&group.first, m_block.data() + m_position,
+                sizeof(std::int64_t));
+    std::memcpy(&group.second,
+                m_block.data() + m_position + sizeof(std::int64_t),
+                sizeof(int));
+    m_position += RECORD_BYTES;
+    return true;
+  }
+
+private:
+  std::ifstream m_file;
+  std::vector<char> m_block;
+  std::size_t m_position = 0;
+  std::size_t m_size = 0;
+};
+
+constexpr std::size_t INITIAL_CAPACITY = 16;
+
+// MurmurHash3 finalizer: every key bit reaches both the low bits that pick
+// a slot and the high bits that pick a partition.
+std::uint64_t mix(std::int64_t key) {
+  auto hash = static_cast<std::uint64_t>(key);
+  hash ^= hash >> 33;
+  hash *= 0xff51afd7ed558ccdull;
+  hash ^= hash >> 33;
+  hash *= 0xc4ceb9fe1a85ec53ull;
+  hash ^= hash >> 33;
+  return hash;
+}
+
+// Moves a table's groups to its first slots and sorts them by key, in
+// place, so that a table at the memory budget spills without a second copy
+// of its groups. Heapsort, since the sums must move with their keys. The
+// table is no longer a valid hash table afterwards.
+template <typename Keys, typename Sums, typename Occupied>
+std::size_t sort_groups_in_place(Keys& keys, Sums& sums,
+                                 const Occupied& occupied) {
+  std::size_t count = 0;
+  for (std::size_t slot = 0; slot < keys.size(); ++slot) {
+    if (occupied[slot]) {
+      keys[count] = keys[slot];
+      sums[count] = sums[slot];
+      ++count;
+    }
+  }
+
+  auto swap_groups = [&](std::size_t first, std::size_t second) {
+    std::swap(keys[first], keys[second]);
+    std::swap(sums[first], sums[second]);
+  };
+  auto sift_down = [&](std::size_t root, std::size_t end) {
+    for (std::size_t child = 2 * root + 1; child < end;
+         root = child, child = 2 * root + 1) {
+      if (child + 1 < end && keys[child] < keys[child + 1]) {
+        ++child;
+      }
+      if (!(keys[root] < keys[child])) {
+        return;
+      }
+      swap_groups(root, child);
+    }
+  };
+  for (std::size_t root = count / 2; root-- > 0;) {
+    sift_down(root, count);
+  }
+  for (std::size_t end = count; end > 1; --end) {
+    swap_groups(0, end - 1);
+    sift_down(0, end - 1);
+  }
+  return count;
+}
+
+// Merges sorted sources into one stream, combining the groups of each key
+// with combine. next(source, group) yields a source's next group.
+template <typename Next, typename Combine, typename Sink>
+void merge_sources(std::size_t source_count, Next next, Combine combine,
+                   Sink sink) {
+  using Head = std::pair<Group, std::size_t>;
+  std::priority_queue<Head, std::vector<Head>, std::greater<>> heads;
+  for (std::size_t source = 0; source < source_count; ++source) {
+    if (Group group; next(source, group)) {
+      heads.emplace(group, source);
+    }
+  }
+
+  while (!heads.empty()) {
+    const std::int64_t key = heads.top().first.first;
+    int sum = 0;
+    bool first = true;
+    while (!heads.empty() && heads.top().first.first == key) {
+      auto [group, source] = heads.top();
+      heads.pop();
+      sum = first ? group.second : combine(sum, group.second);
+      first = false;
+      if (next(source, group)) {
+        heads.emplace(group, source);
+      }
+    }
+    sink(Group{key, sum});
+  }
+}
+
+std::filesystem::path create_spill_directory(std::filesystem::path parent) {
+  if (parent.empty()) {
+    parent = std::filesystem::temp_directory_path();
+  }
+  std::filesystem::create_directories(parent);
+  std::random_device random;
+  for (int attempt = 0; attempt < 100; ++attempt) {
+    std::filesystem::path directory =
+        parent / ("calculator-spill-" + std::to_string(random()));
+    if (std::filesystem::create_directory(directory)) {
+      return directory;
+    }
+  }
+  throw std::runtime_error("Cannot create spill directory in " +
+                           parent.string());
+}
+
+} // namespace
+
+SpillingAggregator::SpillingAggregator(AggregationOptions options)
+    : m_options(std::move(options)) {
+  if (m_options.partition_count == 0) {
+    throw std::invalid_argument("Partition count must be positive");
+  }
+  if (m_options.merge_fan_in < 2) {
+    throw std::invalid_argument("Merge fan-in must be at least two");
+  }
+  m_partitions.resize(m_options.partition_count);
+  m_runs.resize(m_options.partition_count);
+  for (Partition& partition : m_partitions) {
+    resize(partition, INITIAL_CAPACITY);
+  }
+}
+
+SpillingAggregator::~SpillingAggregator() { remove_spill_files(); }
+
+void SpillingAggregator::add(std::int64_t key, int value) {
+  const std::uint64_t hash = mix(key);
+  const auto index = static_cast<std::size_t>((hash >> 32) %
+                                              m_partitions.size());
+  Partition& partition = m_partitions[index];
+  const std::size_t mask = partition.keys.size() - 1;
+  auto slot = static_cast<std::size_t>(hash) & mask;
+  for (; partition.occupied[slot]; slot = (slot + 1) & mask) {
+    if (partition.keys[slot] == key) {
+      partition.sums[slot] = m_calculator.add(partition.sums[slot], value);
+      return;
+    }
+  }
+
+  if ((partition.size + 1) * 4 > partition.keys.size() * 3) {
+    make_room(index);
+    add(key, value);
+    return;
+  }
+  partition.keys[slot] = key;
+  partition.sums[slot] = value;
+  partition.occupied[slot] = 1;
+  ++partition.size;
+}
+
+void SpillingAggregator::add(std::span<const std::int64_t> keys,
+                             std::span<const int> values) {
+  if (keys.size() != values.size()) {
+    throw std::invalid_argument("Keys and values differ in length");
+  }
+  for (std::size_t row = 0; row < keys.size(); ++row) {
+    add(keys[row], values[row]);
+  }
+}
+
+void SpillingAggregator::finish(
+    const std::function<void(std::int64_t key, int sum)>& consumer) {
+  for (std::size_t partition = 0; partition < m_partitions.size();
+       ++partition) {
+    merge_partition(partition, consumer);
+  }
+  remove_spill_files();
+}
+
+std::size_t SpillingAggregator::spilled_runs() const { return m_spilled_runs; }
+
+std::uint64_t SpillingAggregator::spilled_bytes() const {
+  return m_spilled_bytes;
+}
+
+void SpillingAggregator::make_room(std::size_t partition) {
+  // A table that cannot double within the budget keeps its size and is
+  // emptied to disk instead, so it refills without reallocating.
+  const std::size_t capacity = m_partitions[partition].keys.size();
+  if (m_table_bytes + capacity * SLOT_BYTES <= m_options.memory_budget) {
+    resize(m_partitions[partition], 2 * capacity);
+  } else {
+    spill(partition);
+  }
+}
+
+void SpillingAggregator::resize(Partition& partition, std::size_t capacity) {
+  Partition resized;
+  resized.keys.resize(capacity);
+  resized.sums.resize(capacity);
+  resized.occupied.resize(capacity);
+  resized.size = partition.size;
+  const std::size_t mask = capacity - 1;
+  for (std::size_t slot = 0; slot < partition.keys.size(); ++slot) {
+    if (!partition.occupied[slot]) {
+      continue;
+    }
+    auto target = static_cast<std::size_t>(mix(partition.keys[slot])) & mask;
+    while (resized.occupied[target]) {
+      target = (target + 1) & mask;
+    }
+    resized.keys[target] = partition.keys[slot];
+    resized.sums[target] = partition.sums[slot];
+    resized.occupied[target] = 1;
+  }
+  m_table_bytes -= partition.keys.size() * SLOT_BYTES;
+  m_table_bytes += capacity * SLOT_BYTES;
+  partition = std::move(resized);
+}
+
+void SpillingAggregator::spill(std::size_t partition) {
+  Partition& table = m_partitions[partition];
+  const std::size_t count =
+      sort_groups_in_place(table.keys, table.sums, table.occupied);
+  std::filesystem::path path = next_run_path();
+  RunWriter writer(path);
+  for (std::size_t slot = 0; slot < count; ++slot) {
+    writer.write({table.keys[slot], table.sums[slot]});
+  }
+  std::fill(table.occupied.begin(), table.occupied.end(), std::uint8_t{0});
+  table.size = 0;
+  add_run(partition, std::move(path), writer.close());
+}
+
+void SpillingAggregator::merge_partition(
+    std::size_t partition,
+    const std::function<void(std::int64_t key, int sum)>& consumer) {
+  auto combine = [this](int sum, int value) {
+    return m_calculator.add(sum, value);
+  };
+
+  // Intermediate passes merge the oldest runs into one until the remaining
+  // runs and the resident groups fit in one final pass.
+  std::vector<std::filesystem::path>& runs = m_runs[partition];
+  while (runs.size() + 1 > m_options.merge_fan_in) {
+    std::vector<std::filesystem::path> inputs(
+        runs.begin(),
+        runs.begin() + static_cast<std::ptrdiff_t>(m_options.merge_fan_in));
+    runs.erase(runs.begin(),
+               runs.begin() + static_cast<std::ptrdiff_t>(inputs.size()));
+    {
+      std::vector<RunReader> readers(inputs.begin(), inputs.end());
+      std::filesystem::path path = next_run_path();
+      RunWriter writer(path);
+      merge_sources(
+          readers.size(),
+          [&](std::size_t source, Group& group) {
+            return readers[source].next(group);
+          },
+          combine, [&](const Group& group) { writer.write(group); });
+      add_run(partition, std::move(path), writer.close());
+    }
+    for (const std::filesystem::path& input : inputs) {
+      std::error_code error;
+      std::filesystem::remove(input, error);
+    }
+  }
+
+  // The groups still in memory are sorted in place into one more source;
+  // the table shrinks back for reuse once the merge has read them.
+  Partition& table = m_partitions[partition];
+  const std::size_t resident =
+      sort_groups_in_place(table.keys, table.sums, table.occupied);
+  std::vector<RunReader> readers(runs.begin(), runs.end());
+
+  // Source readers.size() is the resident groups; the others are runs.
+  const std::size_t resident_source = readers.size();
+  std::size_t resident_position = 0;
+  merge_sources(
+      resident_source + 1,
+      [&](std::size_t source, Group& group) {
+        if (source == resident_source) {
+          if (resident_position == resident) {
+            return false;
+          }
+          group = {table.keys[resident_position],
+                   table.sums[resident_position]};
+          ++resident_position;
+          return true;
+        }
+        return readers[source].next(group);
+      },
+      combine,
+      [&](const Group& group) { consumer(group.first, group.second); });
+
+  std::fill(table.occupied.begin(), table.occupied.end(), std::uint8_t{0});
+  table.size = 0;
+  resize(table, INITIAL_CAPACITY);
+}
+
+std::filesystem::path SpillingAggregator::next_run_path() {
+  if (m_spill_directory.empty()) {
+    m_spill_directory = create_spill_directory(m_options.spill_directory);
+  }
+  return m_spill_directory /
+         ("run-" + std::to_string(m_spilled_runs) + ".bin");
+}
+
+void SpillingAggregator::add_run(std::size_t partition,
+                                 std::filesystem::path path,
+                                 std::uint64_t bytes) {
+  m_runs[partition].push_back(std::move(path));
+  ++m_spilled_runs;
+  m_spilled_bytes += bytes;
+}
+
+void SpillingAggregator::remove_spill_files() {
+  for (auto& runs : m_runs) {
+    runs.clear();
+  }
+  if (!m_spill_directory.empty()) {
+    std::error_code error;
+    std::filesystem::remove_all(m_spill_directory, error);
+    m_spill_directory.clear();
+  }
+}
+
+// Unit tests (embedded in source file)
+// Disabled in production builds via DOCTEST_CONFIG_DISABLE
+#include <doctest/doctest.h>
+
+TEST_CASE("SpillingAggregator - grouped sums") {
+  // Arrange - 30 groups where the budget keeps the first table at 16 slots
+  AggregationOptions options;
+  options.memory_budget = 0;
+  options.partition_count = 1;
+  SpillingAggregator aggregator(options);
+  std::vector<std::int64_t> keys;
+  std::vector<int> values;
+  for (int pass = 0; pass < 2; ++pass) {
+    for (int key = 0; key < 30; ++key) {
+      keys.push_back(key * 7 - 100);
+      values.push_back(key + pass);
+    }
+  }
+
+  SUBCASE("spilled and resident groups merge into one sum per key") {
+    // Act
+    aggregator.add(keys, values);
+    std::vector<Group> groups;
+    aggregator.finish([&](std::int64_t key, int sum) {
+      groups.emplace_back(key, sum);
+    });
+
+    // Assert
+    CHECK(aggregator.spilled_runs() >= 2);
+    REQUIRE(groups.size() == 30);
+    for (int key = 0; key < 30; ++key) {
+      CHECK(groups[key] == Group{key * 7 - 100, 2 * key + 1});
+    }
+  }
+
+  SUBCASE("a small fan-in merges the runs in several passes") {
+    // Arrange
+    options.merge_fan_in = 2;
+    SpillingAggregator narrow(options);
+    narrow.add(keys, values);
+    const std::size_t spilled = narrow.spilled_runs();
+
+    // Act
+    std::vector<Group> groups;
+    narrow.finish([&](std::int64_t key, int sum) {
+      groups.emplace_back(key, sum);
+    });
+
+    // Assert - each pass merges two runs into a new one
+    REQUIRE(spilled >= 2);
+    CHECK(narrow.spilled_runs() == 2 * spilled - 1);
+    REQUIRE(groups.size() == 30);
+    for (int key = 0; key < 30; ++key) {
+      CHECK(groups[key] == Group{key * 7 - 100, 2 * key + 1});
+    }
+  }
+
+  SUBCASE("finish removes the run files and resets the groups") {
+    // Arrange
+    aggregator.add(keys, values);
+    std::size_t first_pass = 0;
+    aggregator.finish([&](std::int64_t, int) { ++first_pass; });
+
+    // Act
+    aggregator.add(1, 10);
+    aggregator.add(1, -4);
+    std::vector<Group> groups;
+    aggregator.finish([&](std::int64_t key, int sum) {
+      groups.emplace_back(key, sum);
+    });
+
+    // Assert
+    CHECK(first_pass == 30);
+    CHECK(groups == std::vector<Group>{{1, 6}});
+  }
+
+  SUBCASE("keys and values must pair up") {
+    // Act & Assert
+    std::vector<int> short_values = {1};
+    CHECK_THROWS_AS(aggregator.add(keys, short_values), std::invalid_argument);
+  }
+}
+
+TEST_CASE("SpillingAggregator - options") {
+  // Arrange
+  AggregationOptions no_partitions;
+  no_partitions.partition_count = 0;
+  AggregationOptions no_fan_in;
+  no_fan_in.merge_fan_in = 1;
+
+  // Act & Assert
+  CHECK_THROWS_AS(SpillingAggregator{no_partitions}, std::invalid_argument);
+  CHECK_THROWS_AS(SpillingAggregator{no_fan_in}, std::invalid_argument);
+}
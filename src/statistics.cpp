@@ -0,0 +1,394 @@
+// First-party headers
+#include "calculator/statistics.h"
+
+// Standard library headers
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <stdexcept>
+
+namespace {
+
+// Values per block: small enough to stay in L1 between the two passes.
+constexpr std::size_t BLOCK_SIZE = 512;
+// Independent accumulators per pass, enough to fill a vector register and
+// hide the latency of dependent additions.
+constexpr std::size_t LANES = 8;
+
+using Lanes = std::array<double, LANES>;
+
+double fold(const Lanes& lanes) {
+  double total = 0.0;
+  for (double lane : lanes) {
+    total += lane;
+  }
+  return total;
+}
+
+template <typename T> double block_sum(const T* values, std::size_t count) {
+  Lanes sums{};
+  std::size_t index = 0;
+  for (; index + LANES <= count; index += LANES) {
+    for (std::size_t lane = 0; lane < LANES; ++lane) {
+      sums[lane] += static_cast<double>(values[index + lane]);
+    }
+  }
+  double total = fold(sums);
+  for (; index < count; ++index) {
+    total += static_cast<double>(values[index]);
+  }
+  return total;
+}
+
+} // namespace
+
+void RunningStatistics::add(double value) { merge(summarize(&value, 1)); }
+
+void RunningStatistics::add(std::span<const double> values) {
+  add_blocks(values);
+}
+
+void RunningStatistics::add(std::span<const int> values) {
+  add_blocks(values);
+}
+
+void RunningStatistics::merge(const RunningStatistics& other) {
+  if (other.m_count == 0) {
+    return;
+  }
+  if (m_count == 0) {
+    *this = other;
+    return;
+  }
+  const auto na = static_cast<double>(m_count);
+  const auto nb = static_cast<double>(other.m_count);
+  const double delta = other.m_mean - m_mean;
+  const double delta_n = delta / (na + nb);
+  const double delta_n2 = delta_n * delta_n;
+
+  const double m2 = m_m2 + other.m_m2 + delta * delta_n * na * nb;
+  const double m3 = m_m3 + other.m_m3 +
+                    delta * delta_n2 * na * nb * (na - nb) +
+                    3.0 * delta_n * (na * other.m_m2 - nb * m_m2);
+  const double m4 = m_m4 + other.m_m4 +
+                    delta * delta_n * delta_n2 * na * nb *
+                        (na * na - na * nb + nb * nb) +
+                    6.0 * delta_n2 * (na * na * other.m_m2 + nb * nb * m_m2) +
+                    4.0 * delta_n * (na * other.m_m3 - nb * m_m3);
+
+  m_count += other.m_count;
+  m_mean += delta_n * nb;
+  m_m2 = m2;
+  m_m3 = m3;
+  m_m4 = m4;
+}
+
+std::uint64_t RunningStatistics::count() const { return m_count; }
+
+double RunningStatistics::mean() const {
+  if (m_count == 0) {
+    throw std::invalid_argument("Mean of no values");
+  }
+  return m_mean;
+}
+
+double RunningStatistics::variance() const {
+  if (m_count < 2) {
+    throw std::invalid_argument("Variance needs at least two values");
+  }
+  return m_m2 / static_cast<double>(m_count - 1);
+}
+
+double RunningStatistics::standard_deviation() const {
+  return std::sqrt(variance());
+}
+
+double RunningStatistics::skewness() const {
+  if (m_count == 0 || m_m2 == 0.0) {
+    throw std::invalid_argument("Skewness of constant data");
+  }
+  const auto n = static_cast<double>(m_count);
+  return std::sqrt(n) * m_m3 / std::pow(m_m2, 1.5);
+}
+
+double RunningStatistics::kurtosis() const {
+  if (m_count == 0 || m_m2 == 0.0) {
+    throw std::invalid_argument("Kurtosis of constant data");
+  }
+  const auto n = static_cast<double>(m_count);
+  return n * m_m4 / (m_m2 * m_m2) - 3.0;
+}
+
+template <typename T>
+RunningStatistics RunningStatistics::summarize(const T* values,
+                                               std::size_t count) {
+  const auto n = static_cast<double>(count);
+  const double mean = block_sum(values, count) / n;
+
+  Lanes s1{};
+  Lanes s2{};
+  Lanes s3{};
+  Lanes s4{};
+  auto accumulate = [&](std::size_t lane, double value) {
+    const double d = value - mean;
+    const double d2 = d * d;
+    s1[lane] += d;
+    s2[lane] += d2;
+    s3[lane] += d2 * d;
+    s4[lane] += d2 * d2;
+  };
+  std::size_t index = 0;
+  for (; index + LANES <= count; index += LANES) {
+    for (std::size_t lane = 0; lane < LANES; ++lane) {
+      accumulate(lane, static_cast<double>(values[index + lane]));
+    }
+  }
+  for (std::size_t lane = 0; index < count; ++index, ++lane) {
+    accumulate(lane, static_cast<double>(values[index]));
+  }
+
+  // The deviations sum to zero up to the rounding of the first pass; shift
+  // the moments to the corrected mean.
+  const double sum1 = fold(s1);
+  const double sum2 = fold(s2);
+  const double sum3 = fold(s3);
+  const double sum4 = fold(s4);
+  const double c = sum1 / n;
+  RunningStatistics block;
+  block.m_count = count;
+  block.m_mean = mean + c;
+  block.m_m2 = sum2 - sum1 * c;
+  block.m_m3 = sum3 - 3.0 * c * sum2 + 3.0 * c * c * sum1 - n * c * c * c;
+  block.m_m4 = sum4 - 4.0 * c * sum3 + 6.0 * c * c * sum2 -
+               4.0 * c * c * c * sum1 + n * c * c * c * c;
+  return block;
+}
+
+template <typename T>
+void RunningStatistics::add_blocks(std::span<const T> values) {
+  for (std::size_t offset = 0; offset < values.size(); offset += BLOCK_SIZE) {
+    const std::size_t count = std::min(BLOCK_SIZE, values.size() - offset);
+    merge(summarize(values.data() + offset, count));
+  }
+}
+
+void RunningCovariance::add(double x, double y) {
+  merge(summarize(&x, &y, 1));
+}
+
+void RunningCovariance::add(std::span<const double> xs,
+                            std::span<const double> ys) {
+  if (xs.size() != ys.size()) {
+    throw std::invalid_argument("Paired spans differ in length");
+  }
+  for (std::size_t offset = 0; offset < xs.size(); offset += BLOCK_SIZE) {
+    const std::size_t count = std::min(BLOCK_SIZE, xs.size() - offset);
+    merge(summarize(xs.data() + offset, ys.data() + offset, count));
+  }
+}
+
+void RunningCovariance::merge(const RunningCovariance& other) {
+  if (other.m_count == 0) {
+    return;
+  }
+  if (m_count == 0) {
+    *this = other;
+    return;
+  }
+  const auto na = static_cast<double>(m_count);
+  const auto nb = static_cast<double>(other.m_count);
+  const double weight = na * nb / (na + nb);
+  const double delta_x = other.m_mean_x - m_mean_x;
+  const double delta_y = other.m_mean_y - m_mean_y;
+
+  m_count += other.m_count;
+  m_mean_x += delta_x * nb / (na + nb);
+  m_mean_y += delta_y * nb / (na + nb);
+  m_m2_x += other.m_m2_x + delta_x * delta_x * weight;
+  m_m2_y += other.m_m2_y + delta_y * delta_y * weight;
+  m_c_xy += other.m_c_xy + delta_x * delta_y * weight;
+}
+
+std::uint64_t RunningCovariance::count() const { return m_count; }
+
+double RunningCovariance::covariance() const {
+  if (m_count < 2) {
+    throw std::invalid_argument("Covariance needs at least two pairs");
+  }
+  return m_c_xy / static_cast<double>(m_count - 1);
+}
+
+double RunningCovariance::correlation() const {
+  if (m_m2_x == 0.0 || m_m2_y == 0.0) {
+    throw std::invalid_argument("Correlation of constant data");
+  }
+  // Rounding can push a perfect correlation just past one.
+  return std::clamp(m_c_xy / std::sqrt(m_m2_x * m_m2_y), -1.0, 1.0);
+}
+
+RunningCovariance RunningCovariance::summarize(const double* xs,
+                                               const double* ys,
+                                               std::size_t count) {
+  const auto n = static_cast<double>(count);
+  const double mean_x = block_sum(xs, count) / n;
+  const double mean_y = block_sum(ys, count) / n;
+
+  Lanes sx{};
+  Lanes sy{};
+  Lanes sxx{};
+  Lanes syy{};
+  Lanes sxy{};
+  auto accumulate = [&](std::size_t lane, std::size_t index) {
+    const double dx = xs[index] - mean_x;
+    const double dy = ys[index] - mean_y;
+    sx[lane] += dx;
+    sy[lane] += dy;
+    sxx[lane] += dx * dx;
+    syy[lane] += dy * dy;
+    sxy[lane] += dx * dy;
+  };
+  std::size_t index = 0;
+  for (; index + LANES <= count; index += LANES) {
+    for (std::size_t lane = 0; lane < LANES; ++lane) {
+      accumulate(lane, index + lane);
+    }
+  }
+  for (std::size_t lane = 0; index < count; ++index, ++lane) {
+    accumulate(lane, index);
+  }
+
+  const double sum_x = fold(sx);
+  const double sum_y = fold(sy);
+  RunningCovariance block;
+  block.m_count = count;
+  block.m_mean_x = mean_x + sum_x / n;
+  block.m_mean_y = mean_y + sum_y / n;
+  block.m_m2_x = fold(sxx) - sum_x * sum_x / n;
+  block.m_m2_y = fold(syy) - sum_y * sum_y / n;
+  block.m_c_xy = fold(sxy) - sum_x * sum_y / n;
+  return block;
+}
+
+// Unit tests (embedded in source file)
+// Disabled in production builds via DOCTEST_CONFIG_DISABLE
+#include <doctest/doctest.h>
+
+// Standard library headers
+#include <vector>
+
+TEST_CASE("RunningStatistics - moments") {
+  // Arrange - a large mean defeats the naive sum-of-squares formula
+  std::vector<double> values = {1e9 + 4, 1e9 + 7, 1e9 + 13, 1e9 + 16};
+  RunningStatistics statistics;
+
+  SUBCASE("spans match the exact moments") {
+    // Act
+    statistics.add(values);
+
+    // Assert
+    CHECK(statistics.count() == 4);
+    CHECK(statistics.mean() == doctest::Approx(1e9 + 10));
+    CHECK(statistics.variance() == doctest::Approx(30.0));
+    CHECK(statistics.skewness() == doctest::Approx(0.0));
+    CHECK(statistics.kurtosis() == doctest::Approx(-1.64));
+  }
+
+  SUBCASE("single values, blocks and merges agree") {
+    // Arrange - spans several blocks with a partial last block
+    std::vector<double> skewed(2000);
+    for (std::size_t index = 0; index < skewed.size(); ++index) {
+      skewed[index] = std::exp(static_cast<double>(index % 97) / 20.0);
+    }
+    RunningStatistics one_by_one;
+    RunningStatistics first;
+    RunningStatistics second;
+
+    // Act
+    statistics.add(skewed);
+    for (double value : skewed) {
+      one_by_one.add(value);
+    }
+    first.add(std::span<const double>(skewed).first(700));
+    second.add(std::span<const double>(skewed).subspan(700));
+    first.merge(second);
+
+    // Assert
+    for (const RunningStatistics* other : {&one_by_one, &first}) {
+      CHECK(other->count() == statistics.count());
+      CHECK(other->mean() == doctest::Approx(statistics.mean()));
+      CHECK(other->variance() == doctest::Approx(statistics.variance()));
+      CHECK(other->skewness() == doctest::Approx(statistics.skewness()));
+      CHECK(other->kurtosis() == doctest::Approx(statistics.kurtosis()));
+    }
+  }
+
+  SUBCASE("ints are summarized like doubles") {
+    // Arrange
+    std::vector<int> ints = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11};
+
+    // Act
+    statistics.add(ints);
+
+    // Assert
+    CHECK(statistics.mean() == doctest::Approx(6.0));
+    CHECK(statistics.variance() == doctest::Approx(11.0));
+    CHECK(statistics.standard_deviation() == doctest::Approx(std::sqrt(11)));
+  }
+
+  SUBCASE("undefined statistics throw") {
+    // Act & Assert
+    CHECK_THROWS_AS(statistics.mean(), std::invalid_argument);
+    statistics.add(5.0);
+    CHECK(statistics.mean() == 5.0);
+    CHECK_THROWS_AS(statistics.variance(), std::invalid_argument);
+    statistics.add(5.0);
+    CHECK(statistics.variance() == 0.0);
+    CHECK_THROWS_AS(statistics.skewness(), std::invalid_argument);
+  }
+}
+
+TEST_CASE("RunningCovariance - covariance and correlation") {
+  // Arrange
+  std::vector<double> xs(1000);
+  std::vector<double> ys(xs.size());
+  for (std::size_t index = 0; index < xs.size(); ++index) {
+    xs[index] = 1e8 + static_cast<double>(index);
+    ys[index] = -3.0 * static_cast<double>(index) + 7.0;
+  }
+  RunningCovariance covariance;
+
+  SUBCASE("perfectly anti-correlated data") {
+    // Act
+    covariance.add(xs, ys);
+
+    // Assert - var(index) of 0..999 is 1000 * 1001 / 12
+    CHECK(covariance.count() == 1000);
+    CHECK(covariance.covariance() == doctest::Approx(-3.0 * 1000 * 1001 / 12));
+    CHECK(covariance.correlation() == doctest::Approx(-1.0));
+  }
+
+  SUBCASE("merged partial states agree") {
+    // Arrange
+    RunningCovariance other;
+    covariance.add(std::span<const double>(xs).first(10),
+                   std::span<const double>(ys).first(10));
+    other.add(std::span<const double>(xs).subspan(10),
+              std::span<const double>(ys).subspan(10));
+
+    // Act
+    covariance.merge(other);
+
+    // Assert
+    CHECK(covariance.covariance() == doctest::Approx(-3.0 * 1000 * 1001 / 12));
+  }
+
+  SUBCASE("invalid input throws") {
+    // Act & Assert
+    CHECK_THROWS_AS(covariance.add(xs, std::span<const double>(ys).first(1)),
+                    std::invalid_argument);
+    CHECK_THROWS_AS(covariance.covariance(), std::invalid_argument);
+    covariance.add(1.0, 2.0);
+    covariance.add(1.0, 3.0);
+    CHECK_THROWS_AS(covariance.correlation(), std::invalid_argument);
+  }
+}
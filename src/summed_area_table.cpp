@@ -0,0 +1,180 @@
+// First-party headers
+#include "calculator/summed_area_table.h"
+#include "parallel_for.h"
+
+// Standard library headers
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+// Table entries per cache line; column strips start on these boundaries so
+// that threads never write to the same line.
+constexpr std::size_t LINE_ENTRIES = 64 / sizeof(std::int64_t);
+
+} // namespace
+
+SummedAreaTable::SummedAreaTable(std::span<const int> values,
+                                 std::size_t rows, std::size_t columns,
+                                 unsigned thread_count)
+    : m_rows(rows), m_columns(columns) {
+  if (values.size() != rows * columns) {
+    throw std::invalid_argument("Grid size does not match values");
+  }
+  if (thread_count == 0) {
+    throw std::invalid_argument("Thread count must be positive");
+  }
+
+  const std::size_t width = columns + 1;
+  m_table.reset(new std::int64_t[(rows + 1) * width]);
+  std::int64_t* table = m_table.get();
+  std::fill_n(table, width, std::int64_t{0});
+
+  // First pass: independent prefix sums along each row.
+  parallel_for(rows, thread_count, [&](std::size_t first, std::size_t last) {
+    for (std::size_t row = first; row < last; ++row) {
+      const int* cells = values.data() + row * columns;
+      std::int64_t* entries = table + (row + 1) * width;
+      std::int64_t running = 0;
+      entries[0] = 0;
+      for (std::size_t column = 0; column < columns; ++column) {
+        running += cells[column];
+        entries[column + 1] = running;
+      }
+    }
+  });
+
+  // Second pass: add each row to the one below, strip by strip. The inner
+  // loop is a contiguous vector add.
+  const std::size_t strips = (width + LINE_ENTRIES - 1) / LINE_ENTRIES;
+  parallel_for(strips, thread_count, [&](std::size_t first, std::size_t last) {
+    const std::size_t begin = first * LINE_ENTRIES;
+    const std::size_t end = std::min(last * LINE_ENTRIES, width);
+    for (std::size_t row = 2; row <= rows; ++row) {
+      const std::int64_t* above = table + (row - 1) * width;
+      std::int64_t* entries = table + row * width;
+      for (std::size_t column = begin; column < end; ++column) {
+        entries[column] += above[column];
+      }
+    }
+  });
+}
+
+std::size_t SummedAreaTable::rows() const { return m_rows; }
+
+std::size_t SummedAreaTable::columns() const { return m_columns; }
+
+std::int64_t SummedAreaTable::sum(const GridRectangle& rectangle) const {
+  validate(rectangle);
+  return lookup(rectangle);
+}
+
+void SummedAreaTable::sum(std::span<const GridRectangle> rectangles,
+                          std::span<std::int64_t> results) const {
+  if (results.size() < rectangles.size()) {
+    throw std::invalid_argument("Missing result values");
+  }
+  for (const GridRectangle& rectangle : rectangles) {
+    validate(rectangle);
+  }
+  // Validated up front, so the loop is four independent loads per
+  // rectangle with nothing to stop the next rectangle's loads from issuing.
+  for (std::size_t index = 0; index < rectangles.size(); ++index) {
+    results[index] = lookup(rectangles[index]);
+  }
+}
+
+void SummedAreaTable::validate(const GridRectangle& rectangle) const {
+  if (rectangle.first_row > rectangle.last_row ||
+      rectangle.first_column > rectangle.last_column ||
+      rectangle.last_row > m_rows || rectangle.last_column > m_columns) {
+    throw std::out_of_range("Rectangle exceeds grid");
+  }
+}
+
+std::int64_t SummedAreaTable::lookup(const GridRectangle& rectangle) const {
+  const std::size_t width = m_columns + 1;
+  const std::int64_t* top = m_table.get() + rectangle.first_row * width;
+  const std::int64_t* bottom = m_table.get() + rectangle.last_row * width;
+  return bottom[rectangle.last_column] - bottom[rectangle.first_column] -
+         top[rectangle.last_column] + top[rectangle.first_column];
+}
+
+// Unit tests (embedded in source file)
+// Disabled in production builds via DOCTEST_CONFIG_DISABLE
+#include <doctest/doctest.h>
+
+TEST_CASE("SummedAreaTable - rectangle sums") {
+  // Arrange - 37 x 53 cells of mixed sign, built serially and on 3 threads
+  const std::size_t rows = 37;
+  const std::size_t columns = 53;
+  std::vector<int> values(rows * columns);
+  for (std::size_t cell = 0; cell < values.size(); ++cell) {
+    values[cell] = static_cast<int>(cell % 11) - 5;
+  }
+  auto naive_sum = [&](const GridRectangle& rectangle) {
+    std::int64_t sum = 0;
+    for (std::size_t row = rectangle.first_row; row < rectangle.last_row;
+         ++row) {
+      for (std::size_t column = rectangle.first_column;
+           column < rectangle.last_column; ++column) {
+        sum += values[row * columns + column];
+      }
+    }
+    return sum;
+  };
+  std::vector<GridRectangle> rectangles = {
+      {0, 0, rows, columns}, {0, 0, 1, 1},     {5, 7, 6, 8},
+      {3, 4, 30, 50},        {36, 52, 37, 53}, {10, 10, 10, 20}};
+
+  SUBCASE("sums match nested loops for any thread count") {
+    for (unsigned threads : {1u, 3u}) {
+      // Act
+      SummedAreaTable table(values, rows, columns, threads);
+
+      // Assert
+      for (const GridRectangle& rectangle : rectangles) {
+        CHECK(table.sum(rectangle) == naive_sum(rectangle));
+      }
+    }
+  }
+
+  SUBCASE("batched queries answer every rectangle") {
+    // Arrange
+    SummedAreaTable table(values, rows, columns);
+    std::vector<std::int64_t> sums(rectangles.size());
+
+    // Act
+    table.sum(rectangles, sums);
+
+    // Assert
+    for (std::size_t index = 0; index < rectangles.size(); ++index) {
+      CHECK(sums[index] == naive_sum(rectangles[index]));
+    }
+  }
+
+  SUBCASE("sums wider than int do not overflow") {
+    // Arrange
+    std::vector<int> large(4 * 4, 1 << 30);
+
+    // Act
+    SummedAreaTable table(large, 4, 4);
+
+    // Assert
+    CHECK(table.sum({0, 0, 4, 4}) == std::int64_t{16} << 30);
+  }
+
+  SUBCASE("invalid input throws") {
+    // Arrange
+    SummedAreaTable table(values, rows, columns);
+
+    // Act & Assert
+    CHECK_THROWS_AS(SummedAreaTable(values, rows, columns + 1),
+                    std::invalid_argument);
+    CHECK_THROWS_AS(SummedAreaTable(values, rows, columns, 0),
+                    std::invalid_argument);
+    CHECK_THROWS_AS(table.sum({0, 0, rows + 1, 1}), std::out_of_range);
+    CHECK_THROWS_AS(table.sum({2, 0, 1, 1}), std::out_of_range);
+  }
+}
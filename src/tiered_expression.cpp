@@ -0,0 +1,177 @@
+// First-party headers
+#include "calculator/tiered_expression.h"
+
+// Standard library headers
+#include <utility>
+#include <vector>
+
+TieredExpression::TieredExpression(Expression expression, TierPolicy policy)
+    : m_expression(std::move(expression)), m_policy(policy) {
+  if (m_policy.hot_threshold == 0) {
+    promote();
+  }
+}
+
+double TieredExpression::evaluate(std::span<const double> inputs) {
+  if (const CompiledExpression* optimized =
+          m_optimized.load(std::memory_order_acquire)) {
+    return optimized->evaluate(inputs);
+  }
+
+  record_invocations(1);
+  return m_expression.evaluate(inputs,
+                               m_policy.compile_options.check_overflow);
+}
+
+void TieredExpression::evaluate(
+    std::span<const std::span<const double>> columns,
+    std::span<double> results) {
+  if (const CompiledExpression* optimized =
+          m_optimized.load(std::memory_order_acquire)) {
+    optimized->evaluate(columns, results);
+    return;
+  }
+
+  record_invocations(results.size());
+  m_expression.evaluate(columns, results,
+                        m_policy.compile_options.check_overflow);
+}
+
+std::uint64_t TieredExpression::invocation_count() const {
+  return m_invocation_count.load(std::memory_order_relaxed);
+}
+
+bool TieredExpression::is_optimized() const {
+  return m_optimized.load(std::memory_order_acquire) != nullptr;
+}
+
+void TieredExpression::wait_for_promotion() {
+  std::lock_guard lock(m_promotion_mutex);
+  if (m_promotion_thread.joinable()) {
+    m_promotion_thread.join();
+  }
+}
+
+void TieredExpression::record_invocations(std::uint64_t count) {
+  // Exactly one caller observes the counter crossing the threshold, so the
+  // promotion is started once without further synchronization.
+  std::uint64_t previous =
+      m_invocation_count.fetch_add(count, std::memory_order_relaxed);
+  if (previous >= m_policy.hot_threshold ||
+      previous + count < m_policy.hot_threshold) {
+    return;
+  }
+
+  if (!m_policy.background_promotion) {
+    promote();
+    return;
+  }
+
+  std::lock_guard lock(m_promotion_mutex);
+  m_promotion_thread = std::jthread([this] { promote(); });
+}
+
+void TieredExpression::promote() {
+  m_compiled = std::make_unique<CompiledExpression>(
+      m_expression, m_policy.compile_options);
+  m_optimized.store(m_compiled.get(), std::memory_order_release);
+}
+
+// Unit tests (embedded in source file)
+// Disabled in production builds via DOCTEST_CONFIG_DISABLE
+#include <doctest/doctest.h>
+
+// Standard library headers
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
+TEST_CASE("TieredExpression - promotion") {
+  Expression expression;
+  expression.add(expression.input(0), expression.constant(1.0));
+  std::vector<double> inputs = {2.0};
+  TierPolicy synchronous;
+  synchronous.hot_threshold = 3;
+  synchronous.background_promotion = false;
+
+  SUBCASE("stays interpreted below the hot threshold") {
+    // Arrange
+    TieredExpression tiered(expression, synchronous);
+
+    // Act
+    tiered.evaluate(inputs);
+    tiered.evaluate(inputs);
+
+    // Assert
+    CHECK(tiered.invocation_count() == 2);
+    CHECK_FALSE(tiered.is_optimized());
+  }
+
+  SUBCASE("promotes synchronously when the threshold is crossed") {
+    // Arrange
+    TieredExpression tiered(expression, synchronous);
+
+    // Act
+    for (int call = 0; call < 3; ++call) {
+      tiered.evaluate(inputs);
+    }
+
+    // Assert
+    CHECK(tiered.is_optimized());
+    CHECK(tiered.evaluate(inputs) == doctest::Approx(3.0));
+    CHECK(tiered.invocation_count() == 3);
+  }
+
+  SUBCASE("zero threshold compiles on construction") {
+    // Arrange
+    TierPolicy eager;
+    eager.hot_threshold = 0;
+
+    // Act
+    TieredExpression tiered(expression, eager);
+
+    // Assert
+    CHECK(tiered.is_optimized());
+  }
+}
+
+TEST_CASE("TieredExpression - promotion does not change results") {
+  // Arrange - (a * b) / (c + 1) with bounds that some rows leave
+  Expression expression;
+  NodeId product =
+      expression.multiply(expression.input(0), expression.input(1));
+  expression.divide(product,
+                    expression.add(expression.input(2),
+                                   expression.constant(1.0)));
+  TierPolicy interpreted;
+  interpreted.hot_threshold = UINT64_MAX;
+  interpreted.compile_options.check_overflow = true;
+  interpreted.compile_options.input_bounds = {
+      {-1000.0, 1000.0}, {0.0, 1000.0}, {0.0, 50.0}};
+  TierPolicy compiled = interpreted;
+  compiled.hot_threshold = 0;
+  TieredExpression slow(expression, interpreted);
+  TieredExpression fast(expression, compiled);
+  const std::vector<std::vector<double>> rows = {
+      {10.0, 6.0, 3.0}, {1.0, 1.0, -1.0}, {1e6, 1e6, 1.0}, {5.0, 2.0, 99.0}};
+
+  // Each row's result, or the kind of error it throws.
+  auto outcome = [](TieredExpression& tiered, std::span<const double> row) {
+    try {
+      return std::to_string(tiered.evaluate(row));
+    } catch (const std::overflow_error&) {
+      return std::string("overflow");
+    } catch (const std::invalid_argument&) {
+      return std::string("division by zero");
+    }
+  };
+
+  // Act & Assert
+  REQUIRE(fast.is_optimized());
+  REQUIRE_FALSE(slow.is_optimized());
+  for (const std::vector<double>& row : rows) {
+    CHECK(outcome(slow, row) == outcome(fast, row));
+  }
+  CHECK(outcome(fast, rows[1]) == "division by zero");
+  CHECK(outcome(fast, rows[2]) == "overflow");
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+// Standard library headers
+#include <cstdint>
+
+// Two's-complement 128-bit sum of int64 values, high * 2^64 + low, for
+// compilers without a 128-bit integer type.
+class WideSum {
+public:
+  void add(std::int64_t value) {
+    const std::uint64_t sum = m_low + static_cast<std::uint64_t>(value);
+    m_high += static_cast<std::int64_t>(sum < m_low) -
+              static_cast<std::int64_t>(value < 0);
+    m_low = sum;
+  }
+
+  // Adds value * 2^32.
+  void add_shifted(std::int64_t value) {
+    const std::uint64_t low = static_cast<std::uint64_t>(value) << 32;
+    const std::uint64_t sum = m_low + low;
+    m_high += static_cast<std::int64_t>(sum < m_low) + (value >> 32);
+    m_low = sum;
+  }
+
+  bool fits() const {
+    constexpr auto sign_bit = std::uint64_t{1} << 63;
+    return m_high == (m_low >= sign_bit ? -1 : 0);
+  }
+
+  std::int64_t value() const { return static_cast<std::int64_t>(m_low); }
+
+private:
+  std::uint64_t m_low = 0;
+  std::int64_t m_high = 0;
+};
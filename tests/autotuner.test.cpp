@@ -0,0 +1,75 @@
+// First-party headers
+#include "calculator/autotuner.h"
+#include "calculator/compiled_program.h"
+#include "calculator/expression.h"
+
+// Third-party headers
+#include <doctest/doctest.h>
+
+// Standard library headers
+#include <filesystem>
+#include <random>
+#include <span>
+#include <string>
+#include <vector>
+
+// Functional tests for autotuned parallel evaluation
+
+TEST_CASE("Autotuner - functional test for persisted tuning") {
+  // Arrange
+  std::filesystem::path path =
+      std::filesystem::temp_directory_path() /
+      ("calculator-autotuner-functional-" +
+       std::to_string(std::random_device{}())) /
+      "tuning.txt";
+
+  SUBCASE("a new instance reuses the saved profile") {
+    // Arrange
+    TuningConfig tuned = Autotuner(path).config_for(5000);
+
+    // Act
+    Autotuner reloaded(path);
+
+    // Assert
+    CHECK(std::filesystem::exists(path));
+    CHECK(reloaded.tuned_size_classes() == 1);
+    CHECK(reloaded.config_for(5000).tile_rows == tuned.tile_rows);
+    CHECK(reloaded.config_for(5000).thread_count == tuned.thread_count);
+  }
+
+  SUBCASE("tuned parallel evaluation matches serial evaluation") {
+    // Arrange - (a + b) * c and a - c
+    Expression product;
+    product.multiply(product.add(product.input(0), product.input(1)),
+                     product.input(2));
+    Expression difference;
+    difference.subtract(difference.input(0), difference.input(2));
+    std::vector<Expression> expressions = {product, difference};
+    CompiledProgram program(expressions);
+    std::vector<std::vector<double>> inputs(3, std::vector<double>(20000));
+    for (std::size_t row = 0; row < 20000; ++row) {
+      inputs[0][row] = static_cast<double>(row);
+      inputs[1][row] = 1.5;
+      inputs[2][row] = static_cast<double>(row % 7);
+    }
+    std::vector<std::span<const double>> columns(inputs.begin(),
+                                                 inputs.end());
+    std::vector<std::vector<double>> serial(2, std::vector<double>(20000));
+    std::vector<std::vector<double>> parallel(2, std::vector<double>(20000));
+    std::vector<std::span<double>> serial_outputs(serial.begin(),
+                                                  serial.end());
+    std::vector<std::span<double>> parallel_outputs(parallel.begin(),
+                                                    parallel.end());
+    Autotuner autotuner(path);
+
+    // Act
+    program.evaluate(columns, serial_outputs);
+    evaluate_parallel(program, columns, parallel_outputs,
+                      autotuner.config_for(20000));
+
+    // Assert
+    CHECK(parallel == serial);
+  }
+
+  std::filesystem::remove_all(path.parent_path());
+}
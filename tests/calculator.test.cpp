@@ -1,10 +1,15 @@
 // First-party headers
 #include "calculator/calculator.h"
+#include "calculator/calculator_backend.h"
 
 // Third-party headers
 #include <doctest/doctest.h>
 #include <doctest/trompeloeil.hpp>
 
+// Standard library headers
+#include <memory>
+#include <vector>
+
 // Functional/Integration tests for public API
 
 TEST_CASE("Calculator - functional test for basic arithmetic workflow") {
@@ -127,19 +132,51 @@ TEST_CASE("Calculator - functional test for precision") {
   }
 }
 
-// Service interface for dependency injection and mocking
-class ICalculator {
-public:
-  virtual ~ICalculator() = default;
-  virtual int add(int first_value, int second_value) = 0;
-  virtual int subtract(int first_value, int second_value) = 0;
-};
+TEST_CASE("Calculator - functional test for ratio normalization") {
+  Calculator calculator;
+
+  SUBCASE("reducing ratios to lowest terms") {
+    // Arrange
+    std::vector<int> numerators = {6, -40, 0, 21, 1000000};
+    std::vector<int> denominators = {8, 100, 5, 7, -2500};
+    std::vector<int> divisors(numerators.size());
+
+    // Act - Divide both sides by their greatest common divisor
+    calculator.gcd(numerators, denominators, divisors);
+
+    // Assert
+    std::vector<int> reduced_numerators = {3, -2, 0, 3, 400};
+    std::vector<int> reduced_denominators = {4, 5, 1, 1, -1};
+    for (std::size_t index = 0; index < numerators.size(); ++index) {
+      CHECK(numerators[index] / divisors[index] ==
+            reduced_numerators[index]);
+      CHECK(denominators[index] / divisors[index] ==
+            reduced_denominators[index]);
+    }
+  }
+
+  SUBCASE("common denominator of several ratios") {
+    // Arrange
+    int denominators[] = {4, 6, 10, 15};
 
-// Mock implementation using Trompeloeil
+    // Act - Fold the least common multiple over the denominators
+    int common = 1;
+    for (int denominator : denominators) {
+      common = calculator.lcm(common, denominator);
+    }
+
+    // Assert
+    CHECK(common == 60);
+  }
+}
+
+// Mock implementation of the engine interface using Trompeloeil
 class MockCalculator : public ICalculator {
 public:
   MAKE_MOCK2(add, int(int, int), override);
   MAKE_MOCK2(subtract, int(int, int), override);
+  MAKE_MOCK2(multiply, int(int, int), override);
+  MAKE_MOCK2(divide, double(int, int), override);
 };
 
 TEST_CASE("MockCalculator - functional test with mocking") {
@@ -177,4 +214,24 @@ TEST_CASE("MockCalculator - functional test with mocking") {
 
     // Assert - Trompeloeil verifies the call count automatically
   }
+
+  SUBCASE("mocked engine behind BasicCalculator") {
+    // Arrange
+    auto engine = std::make_unique<MockCalculator>();
+    MockCalculator& mock_calculator = *engine;
+    BasicCalculator<AnyCalculator> calculator{AnyCalculator(std::move(engine))};
+    const std::vector<int> values = {1, 2, 3};
+    const std::vector<int> factors(3, 10);
+    std::vector<int> results(3);
+
+    REQUIRE_CALL(mock_calculator, multiply(trompeloeil::_, 10))
+        .TIMES(3)
+        .RETURN(_1 * 10);
+
+    // Act - One engine call per element of the batch
+    calculator.multiply(values, factors, results);
+
+    // Assert
+    CHECK(results == std::vector<int>{10, 20, 30});
+  }
 }
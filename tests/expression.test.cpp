@@ -0,0 +1,330 @@
+// First-party headers
+#include "calculator/compiled_expression.h"
+#include "calculator/compiled_program.h"
+#include "calculator/expression.h"
+#include "calculator/narrowed_expression.h"
+#include "calculator/tiered_expression.h"
+
+// Third-party headers
+#include <doctest/doctest.h>
+
+// Standard library headers
+#include <algorithm>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+// Functional tests for expression evaluation tiers
+
+namespace {
+
+// Builds (price * qty - discount) / qty
+Expression make_unit_price_expression() {
+  Expression expression;
+  NodeId price = expression.input(0);
+  NodeId qty = expression.input(1);
+  NodeId discount = expression.input(2);
+  NodeId total = expression.multiply(price, qty);
+  expression.divide(expression.subtract(total, discount), qty);
+  return expression;
+}
+
+} // namespace
+
+TEST_CASE("Expression - functional test for tier agreement") {
+  // Arrange
+  Expression expression = make_unit_price_expression();
+  CompiledExpression compiled(expression);
+  std::vector<double> price = {10.0, 2.5, 7.0, 100.0};
+  std::vector<double> qty = {2.0, 4.0, 1.0, 8.0};
+  std::vector<double> discount = {1.0, 0.0, 3.0, 40.0};
+  std::vector<std::span<const double>> columns = {price, qty, discount};
+
+  SUBCASE("interpreter and compiled batches match row evaluation") {
+    // Arrange
+    std::vector<double> interpreted(price.size());
+    std::vector<double> optimized(price.size());
+
+    // Act
+    expression.evaluate(columns, interpreted);
+    compiled.evaluate(columns, optimized);
+
+    // Assert
+    for (std::size_t row = 0; row < price.size(); ++row) {
+      std::vector<double> inputs = {price[row], qty[row], discount[row]};
+      CHECK(interpreted[row] == doctest::Approx(expression.evaluate(inputs)));
+      CHECK(optimized[row] == doctest::Approx(compiled.evaluate(inputs)));
+      CHECK(optimized[row] == doctest::Approx(interpreted[row]));
+    }
+  }
+
+  SUBCASE("zero divisor in any row throws in both tiers") {
+    // Arrange
+    qty[2] = 0.0;
+    std::vector<double> results(price.size());
+
+    // Act & Assert
+    CHECK_THROWS_AS(expression.evaluate(columns, results),
+                    std::invalid_argument);
+    CHECK_THROWS_AS(compiled.evaluate(columns, results),
+                    std::invalid_argument);
+  }
+
+  SUBCASE("short input columns are rejected") {
+    // Arrange
+    std::vector<double> results(price.size() + 1);
+
+    // Act & Assert
+    CHECK_THROWS_AS(compiled.evaluate(columns, results),
+                    std::invalid_argument);
+  }
+}
+
+TEST_CASE("Expression - functional test for conditional formulas") {
+  // Arrange - select(qty > 0, price / qty, 0) over more than one block
+  Expression expression;
+  NodeId price = expression.input(0);
+  NodeId qty = expression.input(1);
+  NodeId zero = expression.constant(0.0);
+  expression.select(expression.greater(qty, zero),
+                    expression.divide(price, qty), zero);
+  std::vector<double> prices(600);
+  std::vector<double> quantities(600);
+  for (std::size_t row = 0; row < prices.size(); ++row) {
+    prices[row] = static_cast<double>(row);
+    quantities[row] = static_cast<double>(row % 4);
+  }
+  std::vector<std::span<const double>> columns = {prices, quantities};
+
+  SUBCASE("every tier skips the guarded zero divisors") {
+    // Arrange
+    CompiledExpression compiled(expression);
+    TierPolicy policy;
+    policy.hot_threshold = 0;
+    TieredExpression tiered(expression, policy);
+    std::vector<double> interpreted(prices.size());
+    std::vector<double> optimized(prices.size());
+    std::vector<double> promoted(prices.size());
+
+    // Act
+    expression.evaluate(columns, interpreted);
+    compiled.evaluate(columns, optimized);
+    tiered.evaluate(columns, promoted);
+
+    // Assert
+    for (std::size_t row = 0; row < prices.size(); ++row) {
+      double expected = quantities[row] > 0.0 ? prices[row] / quantities[row]
+                                              : 0.0;
+      CHECK(interpreted[row] == doctest::Approx(expected));
+      CHECK(optimized[row] == doctest::Approx(expected));
+      CHECK(promoted[row] == doctest::Approx(expected));
+    }
+  }
+
+  SUBCASE("an unguarded zero divisor in a late block still throws") {
+    // Arrange
+    Expression unguarded;
+    unguarded.divide(unguarded.input(0), unguarded.input(1));
+    CompiledExpression compiled(unguarded);
+    std::fill(quantities.begin(), quantities.end(), 1.0);
+    quantities[550] = 0.0;
+    std::vector<double> results(prices.size());
+
+    // Act & Assert
+    CHECK_THROWS_AS(compiled.evaluate(columns, results),
+                    std::invalid_argument);
+  }
+}
+
+TEST_CASE("TieredExpression - functional test for hot promotion") {
+  // Arrange
+  TierPolicy policy;
+  policy.hot_threshold = 100;
+  TieredExpression tiered(make_unit_price_expression(), policy);
+  std::vector<double> price(64, 3.0);
+  std::vector<double> qty(64, 2.0);
+  std::vector<double> discount(64, 1.0);
+  std::vector<std::span<const double>> columns = {price, qty, discount};
+  std::vector<double> results(price.size());
+
+  SUBCASE("batches count every row towards the threshold") {
+    // Act
+    tiered.evaluate(columns, results);
+    tiered.evaluate(columns, results);
+    tiered.wait_for_promotion();
+
+    // Assert
+    CHECK(tiered.invocation_count() == 128);
+    CHECK(tiered.is_optimized());
+  }
+
+  SUBCASE("results are unchanged across the tier swap") {
+    // Act
+    tiered.evaluate(columns, results);
+    double before = results.front();
+    tiered.evaluate(columns, results);
+    tiered.wait_for_promotion();
+    tiered.evaluate(columns, results);
+
+    // Assert
+    CHECK(before == doctest::Approx(2.5));
+    CHECK(results.back() == doctest::Approx(before));
+  }
+}
+
+TEST_CASE("CompiledProgram - functional test for shared formula sets") {
+  // Arrange - revenue, cost and margin over price, qty and unit cost
+  Expression revenue;
+  revenue.multiply(revenue.input(0), revenue.input(1));
+  Expression cost;
+  cost.multiply(cost.input(2), cost.input(1));
+  Expression margin;
+  NodeId qty = margin.input(1);
+  margin.subtract(margin.multiply(margin.input(0), qty),
+                  margin.multiply(qty, margin.input(2)));
+  std::vector<Expression> expressions = {revenue, cost, margin};
+  CompiledProgram program(expressions);
+  std::vector<double> price = {10.0, 4.0, 8.0};
+  std::vector<double> qty_column = {3.0, 5.0, 2.0};
+  std::vector<double> unit_cost = {6.0, 1.0, 7.5};
+  std::vector<std::span<const double>> columns = {price, qty_column,
+                                                  unit_cost};
+
+  SUBCASE("one pass matches evaluating each formula independently") {
+    // Arrange
+    std::vector<std::vector<double>> results(3, std::vector<double>(3));
+    std::vector<std::span<double>> outputs(results.begin(), results.end());
+
+    // Act
+    program.evaluate(columns, outputs);
+
+    // Assert
+    for (std::size_t formula = 0; formula < expressions.size(); ++formula) {
+      std::vector<double> expected(price.size());
+      expressions[formula].evaluate(columns, expected);
+      for (std::size_t row = 0; row < price.size(); ++row) {
+        CHECK(results[formula][row] == doctest::Approx(expected[row]));
+      }
+    }
+  }
+
+  SUBCASE("margin reuses the revenue and cost products") {
+    // Act & Assert
+    CHECK(program.step_count() == 3);
+  }
+
+  SUBCASE("output columns of different lengths are rejected") {
+    // Arrange
+    std::vector<double> first(3);
+    std::vector<double> second(3);
+    std::vector<double> third(2);
+    std::vector<std::span<double>> outputs = {first, second, third};
+
+    // Act & Assert
+    CHECK_THROWS_AS(program.evaluate(columns, outputs), std::invalid_argument);
+  }
+}
+
+TEST_CASE("CompileOptions - functional test for range-checked formulas") {
+  // Arrange - price * qty / qty with qty declared as [1, 1000]
+  Expression expression;
+  NodeId price = expression.input(0);
+  NodeId qty = expression.input(1);
+  expression.divide(expression.multiply(price, qty), qty);
+  CompileOptions options;
+  options.check_overflow = true;
+  options.input_bounds = {{0.0, 1e6}, {1.0, 1000.0}};
+
+  SUBCASE("proven formulas run without checks and agree with the "
+          "interpreter") {
+    // Arrange
+    CompiledExpression compiled(expression, options);
+    std::vector<double> inputs = {250.0, 4.0};
+
+    // Act
+    double result = compiled.evaluate(inputs);
+
+    // Assert
+    CHECK(compiled.checks_kept() == 0);
+    CHECK(compiled.checks_removed() == 2);
+    CHECK(result == doctest::Approx(expression.evaluate(inputs)));
+  }
+
+  SUBCASE("widening a bound brings the overflow check back") {
+    // Arrange
+    options.input_bounds[0].upper = 1e7;
+
+    // Act
+    CompiledExpression compiled(expression, options);
+
+    // Assert
+    CHECK(compiled.checks_kept() == 1);
+    CHECK(compiled.checks_removed() == 1);
+  }
+
+  SUBCASE("tiered expressions compile with the policy options") {
+    // Arrange
+    TierPolicy policy;
+    policy.hot_threshold = 0;
+    policy.compile_options = options;
+    policy.compile_options.input_bounds.clear();
+
+    // Act
+    TieredExpression tiered(expression, policy);
+    std::vector<double> inputs = {1e6, 1e4};
+
+    // Assert
+    CHECK_THROWS_AS(tiered.evaluate(inputs), std::overflow_error);
+  }
+}
+
+TEST_CASE("NarrowedExpression - functional test against the double tier") {
+  // Arrange - (qty * price + fee) / qty over int16 qty, int32 price and a
+  // float64 fee
+  std::vector<InputDeclaration> declarations = {
+      {ValueType::Int16, {1.0, 1000.0}},
+      {ValueType::Int32, {0.0, 100000.0}},
+      {ValueType::Float64, {}}};
+  Expression expression;
+  NodeId qty = expression.input(0);
+  NodeId price = expression.input(1);
+  NodeId fee = expression.input(2);
+  NodeId product = expression.multiply(qty, price);
+  expression.divide(expression.add(product, fee), qty);
+  NarrowedExpression narrowed(expression, declarations);
+  std::vector<std::int16_t> qty_column = {1, 12, 1000, 3};
+  std::vector<std::int32_t> price_column = {100000, 250, 99, 7};
+  std::vector<double> fee_column = {0.5, 1.25, 0.0, 2.0};
+
+  SUBCASE("narrowed results match the double compiled tier exactly") {
+    // Arrange
+    std::vector<TypedColumn> columns = {
+        std::span<const std::int16_t>(qty_column),
+        std::span<const std::int32_t>(price_column),
+        std::span<const double>(fee_column)};
+    std::vector<double> qty_wide(qty_column.begin(), qty_column.end());
+    std::vector<double> price_wide(price_column.begin(), price_column.end());
+    std::vector<std::span<const double>> wide_columns = {qty_wide, price_wide,
+                                                         fee_column};
+    std::vector<double> narrow_results(qty_column.size());
+    std::vector<double> wide_results(qty_column.size());
+
+    // Act
+    narrowed.evaluate(columns, narrow_results);
+    CompiledExpression(expression).evaluate(wide_columns, wide_results);
+
+    // Assert
+    CHECK(narrow_results == wide_results);
+  }
+
+  SUBCASE("the product is computed in int32 and the quotient in double") {
+    // Act
+    const std::vector<ValueType>& types = narrowed.node_types();
+
+    // Assert
+    CHECK(types[qty] == ValueType::Int16);
+    CHECK(types[product] == ValueType::Int32);
+    CHECK(types.back() == ValueType::Float64);
+  }
+}
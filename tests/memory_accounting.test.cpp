@@ -0,0 +1,90 @@
+// First-party headers
+#include "calculator/autotuner.h"
+#include "calculator/compiled_program.h"
+#include "calculator/expression.h"
+#include "calculator/memory_accounting.h"
+
+// Third-party headers
+#include <doctest/doctest.h>
+
+// Standard library headers
+#include <filesystem>
+#include <random>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Functional tests for per-subsystem memory accounting
+
+TEST_CASE("Memory accounting - functional test for subsystem usage") {
+  // Arrange - (a + 2) * b over several blocks
+  Expression expression;
+  expression.multiply(
+      expression.add(expression.input(0), expression.constant(2.0)),
+      expression.input(1));
+  std::vector<Expression> expressions = {expression};
+  const MemorySnapshot before = memory_snapshot();
+
+  SUBCASE("programs hold memory until they are destroyed") {
+    // Act
+    MemorySnapshot compiled;
+    {
+      CompiledProgram program(expressions);
+      compiled = memory_snapshot();
+    }
+    const MemorySnapshot released = memory_snapshot();
+
+    // Assert
+    CHECK(compiled[MemorySubsystem::Programs].current_bytes >
+          before[MemorySubsystem::Programs].current_bytes);
+    CHECK(released[MemorySubsystem::Programs].current_bytes ==
+          before[MemorySubsystem::Programs].current_bytes);
+    CHECK(released[MemorySubsystem::Programs].peak_bytes >=
+          compiled[MemorySubsystem::Programs].current_bytes);
+  }
+
+  SUBCASE("evaluation scratch is charged to buffers") {
+    // Arrange
+    CompiledProgram program(expressions);
+    std::vector<double> a(1000, 1.0);
+    std::vector<double> b(1000, 3.0);
+    std::vector<std::span<const double>> columns = {a, b};
+    std::vector<double> results(1000);
+    std::vector<std::span<double>> outputs = {results};
+
+    // Act - a new thread allocates its own scratch and frees it on exit
+    std::thread([&] { program.evaluate(columns, outputs); }).join();
+    const MemorySnapshot after = memory_snapshot();
+
+    // Assert
+    const MemoryUsage& buffers = after[MemorySubsystem::Buffers];
+    CHECK(results[999] == 9.0);
+    CHECK(buffers.allocation_count >
+          before[MemorySubsystem::Buffers].allocation_count);
+    CHECK(buffers.deallocation_count >
+          before[MemorySubsystem::Buffers].deallocation_count);
+    CHECK(buffers.current_bytes ==
+          before[MemorySubsystem::Buffers].current_bytes);
+  }
+
+  SUBCASE("the tuning profile is charged to caches") {
+    // Arrange
+    std::filesystem::path path =
+        std::filesystem::temp_directory_path() /
+        ("calculator-memory-functional-" +
+         std::to_string(std::random_device{}())) /
+        "tuning.txt";
+
+    // Act
+    Autotuner autotuner(path);
+    autotuner.config_for(5000);
+    const MemorySnapshot after = memory_snapshot();
+
+    // Assert
+    CHECK(after[MemorySubsystem::Caches].allocation_count >
+          before[MemorySubsystem::Caches].allocation_count);
+    CHECK(after.total_current_bytes() > 0);
+    std::filesystem::remove_all(path.parent_path());
+  }
+}
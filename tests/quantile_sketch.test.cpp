@@ -0,0 +1,74 @@
+// First-party headers
+#include "calculator/quantile_sketch.h"
+
+// Third-party headers
+#include <doctest/doctest.h>
+
+// Standard library headers
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <random>
+#include <span>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+// Functional tests for streaming percentiles merged across threads
+
+TEST_CASE("QuantileSketch - functional test for per-thread sketches") {
+  // Arrange - log-normal latencies split across four threads
+  constexpr std::size_t THREAD_COUNT = 4;
+  std::mt19937_64 random(11);
+  std::lognormal_distribution<double> latency(3.0, 1.0);
+  std::vector<double> values(400000);
+  for (double& value : values) {
+    value = latency(random);
+  }
+  const std::size_t share = values.size() / THREAD_COUNT;
+  std::vector<DdSketch> dd_sketches(THREAD_COUNT);
+  std::vector<KllSketch> kll_sketches;
+  for (std::size_t thread = 0; thread < THREAD_COUNT; ++thread) {
+    kll_sketches.emplace_back(200, thread + 1);
+  }
+
+  // Act - each thread fills its own sketches, then the partial results are
+  // shipped through their serialized form and merged
+  std::vector<std::thread> threads;
+  for (std::size_t thread = 0; thread < THREAD_COUNT; ++thread) {
+    threads.emplace_back([&, thread] {
+      auto part = std::span<const double>(values).subspan(thread * share,
+                                                          share);
+      dd_sketches[thread].add(part);
+      kll_sketches[thread].add(part);
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  DdSketch dd_total;
+  KllSketch kll_total;
+  for (std::size_t thread = 0; thread < THREAD_COUNT; ++thread) {
+    std::stringstream stream;
+    dd_sketches[thread].serialize(stream);
+    kll_sketches[thread].serialize(stream);
+    dd_total.merge(DdSketch::deserialize(stream));
+    kll_total.merge(KllSketch::deserialize(stream));
+  }
+
+  // Assert
+  std::sort(values.begin(), values.end());
+  CHECK(dd_total.count() == values.size());
+  CHECK(kll_total.count() == values.size());
+  for (double q : {0.5, 0.9, 0.99, 0.999}) {
+    const double exact =
+        values[static_cast<std::size_t>(q * (values.size() - 1))];
+    CHECK(std::abs(dd_total.quantile(q) - exact) <= 0.01 * exact);
+
+    const double estimate = kll_total.quantile(q);
+    const auto rank =
+        std::lower_bound(values.begin(), values.end(), estimate) -
+        values.begin();
+    CHECK(std::abs(static_cast<double>(rank) / values.size() - q) < 0.02);
+  }
+}
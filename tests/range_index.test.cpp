@@ -0,0 +1,56 @@
+// First-party headers
+#include "calculator/calculator.h"
+#include "calculator/range_index.h"
+
+// Third-party headers
+#include <doctest/doctest.h>
+
+// Standard library headers
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+// Functional tests for range queries over a mutable array
+
+TEST_CASE("RangeIndex - functional test against Calculator summation") {
+  // Arrange - 100000 values under a random mix of updates and queries
+  std::mt19937 random(11);
+  std::uniform_int_distribution<int> value_of(-1000, 1000);
+  std::vector<int> values(100000);
+  for (int& value : values) {
+    value = value_of(random);
+  }
+  RangeIndex index(values);
+  Calculator calculator;
+  std::uniform_int_distribution<std::size_t> position_of(0, values.size());
+
+  for (int round = 0; round < 200; ++round) {
+    // Act
+    std::vector<PointUpdate> updates(8);
+    for (PointUpdate& update : updates) {
+      update.position = position_of(random) % values.size();
+      update.value = value_of(random);
+      values[update.position] = update.value;
+    }
+    index.update(updates);
+    std::size_t first = position_of(random);
+    std::size_t last = position_of(random);
+    if (first > last) {
+      std::swap(first, last);
+    }
+
+    // Assert
+    int expected = 0;
+    for (std::size_t position = first; position < last; ++position) {
+      expected = calculator.add(expected, values[position]);
+    }
+    CHECK(index.sum({first, last}) == expected);
+    if (first < last) {
+      CHECK(index.min({first, last}) ==
+            *std::min_element(values.begin() + first, values.begin() + last));
+      CHECK(index.max({first, last}) ==
+            *std::max_element(values.begin() + first, values.begin() + last));
+    }
+  }
+}
@@ -0,0 +1,54 @@
+// First-party headers
+#include "calculator/spilling_aggregator.h"
+
+// Third-party headers
+#include <doctest/doctest.h>
+
+// Standard library headers
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <random>
+#include <vector>
+
+// Functional tests for group-by aggregation beyond the memory budget
+
+TEST_CASE("SpillingAggregator - functional test for out-of-memory group-by") {
+  // Arrange - 5000 groups with room for a few hundred in memory
+  std::filesystem::path directory = std::filesystem::temp_directory_path() /
+                                    "calculator-aggregation-functional";
+  std::filesystem::remove_all(directory);
+  AggregationOptions options;
+  options.memory_budget = 1024 * SpillingAggregator::SLOT_BYTES;
+  options.partition_count = 4;
+  options.spill_directory = directory;
+  SpillingAggregator aggregator(options);
+
+  std::mt19937 random(42);
+  std::uniform_int_distribution<std::int64_t> key_of(-2500, 2499);
+  std::uniform_int_distribution<int> value_of(-100, 100);
+  std::vector<std::int64_t> keys(200000);
+  std::vector<int> values(keys.size());
+  std::map<std::int64_t, int> expected;
+  for (std::size_t row = 0; row < keys.size(); ++row) {
+    keys[row] = key_of(random);
+    values[row] = value_of(random);
+    expected[keys[row]] += values[row];
+  }
+
+  // Act
+  aggregator.add(keys, values);
+  std::map<std::int64_t, int> actual;
+  std::size_t duplicates = 0;
+  aggregator.finish([&](std::int64_t key, int sum) {
+    duplicates += actual.count(key);
+    actual[key] = sum;
+  });
+
+  // Assert
+  CHECK(aggregator.spilled_runs() > 0);
+  CHECK(duplicates == 0);
+  CHECK(actual == expected);
+  CHECK(std::filesystem::is_empty(directory));
+  std::filesystem::remove_all(directory);
+}
@@ -0,0 +1,90 @@
+// First-party headers
+#include "calculator/statistics.h"
+
+// Third-party headers
+#include <doctest/doctest.h>
+
+// Standard library headers
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <random>
+#include <span>
+#include <thread>
+#include <vector>
+
+// Functional tests for descriptive statistics merged across threads
+
+TEST_CASE("Statistics - functional test for parallel partial states") {
+  // Arrange - correlated pairs with a large offset, split across threads
+  constexpr std::size_t THREAD_COUNT = 4;
+  std::mt19937_64 random(17);
+  std::normal_distribution<double> noise(0.0, 1.0);
+  std::vector<double> xs(100003);
+  std::vector<double> ys(xs.size());
+  for (std::size_t index = 0; index < xs.size(); ++index) {
+    xs[index] = 1e6 + noise(random);
+    ys[index] = 2.0 * xs[index] + noise(random);
+  }
+
+  // Reference values from a two-pass computation in long double
+  long double sum_x = 0;
+  long double sum_y = 0;
+  for (std::size_t index = 0; index < xs.size(); ++index) {
+    sum_x += xs[index];
+    sum_y += ys[index];
+  }
+  const long double mean_x = sum_x / xs.size();
+  const long double mean_y = sum_y / xs.size();
+  long double m2_x = 0;
+  long double m2_y = 0;
+  long double m3_x = 0;
+  long double c_xy = 0;
+  for (std::size_t index = 0; index < xs.size(); ++index) {
+    const long double dx = xs[index] - mean_x;
+    const long double dy = ys[index] - mean_y;
+    m2_x += dx * dx;
+    m2_y += dy * dy;
+    m3_x += dx * dx * dx;
+    c_xy += dx * dy;
+  }
+
+  // Act
+  const std::size_t share = (xs.size() + THREAD_COUNT - 1) / THREAD_COUNT;
+  std::vector<RunningStatistics> statistics(THREAD_COUNT);
+  std::vector<RunningCovariance> covariances(THREAD_COUNT);
+  std::vector<std::thread> threads;
+  for (std::size_t thread = 0; thread < THREAD_COUNT; ++thread) {
+    threads.emplace_back([&, thread] {
+      const std::size_t first = thread * share;
+      const std::size_t count = std::min(share, xs.size() - first);
+      auto x_part = std::span<const double>(xs).subspan(first, count);
+      auto y_part = std::span<const double>(ys).subspan(first, count);
+      statistics[thread].add(x_part);
+      covariances[thread].add(x_part, y_part);
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  for (std::size_t thread = 1; thread < THREAD_COUNT; ++thread) {
+    statistics.front().merge(statistics[thread]);
+    covariances.front().merge(covariances[thread]);
+  }
+
+  // Assert
+  const RunningStatistics& x_statistics = statistics.front();
+  const RunningCovariance& covariance = covariances.front();
+  const auto n = static_cast<double>(xs.size());
+  CHECK(x_statistics.count() == xs.size());
+  CHECK(x_statistics.mean() == doctest::Approx(static_cast<double>(mean_x)));
+  CHECK(x_statistics.variance() ==
+        doctest::Approx(static_cast<double>(m2_x) / (n - 1)));
+  CHECK(x_statistics.skewness() ==
+        doctest::Approx(static_cast<double>(
+            std::sqrt(n) * m3_x / std::pow(m2_x, 1.5L))));
+  CHECK(covariance.covariance() ==
+        doctest::Approx(static_cast<double>(c_xy) / (n - 1)));
+  CHECK(covariance.correlation() ==
+        doctest::Approx(static_cast<double>(c_xy / std::sqrt(m2_x * m2_y))));
+}